@@ -0,0 +1,61 @@
+#ifndef CRAZE_CACHE_H
+#define CRAZE_CACHE_H
+
+#include "craze_parser.h"
+#include <stdint.h>
+
+/* Versão do compilador gravada nos caches; caches de outra versão são ignorados */
+#define CRAZE_VERSION "0.1"
+
+/* Versão do formato .crzc (incremente ao mudar CompactNode ou a AST) */
+#define CRAZE_CACHE_FORMAT 11
+
+/* --- Chave do Cache --- */
+typedef struct
+{
+    char *path;            // Arquivo .crzc (ao lado do fonte ou em CRAZE_CACHE_DIR)
+    uint64_t source_hash;  // FNV-1a do conteúdo do fonte
+    uint64_t source_length;
+} CacheKey;
+
+/* --- Aviso Guardado no Cache --- */
+/* Um cache válido pula a análise semântica: os avisos dela são gravados com
+ * o programa e emitidos de novo na carga */
+typedef struct
+{
+    int line;
+    int column;
+    const char *message;
+} CacheWarning;
+
+struct SemanticAnalyzer;
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+/* Calcula a chave do programa 'filename' com o conteúdo dado.
+ * O cache fica em '<filename>.crzc' ou, se CRAZE_CACHE_DIR estiver definido,
+ * em '<CRAZE_CACHE_DIR>/<hash>.crzc'. Retorna 0 se o cache estiver
+ * desativado (CRAZE_NO_CACHE definido) ou faltar memória. */
+int cache_key_init(CacheKey *key, const char *filename, const char *source, size_t length);
+
+/* Libera o caminho da chave */
+void cache_key_free(CacheKey *key);
+
+/* Copia os avisos (não os erros) do analisador para '*warnings', na ordem em
+ * que foram emitidos. As mensagens apontam para o analisador; libere o array
+ * com free. Retorna 0 se faltar memória (o cache então não deve ser gravado). */
+int cache_collect_warnings(const struct SemanticAnalyzer *analyzer, CacheWarning **warnings, int *count);
+
+/* Carrega o programa validado do cache para a arena, via mmap.
+ * Retorna NULL se o cache não existir, for de outro fonte/versão ou estiver
+ * corrompido; nesse caso o programa deve ser compilado normalmente.
+ * Os avisos gravados (também na arena) vão para 'warnings'/'warning_count',
+ * se não forem NULL. */
+ASTNode *cache_load(const CacheKey *key, AstArena *arena, CacheWarning **warnings, int *warning_count);
+
+/* Grava o programa (já aprovado pela análise semântica) no cache, com os
+ * avisos que a análise emitiu para ele.
+ * A escrita é atômica (arquivo temporário + rename). Retorna 1 em caso de sucesso. */
+int cache_save(const CacheKey *key, ASTNode *program, const CacheWarning *warnings, int warning_count);
+
+#endif /* CRAZE_CACHE_H */
@@ -0,0 +1,105 @@
+#ifndef CRAZE_COMPACT_H
+#define CRAZE_COMPACT_H
+
+#include "craze_parser.h"
+#include <stdint.h>
+
+/* --- AST Compacta --- */
+/* Representação alternativa da AST, densa e sem ponteiros: todos os nós num
+ * único array de registros de 32 bytes (metade de um ASTNode), referenciados
+ * por handles de 32 bits; as listas de filhos são fatias de um array de
+ * handles compartilhado e os nomes e strings ficam numa tabela única, sem
+ * duplicatas. Os nós estão em pré-ordem: a raiz é o handle 0 e todo filho tem
+ * handle maior que o do pai. Por não ter ponteiros, a mesma estrutura é o
+ * conteúdo do cache .crzc, lida direto do arquivo mapeado. */
+
+typedef uint32_t AstHandle;
+
+#define AST_NONE 0xFFFFFFFFu // Filho, lista ou string ausente
+
+/* Conteúdo de 'slot' por tipo de nó (listas ocupam dois slots: início em
+ * 'lists' e quantidade; nomes e strings são offsets em 'strings'):
+ *   VAR_DECL      nome, tipo, inicializador
+ *   FUNC_DECL     nome, params (2), tipo de retorno, corpo
+ *   PARAM         nome, tipo, offset no registro         tag: FieldStorage
+ *   STRUCT_DECL   nome, campos (2), tamanho do registro
+ *   IMPORT        caminho, module_hash (2: parte baixa e alta)
+ *   EXPR_STMT     expressão
+ *   IF_STMT       condição, então, senão
+ *   WHILE_STMT    condição, corpo
+ *   FOR_STMT      variável, início, fim, passo, corpo
+ *   MATCH_STMT    sujeito, braços (2), else
+ *   MATCH_ARM     rótulos (2), corpo
+ *   RETURN_STMT   valor
+ *   BLOCK         instruções (2)
+ *   BINARY_EXPR   esquerda, direita                      tag: operador
+ *   UNARY_EXPR    operando                               tag: operador
+ *   ASSIGN_EXPR   nome, valor
+ *   CALL_EXPR     nome, argumentos (2)
+ *   VAR_EXPR      nome
+ *   INDEX_EXPR    array, índice
+ *   INDEX_ASSIGN  array, índice, valor
+ *   FIELD_EXPR    campo, objeto, valor, offset           tag: FieldStorage
+ *   ARRAY_LITERAL elementos (2)
+ *   MAP_LITERAL   chave, valor, chave... (2)             tag: tipo da chave | tipo do valor << 8
+ *   LITERAL       int, bool, string ou os bits do double (2)  tag: tipo do literal
+ *   TYPE          is_array | is_map << 1, tipo da chave, nome do struct  tag: tipo */
+typedef struct
+{
+    uint8_t kind;      // NodeType
+    uint8_t data_type; // DataType anotado
+    uint16_t tag;
+    int32_t line;
+    int32_t column;
+    uint32_t slot[5];
+} CompactNode;
+
+typedef struct
+{
+    CompactNode *nodes;
+    uint32_t node_count;
+    AstHandle *lists;
+    uint32_t list_count;
+    char *strings;        // Strings terminadas em '\0', uma após a outra
+    uint32_t string_size;
+
+    // Só na construção (compact_ast_build); zerados numa visão (compact_ast_view)
+    uint32_t node_capacity;
+    uint32_t list_capacity;
+    uint32_t string_capacity;
+    uint32_t *intern;     // Offset + 1 de cada string (0 = vazio)
+    uint32_t intern_capacity;
+    uint32_t intern_count;
+    int failed;
+} CompactAst;
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+/* Inicializa uma AST compacta vazia; a tabela de strings começa com "" */
+void compact_ast_init(CompactAst *ast);
+
+/* Acrescenta 'root' e seus descendentes em pré-ordem; retorna o handle de
+ * 'root' ou AST_NONE se faltar memória */
+AstHandle compact_ast_build(CompactAst *ast, const ASTNode *root);
+
+/* Adiciona uma string à tabela (sem duplicatas) e retorna seu offset, ou
+ * AST_NONE para NULL ou se faltar memória */
+uint32_t compact_ast_string(CompactAst *ast, const char *text);
+
+/* Visão somente leitura sobre arrays de outra origem (um .crzc mapeado); não
+ * deve ser passada para compact_ast_free */
+void compact_ast_view(CompactAst *ast, const CompactNode *nodes, uint32_t node_count,
+                      const AstHandle *lists, uint32_t list_count, const char *strings, uint32_t string_size);
+
+/* Reconstrói a árvore de ASTNode (com as tabelas do match) na arena, validando
+ * cada handle, lista e offset: a entrada pode vir de um arquivo corrompido.
+ * Retorna a raiz ou NULL, sem deixar nada na arena em caso de erro. */
+ASTNode *compact_ast_expand(const CompactAst *ast, AstArena *arena);
+
+/* Imprime a subárvore de 'node' no formato de ast_print */
+void compact_ast_print(const CompactAst *ast, AstHandle node, int indent);
+
+/* Libera os arrays de uma AST construída */
+void compact_ast_free(CompactAst *ast);
+
+#endif /* CRAZE_COMPACT_H */
@@ -0,0 +1,93 @@
+#ifndef CRAZE_INCREMENTAL_H
+#define CRAZE_INCREMENTAL_H
+
+#include "craze_semantic.h"
+#include <stdint.h>
+
+/* --- Nome Global e sua Assinatura --- */
+/* Usado para as dependências de um trecho (assinatura do símbolo visível com
+ * esse nome quando o trecho foi verificado; 0 = nenhum) e para os símbolos
+ * que o trecho declara */
+typedef struct
+{
+    const char *name;
+    uint64_t signature;
+} DocumentBinding;
+
+/* --- Trecho do Documento --- */
+/* Uma declaração de nível superior e tudo o que vem até a próxima. O trecho 0
+ * sempre começa no byte 0 (e pode não ter instruções). */
+typedef struct
+{
+    size_t start;          // Offset do primeiro token no fonte
+    int line;              // Linha/coluna do primeiro token
+    int column;
+    int ast_line;          // Linha do primeiro token quando a AST foi construída
+    ASTNode **statements;  // Instruções do trecho (AST própria, um malloc por nó)
+    int stmt_count;
+    int parse_error;       // 1 se o trecho teve erro de sintaxe
+    DocumentBinding *deps; // Nomes usados ou declarados pelo trecho (nomes na AST)
+    int dep_count;
+    DocumentBinding *exports; // Símbolos globais declarados (nomes nos símbolos)
+    int export_count;
+    SymbolSpan symbols;    // Símbolos globais da última verificação
+    int semantic_errors;   // Erros/avisos da última verificação
+    int semantic_warnings;
+    int checked;           // 0 até o trecho ser verificado pela primeira vez
+} DocumentUnit;
+
+/* --- Documento Editável --- */
+/* Mantém fonte, AST e análise semântica de um programa entre edições: uma
+ * edição re-tokeniza e refaz o parse só dos trechos afetados, e a análise
+ * re-verifica só os trechos novos e os que dependem de símbolos globais cuja
+ * assinatura mudou. Sem erros de sintaxe, o resultado é idêntico ao de um parse
+ * e análise completos; com erros, a recuperação acontece dentro de cada trecho. */
+typedef struct
+{
+    char *source;
+    size_t length;
+    size_t capacity;
+
+    DocumentUnit *units;
+    int unit_count;
+    int unit_capacity;
+
+    ASTNode program;       // NODE_BLOCK com as instruções de todos os trechos
+    int program_stale;     // 'program' precisa ser remontado
+
+    SemanticAnalyzer analyzer;
+    DocumentBinding *bindings; // Tabela hash nome -> assinatura (por análise)
+    int binding_capacity;
+    int binding_count;
+
+    int error_count;       // Erros de sintaxe + semânticos da última análise
+
+    // Estatísticas da última edição/análise
+    size_t relexed_bytes;
+    int reparsed_units;
+    int rechecked_units;
+} Document;
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+/* Cria um documento com uma cópia do fonte e faz o parse completo.
+ * Retorna 1 em caso de sucesso, 0 se faltar memória. */
+int document_open(Document *doc, const char *source, size_t length);
+
+/* Substitui 'removed' bytes a partir de 'offset' por 'inserted' bytes de 'text'
+ * e refaz o parse apenas dos trechos afetados. Retorna 0 se o intervalo for
+ * inválido ou faltar memória (o documento fica inalterado só no primeiro caso). */
+int document_edit(Document *doc, size_t offset, size_t removed, const char *text, size_t inserted);
+
+/* Executa a análise semântica incremental. Retorna 1 se o documento não tem
+ * erros de sintaxe nem semânticos. */
+int document_analyze(Document *doc);
+
+/* Programa atual (NODE_BLOCK). Pertence ao documento: não passe para ast_free
+ * e não guarde entre edições. */
+ASTNode *document_program(Document *doc);
+
+/* Libera o documento */
+void document_free(Document *doc);
+
+#endif /* CRAZE_INCREMENTAL_H */
@@ -3,6 +3,7 @@
 
 #include "craze_semantic.h"
 #include <stdarg.h>
+#include <stdint.h>
 
 /* --- Tipos de Valores Runtime --- */
 typedef enum
@@ -13,7 +14,11 @@ typedef enum
     VAL_BOOL,
     VAL_VOID,
     VAL_NULL,      // Para valores não inicializados/erros
-    VAL_BUILTIN_FN // Para funções built-in
+    VAL_BUILTIN_FN, // Para funções built-in
+    VAL_ARRAY,      // Array tipado (int[], float[], bool[], string[])
+    VAL_MAP,        // map<K, V> com chaves e valores escalares
+    VAL_BYTES,      // Buffer binário mutável de tamanho explícito
+    VAL_STRUCT      // Registro de um struct (campos no layout fixado pela análise semântica)
 } ValueType;
 
 /* --- Forward declarations --- */
@@ -24,6 +29,24 @@ typedef struct HashTable HashTable;
 typedef struct HashEntry HashEntry;
 typedef struct CallFrame CallFrame;
 
+/* --- Par de um Map --- */
+/* Chave e valor sem boxing, com o hash da chave ao lado: a busca compara
+ * hashes e só então a chave. Os tipos ficam no map (verificados pela análise
+ * semântica), não em cada par. */
+typedef union
+{
+    int int_val; // int e bool
+    double float_val;
+    char *string_val; // Pertence ao map
+} MapScalar;
+
+typedef struct
+{
+    uint32_t hash; // 0 = par removido
+    MapScalar key;
+    MapScalar value;
+} MapEntry;
+
 /* --- Função Built-in --- */
 typedef Value *(*BuiltinFn)(Interpreter *interpreter, Value **args, int arg_count);
 
@@ -35,13 +58,59 @@ typedef struct Value
     {
         int int_val;
         double float_val;
-        char *string_val;
+        struct
+        {
+            // Fatias apontam para o buffer de outra string e não terminam em
+            // '\0': use sempre 'length'
+            char *chars;
+            int length;
+            Value *owner; // NULL: 'chars' pertence a este Value; senão, a string dona do buffer
+        } string;
+        struct
+        {
+            // Fatias compartilham o buffer do dono: escrever numa fatia altera o original
+            unsigned char *data;
+            int length;
+            Value *owner; // NULL: 'data' pertence a este Value; senão, o bytes dono do buffer
+        } bytes;
         int bool_val;
         struct
         {
             BuiltinFn function;
             char *name;
         } builtin_fn;
+        struct
+        {
+            // Elementos sem boxing, contíguos: indexar é checar limites e ler
+            union
+            {
+                int *ints;
+                double *floats;
+                unsigned char *bools;
+                char **strings; // Cada string pertence ao array
+            } items;
+            int length;
+            DataType element_type; // TYPE_VOID só no array vazio de '[]'
+        } array;
+        struct
+        {
+            // Endereçamento aberto (sondagem linear) sobre 'index', que guarda
+            // posições em 'entries': pares densos, em ordem de inserção
+            int32_t *index;    // -1 = vazio, -2 = removido
+            MapEntry *entries;
+            int capacity;      // Tamanho de 'index' (potência de 2; 0 = sem alocação)
+            int entry_count;   // Pares em 'entries', incluindo removidos
+            int count;         // Pares vivos
+            DataType key_type; // int, string ou bool
+            DataType value_type;
+        } map;
+        struct
+        {
+            // Campos logo após o Value, na mesma alocação: int/bool/float sem
+            // boxing, os demais como Value* com referência própria
+            unsigned char *fields;
+            ASTNode *decl; // NODE_STRUCT_DECL anotado: nome, offsets e representação
+        } record;
     } data;
     int ref_count; // Para garbage collection simples
 } Value;
@@ -126,9 +195,15 @@ void interpreter_cleanup(Interpreter *interpreter);
 Value *value_create_int(int value);
 Value *value_create_float(double value);
 Value *value_create_string(const char *value);
+Value *value_create_string_n(const char *chars, int length);       // Copia 'length' bytes
+Value *value_create_slice(Value *string, int offset, int length); // Sem cópia: referencia o buffer
 Value *value_create_bool(int value);
 Value *value_create_void(void);
 Value *value_create_null(void);
+Value *value_create_array(DataType element_type, int length); // Elementos com o valor padrão
+Value *value_create_map(DataType key_type, DataType value_type); // Map vazio
+Value *value_create_bytes(const unsigned char *data, int length); // Copia 'data' (NULL = zeros)
+Value *value_create_struct(ASTNode *decl); // Campos zerados (Value* = NULL)
 void value_free(Value *value);
 void value_incref(Value *value);
 void value_decref(Value *value);
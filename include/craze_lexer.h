@@ -23,6 +23,14 @@ typedef enum
     TOKEN_FLOAT,
     TOKEN_STRING,
     TOKEN_BOOL,
+    TOKEN_MAP,
+    TOKEN_BYTES,
+    TOKEN_FOR,
+    TOKEN_IN,
+    TOKEN_STEP,
+    TOKEN_STRUCT,
+    TOKEN_IMPORT,
+    TOKEN_MATCH,
 
     // Identificadores e literais
     TOKEN_IDENTIFIER,
@@ -35,6 +43,7 @@ typedef enum
     TOKEN_MINUS,
     TOKEN_STAR,
     TOKEN_SLASH,
+    TOKEN_PERCENT,
     TOKEN_EQUAL,
     TOKEN_EQUAL_EQUAL,
     TOKEN_BANG_EQUAL,
@@ -42,15 +51,23 @@ typedef enum
     TOKEN_LESS,
     TOKEN_GREATER_EQUAL,
     TOKEN_LESS_EQUAL,
+    TOKEN_BANG,
+    TOKEN_AND_AND,
+    TOKEN_PIPE_PIPE,
+    TOKEN_ARROW, // => (braços do match)
 
     // Delimitadores
     TOKEN_LEFT_PAREN,
     TOKEN_RIGHT_PAREN,
     TOKEN_LEFT_BRACE,
     TOKEN_RIGHT_BRACE,
+    TOKEN_LEFT_BRACKET,
+    TOKEN_RIGHT_BRACKET,
     TOKEN_COLON,
     TOKEN_COMMA,
     TOKEN_SEMICOLON,
+    TOKEN_DOT,
+    TOKEN_DOT_DOT,
 
     // Controle
     TOKEN_EOF,
@@ -67,28 +84,91 @@ typedef struct
     int column;   // Coluna inicial (para erro)
 } Token;
 
+/* --- Leitura Incremental (modo streaming) --- */
+/* Lê até 'capacity' bytes em 'buffer'; retorna 0 no fim da entrada */
+typedef size_t (*LexerReadFn)(void *context, char *buffer, size_t capacity);
+
 /* --- Estrutura do Lexer --- */
 typedef struct
 {
-    const char *source;  // Código fonte completo
+    const char *source;  // Código fonte (ou buffer atual no modo streaming)
     const char *start;   // Início do token atual
     const char *current; // Posição atual de análise
+    const char *end;     // Fim do trecho disponível (exclusivo)
     int line;            // Linha atual
     int column;          // Coluna atual
     char error_msg[256]; // Mensagem de erro
+
+    // Modo streaming (stdin/pipes): NULL quando o fonte está todo em memória
+    LexerReadFn read_fn;
+    void *read_context;
+    char *stream_buffer;    // Buffer próprio com a janela atual da entrada
+    size_t stream_capacity; // Capacidade do buffer
+    int stream_eof;         // read_fn já sinalizou fim da entrada
 } Lexer;
 
+/* --- Buffer de Tokens Pré-tokenizados (structure-of-arrays) --- */
+/* O arquivo inteiro é tokenizado de uma vez em arrays paralelos contíguos.
+ * Lexemes não são copiados: offsets/lengths apontam para o fonte, que deve
+ * viver mais que o buffer. Para TOKEN_ERROR, offsets[i] indexa error_messages. */
+typedef struct
+{
+    const char *source;      // Fonte original (base dos offsets)
+    unsigned char *types;    // TokenType de cada token
+    unsigned int *offsets;   // Início do lexeme no fonte
+    int *lengths;            // Comprimento do lexeme
+    int *lines;              // Linha de cada token
+    int *columns;            // Coluna de cada token
+    int count;               // Número de tokens (inclui o TOKEN_EOF final)
+    int capacity;            // Capacidade dos arrays
+    const char **error_messages; // Mensagens dos tokens de erro
+    int error_count;
+    int error_capacity;
+    int *decl_starts;        // Índices dos 'fn'/'let'/'struct'/'import' de nível superior (profundidade 0)
+    int decl_count;
+    int decl_capacity;
+} TokenBuffer;
+
 /* --- FUNÇÕES PÚBLICAS --- */
 
-/* Inicializa o lexer com o código fonte */
+/* Inicializa o lexer com o código fonte (string terminada em '\0') */
 void lexer_init(Lexer *lexer, const char *source);
 
+/* Inicializa o lexer sobre um trecho (ponteiro, tamanho) sem exigir '\0' final,
+ * por exemplo um arquivo mapeado em memória. O trecho deve viver mais que o lexer. */
+void lexer_init_span(Lexer *lexer, const char *source, size_t length);
+
+/* Inicializa o lexer em modo streaming: a entrada é lida em blocos via read_fn,
+ * mantendo em memória apenas a janela do token atual */
+void lexer_init_stream(Lexer *lexer, LexerReadFn read_fn, void *context);
+
 /* Libera recursos do lexer */
 void lexer_cleanup(Lexer *lexer);
 
 /* Obtém próximo token - função principal */
 Token lexer_next_token(Lexer *lexer);
 
+/* Inicializa um buffer de tokens vazio */
+void token_buffer_init(TokenBuffer *buffer);
+
+/* Tokeniza toda a entrada do lexer (modo span) até TOKEN_EOF, registrando
+ * em decl_starts onde começa cada declaração de nível superior.
+ * Retorna 1 em caso de sucesso, 0 se o lexer estiver em modo streaming
+ * ou faltar memória. */
+int token_buffer_fill(TokenBuffer *buffer, Lexer *lexer);
+
+/* Como token_buffer_fill, mas para no primeiro token que comece a 'limit' bytes
+ * ou mais do início do fonte do lexer: esse token vira o TOKEN_EOF final (com a
+ * posição dele), o que permite re-tokenizar só um trecho de um fonte editado */
+int token_buffer_fill_until(TokenBuffer *buffer, Lexer *lexer, size_t limit);
+
+/* Retorna o token 'index' como Token sem cópia (lexeme aponta para o fonte e
+ * NÃO é terminado em '\0'; não chame token_free nele) */
+Token token_buffer_get(const TokenBuffer *buffer, int index);
+
+/* Libera os arrays do buffer */
+void token_buffer_free(TokenBuffer *buffer);
+
 /* Libera recursos de um token */
 void token_free(Token *token);
 
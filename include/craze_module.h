@@ -0,0 +1,66 @@
+#ifndef CRAZE_MODULE_H
+#define CRAZE_MODULE_H
+
+#include "craze_parser.h"
+#include <stdint.h>
+
+/* --- Módulos Importados --- */
+/* 'import "caminho";' traz para o programa as funções, structs e globais de
+ * nível superior de outro arquivo (e, transitivamente, dos que ele importa).
+ * Cada módulo é compilado uma vez por processo e fica num cache indexado pelo
+ * caminho canônico e pelo hash do conteúdo: todos os programas e instâncias
+ * do interpretador que importam o mesmo arquivo compartilham a AST validada
+ * (as func_decls são executadas direto dela) e a instância com os globais já
+ * inicializados, ambas somente leitura depois de prontas: cada import recebe
+ * uma cópia dos globais, e o que ele alterar fica só nela. Entre processos, a
+ * AST do módulo vem do cache .crzc como a de qualquer programa. */
+
+typedef enum
+{
+    MODULE_LOADING, // Em compilação (reencontrá-lo aqui é importação circular)
+    MODULE_READY,
+    MODULE_STALE    // Um import mudou desde a compilação: não é mais entregue
+} ModuleState;
+
+typedef struct CrazeModule
+{
+    char *path;             // Caminho canônico (chave do cache junto com o hash)
+    uint64_t source_hash;   // FNV-1a do conteúdo
+    uint64_t source_length;
+    uint64_t tree_hash;     // Conteúdo e tree_hash de cada import (muda se qualquer um mudar)
+    ASTNode *program;       // NODE_BLOCK validado; nunca alterado depois de pronto
+    AstArena arena;         // Onde vive a AST do módulo
+    ModuleState state;
+
+    // Globais inicializados, criados pelo interpretador na primeira execução
+    // de um import do módulo e liberados com ele em module_cache_clear
+    void *instance;
+    void (*instance_free)(void *instance);
+
+    struct CrazeModule *next;
+} CrazeModule;
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+/* Retorna o módulo 'path', compilando-o (ou carregando-o do .crzc) se ainda não
+ * estiver no cache com o conteúdo atual. Caminhos relativos partem do
+ * diretório de 'importer' (o arquivo com o import; NULL = diretório atual).
+ * Em caso de erro retorna NULL com a causa em 'error'. */
+CrazeModule *module_load(const char *path, const char *importer, char *error, size_t error_size);
+
+/* Liga os imports de nível superior de um programa carregado do cache .crzc
+ * (que não passou pela análise semântica) aos módulos atuais. Retorna 0 se
+ * algum módulo falhou ou mudou desde a gravação: o programa deve então ser
+ * compilado de novo. */
+int module_resolve_imports(ASTNode *program, const char *importer);
+
+/* Trava (recursiva) do cache de módulos; quem cria a instância de um módulo
+ * deve segurá-la para que só uma seja criada */
+void module_lock(void);
+void module_unlock(void);
+
+/* Libera todos os módulos e suas instâncias. Nenhum programa que importou um
+ * módulo pode estar em execução. */
+void module_cache_clear(void);
+
+#endif /* CRAZE_MODULE_H */
@@ -2,6 +2,7 @@
 #define CRAZE_PARSER_H
 
 #include "craze_lexer.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,11 +14,16 @@ typedef enum
     NODE_VAR_DECL,
     NODE_FUNC_DECL,
     NODE_PARAM,
+    NODE_STRUCT_DECL, // struct Nome { campo: tipo, ... }
+    NODE_IMPORT,      // import "caminho"; (só no nível superior)
 
     // Instruções
     NODE_EXPR_STMT,
     NODE_IF_STMT,
     NODE_WHILE_STMT,
+    NODE_FOR_STMT, // for i in a..b step s { ... }
+    NODE_MATCH_STMT, // match (x) { 1, 2 => { ... } else => { ... } }
+    NODE_MATCH_ARM,  // Rótulos e bloco de um braço do match
     NODE_RETURN_STMT,
     NODE_BLOCK,
 
@@ -28,6 +34,12 @@ typedef enum
     NODE_CALL_EXPR,
     NODE_VAR_EXPR,
     NODE_LITERAL_EXPR,
+    NODE_INDEX_EXPR,    // a[i]
+    NODE_INDEX_ASSIGN,  // a[i] = v
+    NODE_ARRAY_LITERAL, // [a, b, c]
+    NODE_MAP_LITERAL,   // {k: v, ...}
+    NODE_FIELD_EXPR,    // r.campo
+    NODE_FIELD_ASSIGN,  // r.campo = v
 
     // Tipos e literais
     NODE_TYPE,
@@ -42,9 +54,44 @@ typedef enum
     TYPE_FLOAT,
     TYPE_STRING,
     TYPE_BOOL,
+    TYPE_BYTES,  // Buffer binário de tamanho explícito
+    TYPE_STRUCT, // Registro declarado com 'struct' (nome no NODE_TYPE)
     TYPE_INVALID
 } DataType;
 
+/* --- Armazenamento de Campos de Struct --- */
+/* Como um campo fica no bloco do registro: escalares sem boxing, os demais
+ * tipos como Value* com referência própria */
+typedef enum
+{
+    FIELD_INT,   // int32
+    FIELD_BOOL,  // 1 byte
+    FIELD_FLOAT, // double
+    FIELD_VALUE  // Value* (string, bytes, arrays, maps e structs)
+} FieldStorage;
+
+/* --- Tabela de Despacho do match --- */
+/* Montada a partir dos rótulos literais (match_table_build) para que a escolha
+ * do braço não dependa do número de braços */
+typedef enum
+{
+    MATCH_JUMP_TABLE,    // Rótulos int densos: índice direto por (valor - base)
+    MATCH_BINARY_SEARCH, // Rótulos int esparsos: busca binária nos rótulos ordenados
+    MATCH_STRING_HASH    // Rótulos string: endereçamento aberto pelo hash FNV-1a
+} MatchDispatch;
+
+typedef struct MatchTable
+{
+    MatchDispatch kind;
+    int base;             // MATCH_JUMP_TABLE: rótulo do slot 0
+    int size;             // Slots (salto e hash, potência de 2) ou rótulos (busca binária)
+    int *arms;            // Braço de cada slot/rótulo (-1 = nenhum)
+    int *keys;            // MATCH_BINARY_SEARCH: rótulos em ordem crescente
+    const char **strings; // MATCH_STRING_HASH: rótulo de cada slot (NULL = vazio)
+    int *lengths;
+    uint32_t *hashes;
+} MatchTable;
+
 /* --- Estrutura Base do Nó --- */
 typedef struct ASTNode
 {
@@ -73,13 +120,32 @@ typedef struct ASTNode
             struct ASTNode *body; // Bloco da função
         } func_decl;
 
-        /* NODE_PARAM */
+        /* NODE_PARAM (também os campos de um NODE_STRUCT_DECL) */
         struct
         {
             char *name;
             struct ASTNode *type_node;
+            int offset;           // Campos: posição no registro (análise semântica)
+            FieldStorage storage; // Campos: representação no registro (análise semântica)
         } param;
 
+        /* NODE_STRUCT_DECL */
+        struct
+        {
+            char *name;
+            struct ASTNode **fields; // NODE_PARAMs, na ordem da declaração
+            int field_count;
+            int size; // Bytes do registro (preenchido pela análise semântica)
+        } struct_decl;
+
+        /* NODE_IMPORT */
+        struct
+        {
+            char *path;                 // Como escrito no fonte (relativo ao arquivo que importa)
+            struct CrazeModule *module; // Resolvido pela análise semântica (ou module_resolve_imports)
+            uint64_t module_hash;       // tree_hash do módulo resolvido (revalida o cache .crzc)
+        } import_stmt;
+
         /* NODE_IF_STMT */
         struct
         {
@@ -95,6 +161,34 @@ typedef struct ASTNode
             struct ASTNode *body;
         } while_stmt;
 
+        /* NODE_FOR_STMT */
+        struct
+        {
+            char *var_name;
+            struct ASTNode *start;
+            struct ASTNode *end;  // Exclusivo
+            struct ASTNode *step; // Pode ser NULL (passo 1)
+            struct ASTNode *body;
+        } for_stmt;
+
+        /* NODE_MATCH_STMT */
+        struct
+        {
+            struct ASTNode *subject;
+            struct ASTNode **arms; // NODE_MATCH_ARMs, na ordem do fonte
+            int arm_count;
+            struct ASTNode *else_branch; // Pode ser NULL
+            MatchTable *table;           // Rótulo -> índice em 'arms' (um único bloco)
+        } match_stmt;
+
+        /* NODE_MATCH_ARM */
+        struct
+        {
+            struct ASTNode **labels; // NODE_LITERALs int ou string
+            int label_count;
+            struct ASTNode *body;
+        } match_arm;
+
         /* NODE_RETURN_STMT */
         struct
         {
@@ -150,6 +244,47 @@ typedef struct ASTNode
             char *name;
         } var_expr;
 
+        /* NODE_INDEX_EXPR */
+        struct
+        {
+            struct ASTNode *array;
+            struct ASTNode *index;
+        } index_expr;
+
+        /* NODE_INDEX_ASSIGN */
+        struct
+        {
+            struct ASTNode *array;
+            struct ASTNode *index;
+            struct ASTNode *value;
+        } index_assign;
+
+        /* NODE_FIELD_EXPR e NODE_FIELD_ASSIGN ('value' só na atribuição) */
+        struct
+        {
+            struct ASTNode *object;
+            char *field_name;
+            struct ASTNode *value;
+            int offset;           // Preenchidos pela análise semântica
+            FieldStorage storage;
+        } field_expr;
+
+        /* NODE_ARRAY_LITERAL */
+        struct
+        {
+            struct ASTNode **elements; // Array de elementos
+            int element_count;
+        } array_literal;
+
+        /* NODE_MAP_LITERAL */
+        struct
+        {
+            struct ASTNode **items; // chave, valor, chave, valor...
+            int entry_count;        // Pares (items tem 2 * entry_count)
+            DataType key_type;      // Preenchidos pela análise semântica
+            DataType value_type;
+        } map_literal;
+
         /* NODE_LITERAL */
         struct
         {
@@ -166,15 +301,46 @@ typedef struct ASTNode
         /* NODE_TYPE */
         struct
         {
-            DataType type;
+            DataType type;     // Tipo do elemento quando is_array, do valor quando is_map
+            int is_array;      // T[]
+            int is_map;        // map<K, V>
+            DataType key_type; // K quando is_map
+            char *struct_name; // Quando type é TYPE_STRUCT (NULL nos demais)
         } type_node;
     } data;
 } ASTNode;
 
+/* --- Arena da AST --- */
+/* Os nós, listas de filhos e nomes de uma árvore ficam em blocos contíguos,
+ * na ordem em que o parser os cria, e são liberados de uma vez com
+ * ast_arena_free. Nós de arena NÃO devem ser passados para ast_free. */
+typedef struct AstArenaBlock
+{
+    struct AstArenaBlock *next;
+    size_t used;
+    size_t capacity;
+    unsigned char data[];
+} AstArenaBlock;
+
+typedef struct
+{
+    AstArenaBlock *head; // Bloco atual (os demais seguem em 'next')
+    size_t bytes;        // Total de bytes entregues
+} AstArena;
+
 /* --- Estrutura do Parser --- */
 typedef struct
 {
     Lexer *lexer;
+    TokenBuffer *tokens; // Modo pré-tokenizado (NULL ao ler do lexer)
+    int token_index;     // Próximo token a ler de 'tokens'
+    int token_end;       // Fim (exclusivo) do trecho de 'tokens' a analisar
+    int thread_count;    // Threads para o parse paralelo (1 = serial)
+    AstArena *arena;     // Onde alocar a AST (NULL = um malloc por nó)
+    // Modo fundido: chamado com cada declaração de nível superior logo após
+    // ser reduzida (NULL = desligado; veja semantic_attach_parser)
+    void (*on_declaration)(void *context, ASTNode *declaration);
+    void *hook_context;
     Token current_token;
     Token previous_token;
     char error_msg[256];
@@ -190,12 +356,47 @@ typedef struct
 /* Inicializa o parser com um lexer */
 void parser_init(Parser *parser, Lexer *lexer);
 
+/* Inicializa o parser sobre um buffer já tokenizado (token_buffer_fill) */
+void parser_init_tokens(Parser *parser, TokenBuffer *tokens);
+
+/* Inicializa o parser sobre os tokens [begin, end) do buffer (sempre serial) */
+void parser_init_range(Parser *parser, TokenBuffer *tokens, int begin, int end);
+
+/* Tipo do token 'distance' posições à frente do atual (0 = atual).
+ * Lookahead além do token atual só está disponível no modo pré-tokenizado. */
+TokenType parser_peek_type(Parser *parser, int distance);
+
 /* Libera recursos do parser e AST */
 void parser_cleanup(Parser *parser);
 
-/* Parse do programa completo - ponto de entrada */
+/* Parse do programa completo - ponto de entrada.
+ * No modo pré-tokenizado, entradas grandes são divididas nas declarações de
+ * nível superior e analisadas em paralelo em 'thread_count' threads; os nós são
+ * reunidos no NODE_BLOCK do programa na ordem do fonte.
+ * Com 'on_declaration' definido (modo fundido), o parse é serial e o gancho
+ * recebe cada declaração de nível superior, na ordem do fonte, enquanto não
+ * houver erro de sintaxe. */
 ASTNode *parse_program(Parser *parser);
 
+/* Analisa declarações até o TOKEN_EOF (real ou fim do trecho), sem criar o nó
+ * do programa. Retorna o array (malloc) e o total em 'count'. */
+ASTNode **parse_declarations(Parser *parser, int *count);
+
+/* Funções da arena da AST */
+void ast_arena_init(AstArena *arena);
+void *ast_arena_alloc(AstArena *arena, size_t size);
+void ast_arena_free(AstArena *arena);
+
+/* Monta a tabela de despacho de um NODE_MATCH_STMT num único bloco (na arena,
+ * ou com malloc se 'arena' for NULL). Retorna NULL se os rótulos misturarem
+ * int e string, sem memória ou se um rótulo se repetir (o rótulo repetido vai
+ * para '*duplicate', quando não NULL). */
+MatchTable *match_table_build(const ASTNode *node, AstArena *arena, const ASTNode **duplicate);
+
+/* Índice do braço para o valor, ou -1 (vai para o else) */
+int match_table_find_int(const MatchTable *table, int value);
+int match_table_find_string(const MatchTable *table, const char *chars, int length);
+
 /* Funções de utilidade */
 void ast_print(ASTNode *node, int indent); // Para debug
 void ast_free(ASTNode *node);              // Liberar árvore
@@ -3,6 +3,7 @@
 
 #include "craze_parser.h"
 #include <stdarg.h>
+#include <stdint.h>
 
 /* --- Tipos de Escopo --- */
 typedef enum
@@ -17,40 +18,83 @@ typedef enum
 {
     SYMBOL_VARIABLE,
     SYMBOL_FUNCTION,
-    SYMBOL_PARAMETER
+    SYMBOL_PARAMETER,
+    SYMBOL_TYPE // struct declarado (o tipo está em 'type')
 } SymbolCategory;
 
 /* --- Informações de Tipo Expandidas --- */
+/* Tipos são internados e imutáveis: obtenha-os com typeinfo_create,
+ * typeinfo_array, typeinfo_map ou typeinfo_intern, compare por ponteiro e nunca
+ * os libere. Um array T[] tem is_array = 1, base_type = T e inner = o tipo T;
+ * um map<K, V> tem is_map = 1, base_type = V, inner = o tipo V e key = K.
+ * Um struct tem base_type = TYPE_STRUCT e 'layout' com seus campos. */
+struct StructLayout;
+
 typedef struct TypeInfo
 {
     DataType base_type;
-    int is_array;           // Para futuras versões
-    int is_const;           // Para futuras versões
-    struct TypeInfo *inner; // Para tipos complexos futuros
+    int is_array;                 // T[] (base_type/inner descrevem o elemento)
+    int is_const;                 // Para futuras versões
+    const struct TypeInfo *inner; // Tipo do elemento (também internado)
+    int is_map;                   // map<K, V> (base_type/inner descrevem o valor)
+    const struct TypeInfo *key;   // Tipo da chave quando is_map
+    const struct StructLayout *layout; // Campos quando TYPE_STRUCT (NULL nos demais)
 } TypeInfo;
 
+/* --- Layout de Structs --- */
+/* Fixado pela análise semântica: cada campo tem posição e representação
+ * conhecidas, então r.campo vira uma leitura no offset, sem busca por nome.
+ * Os campos ficam na ordem da declaração, cada um alinhado ao próprio tamanho. */
+typedef struct
+{
+    const char *name;
+    const TypeInfo *type;
+    int offset;           // Bytes desde o início do registro
+    FieldStorage storage; // Escalar sem boxing ou Value*
+} StructField;
+
+typedef struct StructLayout
+{
+    const char *name;
+    int field_count;
+    int size;             // Múltiplo do maior alinhamento entre os campos
+    StructField fields[]; // 'field_count' campos
+} StructLayout;
+
+/* --- Verificação de Built-ins --- */
+/* Built-ins de assinatura flexível (print, len...) verificam a própria chamada:
+ * recebem o NODE_CALL_EXPR e retornam o tipo do resultado */
+struct SemanticAnalyzer;
+struct TypeCheckResult;
+typedef struct TypeCheckResult (*BuiltinCheckFn)(struct SemanticAnalyzer *analyzer, ASTNode *call);
+
 /* --- Entrada na Tabela de Símbolos --- */
 typedef struct SymbolEntry
 {
     char *name;
     SymbolCategory category;
-    TypeInfo *type;
+    const TypeInfo *type;
     int declared_line;
     int declared_column;
     int scope_depth;
-    struct SymbolEntry *next; // Para encadeamento
+    int declared_order;           // Ordem de inserção na tabela (visibilidade na análise paralela)
+    const struct CrazeModule *module; // Módulo de origem de um símbolo importado (somente leitura); NULL = local
+    struct SymbolEntry *next;     // Para encadeamento
+    struct SymbolEntry *shadowed; // Símbolo de mesmo nome escondido por este (índice de nomes)
     union
     {
         struct
         {
             struct SymbolEntry **parameters; // Array de parâmetros para funções
             int param_count;
-            TypeInfo *return_type;
+            const TypeInfo *return_type;
             ASTNode *function_node; // Referência para verificação de return
+            BuiltinCheckFn check_call; // NULL = verificar pelos parâmetros
         } func_info;
         struct
         {
             ASTNode *initializer; // Para verificação de inicialização
+            int is_loop_counter;  // Variável de controle de 'for' (somente leitura)
         } var_info;
     } details;
 } SymbolEntry;
@@ -64,14 +108,39 @@ typedef struct Scope
     ScopeType scope_type; // GLOBAL, FUNCTION, BLOCK
 } Scope;
 
+/* --- Índice de Nomes --- */
+/* Cada nome (internado) aponta para o símbolo visível mais interno com esse
+ * nome; os de escopos externos seguem em 'shadowed'. A lista de símbolos de
+ * cada escopo serve de log para desfazer o índice em exit_scope. */
+typedef struct
+{
+    char *name;          // Cópia própria, mantida até semantic_cleanup
+    SymbolEntry *symbol; // NULL se nenhum símbolo com esse nome está visível
+} NameSlot;
+
 /* --- Tabela de Símbolos Hierárquica --- */
 typedef struct SymbolTable
 {
     Scope *current_scope;
     Scope *global_scope;
     int scope_count;
+    NameSlot *index;    // Endereçamento aberto, capacidade potência de 2
+    int index_capacity;
+    int index_count;
+    int insert_count;   // Próximo 'declared_order'
 } SymbolTable;
 
+/* --- Diagnóstico Semântico --- */
+/* Erros e avisos ficam num buffer só de acréscimo no analisador; o texto só é
+ * formatado quando o diagnóstico é de fato emitido. */
+typedef struct
+{
+    int line;
+    int column;
+    int is_error;   // 1 = erro, 0 = aviso
+    size_t message; // Offset da mensagem em 'diagnostic_text'
+} SemanticDiagnostic;
+
 /* --- Contexto de Análise Semântica --- */
 typedef struct SemanticAnalyzer
 {
@@ -79,24 +148,42 @@ typedef struct SemanticAnalyzer
     ASTNode *ast_root;
     int error_count;
     int warning_count;
-    char error_msg[512];
 
     // Estado atual para verificação
-    TypeInfo *current_return_type; // Tipo de retorno da função atual
-    int in_function;               // Flag se está dentro de função
-    char current_function[64];     // Nome da função atual
-    int has_return_statement;      // Para verificar retorno em funções não-void
+    const TypeInfo *current_return_type; // Tipo de retorno da função atual
+    int in_function;                     // Flag se está dentro de função
+    char current_function[64];           // Nome da função atual
+    int has_return_statement;            // Para verificar retorno em funções não-void
 
     // Configurações
-    int strict_mode; // Verificações extras
+    int strict_mode;        // Verificações extras
+    int thread_count;       // Threads para verificar corpos de funções (1 = serial)
+    int print_diagnostics;  // Ecoar cada diagnóstico em stderr (padrão 1)
+    const char *source_path; // Arquivo analisado: base dos caminhos de import (NULL = diretório atual)
+
+    // Análise paralela: tabela do programa, só para leitura, e o último
+    // símbolo dela visível na função em verificação
+    const SymbolTable *shared_symbols;
+    int visible_order;
+
+    SymbolEntry *builtin_symbols; // Topo do escopo global logo após os built-ins
+
+    // Diagnósticos emitidos, na ordem
+    SemanticDiagnostic *diagnostics;
+    int diagnostic_count;
+    int diagnostic_capacity;
+    char *diagnostic_text; // Mensagens terminadas em '\0', uma após a outra
+    size_t diagnostic_text_length;
+    size_t diagnostic_text_capacity;
 } SemanticAnalyzer;
 
 /* --- Resultado da Verificação de Tipos --- */
+/* Pequeno o bastante para voltar em registradores; a mensagem de um erro vai
+ * direto para os diagnósticos do analisador */
 typedef struct TypeCheckResult
 {
-    TypeInfo *type;
+    const TypeInfo *type;
     int is_valid;
-    char error_msg[256];
     int implicit_conversion; // Flag para conversões implícitas
 } TypeCheckResult;
 
@@ -105,24 +192,89 @@ typedef struct TypeCheckResult
 /* Inicializa o analisador semântico */
 void semantic_init(SemanticAnalyzer *analyzer, ASTNode *ast_root);
 
-/* Executa toda a análise semântica */
+/* Executa toda a análise semântica.
+ * Com thread_count > 1 e muitas funções no programa, a análise é feita em duas
+ * fases: as declarações de nível superior e as assinaturas das funções são
+ * registradas em série, e depois os corpos das funções são verificados em
+ * paralelo, cada thread com seus próprios escopos e diagnósticos. Os
+ * diagnósticos são reunidos na ordem do fonte, então o resultado é idêntico
+ * ao da análise serial. */
 int semantic_analyze(SemanticAnalyzer *analyzer);
 
+/* Avaliação em tempo de compilação: depois de uma análise sem erros, cada
+ * chamada a uma função pura com argumentos constantes é executada aqui e
+ * trocada pelo NODE_LITERAL do resultado. Pura é a função de nível superior
+ * com parâmetros e retorno int, float, bool ou string cujo corpo só usa os
+ * próprios parâmetros e locais, operadores e outras funções puras. Chamadas
+ * que falhariam, estourariam int ou passariam do limite de passos ou de
+ * recursão ficam para o tempo de execução. 'arena' é onde vive a AST (NULL =
+ * um malloc por nó, como em Parser.arena). Retorna o número de chamadas
+ * substituídas. */
+int semantic_fold_constants(SemanticAnalyzer *analyzer, AstArena *arena);
+
 /* Libera recursos do analisador */
 void semantic_cleanup(SemanticAnalyzer *analyzer);
 
 /* Retorna relatório de erros e warnings */
 void semantic_print_report(SemanticAnalyzer *analyzer);
 
+/* Imprime um diagnóstico em stderr no formato usado durante a análise
+ * (também para os avisos recuperados de um cache) */
+void semantic_print_diagnostic(int is_error, int line, int column, const char *message);
+
+/* Mensagem do diagnóstico 'index' (0 <= index < diagnostic_count) */
+const char *semantic_diagnostic_message(const SemanticAnalyzer *analyzer, int index);
+
 /* Funções de utilidade para tipos */
-TypeInfo *typeinfo_create(DataType base_type);
-void typeinfo_free(TypeInfo *type_info);
-const char *typeinfo_to_string(TypeInfo *type_info);
-TypeInfo *typeinfo_copy(TypeInfo *type_info);
+const TypeInfo *typeinfo_create(DataType base_type);
+const TypeInfo *typeinfo_intern(DataType base_type, int is_array, int is_const, const TypeInfo *inner);
+const TypeInfo *typeinfo_array(DataType element_type); // T[]; void[] é o literal vazio '[]'
+const TypeInfo *typeinfo_map(DataType key_type, DataType value_type); // map<void, void> é '{}'
+const TypeInfo *typeinfo_struct(const char *name, const char *const *field_names,
+                                const TypeInfo *const *field_types, int field_count); // Calcula o layout
+const char *typeinfo_to_string(const TypeInfo *type_info);
 
 /* Função para inserir built-ins */
 void semantic_register_builtins(SemanticAnalyzer *analyzer);
 
+/* --- Análise Fundida com o Parse --- */
+/* Liga o analisador (criado com semantic_init(analyzer, NULL)) ao parser:
+ * cada declaração de nível superior é verificada assim que o parser a reduz,
+ * enquanto ainda está no cache, sem uma segunda passada sobre a árvore. Sem
+ * erros de sintaxe, o resultado é o mesmo de semantic_analyze. */
+void semantic_attach_parser(SemanticAnalyzer *analyzer, Parser *parser);
+
+/* Depois de parse_program: fecha o escopo do programa e o registra como raiz
+ * da análise. Retorna 1 se nenhum erro semântico foi encontrado. */
+int semantic_end_program(SemanticAnalyzer *analyzer, ASTNode *program);
+
+/* --- Análise Incremental --- */
+/* Símbolos globais declarados por um trecho do programa, do mais recente
+ * ('first') ao mais antigo ('last'), encadeados por 'next' */
+typedef struct
+{
+    SymbolEntry *first;
+    SymbolEntry *last;
+} SymbolSpan;
+
+/* Retira do escopo global os símbolos do programa (os built-ins ficam) e zera
+ * as contagens e o buffer de erros/avisos. Os símbolos retirados continuam pertencendo a
+ * quem guardou seus SymbolSpans. */
+void semantic_reset_globals(SemanticAnalyzer *analyzer);
+
+/* Analisa uma instrução de nível superior e retorna os símbolos globais que ela declarou */
+SymbolSpan semantic_analyze_statement(SemanticAnalyzer *analyzer, ASTNode *node);
+
+/* Recoloca no topo do escopo global um segmento já analisado */
+void semantic_restore_symbols(SemanticAnalyzer *analyzer, SymbolSpan span);
+
+/* Libera os símbolos de um segmento que está fora do escopo global */
+void semantic_free_symbols(SymbolSpan span);
+
+/* Assinatura (hash, nunca 0) de um símbolo: nome, categoria e tipos.
+ * Muda sempre que o que outras declarações enxergam do símbolo muda. */
+uint64_t semantic_symbol_signature(const SymbolEntry *symbol);
+
 /* --- Compatibilidade com Parser (APIs antigas) --- */
 
 // Estrutura antiga para compatibilidade
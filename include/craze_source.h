@@ -0,0 +1,29 @@
+#ifndef CRAZE_SOURCE_H
+#define CRAZE_SOURCE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* --- Arquivo Fonte Carregado --- */
+typedef struct
+{
+    const char *data; // Conteúdo do arquivo (NÃO terminado em '\0')
+    size_t length;    // Tamanho em bytes
+    int is_mapped;    // 1 se data vem de mmap/MapViewOfFile, 0 se de malloc
+    void *handle;     // Handle do mapeamento (apenas Windows)
+} SourceFile;
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+/* Abre um arquivo fonte somente-leitura, mapeando-o em memória quando possível.
+ * Retorna 1 em caso de sucesso, 0 em caso de erro (mensagem em stderr). */
+int source_open(SourceFile *file, const char *filename);
+
+/* Libera o mapeamento ou buffer do arquivo */
+void source_close(SourceFile *file);
+
+/* Função de leitura para o modo streaming do lexer (lexer_init_stream):
+ * lê até 'capacity' bytes do FILE* passado em 'context' */
+size_t source_stream_read(void *context, char *buffer, size_t capacity);
+
+#endif /* CRAZE_SOURCE_H */
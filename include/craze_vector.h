@@ -0,0 +1,52 @@
+#ifndef CRAZE_VECTOR_H
+#define CRAZE_VECTOR_H
+
+#include <stddef.h>
+
+/* --- Kernels Numéricos sobre Buffers Contíguos --- */
+/* Base dos built-ins sum/min/max/dot/scale/axpy/add/mul sobre float[] e int[].
+ * Os kernels de double têm versões SSE2 e AVX escolhidas em tempo de execução
+ * pela CPU, com fallback escalar; os de int são laços simples que o
+ * compilador vetoriza. Reduções vetoriais somam em outra ordem que o laço
+ * escalar, então sum/dot podem diferir no último bit entre CPUs. */
+
+typedef enum
+{
+    VECTOR_ISA_SCALAR,
+    VECTOR_ISA_SSE2,
+    VECTOR_ISA_AVX
+} VectorIsa;
+
+/* Melhor conjunto de instruções suportado pela CPU (e pelo sistema) */
+VectorIsa vector_detect_isa(void);
+
+/* Conjunto em uso pelos kernels (padrão: vector_detect_isa) */
+VectorIsa vector_active_isa(void);
+
+/* Força um conjunto de instruções (testes/benchmarks), limitado ao suportado.
+ * Retorna o conjunto efetivamente ativo. */
+VectorIsa vector_force_isa(VectorIsa isa);
+
+const char *vector_isa_name(VectorIsa isa);
+
+/* Kernels de double. min/max exigem n > 0; 'out' pode ser x ou y. */
+double vector_sum(const double *x, int n);
+double vector_dot(const double *x, const double *y, int n);
+double vector_min(const double *x, int n);
+double vector_max(const double *x, int n);
+void vector_scale(double *x, double alpha, int n);            // x = alpha * x
+void vector_axpy(double alpha, const double *x, double *y, int n); // y = alpha * x + y
+void vector_add(const double *x, const double *y, double *out, int n);
+void vector_mul(const double *x, const double *y, double *out, int n);
+
+/* Kernels de int (aritmética com wrap-around em 32 bits) */
+int vector_sum_int(const int *x, int n);
+int vector_dot_int(const int *x, const int *y, int n);
+int vector_min_int(const int *x, int n);
+int vector_max_int(const int *x, int n);
+void vector_scale_int(int *x, int alpha, int n);
+void vector_axpy_int(int alpha, const int *x, int *y, int n);
+void vector_add_int(const int *x, const int *y, int *out, int n);
+void vector_mul_int(const int *x, const int *y, int *out, int n);
+
+#endif /* CRAZE_VECTOR_H */
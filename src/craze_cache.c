@@ -0,0 +1,329 @@
+#include "../include/craze_cache.h"
+#include "../include/craze_compact.h"
+#include "../include/craze_semantic.h"
+#include "../include/craze_source.h"
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+/* --- FORMATO .crzc --- */
+/* [CrzcHeader][CompactNode x node_count][AstHandle x list_count]
+ * [CrzcWarning x warning_count][strings]
+ * O conteúdo é a AST compacta (craze_compact.h) do programa: nós em pré-ordem
+ * (a raiz é o nó 0) que referenciam filhos, listas e strings por handles e
+ * offsets de 32 bits; a carga valida e expande direto do arquivo mapeado.
+ * Os avisos da análise semântica vão junto para serem emitidos de novo. */
+
+#define CRZC_MAGIC "CRZC"
+#define CRZC_BYTE_ORDER 0x01020304u // Rejeita caches gravados em outra arquitetura
+
+typedef struct
+{
+    char magic[4];
+    uint32_t format;
+    uint32_t byte_order;
+    uint32_t node_size;
+    char version[16];
+    uint64_t source_hash;
+    uint64_t source_length;
+    uint64_t payload_hash; // FNV-1a de tudo após o cabeçalho (detecta corrupção)
+    uint32_t node_count;
+    uint32_t list_count;
+    uint32_t string_size;
+    uint32_t warning_count;
+} CrzcHeader;
+
+typedef struct
+{
+    int32_t line;
+    int32_t column;
+    uint32_t message; // Offset na tabela de strings
+} CrzcWarning;
+
+/* --- FUNÇÕES INTERNAS/HELPERS --- */
+
+#define FNV_OFFSET 14695981039346656037ULL
+
+/* FNV-1a de 64 bits, continuando a partir de 'hash' */
+static uint64_t hash_continue(uint64_t hash, const char *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t hash_bytes(const char *data, size_t length)
+{
+    return hash_continue(FNV_OFFSET, data, length);
+}
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+int cache_key_init(CacheKey *key, const char *filename, const char *source, size_t length)
+{
+    key->path = NULL;
+    key->source_hash = hash_bytes(source, length);
+    key->source_length = length;
+
+    if (getenv("CRAZE_NO_CACHE") != NULL)
+        return 0;
+
+    const char *dir = getenv("CRAZE_CACHE_DIR");
+    size_t size = dir != NULL ? strlen(dir) + 32 : strlen(filename) + 6;
+    key->path = malloc(size);
+    if (!key->path)
+        return 0;
+
+    if (dir != NULL)
+        snprintf(key->path, size, "%s/%016llx.crzc", dir, (unsigned long long)key->source_hash);
+    else
+        snprintf(key->path, size, "%s.crzc", filename);
+    return 1;
+}
+
+void cache_key_free(CacheKey *key)
+{
+    free(key->path);
+    key->path = NULL;
+}
+
+int cache_collect_warnings(const SemanticAnalyzer *analyzer, CacheWarning **warnings, int *count)
+{
+    *warnings = NULL;
+    *count = 0;
+    int warning_count = 0;
+    for (int i = 0; i < analyzer->diagnostic_count; i++)
+        warning_count += !analyzer->diagnostics[i].is_error;
+    if (warning_count == 0)
+        return 1;
+
+    *warnings = malloc(sizeof(CacheWarning) * (size_t)warning_count);
+    if (!*warnings)
+        return 0;
+
+    for (int i = 0; i < analyzer->diagnostic_count; i++)
+    {
+        const SemanticDiagnostic *diagnostic = &analyzer->diagnostics[i];
+        if (diagnostic->is_error)
+            continue;
+
+        CacheWarning *warning = &(*warnings)[(*count)++];
+        warning->line = diagnostic->line;
+        warning->column = diagnostic->column;
+        warning->message = semantic_diagnostic_message(analyzer, i);
+    }
+    return 1;
+}
+
+ASTNode *cache_load(const CacheKey *key, AstArena *arena, CacheWarning **warnings, int *warning_count)
+{
+    if (warnings)
+        *warnings = NULL;
+    if (warning_count)
+        *warning_count = 0;
+
+    // Sem cache ainda: falha silenciosa (source_open reportaria erro)
+    FILE *probe = fopen(key->path, "rb");
+    if (!probe)
+        return NULL;
+    fclose(probe);
+
+    SourceFile file;
+    if (!source_open(&file, key->path))
+        return NULL;
+
+    ASTNode *program = NULL;
+    const CrzcHeader *header = (const CrzcHeader *)file.data;
+
+    // Validar cabeçalho e tamanhos antes de tocar no restante do arquivo
+    if (file.length < sizeof(CrzcHeader) ||
+        memcmp(header->magic, CRZC_MAGIC, 4) != 0 ||
+        header->format != CRAZE_CACHE_FORMAT ||
+        header->byte_order != CRZC_BYTE_ORDER ||
+        header->node_size != sizeof(CompactNode) ||
+        strncmp(header->version, CRAZE_VERSION, sizeof(header->version)) != 0 ||
+        header->source_hash != key->source_hash ||
+        header->source_length != key->source_length ||
+        header->node_count == 0 || header->string_size == 0)
+    {
+        source_close(&file);
+        return NULL;
+    }
+
+    uint64_t expected = sizeof(CrzcHeader) +
+                        (uint64_t)header->node_count * sizeof(CompactNode) +
+                        (uint64_t)header->list_count * sizeof(AstHandle) +
+                        (uint64_t)header->warning_count * sizeof(CrzcWarning) +
+                        header->string_size;
+    const char *payload = file.data + sizeof(CrzcHeader);
+    const char *warning_records = payload + (size_t)header->node_count * sizeof(CompactNode) +
+                                  (size_t)header->list_count * sizeof(AstHandle);
+    const char *strings = warning_records + (size_t)header->warning_count * sizeof(CrzcWarning);
+    if (expected != file.length || strings[header->string_size - 1] != '\0' ||
+        hash_bytes(payload, file.length - sizeof(CrzcHeader)) != header->payload_hash)
+    {
+        source_close(&file);
+        return NULL;
+    }
+
+    // A AST compacta é lida direto do arquivo mapeado, sem cópia
+    CompactAst compact;
+    compact_ast_view(&compact, (const CompactNode *)payload, header->node_count,
+                     (const AstHandle *)(payload + (size_t)header->node_count * sizeof(CompactNode)),
+                     header->list_count, strings, header->string_size);
+
+    // Nós e avisos vão para uma arena própria até que tudo seja validado
+    AstArena loaded;
+    ast_arena_init(&loaded);
+    CacheWarning *loaded_warnings = header->warning_count > 0
+                                        ? ast_arena_alloc(&loaded, sizeof(CacheWarning) * header->warning_count)
+                                        : NULL;
+
+    int ok = header->warning_count == 0 || loaded_warnings != NULL;
+    for (uint32_t i = 0; ok && i < header->warning_count; i++)
+    {
+        CrzcWarning record;
+        memcpy(&record, warning_records + (size_t)i * sizeof(CrzcWarning), sizeof(record));
+        ok = record.message < header->string_size;
+        if (!ok)
+            break;
+
+        size_t length = strlen(strings + record.message);
+        char *message = ast_arena_alloc(&loaded, length + 1);
+        ok = message != NULL;
+        if (ok)
+            memcpy(message, strings + record.message, length + 1);
+        loaded_warnings[i].line = record.line;
+        loaded_warnings[i].column = record.column;
+        loaded_warnings[i].message = message;
+    }
+
+    if (ok)
+        program = compact_ast_expand(&compact, &loaded);
+
+    if (program != NULL && program->node_type == NODE_BLOCK)
+    {
+        // Transfere os blocos carregados para a arena do chamador
+        while (loaded.head != NULL)
+        {
+            AstArenaBlock *block = loaded.head;
+            loaded.head = block->next;
+            block->next = arena->head;
+            arena->head = block;
+        }
+        arena->bytes += loaded.bytes;
+
+        if (warnings)
+            *warnings = loaded_warnings;
+        if (warning_count)
+            *warning_count = (int)header->warning_count;
+    }
+    else
+    {
+        program = NULL;
+        ast_arena_free(&loaded);
+    }
+
+    source_close(&file);
+    return program;
+}
+
+int cache_save(const CacheKey *key, ASTNode *program, const CacheWarning *warnings, int warning_count)
+{
+    if (key->path == NULL || program == NULL || warning_count < 0)
+        return 0;
+
+    CompactAst compact;
+    compact_ast_init(&compact);
+    compact_ast_build(&compact, program);
+
+    // As mensagens dos avisos entram na mesma tabela de strings dos nós
+    CrzcWarning *records = NULL;
+    int ok = !compact.failed;
+    if (ok && warning_count > 0)
+    {
+        records = malloc(sizeof(CrzcWarning) * (size_t)warning_count);
+        ok = records != NULL;
+    }
+    for (int i = 0; ok && i < warning_count; i++)
+    {
+        records[i].line = warnings[i].line;
+        records[i].column = warnings[i].column;
+        records[i].message = compact_ast_string(&compact, warnings[i].message);
+        ok = !compact.failed;
+    }
+
+    if (!ok)
+    {
+        free(records);
+        compact_ast_free(&compact);
+        return 0;
+    }
+
+    CrzcHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CRZC_MAGIC, 4);
+    header.format = CRAZE_CACHE_FORMAT;
+    header.byte_order = CRZC_BYTE_ORDER;
+    header.node_size = sizeof(CompactNode);
+    strncpy(header.version, CRAZE_VERSION, sizeof(header.version) - 1);
+    header.source_hash = key->source_hash;
+    header.source_length = key->source_length;
+    header.node_count = compact.node_count;
+    header.list_count = compact.list_count;
+    header.string_size = compact.string_size;
+    header.warning_count = (uint32_t)warning_count;
+    header.payload_hash = hash_continue(
+        hash_continue(
+            hash_continue(hash_bytes((const char *)compact.nodes, sizeof(CompactNode) * compact.node_count),
+                          (const char *)compact.lists, sizeof(AstHandle) * compact.list_count),
+            (const char *)records, sizeof(CrzcWarning) * (size_t)warning_count),
+        compact.strings, compact.string_size);
+
+    // Grava num temporário e renomeia: leitores concorrentes nunca veem meio arquivo
+    size_t tmp_size = strlen(key->path) + 32;
+    char *tmp_path = malloc(tmp_size);
+    if (!tmp_path)
+    {
+        free(records);
+        compact_ast_free(&compact);
+        return 0;
+    }
+    snprintf(tmp_path, tmp_size, "%s.%ld.tmp", key->path, (long)getpid());
+
+    FILE *file = fopen(tmp_path, "wb");
+    ok = file != NULL;
+    if (ok)
+    {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(compact.nodes, sizeof(CompactNode), compact.node_count, file) == compact.node_count &&
+             (compact.list_count == 0 ||
+              fwrite(compact.lists, sizeof(AstHandle), compact.list_count, file) == compact.list_count) &&
+             (warning_count == 0 ||
+              fwrite(records, sizeof(CrzcWarning), (size_t)warning_count, file) == (size_t)warning_count) &&
+             fwrite(compact.strings, 1, compact.string_size, file) == compact.string_size;
+        ok = fclose(file) == 0 && ok;
+    }
+
+    if (ok)
+    {
+#ifdef _WIN32
+        remove(key->path); // rename não sobrescreve no Windows
+#endif
+        ok = rename(tmp_path, key->path) == 0;
+    }
+    if (!ok)
+        remove(tmp_path);
+
+    free(tmp_path);
+    free(records);
+    compact_ast_free(&compact);
+    return ok;
+}
@@ -0,0 +1,879 @@
+#include "../include/craze_compact.h"
+
+/* --- FUNÇÕES INTERNAS/HELPERS --- */
+
+/* FNV-1a de 32 bits (só para a tabela de internação) */
+static uint32_t string_hash(const char *text, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int grow(void **array, uint32_t *capacity, uint32_t needed, size_t item_size)
+{
+    if (needed <= *capacity)
+        return 1;
+
+    uint32_t new_capacity = *capacity == 0 ? 64 : *capacity;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+
+    void *grown = realloc(*array, item_size * new_capacity);
+    if (!grown)
+        return 0;
+
+    *array = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+static int intern_rehash(CompactAst *ast)
+{
+    uint32_t capacity = ast->intern_capacity == 0 ? 256 : ast->intern_capacity * 2;
+    uint32_t *table = calloc(capacity, sizeof(uint32_t));
+    if (!table)
+        return 0;
+
+    for (uint32_t i = 0; i < ast->intern_capacity; i++)
+    {
+        uint32_t entry = ast->intern[i];
+        if (entry == 0)
+            continue;
+
+        const char *text = ast->strings + entry - 1;
+        uint32_t slot = string_hash(text, strlen(text)) & (capacity - 1);
+        while (table[slot] != 0)
+            slot = (slot + 1) & (capacity - 1);
+        table[slot] = entry;
+    }
+
+    free(ast->intern);
+    ast->intern = table;
+    ast->intern_capacity = capacity;
+    return 1;
+}
+
+/* --- CONSTRUÇÃO --- */
+
+static AstHandle build_node(CompactAst *ast, const ASTNode *node);
+
+/* Reserva a fatia da lista em 'lists' antes de descer nos filhos (cujas
+ * próprias listas vêm depois) e grava início e quantidade em dois slots */
+static void build_list(CompactAst *ast, AstHandle index, int slot, ASTNode *const *items, int count)
+{
+    uint32_t start = ast->list_count;
+    if (!grow((void **)&ast->lists, &ast->list_capacity, start + (uint32_t)count, sizeof(AstHandle)))
+    {
+        ast->failed = 1;
+        return;
+    }
+    ast->list_count += (uint32_t)count;
+
+    for (int i = 0; i < count; i++)
+    {
+        AstHandle child = build_node(ast, items[i]);
+        ast->lists[start + i] = child;
+    }
+
+    ast->nodes[index].slot[slot] = start;
+    ast->nodes[index].slot[slot + 1] = (uint32_t)count;
+}
+
+/* Grava o filho no slot. Como 'nodes' pode ser realocado durante a recursão,
+ * o pai é sempre acessado pelo handle. */
+static void build_child(CompactAst *ast, AstHandle index, int slot, const ASTNode *child)
+{
+    AstHandle handle = build_node(ast, child);
+    ast->nodes[index].slot[slot] = handle;
+}
+
+static void build_text(CompactAst *ast, AstHandle index, int slot, const char *text)
+{
+    uint32_t offset = compact_ast_string(ast, text);
+    ast->nodes[index].slot[slot] = offset;
+}
+
+static AstHandle build_node(CompactAst *ast, const ASTNode *node)
+{
+    if (node == NULL || ast->failed)
+        return AST_NONE;
+
+    AstHandle index = ast->node_count;
+    if (!grow((void **)&ast->nodes, &ast->node_capacity, index + 1, sizeof(CompactNode)))
+    {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+    ast->node_count++;
+
+    CompactNode *record = &ast->nodes[index];
+    record->kind = (uint8_t)node->node_type;
+    record->data_type = (uint8_t)node->data_type;
+    record->tag = 0;
+    record->line = node->line;
+    record->column = node->column;
+    for (int i = 0; i < 5; i++)
+        record->slot[i] = AST_NONE;
+
+    switch (node->node_type)
+    {
+    case NODE_VAR_DECL:
+        build_text(ast, index, 0, node->data.var_decl.name);
+        build_child(ast, index, 1, node->data.var_decl.type_node);
+        build_child(ast, index, 2, node->data.var_decl.initializer);
+        break;
+    case NODE_FUNC_DECL:
+        build_text(ast, index, 0, node->data.func_decl.name);
+        build_list(ast, index, 1, node->data.func_decl.params, node->data.func_decl.param_count);
+        build_child(ast, index, 3, node->data.func_decl.return_type);
+        build_child(ast, index, 4, node->data.func_decl.body);
+        break;
+    case NODE_PARAM:
+        // Campos de struct: posição e representação no registro
+        record->tag = (uint16_t)node->data.param.storage;
+        record->slot[2] = (uint32_t)node->data.param.offset;
+        build_text(ast, index, 0, node->data.param.name);
+        build_child(ast, index, 1, node->data.param.type_node);
+        break;
+    case NODE_STRUCT_DECL:
+        record->slot[3] = (uint32_t)node->data.struct_decl.size;
+        build_text(ast, index, 0, node->data.struct_decl.name);
+        build_list(ast, index, 1, node->data.struct_decl.fields, node->data.struct_decl.field_count);
+        break;
+    case NODE_IMPORT:
+        // O módulo é religado depois (module_resolve_imports) e conferido pelo hash
+        record->slot[1] = (uint32_t)node->data.import_stmt.module_hash;
+        record->slot[2] = (uint32_t)(node->data.import_stmt.module_hash >> 32);
+        build_text(ast, index, 0, node->data.import_stmt.path);
+        break;
+    case NODE_EXPR_STMT:
+        build_child(ast, index, 0, node->data.expr_stmt.expression);
+        break;
+    case NODE_IF_STMT:
+        build_child(ast, index, 0, node->data.if_stmt.condition);
+        build_child(ast, index, 1, node->data.if_stmt.then_branch);
+        build_child(ast, index, 2, node->data.if_stmt.else_branch);
+        break;
+    case NODE_WHILE_STMT:
+        build_child(ast, index, 0, node->data.while_stmt.condition);
+        build_child(ast, index, 1, node->data.while_stmt.body);
+        break;
+    case NODE_FOR_STMT:
+        build_text(ast, index, 0, node->data.for_stmt.var_name);
+        build_child(ast, index, 1, node->data.for_stmt.start);
+        build_child(ast, index, 2, node->data.for_stmt.end);
+        build_child(ast, index, 3, node->data.for_stmt.step);
+        build_child(ast, index, 4, node->data.for_stmt.body);
+        break;
+    case NODE_MATCH_STMT:
+        // A tabela de despacho não é guardada: é remontada dos rótulos na expansão
+        build_child(ast, index, 0, node->data.match_stmt.subject);
+        build_list(ast, index, 1, node->data.match_stmt.arms, node->data.match_stmt.arm_count);
+        build_child(ast, index, 3, node->data.match_stmt.else_branch);
+        break;
+    case NODE_MATCH_ARM:
+        build_list(ast, index, 0, node->data.match_arm.labels, node->data.match_arm.label_count);
+        build_child(ast, index, 2, node->data.match_arm.body);
+        break;
+    case NODE_RETURN_STMT:
+        build_child(ast, index, 0, node->data.return_stmt.value);
+        break;
+    case NODE_BLOCK:
+        build_list(ast, index, 0, node->data.block.statements, node->data.block.stmt_count);
+        break;
+    case NODE_BINARY_EXPR:
+        record->tag = (uint16_t)node->data.binary_expr.operator;
+        build_child(ast, index, 0, node->data.binary_expr.left);
+        build_child(ast, index, 1, node->data.binary_expr.right);
+        break;
+    case NODE_UNARY_EXPR:
+        record->tag = (uint16_t)node->data.unary_expr.operator;
+        build_child(ast, index, 0, node->data.unary_expr.operand);
+        break;
+    case NODE_ASSIGN_EXPR:
+        build_text(ast, index, 0, node->data.assign_expr.variable_name);
+        build_child(ast, index, 1, node->data.assign_expr.value);
+        break;
+    case NODE_CALL_EXPR:
+        build_text(ast, index, 0, node->data.call_expr.function_name);
+        build_list(ast, index, 1, node->data.call_expr.arguments, node->data.call_expr.arg_count);
+        break;
+    case NODE_VAR_EXPR:
+        build_text(ast, index, 0, node->data.var_expr.name);
+        break;
+    case NODE_INDEX_EXPR:
+        build_child(ast, index, 0, node->data.index_expr.array);
+        build_child(ast, index, 1, node->data.index_expr.index);
+        break;
+    case NODE_INDEX_ASSIGN:
+        build_child(ast, index, 0, node->data.index_assign.array);
+        build_child(ast, index, 1, node->data.index_assign.index);
+        build_child(ast, index, 2, node->data.index_assign.value);
+        break;
+    case NODE_FIELD_EXPR:
+    case NODE_FIELD_ASSIGN:
+        record->tag = (uint16_t)node->data.field_expr.storage;
+        record->slot[3] = (uint32_t)node->data.field_expr.offset;
+        build_text(ast, index, 0, node->data.field_expr.field_name);
+        build_child(ast, index, 1, node->data.field_expr.object);
+        build_child(ast, index, 2, node->data.field_expr.value);
+        break;
+    case NODE_ARRAY_LITERAL:
+        build_list(ast, index, 0, node->data.array_literal.elements, node->data.array_literal.element_count);
+        break;
+    case NODE_MAP_LITERAL:
+        // Tipos da chave e do valor (anotados pela análise semântica) no tag
+        record->tag = (uint16_t)(node->data.map_literal.key_type | (node->data.map_literal.value_type << 8));
+        build_list(ast, index, 0, node->data.map_literal.items, 2 * node->data.map_literal.entry_count);
+        break;
+    case NODE_LITERAL:
+        record->tag = (uint16_t)node->data.literal.literal_type;
+        switch (node->data.literal.literal_type)
+        {
+        case TOKEN_INT_LITERAL:
+            record->slot[0] = (uint32_t)node->data.literal.value.int_value;
+            break;
+        case TOKEN_FLOAT_LITERAL:
+            memcpy(&record->slot[0], &node->data.literal.value.float_value, sizeof(double));
+            break;
+        case TOKEN_STRING_LITERAL:
+            build_text(ast, index, 0, node->data.literal.value.string_value);
+            break;
+        default:
+            record->slot[0] = (uint32_t)node->data.literal.value.bool_value;
+            break;
+        }
+        break;
+    case NODE_TYPE:
+        record->tag = (uint16_t)node->data.type_node.type;
+        record->slot[0] = (uint32_t)(node->data.type_node.is_array != 0) |
+                          ((uint32_t)(node->data.type_node.is_map != 0) << 1);
+        record->slot[1] = (uint32_t)node->data.type_node.key_type;
+        build_text(ast, index, 2, node->data.type_node.struct_name);
+        break;
+    default:
+        // Tipo de nó sem representação compacta
+        ast->failed = 1;
+        return AST_NONE;
+    }
+
+    return index;
+}
+
+/* --- EXPANSÃO (VALIDAÇÃO E PONTEIROS) --- */
+
+typedef struct
+{
+    const CompactAst *ast;
+    ASTNode *nodes;       // Todos os nós, contíguos na arena
+    ASTNode **list_slots; // Array compartilhado com todas as listas de filhos
+    char *strings;        // Cópia da tabela de strings na arena
+} Expander;
+
+/* Converte o handle de um filho em ponteiro. Filhos sempre vêm depois do pai
+ * (pré-ordem), o que também impede ciclos numa entrada corrompida. */
+static int expand_child(Expander *expander, AstHandle parent, AstHandle handle, int required,
+                        ASTNode **out)
+{
+    if (handle == AST_NONE)
+    {
+        *out = NULL;
+        return !required;
+    }
+    if (handle <= parent || handle >= expander->ast->node_count)
+        return 0;
+
+    *out = &expander->nodes[handle];
+    return 1;
+}
+
+static int expand_text(Expander *expander, uint32_t offset, char **out)
+{
+    if (offset == AST_NONE || offset >= expander->ast->string_size)
+        return 0;
+
+    *out = expander->strings + offset;
+    return 1;
+}
+
+static int expand_list(Expander *expander, AstHandle parent, const uint32_t *slot, ASTNode ***out,
+                       int *count)
+{
+    uint32_t start = slot[0];
+    uint32_t length = slot[1];
+    uint32_t total = expander->ast->list_count;
+    if (start > total || length > total - start || length > INT32_MAX)
+        return 0;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (!expand_child(expander, parent, expander->ast->lists[start + i], 1,
+                          &expander->list_slots[start + i]))
+            return 0;
+    }
+
+    *out = length > 0 ? &expander->list_slots[start] : NULL;
+    *count = (int)length;
+    return 1;
+}
+
+/* Braços e rótulos de um match expandido têm os tipos que match_table_build
+ * espera (uma entrada corrompida não pode levá-lo a ler o campo errado) */
+static int match_labels_valid(const ASTNode *node)
+{
+    for (int a = 0; a < node->data.match_stmt.arm_count; a++)
+    {
+        const ASTNode *arm = node->data.match_stmt.arms[a];
+        if (arm->node_type != NODE_MATCH_ARM)
+            return 0;
+
+        for (int l = 0; l < arm->data.match_arm.label_count; l++)
+        {
+            const ASTNode *label = arm->data.match_arm.labels[l];
+            if (label->node_type != NODE_LITERAL ||
+                (label->data.literal.literal_type != TOKEN_INT_LITERAL &&
+                 label->data.literal.literal_type != TOKEN_STRING_LITERAL))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+static int expand_node(Expander *expander, AstHandle index)
+{
+    const CompactNode *record = &expander->ast->nodes[index];
+    const uint32_t *slot = record->slot;
+    ASTNode *node = &expander->nodes[index];
+
+    memset(node, 0, sizeof(ASTNode));
+    node->node_type = (NodeType)record->kind;
+    node->data_type = (DataType)record->data_type;
+    node->line = record->line;
+    node->column = record->column;
+
+    switch (node->node_type)
+    {
+    case NODE_VAR_DECL:
+        return expand_text(expander, slot[0], &node->data.var_decl.name) &&
+               expand_child(expander, index, slot[1], 1, &node->data.var_decl.type_node) &&
+               expand_child(expander, index, slot[2], 1, &node->data.var_decl.initializer);
+    case NODE_FUNC_DECL:
+        return expand_text(expander, slot[0], &node->data.func_decl.name) &&
+               expand_list(expander, index, &slot[1], &node->data.func_decl.params,
+                           &node->data.func_decl.param_count) &&
+               expand_child(expander, index, slot[3], 1, &node->data.func_decl.return_type) &&
+               expand_child(expander, index, slot[4], 1, &node->data.func_decl.body);
+    case NODE_PARAM:
+        node->data.param.storage = (FieldStorage)record->tag;
+        node->data.param.offset = (int)slot[2];
+        return node->data.param.storage <= FIELD_VALUE &&
+               expand_text(expander, slot[0], &node->data.param.name) &&
+               expand_child(expander, index, slot[1], 1, &node->data.param.type_node);
+    case NODE_STRUCT_DECL:
+        node->data.struct_decl.size = (int)slot[3];
+        return expand_text(expander, slot[0], &node->data.struct_decl.name) &&
+               expand_list(expander, index, &slot[1], &node->data.struct_decl.fields,
+                           &node->data.struct_decl.field_count);
+    case NODE_IMPORT:
+        node->data.import_stmt.module_hash = (uint64_t)slot[1] | ((uint64_t)slot[2] << 32);
+        return expand_text(expander, slot[0], &node->data.import_stmt.path);
+    case NODE_EXPR_STMT:
+        return expand_child(expander, index, slot[0], 1, &node->data.expr_stmt.expression);
+    case NODE_IF_STMT:
+        return expand_child(expander, index, slot[0], 1, &node->data.if_stmt.condition) &&
+               expand_child(expander, index, slot[1], 1, &node->data.if_stmt.then_branch) &&
+               expand_child(expander, index, slot[2], 0, &node->data.if_stmt.else_branch);
+    case NODE_WHILE_STMT:
+        return expand_child(expander, index, slot[0], 1, &node->data.while_stmt.condition) &&
+               expand_child(expander, index, slot[1], 1, &node->data.while_stmt.body);
+    case NODE_FOR_STMT:
+        return expand_text(expander, slot[0], &node->data.for_stmt.var_name) &&
+               expand_child(expander, index, slot[1], 1, &node->data.for_stmt.start) &&
+               expand_child(expander, index, slot[2], 1, &node->data.for_stmt.end) &&
+               expand_child(expander, index, slot[3], 0, &node->data.for_stmt.step) &&
+               expand_child(expander, index, slot[4], 1, &node->data.for_stmt.body);
+    case NODE_MATCH_STMT:
+        return expand_child(expander, index, slot[0], 1, &node->data.match_stmt.subject) &&
+               expand_list(expander, index, &slot[1], &node->data.match_stmt.arms,
+                           &node->data.match_stmt.arm_count) &&
+               expand_child(expander, index, slot[3], 0, &node->data.match_stmt.else_branch);
+    case NODE_MATCH_ARM:
+        return expand_list(expander, index, &slot[0], &node->data.match_arm.labels,
+                           &node->data.match_arm.label_count) &&
+               expand_child(expander, index, slot[2], 1, &node->data.match_arm.body);
+    case NODE_RETURN_STMT:
+        return expand_child(expander, index, slot[0], 0, &node->data.return_stmt.value);
+    case NODE_BLOCK:
+        return expand_list(expander, index, &slot[0], &node->data.block.statements,
+                           &node->data.block.stmt_count);
+    case NODE_BINARY_EXPR:
+        node->data.binary_expr.operator = (TokenType)record->tag;
+        return expand_child(expander, index, slot[0], 1, &node->data.binary_expr.left) &&
+               expand_child(expander, index, slot[1], 1, &node->data.binary_expr.right);
+    case NODE_UNARY_EXPR:
+        node->data.unary_expr.operator = (TokenType)record->tag;
+        return expand_child(expander, index, slot[0], 1, &node->data.unary_expr.operand);
+    case NODE_ASSIGN_EXPR:
+        return expand_text(expander, slot[0], &node->data.assign_expr.variable_name) &&
+               expand_child(expander, index, slot[1], 1, &node->data.assign_expr.value);
+    case NODE_CALL_EXPR:
+        return expand_text(expander, slot[0], &node->data.call_expr.function_name) &&
+               expand_list(expander, index, &slot[1], &node->data.call_expr.arguments,
+                           &node->data.call_expr.arg_count);
+    case NODE_VAR_EXPR:
+        return expand_text(expander, slot[0], &node->data.var_expr.name);
+    case NODE_INDEX_EXPR:
+        return expand_child(expander, index, slot[0], 1, &node->data.index_expr.array) &&
+               expand_child(expander, index, slot[1], 1, &node->data.index_expr.index);
+    case NODE_INDEX_ASSIGN:
+        return expand_child(expander, index, slot[0], 1, &node->data.index_assign.array) &&
+               expand_child(expander, index, slot[1], 1, &node->data.index_assign.index) &&
+               expand_child(expander, index, slot[2], 1, &node->data.index_assign.value);
+    case NODE_FIELD_EXPR:
+    case NODE_FIELD_ASSIGN:
+        node->data.field_expr.storage = (FieldStorage)record->tag;
+        node->data.field_expr.offset = (int)slot[3];
+        return node->data.field_expr.storage <= FIELD_VALUE &&
+               expand_text(expander, slot[0], &node->data.field_expr.field_name) &&
+               expand_child(expander, index, slot[1], 1, &node->data.field_expr.object) &&
+               expand_child(expander, index, slot[2], node->node_type == NODE_FIELD_ASSIGN,
+                            &node->data.field_expr.value);
+    case NODE_ARRAY_LITERAL:
+        return expand_list(expander, index, &slot[0], &node->data.array_literal.elements,
+                           &node->data.array_literal.element_count);
+    case NODE_MAP_LITERAL:
+        node->data.map_literal.key_type = (DataType)(record->tag & 0xff);
+        node->data.map_literal.value_type = (DataType)(record->tag >> 8);
+        if (!expand_list(expander, index, &slot[0], &node->data.map_literal.items,
+                         &node->data.map_literal.entry_count) ||
+            node->data.map_literal.entry_count % 2 != 0)
+            return 0;
+        node->data.map_literal.entry_count /= 2;
+        return 1;
+    case NODE_LITERAL:
+        node->data.literal.literal_type = (TokenType)record->tag;
+        switch (node->data.literal.literal_type)
+        {
+        case TOKEN_INT_LITERAL:
+            node->data.literal.value.int_value = (int)slot[0];
+            return 1;
+        case TOKEN_FLOAT_LITERAL:
+            memcpy(&node->data.literal.value.float_value, &slot[0], sizeof(double));
+            return 1;
+        case TOKEN_STRING_LITERAL:
+            return expand_text(expander, slot[0], &node->data.literal.value.string_value);
+        case TOKEN_TRUE:
+        case TOKEN_FALSE:
+            node->data.literal.value.bool_value = (int)slot[0];
+            return 1;
+        default:
+            return 0;
+        }
+    case NODE_TYPE:
+        node->data.type_node.type = (DataType)record->tag;
+        node->data.type_node.is_array = (slot[0] & 1) != 0;
+        node->data.type_node.is_map = (slot[0] & 2) != 0;
+        node->data.type_node.key_type = (DataType)slot[1];
+        if (node->data.type_node.type == TYPE_STRUCT || slot[2] != AST_NONE)
+            return expand_text(expander, slot[2], &node->data.type_node.struct_name);
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* --- IMPRESSÃO --- */
+
+static void print_indent(int indent)
+{
+    for (int i = 0; i < indent; i++)
+        printf("  ");
+}
+
+/* Imprime um nó de tipo (int, int[], map<string, int>) */
+static void print_type(const CompactAst *ast, AstHandle handle)
+{
+    if (handle == AST_NONE)
+        return;
+
+    const CompactNode *type_node = &ast->nodes[handle];
+    if (type_node->slot[0] & 2)
+    {
+        printf("map<%s, %s>", data_type_to_string((DataType)type_node->slot[1]),
+               data_type_to_string((DataType)type_node->tag));
+        return;
+    }
+
+    if (type_node->slot[2] != AST_NONE)
+    {
+        printf("%s", ast->strings + type_node->slot[2]);
+        return;
+    }
+
+    printf("%s%s", data_type_to_string((DataType)type_node->tag), (type_node->slot[0] & 1) ? "[]" : "");
+}
+
+/* Nome e tipo de um parâmetro ou campo */
+static void print_param(const CompactAst *ast, AstHandle handle)
+{
+    const CompactNode *param = &ast->nodes[handle];
+    printf("%s:", ast->strings + param->slot[0]);
+    print_type(ast, param->slot[1]);
+}
+
+static void print_list(const CompactAst *ast, const uint32_t *slot, int indent)
+{
+    for (uint32_t i = 0; i < slot[1]; i++)
+        compact_ast_print(ast, ast->lists[slot[0] + i], indent);
+}
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+void compact_ast_init(CompactAst *ast)
+{
+    memset(ast, 0, sizeof(CompactAst));
+
+    // A tabela de strings começa com "" para nunca ser vazia
+    compact_ast_string(ast, "");
+}
+
+uint32_t compact_ast_string(CompactAst *ast, const char *text)
+{
+    if (text == NULL)
+        return AST_NONE;
+
+    if ((ast->intern_count + 1) * 2 > ast->intern_capacity && !intern_rehash(ast))
+    {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+
+    size_t length = strlen(text);
+    uint32_t slot = string_hash(text, length) & (ast->intern_capacity - 1);
+    while (ast->intern[slot] != 0)
+    {
+        uint32_t offset = ast->intern[slot] - 1;
+        if (strcmp(ast->strings + offset, text) == 0)
+            return offset;
+        slot = (slot + 1) & (ast->intern_capacity - 1);
+    }
+
+    uint32_t offset = ast->string_size;
+    if (!grow((void **)&ast->strings, &ast->string_capacity, offset + (uint32_t)length + 1, sizeof(char)))
+    {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+
+    memcpy(ast->strings + offset, text, length + 1);
+    ast->string_size += (uint32_t)length + 1;
+    ast->intern[slot] = offset + 1;
+    ast->intern_count++;
+    return offset;
+}
+
+AstHandle compact_ast_build(CompactAst *ast, const ASTNode *root)
+{
+    AstHandle handle = build_node(ast, root);
+    return ast->failed ? AST_NONE : handle;
+}
+
+void compact_ast_view(CompactAst *ast, const CompactNode *nodes, uint32_t node_count,
+                      const AstHandle *lists, uint32_t list_count, const char *strings, uint32_t string_size)
+{
+    memset(ast, 0, sizeof(CompactAst));
+    // Somente leitura: compact_ast_expand e compact_ast_print não escrevem nos arrays
+    ast->nodes = (CompactNode *)nodes;
+    ast->node_count = node_count;
+    ast->lists = (AstHandle *)lists;
+    ast->list_count = list_count;
+    ast->strings = (char *)strings;
+    ast->string_size = string_size;
+}
+
+ASTNode *compact_ast_expand(const CompactAst *ast, AstArena *arena)
+{
+    if (ast->failed || ast->node_count == 0 || ast->string_size == 0 ||
+        ast->strings[ast->string_size - 1] != '\0')
+        return NULL;
+
+    // Uma alocação por região: nós, listas e strings ficam contíguos na arena
+    AstArena expanded;
+    ast_arena_init(&expanded);
+
+    Expander expander;
+    expander.ast = ast;
+    expander.nodes = ast_arena_alloc(&expanded, sizeof(ASTNode) * ast->node_count);
+    expander.list_slots = ast->list_count > 0 ? ast_arena_alloc(&expanded, sizeof(ASTNode *) * ast->list_count)
+                                              : NULL;
+    expander.strings = ast_arena_alloc(&expanded, ast->string_size);
+
+    int ok = expander.nodes != NULL && expander.strings != NULL &&
+             (ast->list_count == 0 || expander.list_slots != NULL);
+    if (ok)
+        memcpy(expander.strings, ast->strings, ast->string_size);
+    for (uint32_t i = 0; ok && i < ast->node_count; i++)
+        ok = expand_node(&expander, i);
+
+    // Tabelas de despacho do match, agora que os rótulos estão expandidos
+    for (uint32_t i = 0; ok && i < ast->node_count; i++)
+    {
+        ASTNode *node = &expander.nodes[i];
+        if (node->node_type == NODE_MATCH_STMT)
+            ok = match_labels_valid(node) &&
+                 (node->data.match_stmt.table = match_table_build(node, &expanded, NULL)) != NULL;
+    }
+
+    if (!ok)
+    {
+        ast_arena_free(&expanded);
+        return NULL;
+    }
+
+    // Transfere os blocos expandidos para a arena do chamador
+    while (expanded.head != NULL)
+    {
+        AstArenaBlock *block = expanded.head;
+        expanded.head = block->next;
+        block->next = arena->head;
+        arena->head = block;
+    }
+    arena->bytes += expanded.bytes;
+    return &expander.nodes[0];
+}
+
+void compact_ast_print(const CompactAst *ast, AstHandle handle, int indent)
+{
+    if (handle == AST_NONE)
+        return;
+
+    const CompactNode *node = &ast->nodes[handle];
+    const uint32_t *slot = node->slot;
+
+    print_indent(indent);
+
+    switch ((NodeType)node->kind)
+    {
+    case NODE_VAR_DECL:
+        printf("VAR_DECL: %s:", ast->strings + slot[0]);
+        print_type(ast, slot[1]);
+        printf(" = \n");
+        compact_ast_print(ast, slot[2], indent + 1);
+        break;
+
+    case NODE_FUNC_DECL:
+        printf("FUNC_DECL: %s(", ast->strings + slot[0]);
+        for (uint32_t i = 0; i < slot[2]; i++)
+        {
+            if (i > 0)
+                printf(", ");
+            print_param(ast, ast->lists[slot[1] + i]);
+        }
+        printf(") -> ");
+        print_type(ast, slot[3]);
+        printf("\n");
+        compact_ast_print(ast, slot[4], indent + 1);
+        break;
+
+    case NODE_STRUCT_DECL:
+        printf("STRUCT_DECL: %s {", ast->strings + slot[0]);
+        for (uint32_t i = 0; i < slot[2]; i++)
+        {
+            if (i > 0)
+                printf(",");
+            printf(" ");
+            print_param(ast, ast->lists[slot[1] + i]);
+        }
+        printf(" }\n");
+        break;
+
+    case NODE_IMPORT:
+        printf("IMPORT: \"%s\"\n", ast->strings + slot[0]);
+        break;
+
+    case NODE_IF_STMT:
+        printf("IF\n");
+        print_indent(indent + 1);
+        printf("CONDITION:\n");
+        compact_ast_print(ast, slot[0], indent + 2);
+        print_indent(indent + 1);
+        printf("THEN:\n");
+        compact_ast_print(ast, slot[1], indent + 2);
+        if (slot[2] != AST_NONE)
+        {
+            print_indent(indent + 1);
+            printf("ELSE:\n");
+            compact_ast_print(ast, slot[2], indent + 2);
+        }
+        break;
+
+    case NODE_WHILE_STMT:
+        printf("WHILE\n");
+        print_indent(indent + 1);
+        printf("CONDITION:\n");
+        compact_ast_print(ast, slot[0], indent + 2);
+        print_indent(indent + 1);
+        printf("BODY:\n");
+        compact_ast_print(ast, slot[1], indent + 2);
+        break;
+
+    case NODE_FOR_STMT:
+        printf("FOR: %s\n", ast->strings + slot[0]);
+        print_indent(indent + 1);
+        printf("RANGE:\n");
+        compact_ast_print(ast, slot[1], indent + 2);
+        compact_ast_print(ast, slot[2], indent + 2);
+        if (slot[3] != AST_NONE)
+        {
+            print_indent(indent + 1);
+            printf("STEP:\n");
+            compact_ast_print(ast, slot[3], indent + 2);
+        }
+        print_indent(indent + 1);
+        printf("BODY:\n");
+        compact_ast_print(ast, slot[4], indent + 2);
+        break;
+
+    case NODE_MATCH_STMT:
+        printf("MATCH\n");
+        compact_ast_print(ast, slot[0], indent + 1);
+        print_list(ast, &slot[1], indent + 1);
+        if (slot[3] != AST_NONE)
+        {
+            print_indent(indent + 1);
+            printf("ELSE:\n");
+            compact_ast_print(ast, slot[3], indent + 2);
+        }
+        break;
+
+    case NODE_MATCH_ARM:
+        printf("ARM:\n");
+        print_list(ast, &slot[0], indent + 1);
+        compact_ast_print(ast, slot[2], indent + 1);
+        break;
+
+    case NODE_RETURN_STMT:
+        printf("RETURN\n");
+        compact_ast_print(ast, slot[0], indent + 1);
+        break;
+
+    case NODE_BLOCK:
+        printf("BLOCK\n");
+        print_list(ast, &slot[0], indent + 1);
+        break;
+
+    case NODE_EXPR_STMT:
+        printf("EXPR_STMT\n");
+        compact_ast_print(ast, slot[0], indent + 1);
+        break;
+
+    case NODE_BINARY_EXPR:
+        printf("BINARY_OP(%s)\n", token_type_to_string((TokenType)node->tag));
+        compact_ast_print(ast, slot[0], indent + 1);
+        compact_ast_print(ast, slot[1], indent + 1);
+        break;
+
+    case NODE_UNARY_EXPR:
+        printf("UNARY_OP(%s)\n", token_type_to_string((TokenType)node->tag));
+        compact_ast_print(ast, slot[0], indent + 1);
+        break;
+
+    case NODE_ASSIGN_EXPR:
+        printf("ASSIGN: %s =\n", ast->strings + slot[0]);
+        compact_ast_print(ast, slot[1], indent + 1);
+        break;
+
+    case NODE_CALL_EXPR:
+        printf("CALL: %s\n", ast->strings + slot[0]);
+        for (uint32_t i = 0; i < slot[2]; i++)
+        {
+            print_indent(indent + 1);
+            printf("ARG %u:\n", i);
+            compact_ast_print(ast, ast->lists[slot[1] + i], indent + 2);
+        }
+        break;
+
+    case NODE_VAR_EXPR:
+        printf("VAR: %s\n", ast->strings + slot[0]);
+        break;
+
+    case NODE_INDEX_EXPR:
+        printf("INDEX\n");
+        compact_ast_print(ast, slot[0], indent + 1);
+        compact_ast_print(ast, slot[1], indent + 1);
+        break;
+
+    case NODE_INDEX_ASSIGN:
+        printf("INDEX_ASSIGN\n");
+        compact_ast_print(ast, slot[0], indent + 1);
+        compact_ast_print(ast, slot[1], indent + 1);
+        compact_ast_print(ast, slot[2], indent + 1);
+        break;
+
+    case NODE_FIELD_EXPR:
+        printf("FIELD: .%s\n", ast->strings + slot[0]);
+        compact_ast_print(ast, slot[1], indent + 1);
+        break;
+
+    case NODE_FIELD_ASSIGN:
+        printf("FIELD_ASSIGN: .%s =\n", ast->strings + slot[0]);
+        compact_ast_print(ast, slot[1], indent + 1);
+        compact_ast_print(ast, slot[2], indent + 1);
+        break;
+
+    case NODE_ARRAY_LITERAL:
+        printf("ARRAY_LITERAL (%u)\n", slot[1]);
+        print_list(ast, &slot[0], indent + 1);
+        break;
+
+    case NODE_MAP_LITERAL:
+        printf("MAP_LITERAL (%u)\n", slot[1] / 2);
+        print_list(ast, &slot[0], indent + 1);
+        break;
+
+    case NODE_LITERAL:
+        printf("LITERAL: ");
+        switch ((TokenType)node->tag)
+        {
+        case TOKEN_INT_LITERAL:
+            printf("%d\n", (int)slot[0]);
+            break;
+        case TOKEN_FLOAT_LITERAL:
+        {
+            double value;
+            memcpy(&value, &slot[0], sizeof(double));
+            printf("%.6f\n", value);
+            break;
+        }
+        case TOKEN_STRING_LITERAL:
+            printf("\"%s\"\n", ast->strings + slot[0]);
+            break;
+        case TOKEN_TRUE:
+        case TOKEN_FALSE:
+            printf("%s\n", slot[0] ? "true" : "false");
+            break;
+        default:
+            printf("unknown\n");
+            break;
+        }
+        break;
+
+    default:
+        printf("UNKNOWN_NODE\n");
+        break;
+    }
+}
+
+void compact_ast_free(CompactAst *ast)
+{
+    free(ast->nodes);
+    free(ast->lists);
+    free(ast->strings);
+    free(ast->intern);
+    memset(ast, 0, sizeof(CompactAst));
+}
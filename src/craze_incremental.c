@@ -0,0 +1,702 @@
+#include "../include/craze_incremental.h"
+
+/* --- PERCURSO DA AST --- */
+
+typedef void (*NodeVisitor)(ASTNode *node, void *context);
+
+/* Visita 'node' e todos os seus descendentes em pré-ordem */
+static void walk_tree(ASTNode *node, NodeVisitor visit, void *context)
+{
+    if (!node)
+        return;
+
+    visit(node, context);
+
+    switch (node->node_type)
+    {
+    case NODE_VAR_DECL:
+        walk_tree(node->data.var_decl.type_node, visit, context);
+        walk_tree(node->data.var_decl.initializer, visit, context);
+        break;
+    case NODE_FUNC_DECL:
+        for (int i = 0; i < node->data.func_decl.param_count; i++)
+            walk_tree(node->data.func_decl.params[i], visit, context);
+        walk_tree(node->data.func_decl.return_type, visit, context);
+        walk_tree(node->data.func_decl.body, visit, context);
+        break;
+    case NODE_PARAM:
+        walk_tree(node->data.param.type_node, visit, context);
+        break;
+    case NODE_STRUCT_DECL:
+        for (int i = 0; i < node->data.struct_decl.field_count; i++)
+            walk_tree(node->data.struct_decl.fields[i], visit, context);
+        break;
+    case NODE_EXPR_STMT:
+        walk_tree(node->data.expr_stmt.expression, visit, context);
+        break;
+    case NODE_IF_STMT:
+        walk_tree(node->data.if_stmt.condition, visit, context);
+        walk_tree(node->data.if_stmt.then_branch, visit, context);
+        walk_tree(node->data.if_stmt.else_branch, visit, context);
+        break;
+    case NODE_WHILE_STMT:
+        walk_tree(node->data.while_stmt.condition, visit, context);
+        walk_tree(node->data.while_stmt.body, visit, context);
+        break;
+    case NODE_FOR_STMT:
+        walk_tree(node->data.for_stmt.start, visit, context);
+        walk_tree(node->data.for_stmt.end, visit, context);
+        walk_tree(node->data.for_stmt.step, visit, context);
+        walk_tree(node->data.for_stmt.body, visit, context);
+        break;
+    case NODE_MATCH_STMT:
+        walk_tree(node->data.match_stmt.subject, visit, context);
+        for (int i = 0; i < node->data.match_stmt.arm_count; i++)
+            walk_tree(node->data.match_stmt.arms[i], visit, context);
+        walk_tree(node->data.match_stmt.else_branch, visit, context);
+        break;
+    case NODE_MATCH_ARM:
+        for (int i = 0; i < node->data.match_arm.label_count; i++)
+            walk_tree(node->data.match_arm.labels[i], visit, context);
+        walk_tree(node->data.match_arm.body, visit, context);
+        break;
+    case NODE_RETURN_STMT:
+        walk_tree(node->data.return_stmt.value, visit, context);
+        break;
+    case NODE_BLOCK:
+        for (int i = 0; i < node->data.block.stmt_count; i++)
+            walk_tree(node->data.block.statements[i], visit, context);
+        break;
+    case NODE_ASSIGN_EXPR:
+        walk_tree(node->data.assign_expr.value, visit, context);
+        break;
+    case NODE_BINARY_EXPR:
+        walk_tree(node->data.binary_expr.left, visit, context);
+        walk_tree(node->data.binary_expr.right, visit, context);
+        break;
+    case NODE_UNARY_EXPR:
+        walk_tree(node->data.unary_expr.operand, visit, context);
+        break;
+    case NODE_CALL_EXPR:
+        for (int i = 0; i < node->data.call_expr.arg_count; i++)
+            walk_tree(node->data.call_expr.arguments[i], visit, context);
+        break;
+    case NODE_INDEX_EXPR:
+        walk_tree(node->data.index_expr.array, visit, context);
+        walk_tree(node->data.index_expr.index, visit, context);
+        break;
+    case NODE_INDEX_ASSIGN:
+        walk_tree(node->data.index_assign.array, visit, context);
+        walk_tree(node->data.index_assign.index, visit, context);
+        walk_tree(node->data.index_assign.value, visit, context);
+        break;
+    case NODE_FIELD_EXPR:
+    case NODE_FIELD_ASSIGN:
+        walk_tree(node->data.field_expr.object, visit, context);
+        walk_tree(node->data.field_expr.value, visit, context);
+        break;
+    case NODE_ARRAY_LITERAL:
+        for (int i = 0; i < node->data.array_literal.element_count; i++)
+            walk_tree(node->data.array_literal.elements[i], visit, context);
+        break;
+    case NODE_MAP_LITERAL:
+        for (int i = 0; i < 2 * node->data.map_literal.entry_count; i++)
+            walk_tree(node->data.map_literal.items[i], visit, context);
+        break;
+    default:
+        break;
+    }
+}
+
+static void shift_node_line(ASTNode *node, void *context)
+{
+    node->line += *(int *)context;
+}
+
+/* Corrige as linhas da AST do trecho depois de edições acima dele.
+ * Colunas não mudam: uma edição na mesma linha do trecho o faz ser re-tokenizado. */
+static void unit_sync_lines(DocumentUnit *unit)
+{
+    int delta = unit->line - unit->ast_line;
+    if (delta == 0)
+        return;
+
+    for (int i = 0; i < unit->stmt_count; i++)
+        walk_tree(unit->statements[i], shift_node_line, &delta);
+    unit->ast_line = unit->line;
+}
+
+/* --- DEPENDÊNCIAS DOS TRECHOS --- */
+
+typedef struct
+{
+    DocumentUnit *unit;
+    int capacity;
+    int failed;
+} DepCollector;
+
+static void add_dep(DepCollector *collector, const char *name)
+{
+    DocumentUnit *unit = collector->unit;
+    if (collector->failed || !name)
+        return;
+
+    for (int i = 0; i < unit->dep_count; i++)
+    {
+        if (strcmp(unit->deps[i].name, name) == 0)
+            return;
+    }
+
+    if (unit->dep_count >= collector->capacity)
+    {
+        int capacity = collector->capacity == 0 ? 8 : collector->capacity * 2;
+        DocumentBinding *deps = realloc(unit->deps, sizeof(DocumentBinding) * capacity);
+        if (!deps)
+        {
+            collector->failed = 1;
+            return;
+        }
+        unit->deps = deps;
+        collector->capacity = capacity;
+    }
+
+    unit->deps[unit->dep_count].name = name;
+    unit->deps[unit->dep_count].signature = 0;
+    unit->dep_count++;
+}
+
+static void collect_dep(ASTNode *node, void *context)
+{
+    switch (node->node_type)
+    {
+    case NODE_VAR_EXPR:
+        add_dep(context, node->data.var_expr.name);
+        break;
+    case NODE_CALL_EXPR:
+        add_dep(context, node->data.call_expr.function_name);
+        break;
+    case NODE_ASSIGN_EXPR:
+        add_dep(context, node->data.assign_expr.variable_name);
+        break;
+    case NODE_TYPE:
+        add_dep(context, node->data.type_node.struct_name); // Ignora NULL
+        break;
+    default:
+        break;
+    }
+}
+
+/* Registra os nomes que o resultado da verificação do trecho depende: os que
+ * ele usa (inclusive locais, por simplicidade) e os que declara no nível
+ * superior (erro de redeclaração). Com falta de memória, dep_count fica -1 e o
+ * trecho é sempre re-verificado; o mesmo vale para trechos com import, que
+ * declaram o que o módulo exporta e dependem de um arquivo que pode mudar. */
+static void unit_collect_deps(DocumentUnit *unit)
+{
+    DepCollector collector = {unit, 0, 0};
+
+    for (int i = 0; i < unit->stmt_count; i++)
+    {
+        ASTNode *stmt = unit->statements[i];
+        if (stmt->node_type == NODE_VAR_DECL)
+            add_dep(&collector, stmt->data.var_decl.name);
+        else if (stmt->node_type == NODE_FUNC_DECL)
+            add_dep(&collector, stmt->data.func_decl.name);
+        else if (stmt->node_type == NODE_STRUCT_DECL)
+            add_dep(&collector, stmt->data.struct_decl.name);
+        else if (stmt->node_type == NODE_IMPORT)
+            collector.failed = 1;
+
+        walk_tree(stmt, collect_dep, &collector);
+    }
+
+    if (collector.failed)
+    {
+        free(unit->deps);
+        unit->deps = NULL;
+        unit->dep_count = -1;
+    }
+}
+
+static void unit_free(DocumentUnit *unit)
+{
+    for (int i = 0; i < unit->stmt_count; i++)
+        ast_free(unit->statements[i]);
+    free(unit->statements);
+    free(unit->deps);
+    free(unit->exports);
+    semantic_free_symbols(unit->symbols);
+}
+
+/* --- TABELA DE NOMES GLOBAIS --- */
+/* Endereçamento aberto; as chaves apontam para os nomes dos SymbolEntry */
+
+static uint64_t name_hash(const char *name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *name; name++)
+    {
+        hash ^= (unsigned char)*name;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static DocumentBinding *binding_slot(DocumentBinding *table, int capacity, const char *name)
+{
+    int mask = capacity - 1;
+    for (int i = (int)(name_hash(name) & (uint64_t)mask);; i = (i + 1) & mask)
+    {
+        if (!table[i].name || strcmp(table[i].name, name) == 0)
+            return &table[i];
+    }
+}
+
+static uint64_t binding_get(Document *doc, const char *name)
+{
+    DocumentBinding *slot = binding_slot(doc->bindings, doc->binding_capacity, name);
+    return slot->name ? slot->signature : 0;
+}
+
+static int binding_set(Document *doc, const char *name, uint64_t signature)
+{
+    if ((doc->binding_count + 1) * 2 > doc->binding_capacity)
+    {
+        int capacity = doc->binding_capacity * 2;
+        DocumentBinding *table = calloc(capacity, sizeof(DocumentBinding));
+        if (!table)
+            return 0;
+
+        for (int i = 0; i < doc->binding_capacity; i++)
+        {
+            if (doc->bindings[i].name)
+                *binding_slot(table, capacity, doc->bindings[i].name) = doc->bindings[i];
+        }
+        free(doc->bindings);
+        doc->bindings = table;
+        doc->binding_capacity = capacity;
+    }
+
+    DocumentBinding *slot = binding_slot(doc->bindings, doc->binding_capacity, name);
+    if (!slot->name)
+    {
+        slot->name = name;
+        doc->binding_count++;
+    }
+    slot->signature = signature;
+    return 1;
+}
+
+/* --- RE-TOKENIZAÇÃO E PARSE DE TRECHOS --- */
+
+/* Índice do trecho que contém o byte 'offset' */
+static int unit_at(Document *doc, size_t offset)
+{
+    int low = 0;
+    int high = doc->unit_count - 1;
+    while (low < high)
+    {
+        int mid = (low + high + 1) / 2;
+        if (doc->units[mid].start <= offset)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    return low;
+}
+
+static int count_newlines(const char *text, size_t length)
+{
+    int count = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (text[i] == '\n')
+            count++;
+    }
+    return count;
+}
+
+/* O trecho re-tokenizado termina exatamente onde o próximo trecho começa, na
+ * mesma linha/coluna e numa fronteira de declaração (profundidade 0, após ';'
+ * ou '}'), ou seja, o fonte inteiro seria tokenizado da mesma forma */
+static int region_synchronized(const TokenBuffer *tokens, size_t limit, const DocumentUnit *next)
+{
+    int eof = tokens->count - 1;
+    if (tokens->offsets[eof] != limit || tokens->lines[eof] != next->line ||
+        tokens->columns[eof] != next->column)
+        return 0;
+
+    int depth = 0;
+    TokenType last = TOKEN_SEMICOLON;
+    for (int i = 0; i < eof; i++)
+    {
+        TokenType type = (TokenType)tokens->types[i];
+        if (type == TOKEN_LEFT_BRACE)
+            depth++;
+        else if (type == TOKEN_RIGHT_BRACE && depth > 0)
+            depth--;
+        last = type;
+    }
+    return depth == 0 && (last == TOKEN_SEMICOLON || last == TOKEN_RIGHT_BRACE);
+}
+
+/* Substitui os trechos [first, first+count) por 'replacement' */
+static int units_splice(Document *doc, int first, int count, DocumentUnit *replacement, int replacement_count)
+{
+    int new_count = doc->unit_count - count + replacement_count;
+    if (new_count > doc->unit_capacity)
+    {
+        int capacity = doc->unit_capacity * 2 > new_count ? doc->unit_capacity * 2 : new_count;
+        DocumentUnit *units = realloc(doc->units, sizeof(DocumentUnit) * capacity);
+        if (!units)
+            return 0;
+        doc->units = units;
+        doc->unit_capacity = capacity;
+    }
+
+    for (int i = first; i < first + count; i++)
+        unit_free(&doc->units[i]);
+
+    memmove(&doc->units[first + replacement_count], &doc->units[first + count],
+            sizeof(DocumentUnit) * (doc->unit_count - first - count));
+    memcpy(&doc->units[first], replacement, sizeof(DocumentUnit) * replacement_count);
+    doc->unit_count = new_count;
+    return 1;
+}
+
+/* Re-tokeniza e refaz o parse dos trechos [first, last] no fonte atual (os
+ * trechos seguintes já devem estar com posições atualizadas). O intervalo cresce
+ * até o novo texto se encaixar entre fronteiras de declaração inalteradas. */
+static int reparse_units(Document *doc, int first, int last)
+{
+    Lexer lexer;
+    TokenBuffer tokens;
+    size_t region_start;
+    size_t region_end;
+
+    for (;;)
+    {
+        region_start = doc->units[first].start;
+        region_end = last + 1 < doc->unit_count ? doc->units[last + 1].start : doc->length;
+
+        lexer_init_span(&lexer, doc->source + region_start, doc->length - region_start);
+        lexer.line = doc->units[first].line;
+        lexer.column = doc->units[first].column;
+        token_buffer_init(&tokens);
+
+        if (!token_buffer_fill_until(&tokens, &lexer, region_end - region_start))
+        {
+            token_buffer_free(&tokens);
+            lexer_cleanup(&lexer);
+            return 0;
+        }
+
+        // Cresce em progressão geométrica: edições que desbalanceiam chaves
+        // continuam lineares no tamanho do arquivo
+        int grow = last - first + 1;
+        if (first > 0 && (tokens.decl_count == 0 || tokens.decl_starts[0] != 0))
+        {
+            // O texto deixou de começar com uma declaração: pertence ao trecho anterior
+            first = first > grow ? first - grow : 0;
+        }
+        else if (last + 1 < doc->unit_count &&
+                 !region_synchronized(&tokens, region_end - region_start, &doc->units[last + 1]))
+        {
+            last = last + grow < doc->unit_count - 1 ? last + grow : doc->unit_count - 1;
+        }
+        else
+        {
+            break;
+        }
+
+        token_buffer_free(&tokens);
+        lexer_cleanup(&lexer);
+    }
+
+    // Um trecho por declaração; no início do arquivo, o primeiro trecho começa
+    // no token 0 (e no byte 0) mesmo que ele não seja uma declaração
+    int leading = first == 0 && (tokens.decl_count == 0 || tokens.decl_starts[0] != 0);
+    int piece_count = tokens.decl_count + leading;
+    DocumentUnit *pieces = calloc(piece_count, sizeof(DocumentUnit));
+    if (!pieces)
+    {
+        token_buffer_free(&tokens);
+        lexer_cleanup(&lexer);
+        return 0;
+    }
+
+    int ok = 1;
+    int eof = tokens.count - 1;
+    for (int p = 0; p < piece_count; p++)
+    {
+        DocumentUnit *unit = &pieces[p];
+        int begin = p < leading ? 0 : tokens.decl_starts[p - leading];
+        int end = p + 1 < piece_count ? tokens.decl_starts[p + 1 - leading] : eof;
+
+        if (first == 0 && p == 0)
+        {
+            unit->start = 0;
+            unit->line = 1;
+            unit->column = 1;
+        }
+        else
+        {
+            unit->start = region_start + tokens.offsets[begin];
+            unit->line = tokens.lines[begin];
+            unit->column = tokens.columns[begin];
+        }
+        unit->ast_line = unit->line;
+
+        Parser parser;
+        parser_init_range(&parser, &tokens, begin, end);
+        unit->statements = parse_declarations(&parser, &unit->stmt_count);
+        unit->parse_error = parser.had_error;
+        parser_cleanup(&parser);
+
+        if (unit->stmt_count > 0 && !unit->statements)
+            ok = 0;
+        unit_collect_deps(unit);
+    }
+
+    if (ok)
+        ok = units_splice(doc, first, last - first + 1, pieces, piece_count);
+
+    if (!ok)
+    {
+        for (int p = 0; p < piece_count; p++)
+            unit_free(&pieces[p]);
+    }
+    else
+    {
+        doc->relexed_bytes = region_end - region_start;
+        doc->reparsed_units = piece_count;
+        doc->program_stale = 1;
+    }
+
+    free(pieces);
+    token_buffer_free(&tokens);
+    lexer_cleanup(&lexer);
+    return ok;
+}
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+int document_open(Document *doc, const char *source, size_t length)
+{
+    memset(doc, 0, sizeof(Document));
+
+    doc->capacity = length + 1;
+    doc->source = malloc(doc->capacity);
+    doc->unit_capacity = 16;
+    doc->units = calloc(doc->unit_capacity, sizeof(DocumentUnit));
+    doc->binding_capacity = 64;
+    doc->bindings = calloc(doc->binding_capacity, sizeof(DocumentBinding));
+    if (!doc->source || !doc->units || !doc->bindings)
+    {
+        free(doc->source);
+        free(doc->units);
+        free(doc->bindings);
+        return 0;
+    }
+
+    memcpy(doc->source, source, length);
+    doc->source[length] = '\0';
+    doc->length = length;
+
+    doc->program.node_type = NODE_BLOCK;
+    doc->program.data_type = TYPE_VOID;
+    doc->program.line = 1;
+    doc->program.column = 1;
+    doc->program_stale = 1;
+    semantic_init(&doc->analyzer, &doc->program);
+
+    // Um trecho vazio cobrindo o arquivo inteiro, re-tokenizado por completo
+    doc->unit_count = 1;
+    doc->units[0].line = 1;
+    doc->units[0].column = 1;
+    doc->units[0].ast_line = 1;
+    if (!reparse_units(doc, 0, 0))
+    {
+        document_free(doc);
+        return 0;
+    }
+    return 1;
+}
+
+int document_edit(Document *doc, size_t offset, size_t removed, const char *text, size_t inserted)
+{
+    if (offset > doc->length || removed > doc->length - offset)
+        return 0;
+
+    // Os símbolos de todos os trechos saem do escopo global até a próxima análise
+    semantic_reset_globals(&doc->analyzer);
+
+    size_t new_length = doc->length - removed + inserted;
+    if (new_length + 1 > doc->capacity)
+    {
+        size_t capacity = doc->capacity * 2 > new_length + 1 ? doc->capacity * 2 : new_length + 1;
+        char *source = realloc(doc->source, capacity);
+        if (!source)
+            return 0;
+        doc->source = source;
+        doc->capacity = capacity;
+    }
+
+    int first = unit_at(doc, offset);
+    int last = unit_at(doc, offset + removed);
+    int line_delta = count_newlines(text, inserted) - count_newlines(doc->source + offset, removed);
+
+    memmove(doc->source + offset + inserted, doc->source + offset + removed,
+            doc->length - offset - removed);
+    memcpy(doc->source + offset, text, inserted);
+    doc->length = new_length;
+    doc->source[new_length] = '\0';
+
+    // Trechos depois da edição só mudam de posição
+    for (int i = last + 1; i < doc->unit_count; i++)
+    {
+        doc->units[i].start = doc->units[i].start + inserted - removed;
+        doc->units[i].line += line_delta;
+    }
+
+    return reparse_units(doc, first, last);
+}
+
+int document_analyze(Document *doc)
+{
+    SemanticAnalyzer *analyzer = &doc->analyzer;
+    semantic_reset_globals(analyzer);
+
+    memset(doc->bindings, 0, sizeof(DocumentBinding) * doc->binding_capacity);
+    doc->binding_count = 0;
+    for (SymbolEntry *builtin = analyzer->builtin_symbols; builtin; builtin = builtin->next)
+        binding_set(doc, builtin->name, semantic_symbol_signature(builtin));
+
+    int parse_errors = 0;
+    doc->rechecked_units = 0;
+
+    for (int u = 0; u < doc->unit_count; u++)
+    {
+        DocumentUnit *unit = &doc->units[u];
+        parse_errors += unit->parse_error;
+
+        // Verificado antes e enxergando os mesmos símbolos globais: o resultado
+        // não mudou, basta recolocar os símbolos que ele declarou
+        int stale = !unit->checked || unit->dep_count < 0;
+        for (int i = 0; !stale && i < unit->dep_count; i++)
+            stale = binding_get(doc, unit->deps[i].name) != unit->deps[i].signature;
+
+        if (stale)
+        {
+            semantic_free_symbols(unit->symbols);
+            unit->symbols.first = NULL;
+            unit->symbols.last = NULL;
+            unit_sync_lines(unit);
+
+            for (int i = 0; i < unit->dep_count; i++)
+                unit->deps[i].signature = binding_get(doc, unit->deps[i].name);
+
+            int errors = analyzer->error_count;
+            int warnings = analyzer->warning_count;
+            for (int i = 0; i < unit->stmt_count; i++)
+            {
+                SymbolSpan span = semantic_analyze_statement(analyzer, unit->statements[i]);
+                if (span.first)
+                {
+                    if (!unit->symbols.first)
+                        unit->symbols.last = span.last;
+                    unit->symbols.first = span.first;
+                }
+            }
+            unit->semantic_errors = analyzer->error_count - errors;
+            unit->semantic_warnings = analyzer->warning_count - warnings;
+            unit->checked = 1;
+            doc->rechecked_units++;
+
+            // Assinaturas dos símbolos declarados, para os trechos seguintes
+            int count = 0;
+            for (SymbolEntry *s = unit->symbols.first; s; s = s == unit->symbols.last ? NULL : s->next)
+                count++;
+
+            free(unit->exports);
+            unit->exports = count > 0 ? malloc(sizeof(DocumentBinding) * count) : NULL;
+            unit->export_count = 0;
+            for (SymbolEntry *s = unit->symbols.first; s && unit->exports; s = s == unit->symbols.last ? NULL : s->next)
+            {
+                unit->exports[unit->export_count].name = s->name;
+                unit->exports[unit->export_count].signature = semantic_symbol_signature(s);
+                unit->export_count++;
+            }
+            if (unit->export_count < count)
+                unit->checked = 0; // Sem memória: re-verifica na próxima análise
+        }
+        else
+        {
+            semantic_restore_symbols(analyzer, unit->symbols);
+            analyzer->error_count += unit->semantic_errors;
+            analyzer->warning_count += unit->semantic_warnings;
+        }
+
+        // Do mais antigo ao mais recente: o último registrado prevalece, como na busca do escopo
+        for (int i = unit->export_count - 1; i >= 0; i--)
+        {
+            if (!binding_set(doc, unit->exports[i].name, unit->exports[i].signature))
+                unit->checked = 0;
+        }
+    }
+
+    doc->error_count = parse_errors + analyzer->error_count;
+    return doc->error_count == 0;
+}
+
+ASTNode *document_program(Document *doc)
+{
+    if (!doc->program_stale)
+        return &doc->program;
+
+    int total = 0;
+    for (int u = 0; u < doc->unit_count; u++)
+        total += doc->units[u].stmt_count;
+
+    ASTNode **statements = realloc(doc->program.data.block.statements,
+                                   sizeof(ASTNode *) * (total > 0 ? total : 1));
+    if (!statements)
+        return NULL;
+
+    int count = 0;
+    for (int u = 0; u < doc->unit_count; u++)
+    {
+        DocumentUnit *unit = &doc->units[u];
+        if (unit->stmt_count == 0)
+            continue;
+
+        unit_sync_lines(unit);
+        memcpy(statements + count, unit->statements, sizeof(ASTNode *) * unit->stmt_count);
+        count += unit->stmt_count;
+    }
+
+    doc->program.data.block.statements = statements;
+    doc->program.data.block.stmt_count = count;
+    doc->program_stale = 0;
+    return &doc->program;
+}
+
+void document_free(Document *doc)
+{
+    // Os símbolos pertencem aos trechos: tirá-los do escopo antes do semantic_cleanup
+    semantic_reset_globals(&doc->analyzer);
+
+    for (int u = 0; u < doc->unit_count; u++)
+        unit_free(&doc->units[u]);
+    free(doc->units);
+    doc->units = NULL;
+    doc->unit_count = 0;
+
+    semantic_cleanup(&doc->analyzer);
+    free(doc->program.data.block.statements);
+    free(doc->bindings);
+    free(doc->source);
+    doc->program.data.block.statements = NULL;
+    doc->bindings = NULL;
+    doc->source = NULL;
+}
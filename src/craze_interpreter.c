@@ -1,4 +1,6 @@
 #include "../include/craze_interpreter.h"
+#include "../include/craze_module.h"
+#include "../include/craze_vector.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,11 +29,56 @@ Value *value_create_float(double value)
     return val;
 }
 
+/* Cópia terminada em '\0' de 'length' bytes (que podem vir de uma fatia) */
+static char *copy_chars(const char *chars, int length)
+{
+    char *copy = malloc((size_t)length + 1);
+    memcpy(copy, chars, (size_t)length);
+    copy[length] = '\0';
+    return copy;
+}
+
+/* String que assume a posse de 'chars' (terminado em '\0') */
+static Value *value_adopt_string(char *chars, int length)
+{
+    Value *val = malloc(sizeof(Value));
+    val->type = VAL_STRING;
+    val->data.string.chars = chars;
+    val->data.string.length = length;
+    val->data.string.owner = NULL;
+    val->ref_count = 1;
+    return val;
+}
+
 Value *value_create_string(const char *value)
 {
+    return value_create_string_n(value, (int)strlen(value));
+}
+
+Value *value_create_string_n(const char *chars, int length)
+{
+    return value_adopt_string(copy_chars(chars, length), length);
+}
+
+/* Fatia [offset, offset + length) de 'string' (intervalo já validado). Não
+ * copia: aponta para o buffer da string dona dele e segura uma referência a
+ * ela, que vive enquanto houver fatias */
+Value *value_create_slice(Value *string, int offset, int length)
+{
+    if (offset == 0 && length == string->data.string.length)
+    {
+        value_incref(string);
+        return string;
+    }
+
+    Value *owner = string->data.string.owner ? string->data.string.owner : string;
+    value_incref(owner);
+
     Value *val = malloc(sizeof(Value));
     val->type = VAL_STRING;
-    val->data.string_val = strdup(value);
+    val->data.string.chars = string->data.string.chars + offset;
+    val->data.string.length = length;
+    val->data.string.owner = owner;
     val->ref_count = 1;
     return val;
 }
@@ -71,6 +118,87 @@ Value *value_create_builtin(BuiltinFn function, const char *name)
     return val;
 }
 
+Value *value_create_array(DataType element_type, int length)
+{
+    Value *val = malloc(sizeof(Value));
+    val->type = VAL_ARRAY;
+    val->data.array.element_type = element_type;
+    val->data.array.length = length;
+    val->data.array.items.ints = NULL;
+    val->ref_count = 1;
+
+    if (length <= 0)
+    {
+        val->data.array.length = 0;
+        return val;
+    }
+
+    switch (element_type)
+    {
+    case TYPE_INT:
+        val->data.array.items.ints = calloc(length, sizeof(int));
+        break;
+    case TYPE_FLOAT:
+        val->data.array.items.floats = calloc(length, sizeof(double));
+        break;
+    case TYPE_BOOL:
+        val->data.array.items.bools = calloc(length, sizeof(unsigned char));
+        break;
+    case TYPE_STRING:
+        val->data.array.items.strings = malloc(sizeof(char *) * length);
+        for (int i = 0; i < length; i++)
+        {
+            val->data.array.items.strings[i] = strdup("");
+        }
+        break;
+    default:
+        val->data.array.length = 0;
+        break;
+    }
+
+    return val;
+}
+
+Value *value_create_map(DataType key_type, DataType value_type)
+{
+    Value *val = malloc(sizeof(Value));
+    val->type = VAL_MAP;
+    val->data.map.index = NULL;
+    val->data.map.entries = NULL;
+    val->data.map.capacity = 0;
+    val->data.map.entry_count = 0;
+    val->data.map.count = 0;
+    val->data.map.key_type = key_type;
+    val->data.map.value_type = value_type;
+    val->ref_count = 1;
+    return val;
+}
+
+Value *value_create_bytes(const unsigned char *data, int length)
+{
+    Value *val = malloc(sizeof(Value));
+    val->type = VAL_BYTES;
+    val->data.bytes.data = calloc((size_t)length + 1, 1); // +1: malloc(0) pode ser NULL
+    if (data)
+        memcpy(val->data.bytes.data, data, (size_t)length);
+    val->data.bytes.length = length;
+    val->data.bytes.owner = NULL;
+    val->ref_count = 1;
+    return val;
+}
+
+Value *value_create_struct(ASTNode *decl)
+{
+    // Um bloco só: o Value seguido dos campos (sizeof(Value) já é múltiplo do
+    // alinhamento de double e de ponteiros)
+    Value *val = calloc(1, sizeof(Value) + (size_t)decl->data.struct_decl.size);
+    val->type = VAL_STRUCT;
+    val->data.record.fields = (unsigned char *)(val + 1);
+    val->data.record.decl = decl;
+    val->ref_count = 1;
+    return val;
+}
+
 void value_incref(Value *value)
 {
     if (value != NULL)
@@ -99,11 +227,57 @@ void value_free(Value *value)
     switch (value->type)
     {
     case VAL_STRING:
-        free(value->data.string_val);
+        if (value->data.string.owner)
+            value_decref(value->data.string.owner);
+        else
+            free(value->data.string.chars);
         break;
     case VAL_BUILTIN_FN:
         free(value->data.builtin_fn.name);
         break;
+    case VAL_ARRAY:
+        if (value->data.array.element_type == TYPE_STRING)
+        {
+            for (int i = 0; i < value->data.array.length; i++)
+            {
+                free(value->data.array.items.strings[i]);
+            }
+        }
+        free(value->data.array.items.ints);
+        break;
+    case VAL_MAP:
+        for (int i = 0; i < value->data.map.entry_count; i++)
+        {
+            MapEntry *entry = &value->data.map.entries[i];
+            if (entry->hash == 0)
+                continue;
+            if (value->data.map.key_type == TYPE_STRING)
+                free(entry->key.string_val);
+            if (value->data.map.value_type == TYPE_STRING)
+                free(entry->value.string_val);
+        }
+        free(value->data.map.entries);
+        free(value->data.map.index);
+        break;
+    case VAL_BYTES:
+        if (value->data.bytes.owner)
+            value_decref(value->data.bytes.owner);
+        else
+            free(value->data.bytes.data);
+        break;
+    case VAL_STRUCT:
+        // Os campos saem junto com o Value; só os Value* têm dono
+        for (int i = 0; i < value->data.record.decl->data.struct_decl.field_count; i++)
+        {
+            ASTNode *field = value->data.record.decl->data.struct_decl.fields[i];
+            if (field->data.param.storage == FIELD_VALUE)
+            {
+                Value *item;
+                memcpy(&item, value->data.record.fields + field->data.param.offset, sizeof(Value *));
+                value_decref(item);
+            }
+        }
+        break;
     default:
         break;
     }
@@ -111,6 +285,270 @@ void value_free(Value *value)
     free(value);
 }
 
+/* --- CAMPOS DE STRUCTS --- */
+/* Acesso direto no offset anotado pela análise semântica; memcpy de tamanho
+ * constante vira uma única leitura/escrita */
+
+/* Lê um campo como Value novo (um Value* ganha mais uma referência) */
+static Value *record_load(const Value *record, int offset, FieldStorage storage)
+{
+    const unsigned char *slot = record->data.record.fields + offset;
+    switch (storage)
+    {
+    case FIELD_INT:
+    {
+        int32_t number;
+        memcpy(&number, slot, sizeof(number));
+        return value_create_int(number);
+    }
+    case FIELD_BOOL:
+        return value_create_bool(*slot);
+    case FIELD_FLOAT:
+    {
+        double number;
+        memcpy(&number, slot, sizeof(number));
+        return value_create_float(number);
+    }
+    default:
+    {
+        Value *item;
+        memcpy(&item, slot, sizeof(item));
+        value_incref(item);
+        return item;
+    }
+    }
+}
+
+/* Grava 'value' num campo (int é convertido para um campo float) */
+static void record_store(Value *record, int offset, FieldStorage storage, Value *value)
+{
+    unsigned char *slot = record->data.record.fields + offset;
+    switch (storage)
+    {
+    case FIELD_INT:
+    {
+        int32_t number = value->data.int_val;
+        memcpy(slot, &number, sizeof(number));
+        break;
+    }
+    case FIELD_BOOL:
+        *slot = (unsigned char)(value->data.bool_val != 0);
+        break;
+    case FIELD_FLOAT:
+    {
+        double number = value->type == VAL_INT ? (double)value->data.int_val : value->data.float_val;
+        memcpy(slot, &number, sizeof(number));
+        break;
+    }
+    default:
+    {
+        Value *previous;
+        memcpy(&previous, slot, sizeof(previous));
+        value_incref(value);
+        memcpy(slot, &value, sizeof(value));
+        value_decref(previous);
+        break;
+    }
+    }
+}
+
+/* "[1, 2, 3]"; strings entre aspas */
+static char *array_to_string(Value *value)
+{
+    size_t capacity = 64;
+    size_t length = 0;
+    char *buffer = malloc(capacity);
+    buffer[length++] = '[';
+
+    for (int i = 0; i < value->data.array.length; i++)
+    {
+        char item[64];
+        const char *text = item;
+        switch (value->data.array.element_type)
+        {
+        case TYPE_INT:
+            snprintf(item, sizeof(item), "%d", value->data.array.items.ints[i]);
+            break;
+        case TYPE_FLOAT:
+            snprintf(item, sizeof(item), "%.6g", value->data.array.items.floats[i]);
+            break;
+        case TYPE_BOOL:
+            text = value->data.array.items.bools[i] ? "true" : "false";
+            break;
+        default:
+            text = value->data.array.items.strings[i];
+            break;
+        }
+
+        // ", " + aspas + texto + "]" + '\0'
+        size_t needed = length + strlen(text) + 6;
+        if (needed > capacity)
+        {
+            while (needed > capacity)
+                capacity *= 2;
+            buffer = realloc(buffer, capacity);
+        }
+
+        if (i > 0)
+        {
+            buffer[length++] = ',';
+            buffer[length++] = ' ';
+        }
+        int quoted = value->data.array.element_type == TYPE_STRING;
+        if (quoted)
+            buffer[length++] = '"';
+        memcpy(buffer + length, text, strlen(text));
+        length += strlen(text);
+        if (quoted)
+            buffer[length++] = '"';
+    }
+
+    buffer[length++] = ']';
+    buffer[length] = '\0';
+    return buffer;
+}
+
+/* Acrescenta um escalar de map a 'buffer' (strings entre aspas) */
+static void append_map_scalar(char **buffer, size_t *length, size_t *capacity, DataType type, MapScalar scalar)
+{
+    char item[64];
+    const char *text = item;
+    switch (type)
+    {
+    case TYPE_FLOAT:
+        snprintf(item, sizeof(item), "%.6g", scalar.float_val);
+        break;
+    case TYPE_STRING:
+        text = scalar.string_val;
+        break;
+    case TYPE_BOOL:
+        text = scalar.int_val ? "true" : "false";
+        break;
+    default:
+        snprintf(item, sizeof(item), "%d", scalar.int_val);
+        break;
+    }
+
+    // aspas + texto + ": " ou ", " + "}" + '\0'
+    size_t text_length = strlen(text);
+    size_t needed = *length + text_length + 6;
+    if (needed > *capacity)
+    {
+        while (needed > *capacity)
+            *capacity *= 2;
+        *buffer = realloc(*buffer, *capacity);
+    }
+
+    if (type == TYPE_STRING)
+        (*buffer)[(*length)++] = '"';
+    memcpy(*buffer + *length, text, text_length);
+    *length += text_length;
+    if (type == TYPE_STRING)
+        (*buffer)[(*length)++] = '"';
+}
+
+/* "{"a": 1, "b": 2}", em ordem de inserção */
+static char *map_to_string(Value *value)
+{
+    size_t capacity = 64;
+    size_t length = 0;
+    char *buffer = malloc(capacity);
+    buffer[length++] = '{';
+
+    int first = 1;
+    for (int i = 0; i < value->data.map.entry_count; i++)
+    {
+        const MapEntry *entry = &value->data.map.entries[i];
+        if (entry->hash == 0)
+            continue;
+
+        if (!first)
+        {
+            buffer[length++] = ',';
+            buffer[length++] = ' ';
+        }
+        first = 0;
+
+        append_map_scalar(&buffer, &length, &capacity, value->data.map.key_type, entry->key);
+        buffer[length++] = ':';
+        buffer[length++] = ' ';
+        append_map_scalar(&buffer, &length, &capacity, value->data.map.value_type, entry->value);
+    }
+
+    buffer[length++] = '}';
+    buffer[length] = '\0';
+    return buffer;
+}
+
+/* <bytes 01 ff 7a> (hexadecimal, byte a byte) */
+static char *bytes_to_string(Value *bytes)
+{
+    static const char hex[] = "0123456789abcdef";
+    int length = bytes->data.bytes.length;
+    char *buffer = malloc((size_t)length * 3 + 9);
+    char *out = buffer + sprintf(buffer, "<bytes");
+    for (int i = 0; i < length; i++)
+    {
+        unsigned char byte = bytes->data.bytes.data[i];
+        *out++ = ' ';
+        *out++ = hex[byte >> 4];
+        *out++ = hex[byte & 15];
+    }
+    *out++ = '>';
+    *out = '\0';
+    return buffer;
+}
+
+/* Acrescenta 'count' bytes de 'text' a 'buffer', que cresce se preciso */
+static void append_chars(char **buffer, size_t *length, size_t *capacity, const char *text, size_t count)
+{
+    if (*length + count + 1 > *capacity)
+    {
+        while (*length + count + 1 > *capacity)
+            *capacity *= 2;
+        *buffer = realloc(*buffer, *capacity);
+    }
+    memcpy(*buffer + *length, text, count);
+    *length += count;
+}
+
+/* Nome{campo: valor, ...}; strings entre aspas */
+static char *struct_to_string(Value *record)
+{
+    ASTNode *decl = record->data.record.decl;
+    size_t capacity = 64;
+    size_t length = 0;
+    char *buffer = malloc(capacity);
+
+    append_chars(&buffer, &length, &capacity, decl->data.struct_decl.name, strlen(decl->data.struct_decl.name));
+    append_chars(&buffer, &length, &capacity, "{", 1);
+
+    for (int i = 0; i < decl->data.struct_decl.field_count; i++)
+    {
+        ASTNode *field = decl->data.struct_decl.fields[i];
+        Value *item = record_load(record, field->data.param.offset, field->data.param.storage);
+        char *text = value_to_string(item);
+        int quoted = item && item->type == VAL_STRING;
+
+        if (i > 0)
+            append_chars(&buffer, &length, &capacity, ", ", 2);
+        append_chars(&buffer, &length, &capacity, field->data.param.name, strlen(field->data.param.name));
+        append_chars(&buffer, &length, &capacity, ": ", 2);
+        if (quoted)
+            append_chars(&buffer, &length, &capacity, "\"", 1);
+        append_chars(&buffer, &length, &capacity, text, strlen(text));
+        if (quoted)
+            append_chars(&buffer, &length, &capacity, "\"", 1);
+
+        free(text);
+        value_decref(item);
+    }
+
+    append_chars(&buffer, &length, &capacity, "}", 1);
+    buffer[length] = '\0';
+    return buffer;
+}
+
 char *value_to_string(Value *value)
 {
     if (value == NULL)
@@ -129,7 +567,7 @@ char *value_to_string(Value *value)
         break;
     case VAL_STRING:
         free(buffer);
-        return strdup(value->data.string_val);
+        return copy_chars(value->data.string.chars, value->data.string.length);
     case VAL_BOOL:
         snprintf(buffer, 256, "%s", value->data.bool_val ? "true" : "false");
         break;
@@ -142,6 +580,18 @@ char *value_to_string(Value *value)
     case VAL_BUILTIN_FN:
         snprintf(buffer, 256, "<builtin function %s>", value->data.builtin_fn.name);
         break;
+    case VAL_ARRAY:
+        free(buffer);
+        return array_to_string(value);
+    case VAL_MAP:
+        free(buffer);
+        return map_to_string(value);
+    case VAL_BYTES:
+        free(buffer);
+        return bytes_to_string(value);
+    case VAL_STRUCT:
+        free(buffer);
+        return struct_to_string(value);
     default:
         snprintf(buffer, 256, "<unknown>");
         break;
@@ -167,105 +617,373 @@ const char *value_type_to_string(ValueType type)
         return "null";
     case VAL_BUILTIN_FN:
         return "builtin_function";
+    case VAL_ARRAY:
+        return "array";
+    case VAL_MAP:
+        return "map";
+    case VAL_BYTES:
+        return "bytes";
+    case VAL_STRUCT:
+        return "struct";
     default:
         return "unknown";
     }
 }
 
-/* --- SISTEMA DE TABELA HASH --- */
+/* --- MAPS (ENDEREÇAMENTO ABERTO) --- */
 
-static unsigned int hash_function(const char *key, int capacity)
-{
-    unsigned int hash = 5381;
-    int c;
-    while ((c = *key++))
-    {
-        hash = ((hash << 5) + hash) + c;
-    }
-    return hash % capacity;
-}
+#define MAP_EMPTY_SLOT (-1)
+#define MAP_REMOVED_SLOT (-2)
+#define MAP_MIN_CAPACITY 8
 
-HashTable *hashtable_create(int capacity)
+/* Chave de busca: uma string pode ser fatia (sem '\0'), então leva o
+ * comprimento. Chaves guardadas nos pares são cópias terminadas em '\0'. */
+typedef struct
 {
-    HashTable *table = malloc(sizeof(HashTable));
-    table->capacity = capacity;
-    table->count = 0;
-    table->buckets = calloc(capacity, sizeof(HashEntry *));
-    return table;
-}
+    MapScalar scalar;
+    int length; // Só para chaves string
+} MapKey;
 
-void hashtable_destroy(HashTable *table)
+/* Hash da chave, nunca 0 (0 marca par removido) */
+static uint32_t map_hash_key(const Value *map, MapKey key)
 {
-    if (table == NULL)
-        return;
-
-    for (int i = 0; i < table->capacity; i++)
+    uint32_t hash;
+    if (map->data.map.key_type == TYPE_STRING)
     {
-        HashEntry *entry = table->buckets[i];
-        while (entry != NULL)
+        // FNV-1a
+        hash = 2166136261u;
+        const unsigned char *c = (const unsigned char *)key.scalar.string_val;
+        for (int i = 0; i < key.length; i++)
         {
-            HashEntry *next = entry->next;
-            free(entry->key);
-            value_decref(entry->value);
-            free(entry);
-            entry = next;
+            hash ^= c[i];
+            hash *= 16777619u;
         }
     }
-
-    free(table->buckets);
-    free(table);
+    else
+    {
+        // Finalizador do MurmurHash3: espalha inteiros sequenciais pela tabela
+        hash = (uint32_t)key.scalar.int_val;
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bu;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35u;
+        hash ^= hash >> 16;
+    }
+    return hash ? hash : 1;
 }
 
-void hashtable_set(HashTable *table, const char *key, Value *value)
+static MapKey map_key_of(const Value *map, const Value *key)
 {
-    unsigned int index = hash_function(key, table->capacity);
-    HashEntry *entry = table->buckets[index];
-
-    // Procurar entrada existente
-    while (entry != NULL)
+    MapKey map_key;
+    map_key.length = 0;
+    if (map->data.map.key_type == TYPE_STRING)
     {
-        if (strcmp(entry->key, key) == 0)
-        {
-            // Atualizar valor existente
-            value_decref(entry->value);
-            entry->value = value;
-            value_incref(value);
-            return;
-        }
-        entry = entry->next;
+        map_key.scalar.string_val = key->data.string.chars;
+        map_key.length = key->data.string.length;
     }
+    else
+        map_key.scalar.int_val = key->type == VAL_BOOL ? key->data.bool_val : key->data.int_val;
+    return map_key;
+}
 
-    // Criar nova entrada
-    HashEntry *new_entry = malloc(sizeof(HashEntry));
-    new_entry->key = strdup(key);
-    new_entry->value = value;
-    value_incref(value);
-    new_entry->next = table->buckets[index];
-    table->buckets[index] = new_entry;
-    table->count++;
+/* Compara a chave guardada num par com a chave de busca */
+static int map_keys_equal(const Value *map, MapScalar stored, MapKey key)
+{
+    if (map->data.map.key_type == TYPE_STRING)
+        return strncmp(stored.string_val, key.scalar.string_val, (size_t)key.length) == 0 &&
+               stored.string_val[key.length] == '\0';
+    return stored.int_val == key.scalar.int_val;
 }
 
-Value *hashtable_get(HashTable *table, const char *key)
+/* Posição em 'index' do par com essa chave, ou -1 */
+static int map_find(const Value *map, MapKey key, uint32_t hash)
 {
-    unsigned int index = hash_function(key, table->capacity);
-    HashEntry *entry = table->buckets[index];
+    if (map->data.map.capacity == 0)
+        return -1;
 
-    while (entry != NULL)
+    uint32_t mask = (uint32_t)map->data.map.capacity - 1;
+    for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask)
     {
-        if (strcmp(entry->key, key) == 0)
+        int32_t position = map->data.map.index[slot];
+        if (position == MAP_EMPTY_SLOT)
+            return -1;
+
+        if (position >= 0)
         {
-            return entry->value;
+            const MapEntry *entry = &map->data.map.entries[position];
+            if (entry->hash == hash && map_keys_equal(map, entry->key, key))
+                return (int)slot;
         }
-        entry = entry->next;
     }
-
-    return NULL;
 }
 
-int hashtable_has(HashTable *table, const char *key)
+/* Compacta os pares (descarta removidos) e reconstrói 'index' com
+ * 'capacity' posições; os pares cabem em 3/4 da capacidade */
+static void map_rebuild(Value *map, int capacity)
 {
-    return hashtable_get(table, key) != NULL;
-}
+    MapEntry *entries = map->data.map.entries;
+    int live = 0;
+    for (int i = 0; i < map->data.map.entry_count; i++)
+    {
+        if (entries[i].hash != 0)
+            entries[live++] = entries[i];
+    }
+
+    entries = realloc(entries, sizeof(MapEntry) * (size_t)(capacity / 4 * 3));
+    int32_t *index = realloc(map->data.map.index, sizeof(int32_t) * (size_t)capacity);
+    for (int i = 0; i < capacity; i++)
+        index[i] = MAP_EMPTY_SLOT;
+
+    uint32_t mask = (uint32_t)capacity - 1;
+    for (int i = 0; i < live; i++)
+    {
+        uint32_t slot = entries[i].hash & mask;
+        while (index[slot] != MAP_EMPTY_SLOT)
+            slot = (slot + 1) & mask;
+        index[slot] = i;
+    }
+
+    map->data.map.entries = entries;
+    map->data.map.index = index;
+    map->data.map.capacity = capacity;
+    map->data.map.entry_count = live;
+}
+
+static void map_store_value(Value *map, MapScalar *slot, const Value *value)
+{
+    switch (map->data.map.value_type)
+    {
+    case TYPE_FLOAT:
+        slot->float_val = value->type == VAL_INT ? (double)value->data.int_val : value->data.float_val;
+        break;
+    case TYPE_STRING:
+        slot->string_val = copy_chars(value->data.string.chars, value->data.string.length);
+        break;
+    case TYPE_BOOL:
+        slot->int_val = value->data.bool_val;
+        break;
+    default:
+        slot->int_val = value->data.int_val;
+        break;
+    }
+}
+
+static Value *map_scalar_to_value(DataType type, MapScalar scalar)
+{
+    switch (type)
+    {
+    case TYPE_FLOAT:
+        return value_create_float(scalar.float_val);
+    case TYPE_STRING:
+        return value_create_string(scalar.string_val);
+    case TYPE_BOOL:
+        return value_create_bool(scalar.int_val);
+    default:
+        return value_create_int(scalar.int_val);
+    }
+}
+
+/* Valor da chave (nova referência) ou NULL se ausente */
+static Value *map_get(Value *map, Value *key)
+{
+    MapKey map_key = map_key_of(map, key);
+    int slot = map_find(map, map_key, map_hash_key(map, map_key));
+    if (slot < 0)
+        return NULL;
+
+    const MapEntry *entry = &map->data.map.entries[map->data.map.index[slot]];
+    return map_scalar_to_value(map->data.map.value_type, entry->value);
+}
+
+static void map_set(Value *map, Value *key, Value *value)
+{
+    MapKey map_key = map_key_of(map, key);
+    uint32_t hash = map_hash_key(map, map_key);
+
+    int slot = map_find(map, map_key, hash);
+    if (slot >= 0)
+    {
+        MapEntry *entry = &map->data.map.entries[map->data.map.index[slot]];
+        if (map->data.map.value_type == TYPE_STRING)
+            free(entry->value.string_val);
+        map_store_value(map, &entry->value, value);
+        return;
+    }
+
+    // Sem espaço para mais um par: compacta e, se preciso, dobra a tabela
+    if ((map->data.map.entry_count + 1) * 4 > map->data.map.capacity * 3)
+    {
+        int capacity = MAP_MIN_CAPACITY;
+        while ((map->data.map.count + 1) * 2 > capacity)
+            capacity *= 2;
+        map_rebuild(map, capacity);
+    }
+
+    int position = map->data.map.entry_count++;
+    MapEntry *entry = &map->data.map.entries[position];
+    entry->hash = hash;
+    entry->key = map_key.scalar;
+    if (map->data.map.key_type == TYPE_STRING)
+        entry->key.string_val = copy_chars(map_key.scalar.string_val, map_key.length);
+    map_store_value(map, &entry->value, value);
+
+    // Primeira posição livre (vazia ou removida) da sequência de sondagem
+    uint32_t mask = (uint32_t)map->data.map.capacity - 1;
+    uint32_t free_slot = hash & mask;
+    while (map->data.map.index[free_slot] >= 0)
+        free_slot = (free_slot + 1) & mask;
+    map->data.map.index[free_slot] = position;
+    map->data.map.count++;
+}
+
+static int map_remove(Value *map, Value *key)
+{
+    MapKey map_key = map_key_of(map, key);
+    int slot = map_find(map, map_key, map_hash_key(map, map_key));
+    if (slot < 0)
+        return 0;
+
+    MapEntry *entry = &map->data.map.entries[map->data.map.index[slot]];
+    if (map->data.map.key_type == TYPE_STRING)
+        free(entry->key.string_val);
+    if (map->data.map.value_type == TYPE_STRING)
+        free(entry->value.string_val);
+    entry->hash = 0;
+
+    map->data.map.index[slot] = MAP_REMOVED_SLOT;
+    map->data.map.count--;
+    return 1;
+}
+
+/* Chaves (ou valores) em ordem de inserção, como array tipado */
+static Value *map_to_array(Value *map, int want_values)
+{
+    DataType type = want_values ? map->data.map.value_type : map->data.map.key_type;
+    Value *array = value_create_array(type, map->data.map.count);
+
+    int position = 0;
+    for (int i = 0; i < map->data.map.entry_count; i++)
+    {
+        const MapEntry *entry = &map->data.map.entries[i];
+        if (entry->hash == 0)
+            continue;
+
+        MapScalar scalar = want_values ? entry->value : entry->key;
+        switch (type)
+        {
+        case TYPE_FLOAT:
+            array->data.array.items.floats[position] = scalar.float_val;
+            break;
+        case TYPE_STRING:
+            free(array->data.array.items.strings[position]);
+            array->data.array.items.strings[position] = strdup(scalar.string_val);
+            break;
+        case TYPE_BOOL:
+            array->data.array.items.bools[position] = (unsigned char)scalar.int_val;
+            break;
+        default:
+            array->data.array.items.ints[position] = scalar.int_val;
+            break;
+        }
+        position++;
+    }
+    return array;
+}
+
+/* --- SISTEMA DE TABELA HASH --- */
+
+static unsigned int hash_function(const char *key, int capacity)
+{
+    unsigned int hash = 5381;
+    int c;
+    while ((c = *key++))
+    {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return hash % capacity;
+}
+
+HashTable *hashtable_create(int capacity)
+{
+    HashTable *table = malloc(sizeof(HashTable));
+    table->capacity = capacity;
+    table->count = 0;
+    table->buckets = calloc(capacity, sizeof(HashEntry *));
+    return table;
+}
+
+void hashtable_destroy(HashTable *table)
+{
+    if (table == NULL)
+        return;
+
+    for (int i = 0; i < table->capacity; i++)
+    {
+        HashEntry *entry = table->buckets[i];
+        while (entry != NULL)
+        {
+            HashEntry *next = entry->next;
+            free(entry->key);
+            value_decref(entry->value);
+            free(entry);
+            entry = next;
+        }
+    }
+
+    free(table->buckets);
+    free(table);
+}
+
+void hashtable_set(HashTable *table, const char *key, Value *value)
+{
+    unsigned int index = hash_function(key, table->capacity);
+    HashEntry *entry = table->buckets[index];
+
+    // Procurar entrada existente
+    while (entry != NULL)
+    {
+        if (strcmp(entry->key, key) == 0)
+        {
+            // Atualizar valor existente
+            value_decref(entry->value);
+            entry->value = value;
+            value_incref(value);
+            return;
+        }
+        entry = entry->next;
+    }
+
+    // Criar nova entrada
+    HashEntry *new_entry = malloc(sizeof(HashEntry));
+    new_entry->key = strdup(key);
+    new_entry->value = value;
+    value_incref(value);
+    new_entry->next = table->buckets[index];
+    table->buckets[index] = new_entry;
+    table->count++;
+}
+
+Value *hashtable_get(HashTable *table, const char *key)
+{
+    unsigned int index = hash_function(key, table->capacity);
+    HashEntry *entry = table->buckets[index];
+
+    while (entry != NULL)
+    {
+        if (strcmp(entry->key, key) == 0)
+        {
+            return entry->value;
+        }
+        entry = entry->next;
+    }
+
+    return NULL;
+}
+
+int hashtable_has(HashTable *table, const char *key)
+{
+    return hashtable_get(table, key) != NULL;
+}
 
 void hashtable_remove(HashTable *table, const char *key)
 {
@@ -506,9 +1224,17 @@ static Value *builtin_print(Interpreter *interpreter, Value **args, int arg_coun
 
     for (int i = 0; i < arg_count; i++)
     {
-        char *str = value_to_string(args[i]);
-        printf("%s", str);
-        free(str);
+        if (args[i]->type == VAL_STRING)
+        {
+            // Fatias não terminam em '\0': escreve pelo comprimento, sem cópia
+            fwrite(args[i]->data.string.chars, 1, (size_t)args[i]->data.string.length, stdout);
+        }
+        else
+        {
+            char *str = value_to_string(args[i]);
+            printf("%s", str);
+            free(str);
+        }
         if (i < arg_count - 1)
             printf(" ");
     }
@@ -524,26 +1250,707 @@ static Value *builtin_type(Interpreter *interpreter, Value **args, int arg_count
         return NULL;
     }
 
-    const char *type_name = value_type_to_string(args[0]->type);
-    return value_create_string(type_name);
+    if (args[0]->type == VAL_ARRAY)
+    {
+        // "int[]", "string[]"...
+        char type_name[32];
+        snprintf(type_name, sizeof(type_name), "%s[]",
+                 data_type_to_string(args[0]->data.array.element_type));
+        return value_create_string(type_name);
+    }
+
+    if (args[0]->type == VAL_MAP)
+    {
+        // "map<string, int>"
+        char type_name[48];
+        snprintf(type_name, sizeof(type_name), "map<%s, %s>",
+                 data_type_to_string(args[0]->data.map.key_type),
+                 data_type_to_string(args[0]->data.map.value_type));
+        return value_create_string(type_name);
+    }
+
+    if (args[0]->type == VAL_STRUCT)
+        return value_create_string(args[0]->data.record.decl->data.struct_decl.name);
+
+    const char *type_name = value_type_to_string(args[0]->type);
+    return value_create_string(type_name);
+}
+
+static Value *builtin_len(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (arg_count != 1)
+    {
+        runtime_error(interpreter, 0, 0, "função len() espera 1 argumento, obtido %d", arg_count);
+        return NULL;
+    }
+
+    if (args[0]->type == VAL_ARRAY)
+    {
+        return value_create_int(args[0]->data.array.length);
+    }
+
+    if (args[0]->type == VAL_MAP)
+    {
+        return value_create_int(args[0]->data.map.count);
+    }
+
+    if (args[0]->type == VAL_BYTES)
+    {
+        return value_create_int(args[0]->data.bytes.length);
+    }
+
+    if (args[0]->type != VAL_STRING)
+    {
+        runtime_error(interpreter, 0, 0, "função len() espera string, array, map ou bytes, obtido %s",
+                      value_type_to_string(args[0]->type));
+        return NULL;
+    }
+
+    return value_create_int(args[0]->data.string.length);
+}
+
+/* --- BUILT-INS VETORIAIS --- */
+/* sum/min/max/dot/scale/axpy/add/mul operam direto sobre o buffer contíguo de
+ * int[] e float[] pelos kernels de craze_vector.c (SIMD em float[]) */
+
+static int check_builtin_arity(Interpreter *interpreter, const char *name, int arg_count, int expected)
+{
+    if (arg_count == expected)
+        return 1;
+
+    runtime_error(interpreter, 0, 0, "função %s() espera %d argumento(s), obtido %d",
+                  name, expected, arg_count);
+    return 0;
+}
+
+/* Valida 'count' arrays numéricos a partir de args[first]: mesmo tipo de
+ * elemento e mesmo tamanho. O array vazio '[]' (void[]) assume o tipo dos
+ * demais; sozinho, vale como int[]. */
+static int check_vector_args(Interpreter *interpreter, const char *name, Value **args,
+                             int first, int count, DataType *element_type)
+{
+    *element_type = TYPE_VOID;
+    for (int i = first; i < first + count; i++)
+    {
+        if (args[i]->type != VAL_ARRAY ||
+            (args[i]->data.array.element_type != TYPE_INT &&
+             args[i]->data.array.element_type != TYPE_FLOAT &&
+             args[i]->data.array.element_type != TYPE_VOID))
+        {
+            runtime_error(interpreter, 0, 0, "função %s() espera int[] ou float[] no argumento %d",
+                          name, i + 1);
+            return 0;
+        }
+
+        DataType type = args[i]->data.array.element_type;
+        if (type != TYPE_VOID && *element_type != TYPE_VOID && type != *element_type)
+        {
+            runtime_error(interpreter, 0, 0, "função %s() espera arrays do mesmo tipo, obtido %s[] e %s[]",
+                          name, data_type_to_string(*element_type), data_type_to_string(type));
+            return 0;
+        }
+        if (type != TYPE_VOID)
+            *element_type = type;
+
+        if (args[i]->data.array.length != args[first]->data.array.length)
+        {
+            runtime_error(interpreter, 0, 0, "função %s() espera arrays do mesmo tamanho, obtido %d e %d",
+                          name, args[first]->data.array.length, args[i]->data.array.length);
+            return 0;
+        }
+    }
+
+    if (*element_type == TYPE_VOID)
+        *element_type = TYPE_INT;
+    return 1;
+}
+
+/* Escalar compatível com arrays de 'element_type' (int só converte para float) */
+static int check_vector_scalar(Interpreter *interpreter, const char *name, Value *scalar,
+                               DataType element_type, double *as_float, int *as_int)
+{
+    if (scalar->type == VAL_INT)
+    {
+        *as_int = scalar->data.int_val;
+        *as_float = (double)scalar->data.int_val;
+        return 1;
+    }
+    if (scalar->type == VAL_FLOAT && element_type == TYPE_FLOAT)
+    {
+        *as_float = scalar->data.float_val;
+        return 1;
+    }
+
+    runtime_error(interpreter, 0, 0, "função %s() espera escalar %s, obtido %s",
+                  name, data_type_to_string(element_type), value_type_to_string(scalar->type));
+    return 0;
+}
+
+static Value *builtin_sum(Interpreter *interpreter, Value **args, int arg_count)
+{
+    DataType type;
+    if (!check_builtin_arity(interpreter, "sum", arg_count, 1) ||
+        !check_vector_args(interpreter, "sum", args, 0, 1, &type))
+        return NULL;
+
+    int n = args[0]->data.array.length;
+    if (type == TYPE_FLOAT)
+        return value_create_float(vector_sum(args[0]->data.array.items.floats, n));
+    return value_create_int(vector_sum_int(args[0]->data.array.items.ints, n));
+}
+
+/* min() e max() compartilham validação; 'want_max' escolhe o kernel */
+static Value *vector_extreme(Interpreter *interpreter, const char *name, Value **args, int arg_count,
+                             int want_max)
+{
+    DataType type;
+    if (!check_builtin_arity(interpreter, name, arg_count, 1) ||
+        !check_vector_args(interpreter, name, args, 0, 1, &type))
+        return NULL;
+
+    int n = args[0]->data.array.length;
+    if (n == 0)
+    {
+        runtime_error(interpreter, 0, 0, "função %s() de array vazio", name);
+        return NULL;
+    }
+
+    if (type == TYPE_FLOAT)
+    {
+        const double *x = args[0]->data.array.items.floats;
+        return value_create_float(want_max ? vector_max(x, n) : vector_min(x, n));
+    }
+    const int *x = args[0]->data.array.items.ints;
+    return value_create_int(want_max ? vector_max_int(x, n) : vector_min_int(x, n));
+}
+
+static Value *builtin_min(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return vector_extreme(interpreter, "min", args, arg_count, 0);
+}
+
+static Value *builtin_max(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return vector_extreme(interpreter, "max", args, arg_count, 1);
+}
+
+static Value *builtin_dot(Interpreter *interpreter, Value **args, int arg_count)
+{
+    DataType type;
+    if (!check_builtin_arity(interpreter, "dot", arg_count, 2) ||
+        !check_vector_args(interpreter, "dot", args, 0, 2, &type))
+        return NULL;
+
+    int n = args[0]->data.array.length;
+    if (type == TYPE_FLOAT)
+        return value_create_float(vector_dot(args[0]->data.array.items.floats,
+                                             args[1]->data.array.items.floats, n));
+    return value_create_int(vector_dot_int(args[0]->data.array.items.ints,
+                                           args[1]->data.array.items.ints, n));
+}
+
+/* scale(v, k): v = k * v, no próprio array */
+static Value *builtin_scale(Interpreter *interpreter, Value **args, int arg_count)
+{
+    DataType type;
+    double alpha = 0.0;
+    int alpha_int = 0;
+    if (!check_builtin_arity(interpreter, "scale", arg_count, 2) ||
+        !check_vector_args(interpreter, "scale", args, 0, 1, &type) ||
+        !check_vector_scalar(interpreter, "scale", args[1], type, &alpha, &alpha_int))
+        return NULL;
+
+    int n = args[0]->data.array.length;
+    if (type == TYPE_FLOAT)
+        vector_scale(args[0]->data.array.items.floats, alpha, n);
+    else
+        vector_scale_int(args[0]->data.array.items.ints, alpha_int, n);
+    return value_create_void();
+}
+
+/* axpy(a, x, y): y = a * x + y, no próprio y */
+static Value *builtin_axpy(Interpreter *interpreter, Value **args, int arg_count)
+{
+    DataType type;
+    double alpha = 0.0;
+    int alpha_int = 0;
+    if (!check_builtin_arity(interpreter, "axpy", arg_count, 3) ||
+        !check_vector_args(interpreter, "axpy", args, 1, 2, &type) ||
+        !check_vector_scalar(interpreter, "axpy", args[0], type, &alpha, &alpha_int))
+        return NULL;
+
+    int n = args[1]->data.array.length;
+    if (type == TYPE_FLOAT)
+        vector_axpy(alpha, args[1]->data.array.items.floats, args[2]->data.array.items.floats, n);
+    else
+        vector_axpy_int(alpha_int, args[1]->data.array.items.ints, args[2]->data.array.items.ints, n);
+    return value_create_void();
+}
+
+/* add() e mul() elemento a elemento; o resultado é um array novo */
+static Value *vector_elementwise(Interpreter *interpreter, const char *name, Value **args, int arg_count,
+                                 int multiply)
+{
+    DataType type;
+    if (!check_builtin_arity(interpreter, name, arg_count, 2) ||
+        !check_vector_args(interpreter, name, args, 0, 2, &type))
+        return NULL;
+
+    int n = args[0]->data.array.length;
+    Value *result = value_create_array(type, n);
+    if (n == 0)
+        return result;
+
+    if (type == TYPE_FLOAT)
+    {
+        const double *x = args[0]->data.array.items.floats;
+        const double *y = args[1]->data.array.items.floats;
+        if (multiply)
+            vector_mul(x, y, result->data.array.items.floats, n);
+        else
+            vector_add(x, y, result->data.array.items.floats, n);
+    }
+    else
+    {
+        const int *x = args[0]->data.array.items.ints;
+        const int *y = args[1]->data.array.items.ints;
+        if (multiply)
+            vector_mul_int(x, y, result->data.array.items.ints, n);
+        else
+            vector_add_int(x, y, result->data.array.items.ints, n);
+    }
+    return result;
+}
+
+static Value *builtin_add(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return vector_elementwise(interpreter, "add", args, arg_count, 0);
+}
+
+static Value *builtin_mul(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return vector_elementwise(interpreter, "mul", args, arg_count, 1);
+}
+
+/* --- BUILT-INS DE MAP --- */
+/* Tipos do map, da chave e do valor já foram verificados pela análise
+ * semântica: só a quantidade de argumentos é conferida aqui */
+
+/* Chave ausente em get() ou em 'm[k]' */
+static void map_missing_key_error(Interpreter *interpreter, int line, int column, Value *key)
+{
+    char *text = value_to_string(key);
+    runtime_error(interpreter, line, column, "Chave %s%s%s não encontrada no map",
+                  key->type == VAL_STRING ? "\"" : "", text, key->type == VAL_STRING ? "\"" : "");
+    free(text);
+}
+
+static Value *builtin_get(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "get", arg_count, 2))
+        return NULL;
+
+    Value *value = map_get(args[0], args[1]);
+    if (!value)
+        map_missing_key_error(interpreter, 0, 0, args[1]);
+    return value;
+}
+
+static Value *builtin_set(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "set", arg_count, 3))
+        return NULL;
+
+    map_set(args[0], args[1], args[2]);
+    return value_create_void();
+}
+
+static Value *builtin_has(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "has", arg_count, 2))
+        return NULL;
+
+    MapKey key = map_key_of(args[0], args[1]);
+    return value_create_bool(map_find(args[0], key, map_hash_key(args[0], key)) >= 0);
+}
+
+static Value *builtin_remove(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "remove", arg_count, 2))
+        return NULL;
+
+    return value_create_bool(map_remove(args[0], args[1]));
+}
+
+static Value *builtin_keys(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "keys", arg_count, 1))
+        return NULL;
+
+    return map_to_array(args[0], 0);
+}
+
+static Value *builtin_values(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "values", arg_count, 1))
+        return NULL;
+
+    return map_to_array(args[0], 1);
+}
+
+/* --- BUILT-INS DE STRING --- */
+/* substr/find/starts_with trabalham sobre (ponteiro, comprimento) e substr
+ * devolve uma fatia que compartilha o buffer da original: percorrer um texto
+ * com find + substr é linear, sem cópias. Tipos já verificados pela análise
+ * semântica. */
+
+/* Posição da primeira ocorrência de 'needle' em 'text', ou -1. memchr (que a
+ * libc implementa com SIMD) salta direto para cada candidato ao primeiro
+ * caractere; só então o resto é comparado. */
+static int string_find(const char *text, int length, const char *needle, int needle_length)
+{
+    if (needle_length == 0)
+        return 0;
+    if (needle_length > length)
+        return -1;
+
+    const char *cursor = text;
+    const char *last = text + length - needle_length; // Último início possível
+    while (cursor <= last)
+    {
+        cursor = memchr(cursor, needle[0], (size_t)(last - cursor) + 1);
+        if (cursor == NULL)
+            return -1;
+        if (memcmp(cursor + 1, needle + 1, (size_t)needle_length - 1) == 0)
+            return (int)(cursor - text);
+        cursor++;
+    }
+    return -1;
+}
+
+/* substr(s, início, tamanho): fatia de s, sem cópia */
+static Value *builtin_substr(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "substr", arg_count, 3))
+        return NULL;
+
+    int length = args[0]->data.string.length;
+    int start = args[1]->data.int_val;
+    int count = args[2]->data.int_val;
+    if (start < 0 || count < 0 || start > length || count > length - start)
+    {
+        runtime_error(interpreter, 0, 0, "substr(): intervalo [%d, %d + %d) fora da string de tamanho %d",
+                      start, start, count, length);
+        return NULL;
+    }
+
+    return value_create_slice(args[0], start, count);
+}
+
+/* find(s, sub): posição da primeira ocorrência de sub em s, ou -1 */
+static Value *builtin_find(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "find", arg_count, 2))
+        return NULL;
+
+    return value_create_int(string_find(args[0]->data.string.chars, args[0]->data.string.length,
+                                        args[1]->data.string.chars, args[1]->data.string.length));
+}
+
+static Value *builtin_starts_with(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "starts_with", arg_count, 2))
+        return NULL;
+
+    int prefix_length = args[1]->data.string.length;
+    return value_create_bool(prefix_length <= args[0]->data.string.length &&
+                             memcmp(args[0]->data.string.chars, args[1]->data.string.chars,
+                                    (size_t)prefix_length) == 0);
+}
+
+/* split(s, sep): partes de s entre as ocorrências de sep, como string[] */
+static Value *builtin_split(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "split", arg_count, 2))
+        return NULL;
+
+    const char *text = args[0]->data.string.chars;
+    int length = args[0]->data.string.length;
+    const char *separator = args[1]->data.string.chars;
+    int separator_length = args[1]->data.string.length;
+    if (separator_length == 0)
+    {
+        runtime_error(interpreter, 0, 0, "split(): separador vazio");
+        return NULL;
+    }
+
+    // Primeira passada conta as partes para alocar o array de uma vez
+    int parts = 1;
+    for (int at = 0, found; (found = string_find(text + at, length - at, separator, separator_length)) >= 0;
+         at += found + separator_length)
+        parts++;
+
+    Value *array = value_create_array(TYPE_STRING, parts);
+    int at = 0;
+    for (int i = 0; i < parts; i++)
+    {
+        int found = string_find(text + at, length - at, separator, separator_length);
+        int piece = found >= 0 ? found : length - at;
+
+        free(array->data.array.items.strings[i]);
+        array->data.array.items.strings[i] = copy_chars(text + at, piece);
+        at += piece + separator_length;
+    }
+    return array;
+}
+
+/* --- BUILT-INS DE BYTES --- */
+/* bytes é um buffer binário mutável com tamanho explícito. slice() devolve
+ * uma fatia sem cópia que escreve no mesmo buffer; read_X e write_X acessam
+ * inteiros e floats little-endian num offset, com verificação de limites.
+ * Tipos já verificados pela análise semântica. */
+
+typedef enum
+{
+    BYTES_UINT,
+    BYTES_INT, // Com extensão de sinal
+    BYTES_FLOAT
+} BytesKind;
+
+/* Endereço de 'width' bytes em 'offset', ou NULL (erro) fora dos limites */
+static unsigned char *bytes_at(Interpreter *interpreter, const char *name, Value *bytes, int offset, int width)
+{
+    if (offset < 0 || width > bytes->data.bytes.length || offset > bytes->data.bytes.length - width)
+    {
+        runtime_error(interpreter, 0, 0, "%s(): offset %d fora dos limites (%d byte(s) em bytes de tamanho %d)",
+                      name, offset, width, bytes->data.bytes.length);
+        return NULL;
+    }
+    return bytes->data.bytes.data + offset;
+}
+
+/* Little-endian independente da CPU; o compilador reduz a uma só leitura */
+static uint64_t load_le(const unsigned char *p, int width)
+{
+    uint64_t bits = 0;
+    for (int i = width - 1; i >= 0; i--)
+        bits = (bits << 8) | p[i];
+    return bits;
+}
+
+static void store_le(unsigned char *p, uint64_t bits, int width)
+{
+    for (int i = 0; i < width; i++)
+    {
+        p[i] = (unsigned char)bits;
+        bits >>= 8;
+    }
+}
+
+/* read_*(b, offset). u32 acima de 2^31 - 1 dá a volta no int de 32 bits. */
+static Value *bytes_read(Interpreter *interpreter, const char *name, Value **args, int arg_count,
+                         int width, BytesKind kind)
+{
+    if (!check_builtin_arity(interpreter, name, arg_count, 2))
+        return NULL;
+
+    const unsigned char *p = bytes_at(interpreter, name, args[0], args[1]->data.int_val, width);
+    if (!p)
+        return NULL;
+
+    uint64_t bits = load_le(p, width);
+    switch (kind)
+    {
+    case BYTES_FLOAT:
+        if (width == 4)
+        {
+            uint32_t bits32 = (uint32_t)bits;
+            float value;
+            memcpy(&value, &bits32, sizeof(value));
+            return value_create_float(value);
+        }
+        else
+        {
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            return value_create_float(value);
+        }
+    case BYTES_INT:
+    {
+        int shift = 64 - width * 8;
+        return value_create_int((int)((int64_t)(bits << shift) >> shift));
+    }
+    default:
+        return value_create_int((int)(uint32_t)bits);
+    }
+}
+
+/* write_*(b, offset, valor): inteiros gravam os 'width' bytes baixos */
+static Value *bytes_write(Interpreter *interpreter, const char *name, Value **args, int arg_count,
+                          int width, BytesKind kind)
+{
+    if (!check_builtin_arity(interpreter, name, arg_count, 3))
+        return NULL;
+
+    unsigned char *p = bytes_at(interpreter, name, args[0], args[1]->data.int_val, width);
+    if (!p)
+        return NULL;
+
+    uint64_t bits;
+    if (kind == BYTES_FLOAT)
+    {
+        double value = args[2]->type == VAL_INT ? (double)args[2]->data.int_val : args[2]->data.float_val;
+        if (width == 4)
+        {
+            float narrow = (float)value;
+            uint32_t bits32;
+            memcpy(&bits32, &narrow, sizeof(bits32));
+            bits = bits32;
+        }
+        else
+        {
+            memcpy(&bits, &value, sizeof(bits));
+        }
+    }
+    else
+    {
+        bits = (uint32_t)args[2]->data.int_val;
+    }
+
+    store_le(p, bits, width);
+    return value_create_void();
+}
+
+static Value *builtin_read_u8(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_read(interpreter, "read_u8", args, arg_count, 1, BYTES_UINT);
+}
+
+static Value *builtin_read_u16(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_read(interpreter, "read_u16", args, arg_count, 2, BYTES_UINT);
+}
+
+static Value *builtin_read_i16(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_read(interpreter, "read_i16", args, arg_count, 2, BYTES_INT);
+}
+
+static Value *builtin_read_u32(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_read(interpreter, "read_u32", args, arg_count, 4, BYTES_UINT);
+}
+
+static Value *builtin_read_i32(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_read(interpreter, "read_i32", args, arg_count, 4, BYTES_INT);
+}
+
+static Value *builtin_read_f32(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_read(interpreter, "read_f32", args, arg_count, 4, BYTES_FLOAT);
+}
+
+static Value *builtin_read_f64(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_read(interpreter, "read_f64", args, arg_count, 8, BYTES_FLOAT);
+}
+
+static Value *builtin_write_u8(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_write(interpreter, "write_u8", args, arg_count, 1, BYTES_UINT);
+}
+
+static Value *builtin_write_u16(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_write(interpreter, "write_u16", args, arg_count, 2, BYTES_UINT);
+}
+
+static Value *builtin_write_u32(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_write(interpreter, "write_u32", args, arg_count, 4, BYTES_UINT);
+}
+
+static Value *builtin_write_f32(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_write(interpreter, "write_f32", args, arg_count, 4, BYTES_FLOAT);
+}
+
+static Value *builtin_write_f64(Interpreter *interpreter, Value **args, int arg_count)
+{
+    return bytes_write(interpreter, "write_f64", args, arg_count, 8, BYTES_FLOAT);
+}
+
+/* make_bytes(n): n bytes zerados */
+static Value *builtin_make_bytes(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "make_bytes", arg_count, 1))
+        return NULL;
+
+    if (args[0]->data.int_val < 0)
+    {
+        runtime_error(interpreter, 0, 0, "make_bytes(): tamanho negativo %d", args[0]->data.int_val);
+        return NULL;
+    }
+    return value_create_bytes(NULL, args[0]->data.int_val);
+}
+
+/* to_bytes(s): cópia dos bytes da string */
+static Value *builtin_to_bytes(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "to_bytes", arg_count, 1))
+        return NULL;
+
+    return value_create_bytes((const unsigned char *)args[0]->data.string.chars, args[0]->data.string.length);
+}
+
+/* read_string(b, offset, n): cópia de n bytes como string */
+static Value *builtin_read_string(Interpreter *interpreter, Value **args, int arg_count)
+{
+    if (!check_builtin_arity(interpreter, "read_string", arg_count, 3))
+        return NULL;
+
+    int count = args[2]->data.int_val;
+    if (count < 0)
+    {
+        runtime_error(interpreter, 0, 0, "read_string(): tamanho negativo %d", count);
+        return NULL;
+    }
+
+    const unsigned char *p = bytes_at(interpreter, "read_string", args[0], args[1]->data.int_val, count);
+    if (!p)
+        return NULL;
+
+    return value_create_string_n((const char *)p, count);
 }
 
-static Value *builtin_len(Interpreter *interpreter, Value **args, int arg_count)
+/* slice(b, offset, n): fatia sem cópia; segura uma referência ao dono do buffer */
+static Value *builtin_slice(Interpreter *interpreter, Value **args, int arg_count)
 {
-    if (arg_count != 1)
-    {
-        runtime_error(interpreter, 0, 0, "função len() espera 1 argumento, obtido %d", arg_count);
+    if (!check_builtin_arity(interpreter, "slice", arg_count, 3))
         return NULL;
-    }
 
-    if (args[0]->type != VAL_STRING)
+    Value *bytes = args[0];
+    int offset = args[1]->data.int_val;
+    int count = args[2]->data.int_val;
+    if (count < 0)
     {
-        runtime_error(interpreter, 0, 0, "função len() espera string, obtido %s",
-                      value_type_to_string(args[0]->type));
+        runtime_error(interpreter, 0, 0, "slice(): tamanho negativo %d", count);
         return NULL;
     }
+    if (!bytes_at(interpreter, "slice", bytes, offset, count))
+        return NULL;
 
-    return value_create_int((int)strlen(args[0]->data.string_val));
+    Value *owner = bytes->data.bytes.owner ? bytes->data.bytes.owner : bytes;
+    value_incref(owner);
+
+    Value *val = malloc(sizeof(Value));
+    val->type = VAL_BYTES;
+    val->data.bytes.data = bytes->data.bytes.data + offset;
+    val->data.bytes.length = count;
+    val->data.bytes.owner = owner;
+    val->ref_count = 1;
+    return val;
 }
 
 void register_builtin_functions(Interpreter *interpreter)
@@ -559,6 +1966,58 @@ void register_builtin_functions(Interpreter *interpreter)
     Value *len_fn = value_create_builtin(builtin_len, "len");
     environment_define_var(interpreter->global_env, "len", len_fn);
     value_decref(len_fn);
+
+    // Built-ins vetoriais, de map, de string e de bytes
+    static const struct
+    {
+        const char *name;
+        BuiltinFn function;
+    } table_builtins[] = {
+        {"sum", builtin_sum},
+        {"min", builtin_min},
+        {"max", builtin_max},
+        {"dot", builtin_dot},
+        {"scale", builtin_scale},
+        {"axpy", builtin_axpy},
+        {"add", builtin_add},
+        {"mul", builtin_mul},
+        // Built-ins de map
+        {"get", builtin_get},
+        {"set", builtin_set},
+        {"has", builtin_has},
+        {"remove", builtin_remove},
+        {"keys", builtin_keys},
+        {"values", builtin_values},
+        // Built-ins de string
+        {"substr", builtin_substr},
+        {"find", builtin_find},
+        {"starts_with", builtin_starts_with},
+        {"split", builtin_split},
+        // Built-ins de bytes
+        {"make_bytes", builtin_make_bytes},
+        {"to_bytes", builtin_to_bytes},
+        {"slice", builtin_slice},
+        {"read_string", builtin_read_string},
+        {"read_u8", builtin_read_u8},
+        {"read_u16", builtin_read_u16},
+        {"read_i16", builtin_read_i16},
+        {"read_u32", builtin_read_u32},
+        {"read_i32", builtin_read_i32},
+        {"read_f32", builtin_read_f32},
+        {"read_f64", builtin_read_f64},
+        {"write_u8", builtin_write_u8},
+        {"write_u16", builtin_write_u16},
+        {"write_u32", builtin_write_u32},
+        {"write_f32", builtin_write_f32},
+        {"write_f64", builtin_write_f64},
+    };
+
+    for (size_t i = 0; i < sizeof(table_builtins) / sizeof(table_builtins[0]); i++)
+    {
+        Value *fn = value_create_builtin(table_builtins[i].function, table_builtins[i].name);
+        environment_define_var(interpreter->global_env, table_builtins[i].name, fn);
+        value_decref(fn);
+    }
 }
 
 /* --- OPERAÇÕES ARITMÉTICAS E LÓGICAS --- */
@@ -581,13 +2040,13 @@ static Value *op_add(Interpreter *interpreter, Value *left, Value *right)
     // String + String
     else if (left->type == VAL_STRING && right->type == VAL_STRING)
     {
-        size_t len = strlen(left->data.string_val) + strlen(right->data.string_val) + 1;
-        char *result_str = malloc(len);
-        strcpy(result_str, left->data.string_val);
-        strcat(result_str, right->data.string_val);
-        Value *result = value_create_string(result_str);
-        free(result_str);
-        return result;
+        int left_length = left->data.string.length;
+        int right_length = right->data.string.length;
+        char *result_str = malloc((size_t)left_length + (size_t)right_length + 1);
+        memcpy(result_str, left->data.string.chars, (size_t)left_length);
+        memcpy(result_str + left_length, right->data.string.chars, (size_t)right_length);
+        result_str[left_length + right_length] = '\0';
+        return value_adopt_string(result_str, left_length + right_length);
     }
     else
     {
@@ -706,12 +2165,22 @@ static Value *op_compare_eq(Interpreter *interpreter, Value *left, Value *right)
         case VAL_FLOAT:
             return value_create_bool(fabs(left->data.float_val - right->data.float_val) < 1e-10);
         case VAL_STRING:
-            return value_create_bool(strcmp(left->data.string_val, right->data.string_val) == 0);
+            return value_create_bool(left->data.string.length == right->data.string.length &&
+                                     memcmp(left->data.string.chars, right->data.string.chars,
+                                            (size_t)left->data.string.length) == 0);
         case VAL_BOOL:
             return value_create_bool(left->data.bool_val == right->data.bool_val);
         case VAL_VOID:
         case VAL_NULL:
             return value_create_bool(1); // void == void, null == null
+        case VAL_BYTES:
+            return value_create_bool(left->data.bytes.length == right->data.bytes.length &&
+                                     memcmp(left->data.bytes.data, right->data.bytes.data,
+                                            (size_t)left->data.bytes.length) == 0);
+        case VAL_ARRAY:
+        case VAL_MAP:
+        case VAL_STRUCT:
+            return value_create_bool(left == right); // Arrays, maps e structs são referências
         default:
             return value_create_bool(0);
         }
@@ -834,9 +2303,14 @@ static Value *execute_statement(Interpreter *interpreter, ASTNode *node);
 static Value *execute_expression(Interpreter *interpreter, ASTNode *node);
 static Value *execute_variable_decl(Interpreter *interpreter, ASTNode *node);
 static Value *execute_function_decl(Interpreter *interpreter, ASTNode *node);
+static Value *execute_struct_decl(Interpreter *interpreter, ASTNode *node);
+static Value *execute_import(Interpreter *interpreter, ASTNode *node);
 static Value *execute_block(Interpreter *interpreter, ASTNode *node);
+static Value *execute_flat_block(Interpreter *interpreter, ASTNode *node);
 static Value *execute_if_statement(Interpreter *interpreter, ASTNode *node);
 static Value *execute_while_statement(Interpreter *interpreter, ASTNode *node);
+static Value *execute_for_statement(Interpreter *interpreter, ASTNode *node);
+static Value *execute_match_statement(Interpreter *interpreter, ASTNode *node);
 static Value *execute_return_statement(Interpreter *interpreter, ASTNode *node);
 static Value *execute_expression_statement(Interpreter *interpreter, ASTNode *node);
 static Value *execute_binary_expr(Interpreter *interpreter, ASTNode *node);
@@ -845,6 +2319,13 @@ static Value *execute_assignment(Interpreter *interpreter, ASTNode *node);
 static Value *execute_call_expr(Interpreter *interpreter, ASTNode *node);
 static Value *execute_variable_expr(Interpreter *interpreter, ASTNode *node);
 static Value *execute_literal_expr(Interpreter *interpreter, ASTNode *node);
+static Value *execute_array_literal(Interpreter *interpreter, ASTNode *node);
+static Value *execute_map_literal(Interpreter *interpreter, ASTNode *node);
+static Value *execute_index_expr(Interpreter *interpreter, ASTNode *node);
+static Value *execute_index_assign(Interpreter *interpreter, ASTNode *node);
+static Value *execute_struct_constructor(Interpreter *interpreter, ASTNode *node, ASTNode *decl);
+static Value *execute_field_expr(Interpreter *interpreter, ASTNode *node);
+static Value *execute_field_assign(Interpreter *interpreter, ASTNode *node);
 
 /* --- FUNÇÕES DE EXECUÇÃO PRINCIPAIS --- */
 
@@ -880,12 +2361,20 @@ static Value *execute_statement(Interpreter *interpreter, ASTNode *node)
         return execute_variable_decl(interpreter, node);
     case NODE_FUNC_DECL:
         return execute_function_decl(interpreter, node);
+    case NODE_STRUCT_DECL:
+        return execute_struct_decl(interpreter, node);
+    case NODE_IMPORT:
+        return execute_import(interpreter, node);
     case NODE_BLOCK:
         return execute_block(interpreter, node);
     case NODE_IF_STMT:
         return execute_if_statement(interpreter, node);
     case NODE_WHILE_STMT:
         return execute_while_statement(interpreter, node);
+    case NODE_FOR_STMT:
+        return execute_for_statement(interpreter, node);
+    case NODE_MATCH_STMT:
+        return execute_match_statement(interpreter, node);
     case NODE_RETURN_STMT:
         return execute_return_statement(interpreter, node);
     case NODE_EXPR_STMT:
@@ -961,6 +2450,203 @@ static Value *execute_function_decl(Interpreter *interpreter, ASTNode *node)
     return value_create_void();
 }
 
+static Value *execute_struct_decl(Interpreter *interpreter, ASTNode *node)
+{
+    // Structs ficam junto das funções: 'Nome(...)' é uma chamada ao construtor
+    environment_define_func(interpreter->current_env, node->data.struct_decl.name, node);
+
+    return value_create_void();
+}
+
+/* --- MÓDULOS --- */
+
+/* Interpretador que executou o nível superior de um módulo: seu ambiente
+ * global guarda os globais compartilhados com todos os que importam */
+typedef struct
+{
+    Interpreter interpreter;
+    int failed;
+} ModuleInstance;
+
+static void module_instance_free(void *instance)
+{
+    ModuleInstance *module_instance = instance;
+    interpreter_cleanup(&module_instance->interpreter);
+    free(module_instance);
+}
+
+/* Instancia o módulo na primeira vez que um import dele é executado */
+static ModuleInstance *module_instance_get(CrazeModule *module)
+{
+    module_lock();
+    ModuleInstance *instance = module->instance;
+    if (instance == NULL && (instance = malloc(sizeof(ModuleInstance))) != NULL)
+    {
+        // Imports do próprio módulo instanciam os deles aqui (a trava é recursiva)
+        interpreter_init(&instance->interpreter, module->program);
+        Value *result = execute_flat_block(&instance->interpreter, module->program);
+        if (result)
+            value_decref(result);
+
+        instance->failed = instance->interpreter.has_runtime_error;
+        module->instance = instance;
+        module->instance_free = module_instance_free;
+    }
+    module_unlock();
+    return instance;
+}
+
+/* Cópia profunda de um global da instância. Depois de pronta, a instância
+ * só é lida: nenhum importador altera os valores dela nem mexe na contagem
+ * de referências (que não é atômica) a partir de outra thread. */
+static Value *module_value_copy(const Value *value)
+{
+    switch (value->type)
+    {
+    case VAL_INT:
+        return value_create_int(value->data.int_val);
+    case VAL_FLOAT:
+        return value_create_float(value->data.float_val);
+    case VAL_BOOL:
+        return value_create_bool(value->data.bool_val);
+    case VAL_STRING:
+        return value_create_string_n(value->data.string.chars, value->data.string.length);
+    case VAL_BYTES:
+        return value_create_bytes(value->data.bytes.data, value->data.bytes.length);
+    case VAL_BUILTIN_FN:
+        return value_create_builtin(value->data.builtin_fn.function, value->data.builtin_fn.name);
+    case VAL_ARRAY:
+    {
+        int length = value->data.array.length;
+        Value *copy = value_create_array(value->data.array.element_type, length);
+        switch (length > 0 ? value->data.array.element_type : TYPE_VOID)
+        {
+        case TYPE_INT:
+            memcpy(copy->data.array.items.ints, value->data.array.items.ints, sizeof(int) * (size_t)length);
+            break;
+        case TYPE_FLOAT:
+            memcpy(copy->data.array.items.floats, value->data.array.items.floats, sizeof(double) * (size_t)length);
+            break;
+        case TYPE_BOOL:
+            memcpy(copy->data.array.items.bools, value->data.array.items.bools, (size_t)length);
+            break;
+        case TYPE_STRING:
+            for (int i = 0; i < length; i++)
+            {
+                free(copy->data.array.items.strings[i]);
+                copy->data.array.items.strings[i] = strdup(value->data.array.items.strings[i]);
+            }
+            break;
+        default:
+            break;
+        }
+        return copy;
+    }
+    case VAL_MAP:
+    {
+        Value *copy = value_create_map(value->data.map.key_type, value->data.map.value_type);
+        for (int i = 0; i < value->data.map.entry_count; i++)
+        {
+            const MapEntry *entry = &value->data.map.entries[i];
+            if (entry->hash == 0)
+                continue;
+
+            Value *key = map_scalar_to_value(value->data.map.key_type, entry->key);
+            Value *item = map_scalar_to_value(value->data.map.value_type, entry->value);
+            map_set(copy, key, item);
+            value_decref(key);
+            value_decref(item);
+        }
+        return copy;
+    }
+    case VAL_STRUCT:
+    {
+        ASTNode *decl = value->data.record.decl;
+        Value *copy = value_create_struct(decl);
+        memcpy(copy->data.record.fields, value->data.record.fields, (size_t)decl->data.struct_decl.size);
+        for (int i = 0; i < decl->data.struct_decl.field_count; i++)
+        {
+            ASTNode *field = decl->data.struct_decl.fields[i];
+            if (field->data.param.storage != FIELD_VALUE)
+                continue;
+
+            unsigned char *slot = copy->data.record.fields + field->data.param.offset;
+            Value *item;
+            memcpy(&item, slot, sizeof(Value *));
+            item = item ? module_value_copy(item) : NULL;
+            memcpy(slot, &item, sizeof(Value *));
+        }
+        return copy;
+    }
+    case VAL_VOID:
+        return value_create_void();
+    default:
+        return value_create_null();
+    }
+}
+
+/* Liga funções, structs e globais do módulo (e dos que ele importa, que as
+ * funções dele chamam) no ambiente atual. Cada importador recebe a sua cópia
+ * dos globais: o que ele alterar, por alias, built-in ou função do módulo,
+ * não chega à instância nem aos outros importadores. */
+static void bind_module_exports(Interpreter *interpreter, const CrazeModule *module)
+{
+    const ModuleInstance *instance = module->instance;
+    ASTNode *program = module->program;
+
+    for (int i = 0; i < program->data.block.stmt_count; i++)
+    {
+        ASTNode *stmt = program->data.block.statements[i];
+        switch (stmt->node_type)
+        {
+        case NODE_IMPORT:
+            bind_module_exports(interpreter, stmt->data.import_stmt.module);
+            break;
+        case NODE_FUNC_DECL:
+            environment_define_func(interpreter->current_env, stmt->data.func_decl.name, stmt);
+            break;
+        case NODE_STRUCT_DECL:
+            environment_define_func(interpreter->current_env, stmt->data.struct_decl.name, stmt);
+            break;
+        case NODE_VAR_DECL:
+        {
+            Value *value = hashtable_get(instance->interpreter.global_env->variables, stmt->data.var_decl.name);
+            if (value)
+            {
+                Value *copy = module_value_copy(value);
+                environment_define_var(interpreter->current_env, stmt->data.var_decl.name, copy);
+                value_decref(copy); // environment_define_var incrementa ref_count
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+static Value *execute_import(Interpreter *interpreter, ASTNode *node)
+{
+    CrazeModule *module = node->data.import_stmt.module;
+    if (module == NULL)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Módulo '%s' não carregado", node->data.import_stmt.path);
+        return NULL;
+    }
+
+    ModuleInstance *instance = module_instance_get(module);
+    if (instance == NULL || instance->failed)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Falha ao inicializar o módulo '%s'", node->data.import_stmt.path);
+        return NULL;
+    }
+
+    bind_module_exports(interpreter, module);
+    return value_create_void();
+}
+
 static Value *execute_block(Interpreter *interpreter, ASTNode *node)
 {
     // Criar novo ambiente para o bloco
@@ -1051,6 +2737,46 @@ static Value *execute_if_statement(Interpreter *interpreter, ASTNode *node)
     return result;
 }
 
+/* O braço vem da tabela montada pelo parser: índice direto, busca binária ou
+ * hash da string, sem comparar o valor com cada rótulo em sequência */
+static Value *execute_match_statement(Interpreter *interpreter, ASTNode *node)
+{
+    const MatchTable *table = node->data.match_stmt.table;
+    Value *subject = execute_expression(interpreter, node->data.match_stmt.subject);
+    if (interpreter->has_runtime_error)
+    {
+        if (subject)
+            value_decref(subject);
+        return NULL;
+    }
+
+    int arm;
+    if (table == NULL)
+        arm = -2;
+    else if (subject->type == VAL_INT)
+        arm = match_table_find_int(table, subject->data.int_val);
+    else if (subject->type == VAL_STRING)
+        arm = match_table_find_string(table, subject->data.string.chars, subject->data.string.length);
+    else
+        arm = -2;
+
+    if (arm == -2)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Valor do match deve ser int ou string, encontrado: %s",
+                      value_type_to_string(subject->type));
+        value_decref(subject);
+        return NULL;
+    }
+    value_decref(subject);
+
+    ASTNode *branch = arm >= 0 ? node->data.match_stmt.arms[arm]->data.match_arm.body
+                               : node->data.match_stmt.else_branch;
+    if (branch == NULL)
+        return value_create_void();
+    return execute_statement(interpreter, branch);
+}
+
 static Value *execute_while_statement(Interpreter *interpreter, ASTNode *node)
 {
     Value *result = value_create_void();
@@ -1068,26 +2794,203 @@ static Value *execute_while_statement(Interpreter *interpreter, ASTNode *node)
 
         if (condition->type != VAL_BOOL)
         {
-            runtime_error(interpreter, node->line, node->column,
-                          "Condição do while deve ser booleana, encontrado: %s",
-                          value_type_to_string(condition->type));
-            value_decref(condition);
-            value_decref(result);
-            return NULL;
+            runtime_error(interpreter, node->line, node->column,
+                          "Condição do while deve ser booleana, encontrado: %s",
+                          value_type_to_string(condition->type));
+            value_decref(condition);
+            value_decref(result);
+            return NULL;
+        }
+
+        // Se condição falsa, sair do loop
+        if (!condition->data.bool_val)
+        {
+            value_decref(condition);
+            break;
+        }
+        value_decref(condition);
+
+        // Executar corpo
+        Value *body_result = execute_statement(interpreter, node->data.while_stmt.body);
+
+        // Verificar controle de fluxo
+        if (interpreter->should_break)
+        {
+            interpreter->should_break = 0;
+            if (body_result)
+                value_decref(body_result);
+            break;
+        }
+
+        if (interpreter->should_continue)
+        {
+            interpreter->should_continue = 0;
+            if (body_result)
+                value_decref(body_result);
+            continue;
+        }
+
+        if (interpreter->should_return)
+        {
+            if (body_result)
+            {
+                value_decref(result);
+                result = body_result;
+            }
+            break;
+        }
+
+        // Atualizar resultado (última expressão no corpo)
+        if (body_result)
+        {
+            value_decref(result);
+            result = body_result;
+        }
+
+        if (interpreter->has_runtime_error)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+/* O bloco declara variáveis, funções ou structs diretamente (não em blocos internos)? */
+static int block_declares(ASTNode *block)
+{
+    for (int i = 0; i < block->data.block.stmt_count; i++)
+    {
+        NodeType type = block->data.block.statements[i]->node_type;
+        if (type == NODE_VAR_DECL || type == NODE_FUNC_DECL || type == NODE_STRUCT_DECL)
+            return 1;
+    }
+    return 0;
+}
+
+/* Executa as instruções de um bloco sem declarações no ambiente atual,
+ * poupando a criação do ambiente do bloco */
+static Value *execute_flat_block(Interpreter *interpreter, ASTNode *node)
+{
+    Value *result = value_create_void();
+
+    for (int i = 0; i < node->data.block.stmt_count; i++)
+    {
+        Value *stmt_result = execute_statement(interpreter, node->data.block.statements[i]);
+
+        if (interpreter->has_runtime_error)
+        {
+            value_decref(result);
+            if (stmt_result)
+                value_decref(stmt_result);
+            return NULL;
+        }
+
+        if (stmt_result)
+        {
+            value_decref(result);
+            result = stmt_result;
+        }
+
+        if (interpreter->should_return || interpreter->should_break || interpreter->should_continue)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+/* Avalia um limite ou o passo do for (uma única vez, antes do laço) */
+static int evaluate_for_bound(Interpreter *interpreter, ASTNode *node, ASTNode *bound,
+                              const char *what, int *out)
+{
+    Value *value = execute_expression(interpreter, bound);
+    if (interpreter->has_runtime_error)
+    {
+        if (value)
+            value_decref(value);
+        return 0;
+    }
+
+    if (value->type != VAL_INT)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "%s do for deve ser int, encontrado: %s",
+                      what, value_type_to_string(value->type));
+        value_decref(value);
+        return 0;
+    }
+
+    *out = value->data.int_val;
+    value_decref(value);
+    return 1;
+}
+
+/*
+ * for i in início..fim step passo: limites e passo são avaliados uma vez e o
+ * contador é um int de C (long long, para o incremento não estourar perto de
+ * INT_MAX). A variável do laço é definida uma única vez num ambiente próprio
+ * e atualizada no lugar a cada iteração -- sem Value novo, comparação via
+ * double nem busca na hashtable. Só quando o corpo guardou uma referência ao
+ * Value (ex.: let x: int = i;) ele é trocado por um novo. Um corpo sem
+ * declarações roda direto no ambiente do laço.
+ */
+static Value *execute_for_statement(Interpreter *interpreter, ASTNode *node)
+{
+    int start, end, step = 1;
+    if (!evaluate_for_bound(interpreter, node, node->data.for_stmt.start, "Início do intervalo", &start) ||
+        !evaluate_for_bound(interpreter, node, node->data.for_stmt.end, "Fim do intervalo", &end))
+        return NULL;
+
+    if (node->data.for_stmt.step)
+    {
+        if (!evaluate_for_bound(interpreter, node, node->data.for_stmt.step, "Passo", &step))
+            return NULL;
+        if (step == 0)
+        {
+            runtime_error(interpreter, node->line, node->column, "Passo do for não pode ser zero");
+            return NULL;
+        }
+    }
+
+    Environment *loop_env = environment_create(interpreter->current_env);
+    Environment *previous_env = interpreter->current_env;
+    interpreter->current_env = loop_env;
+
+    const char *var_name = node->data.for_stmt.var_name;
+    Value *counter = value_create_int(start);
+    environment_define_var(loop_env, var_name, counter); // ref_count == 2: ambiente + laço
+
+    // Corpo sem declarações próprias não precisa de um ambiente por iteração
+    ASTNode *body = node->data.for_stmt.body;
+    int flat_body = body->node_type == NODE_BLOCK && !block_declares(body);
+
+    Value *result = value_create_void();
+
+    for (long long i = start; step > 0 ? i < end : i > end; i += step)
+    {
+        if (counter->ref_count != 2)
+        {
+            // O corpo reteve o Value anterior: não pode ser alterado no lugar
+            value_decref(counter);
+            counter = value_create_int((int)i);
+            environment_define_var(loop_env, var_name, counter);
         }
+        counter->data.int_val = (int)i;
 
-        // Se condição falsa, sair do loop
-        if (!condition->data.bool_val)
+        Value *body_result = flat_body ? execute_flat_block(interpreter, body)
+                                       : execute_statement(interpreter, body);
+
+        if (interpreter->has_runtime_error)
         {
-            value_decref(condition);
+            if (body_result)
+                value_decref(body_result);
+            value_decref(result);
+            result = NULL;
             break;
         }
-        value_decref(condition);
 
-        // Executar corpo
-        Value *body_result = execute_statement(interpreter, node->data.while_stmt.body);
-
-        // Verificar controle de fluxo
         if (interpreter->should_break)
         {
             interpreter->should_break = 0;
@@ -1104,29 +3007,22 @@ static Value *execute_while_statement(Interpreter *interpreter, ASTNode *node)
             continue;
         }
 
-        if (interpreter->should_return)
-        {
-            if (body_result)
-            {
-                value_decref(result);
-                result = body_result;
-            }
-            break;
-        }
-
-        // Atualizar resultado (última expressão no corpo)
         if (body_result)
         {
             value_decref(result);
             result = body_result;
         }
 
-        if (interpreter->has_runtime_error)
+        if (interpreter->should_return)
         {
             break;
         }
     }
 
+    value_decref(counter);
+    interpreter->current_env = previous_env;
+    environment_destroy(loop_env);
+
     return result;
 }
 
@@ -1188,6 +3084,18 @@ static Value *execute_expression(Interpreter *interpreter, ASTNode *node)
         return execute_variable_expr(interpreter, node);
     case NODE_LITERAL:
         return execute_literal_expr(interpreter, node);
+    case NODE_ARRAY_LITERAL:
+        return execute_array_literal(interpreter, node);
+    case NODE_MAP_LITERAL:
+        return execute_map_literal(interpreter, node);
+    case NODE_INDEX_EXPR:
+        return execute_index_expr(interpreter, node);
+    case NODE_INDEX_ASSIGN:
+        return execute_index_assign(interpreter, node);
+    case NODE_FIELD_EXPR:
+        return execute_field_expr(interpreter, node);
+    case NODE_FIELD_ASSIGN:
+        return execute_field_assign(interpreter, node);
     default:
         runtime_error(interpreter, node->line, node->column,
                       "Tipo de expressão não implementado: %s",
@@ -1196,8 +3104,54 @@ static Value *execute_expression(Interpreter *interpreter, ASTNode *node)
     }
 }
 
+/* Avalia um operando de '&&'/'||' em 'truth'; 0 em erro */
+static int execute_logical_operand(Interpreter *interpreter, ASTNode *node, ASTNode *operand, int *truth)
+{
+    Value *value = execute_expression(interpreter, operand);
+    if (interpreter->has_runtime_error)
+    {
+        if (value)
+            value_decref(value);
+        return 0;
+    }
+
+    if (value->type != VAL_BOOL)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Operação '%s' não suportada para tipo %s",
+                      node->data.binary_expr.operator == TOKEN_AND_AND ? "&&" : "||",
+                      value_type_to_string(value->type));
+        value_decref(value);
+        return 0;
+    }
+
+    *truth = value->data.bool_val;
+    value_decref(value);
+    return 1;
+}
+
+/* '&&' e '||' em curto-circuito: o lado direito só é avaliado se o esquerdo
+ * não decidir o resultado */
+static Value *execute_logical_expr(Interpreter *interpreter, ASTNode *node)
+{
+    int truth;
+    if (!execute_logical_operand(interpreter, node, node->data.binary_expr.left, &truth))
+        return NULL;
+
+    // false && x == false; true || x == true
+    int decided = node->data.binary_expr.operator == TOKEN_AND_AND ? !truth : truth;
+    if (!decided && !execute_logical_operand(interpreter, node, node->data.binary_expr.right, &truth))
+        return NULL;
+
+    return value_create_bool(truth);
+}
+
 static Value *execute_binary_expr(Interpreter *interpreter, ASTNode *node)
 {
+    TokenType op = node->data.binary_expr.operator;
+    if (op == TOKEN_AND_AND || op == TOKEN_PIPE_PIPE)
+        return execute_logical_expr(interpreter, node);
+
     Value *left = execute_expression(interpreter, node->data.binary_expr.left);
     if (interpreter->has_runtime_error)
     {
@@ -1216,7 +3170,6 @@ static Value *execute_binary_expr(Interpreter *interpreter, ASTNode *node)
     }
 
     Value *result = NULL;
-    TokenType op = node->data.binary_expr.operator;
 
     switch (op)
     {
@@ -1232,7 +3185,9 @@ static Value *execute_binary_expr(Interpreter *interpreter, ASTNode *node)
     case TOKEN_SLASH:
         result = op_divide(interpreter, left, right);
         break;
-    // TOKEN_PERCENT não implementado no lexer
+    case TOKEN_PERCENT:
+        result = op_modulo(interpreter, left, right);
+        break;
     case TOKEN_EQUAL_EQUAL:
         result = op_compare_eq(interpreter, left, right);
         break;
@@ -1277,7 +3232,9 @@ static Value *execute_unary_expr(Interpreter *interpreter, ASTNode *node)
 
     switch (op)
     {
-    // TOKEN_BANG não implementado no lexer
+    case TOKEN_BANG:
+        result = op_logical_not(interpreter, operand);
+        break;
     case TOKEN_MINUS:
         if (operand->type == VAL_INT)
         {
@@ -1332,8 +3289,12 @@ static Value *execute_call_expr(Interpreter *interpreter, ASTNode *node)
 {
     const char *func_name = node->data.call_expr.function_name;
 
+    // Funções e structs do usuário têm precedência sobre os built-ins de mesmo
+    // nome, como na análise semântica (o escopo do programa esconde o global)
+    ASTNode *function_node = environment_get_func(interpreter->current_env, func_name);
+
     // Verificar se é função built-in
-    Value *builtin = environment_get_var(interpreter->current_env, func_name);
+    Value *builtin = function_node ? NULL : environment_get_var(interpreter->current_env, func_name);
     if (builtin && builtin->type == VAL_BUILTIN_FN)
     {
         // Preparar argumentos
@@ -1373,8 +3334,6 @@ static Value *execute_call_expr(Interpreter *interpreter, ASTNode *node)
         return result;
     }
 
-    // Buscar função definida pelo usuário
-    ASTNode *function_node = environment_get_func(interpreter->current_env, func_name);
     if (!function_node)
     {
         runtime_error(interpreter, node->line, node->column,
@@ -1382,6 +3341,11 @@ static Value *execute_call_expr(Interpreter *interpreter, ASTNode *node)
         return NULL;
     }
 
+    if (function_node->node_type == NODE_STRUCT_DECL)
+    {
+        return execute_struct_constructor(interpreter, node, function_node);
+    }
+
     // Verificar número de argumentos
     if (node->data.call_expr.arg_count != function_node->data.func_decl.param_count)
     {
@@ -1499,6 +3463,380 @@ static Value *execute_literal_expr(Interpreter *interpreter, ASTNode *node)
     }
 }
 
+/* --- ARRAYS TIPADOS --- */
+
+/* Tipo de elemento que guarda um valor (TYPE_INVALID se não pode ser elemento) */
+static DataType array_element_type_of(Value *value)
+{
+    switch (value->type)
+    {
+    case VAL_INT:
+        return TYPE_INT;
+    case VAL_FLOAT:
+        return TYPE_FLOAT;
+    case VAL_STRING:
+        return TYPE_STRING;
+    case VAL_BOOL:
+        return TYPE_BOOL;
+    default:
+        return TYPE_INVALID;
+    }
+}
+
+/* Grava 'value' na posição 'index' (já validada); int é convertido para float */
+static int array_store(Value *array, int index, Value *value)
+{
+    switch (array->data.array.element_type)
+    {
+    case TYPE_INT:
+        if (value->type != VAL_INT)
+            return 0;
+        array->data.array.items.ints[index] = value->data.int_val;
+        return 1;
+    case TYPE_FLOAT:
+        if (value->type == VAL_FLOAT)
+            array->data.array.items.floats[index] = value->data.float_val;
+        else if (value->type == VAL_INT)
+            array->data.array.items.floats[index] = (double)value->data.int_val;
+        else
+            return 0;
+        return 1;
+    case TYPE_BOOL:
+        if (value->type != VAL_BOOL)
+            return 0;
+        array->data.array.items.bools[index] = (unsigned char)value->data.bool_val;
+        return 1;
+    case TYPE_STRING:
+        if (value->type != VAL_STRING)
+            return 0;
+        free(array->data.array.items.strings[index]);
+        array->data.array.items.strings[index] = copy_chars(value->data.string.chars, value->data.string.length);
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static Value *array_load(Value *array, int index)
+{
+    switch (array->data.array.element_type)
+    {
+    case TYPE_INT:
+        return value_create_int(array->data.array.items.ints[index]);
+    case TYPE_FLOAT:
+        return value_create_float(array->data.array.items.floats[index]);
+    case TYPE_BOOL:
+        return value_create_bool(array->data.array.items.bools[index]);
+    default:
+        return value_create_string(array->data.array.items.strings[index]);
+    }
+}
+
+static Value *execute_array_literal(Interpreter *interpreter, ASTNode *node)
+{
+    int count = node->data.array_literal.element_count;
+    Value **items = count > 0 ? malloc(sizeof(Value *) * count) : NULL;
+
+    // Avaliar os elementos; uma mistura de int e float gera float[]
+    DataType element_type = TYPE_VOID;
+    for (int i = 0; i < count; i++)
+    {
+        items[i] = execute_expression(interpreter, node->data.array_literal.elements[i]);
+        if (interpreter->has_runtime_error)
+        {
+            for (int j = 0; j <= i; j++)
+            {
+                if (items[j])
+                    value_decref(items[j]);
+            }
+            free(items);
+            return NULL;
+        }
+
+        DataType item_type = array_element_type_of(items[i]);
+        if (i == 0 || item_type == element_type)
+            element_type = item_type;
+        else if ((item_type == TYPE_FLOAT || item_type == TYPE_INT) &&
+                 (element_type == TYPE_FLOAT || element_type == TYPE_INT))
+            element_type = TYPE_FLOAT;
+        else
+            element_type = TYPE_INVALID;
+    }
+
+    Value *array = NULL;
+    if (element_type == TYPE_INVALID)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Elementos do array com tipos incompatíveis");
+    }
+    else
+    {
+        array = value_create_array(element_type, count);
+        for (int i = 0; i < count; i++)
+        {
+            array_store(array, i, items[i]);
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        value_decref(items[i]);
+    }
+    free(items);
+    return array;
+}
+
+/* Avalia alvo e índice de 'a[i]' ou 'm[k]'. Retorna o alvo (com referência)
+ * ou NULL após um erro runtime. Para arrays, '*index' recebe o índice já
+ * validado; para maps, '*key' recebe a chave (com referência). */
+static Value *evaluate_index_target(Interpreter *interpreter, ASTNode *node,
+                                    ASTNode *array_node, ASTNode *index_node, int *index, Value **key)
+{
+    *key = NULL;
+
+    Value *array = execute_expression(interpreter, array_node);
+    if (interpreter->has_runtime_error)
+    {
+        if (array)
+            value_decref(array);
+        return NULL;
+    }
+
+    Value *index_value = execute_expression(interpreter, index_node);
+    if (interpreter->has_runtime_error)
+    {
+        value_decref(array);
+        if (index_value)
+            value_decref(index_value);
+        return NULL;
+    }
+
+    if (array->type == VAL_MAP)
+    {
+        // Tipo da chave garantido pela análise semântica
+        *key = index_value;
+        return array;
+    }
+
+    if (array->type != VAL_ARRAY)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Indexação requer um array ou map, obtido %s", value_type_to_string(array->type));
+    }
+    else if (index_value->type != VAL_INT)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Índice de array deve ser int, obtido %s", value_type_to_string(index_value->type));
+    }
+    else if ((unsigned)index_value->data.int_val >= (unsigned)array->data.array.length)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Índice %d fora dos limites do array (tamanho %d)",
+                      index_value->data.int_val, array->data.array.length);
+    }
+    else
+    {
+        *index = index_value->data.int_val;
+        value_decref(index_value);
+        return array;
+    }
+
+    value_decref(array);
+    value_decref(index_value);
+    return NULL;
+}
+
+static Value *execute_index_expr(Interpreter *interpreter, ASTNode *node)
+{
+    int index;
+    Value *key;
+    Value *array = evaluate_index_target(interpreter, node, node->data.index_expr.array,
+                                         node->data.index_expr.index, &index, &key);
+    if (!array)
+        return NULL;
+
+    Value *result;
+    if (key)
+    {
+        result = map_get(array, key);
+        if (!result)
+            map_missing_key_error(interpreter, node->line, node->column, key);
+        value_decref(key);
+    }
+    else
+    {
+        result = array_load(array, index);
+    }
+
+    value_decref(array);
+    return result;
+}
+
+static Value *execute_index_assign(Interpreter *interpreter, ASTNode *node)
+{
+    int index;
+    Value *key;
+    Value *array = evaluate_index_target(interpreter, node, node->data.index_assign.array,
+                                         node->data.index_assign.index, &index, &key);
+    if (!array)
+        return NULL;
+
+    Value *value = execute_expression(interpreter, node->data.index_assign.value);
+    if (interpreter->has_runtime_error)
+    {
+        value_decref(array);
+        if (key)
+            value_decref(key);
+        if (value)
+            value_decref(value);
+        return NULL;
+    }
+
+    if (key)
+    {
+        map_set(array, key, value);
+        value_decref(key);
+    }
+    else if (!array_store(array, index, value))
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Tipo incompatível na atribuição: elemento %s, valor %s",
+                      data_type_to_string(array->data.array.element_type),
+                      value_type_to_string(value->type));
+        value_decref(value);
+        value = NULL;
+    }
+
+    value_decref(array);
+
+    // Retornar o valor atribuído
+    return value;
+}
+
+/* --- STRUCTS --- */
+
+/* Nome(a, b, ...): um registro com os argumentos nos campos, em ordem */
+static Value *execute_struct_constructor(Interpreter *interpreter, ASTNode *node, ASTNode *decl)
+{
+    if (node->data.call_expr.arg_count != decl->data.struct_decl.field_count)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Número incorreto de argumentos para '%s': esperado %d, obtido %d",
+                      decl->data.struct_decl.name, decl->data.struct_decl.field_count,
+                      node->data.call_expr.arg_count);
+        return NULL;
+    }
+
+    Value *record = value_create_struct(decl);
+    for (int i = 0; i < decl->data.struct_decl.field_count; i++)
+    {
+        Value *value = execute_expression(interpreter, node->data.call_expr.arguments[i]);
+        if (interpreter->has_runtime_error)
+        {
+            if (value)
+                value_decref(value);
+            value_decref(record);
+            return NULL;
+        }
+
+        ASTNode *field = decl->data.struct_decl.fields[i];
+        record_store(record, field->data.param.offset, field->data.param.storage, value);
+        value_decref(value);
+    }
+
+    return record;
+}
+
+/* Avalia o objeto de 'r.campo' (NULL em caso de erro) */
+static Value *evaluate_field_object(Interpreter *interpreter, ASTNode *node)
+{
+    Value *object = execute_expression(interpreter, node->data.field_expr.object);
+    if (interpreter->has_runtime_error)
+    {
+        if (object)
+            value_decref(object);
+        return NULL;
+    }
+
+    if (!object || object->type != VAL_STRUCT)
+    {
+        runtime_error(interpreter, node->line, node->column,
+                      "Acesso ao campo '%s' requer um struct, encontrado %s",
+                      node->data.field_expr.field_name,
+                      object ? value_type_to_string(object->type) : "null");
+        if (object)
+            value_decref(object);
+        return NULL;
+    }
+
+    return object;
+}
+
+static Value *execute_field_expr(Interpreter *interpreter, ASTNode *node)
+{
+    Value *object = evaluate_field_object(interpreter, node);
+    if (!object)
+        return NULL;
+
+    Value *result = record_load(object, node->data.field_expr.offset, node->data.field_expr.storage);
+    value_decref(object);
+    return result;
+}
+
+static Value *execute_field_assign(Interpreter *interpreter, ASTNode *node)
+{
+    Value *object = evaluate_field_object(interpreter, node);
+    if (!object)
+        return NULL;
+
+    Value *value = execute_expression(interpreter, node->data.field_expr.value);
+    if (interpreter->has_runtime_error)
+    {
+        value_decref(object);
+        if (value)
+            value_decref(value);
+        return NULL;
+    }
+
+    record_store(object, node->data.field_expr.offset, node->data.field_expr.storage, value);
+    value_decref(object);
+
+    // Retornar o valor atribuído
+    return value;
+}
+
+/* --- MAPS --- */
+
+/* {k: v, ...}: os tipos da chave e do valor vêm da análise semântica */
+static Value *execute_map_literal(Interpreter *interpreter, ASTNode *node)
+{
+    Value *map = value_create_map(node->data.map_literal.key_type, node->data.map_literal.value_type);
+
+    for (int i = 0; i < node->data.map_literal.entry_count; i++)
+    {
+        Value *key = execute_expression(interpreter, node->data.map_literal.items[2 * i]);
+        Value *value = NULL;
+        if (!interpreter->has_runtime_error)
+            value = execute_expression(interpreter, node->data.map_literal.items[2 * i + 1]);
+
+        if (interpreter->has_runtime_error)
+        {
+            if (key)
+                value_decref(key);
+            if (value)
+                value_decref(value);
+            value_decref(map);
+            return NULL;
+        }
+
+        map_set(map, key, value);
+        value_decref(key);
+        value_decref(value);
+    }
+
+    return map;
+}
+
 /* --- FUNÇÕES PÚBLICAS PRINCIPAIS --- */
 
 void interpreter_init(Interpreter *interpreter, ASTNode *ast)
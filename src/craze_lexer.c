@@ -2,10 +2,71 @@
 
 /* --- FUNÇÕES INTERNAS/HELPERS --- */
 
+#ifndef LEXER_STREAM_CHUNK
+#define LEXER_STREAM_CHUNK 65536 // Tamanho do bloco lido por refill no modo streaming
+#endif
+
+/* Modo streaming: descarta o que já foi consumido antes do token atual e lê
+ * mais um bloco da entrada. Retorna 1 se novos bytes ficaram disponíveis. */
+static int refill(Lexer *lexer)
+{
+    if (lexer->read_fn == NULL || lexer->stream_eof)
+        return 0;
+
+    // Preservar o token em andamento (start..end) no início do buffer
+    size_t keep = (size_t)(lexer->end - lexer->start);
+    size_t consumed = (size_t)(lexer->current - lexer->start);
+
+    if (keep + LEXER_STREAM_CHUNK > lexer->stream_capacity)
+    {
+        size_t capacity = lexer->stream_capacity == 0 ? LEXER_STREAM_CHUNK * 2 : lexer->stream_capacity * 2;
+        while (keep + LEXER_STREAM_CHUNK > capacity)
+            capacity *= 2;
+
+        char *buffer = malloc(capacity);
+        if (buffer == NULL)
+        {
+            lexer->stream_eof = 1;
+            return 0;
+        }
+        if (keep > 0)
+            memcpy(buffer, lexer->start, keep);
+        free(lexer->stream_buffer);
+        lexer->stream_buffer = buffer;
+        lexer->stream_capacity = capacity;
+    }
+    else if (keep > 0)
+    {
+        memmove(lexer->stream_buffer, lexer->start, keep);
+    }
+
+    size_t bytes = lexer->read_fn(lexer->read_context, lexer->stream_buffer + keep,
+                                  lexer->stream_capacity - keep);
+    if (bytes == 0)
+        lexer->stream_eof = 1;
+
+    lexer->source = lexer->stream_buffer;
+    lexer->start = lexer->stream_buffer;
+    lexer->current = lexer->stream_buffer + consumed;
+    lexer->end = lexer->stream_buffer + keep + bytes;
+    return bytes > 0;
+}
+
+/* Garante 'count' bytes disponíveis a partir da posição atual */
+static int ensure_available(Lexer *lexer, size_t count)
+{
+    while ((size_t)(lexer->end - lexer->current) < count)
+    {
+        if (!refill(lexer))
+            return 0;
+    }
+    return 1;
+}
+
 /* Verifica fim do arquivo */
 static int is_at_end(Lexer *lexer)
 {
-    return *lexer->current == '\0';
+    return lexer->current >= lexer->end && !ensure_available(lexer, 1);
 }
 
 /* Avança e retorna char anterior */
@@ -18,13 +79,15 @@ static char advance(Lexer *lexer)
 /* Olha o próximo char sem consumir */
 static char peek(Lexer *lexer)
 {
+    if (is_at_end(lexer))
+        return '\0';
     return *lexer->current;
 }
 
 /* Olha dois chars à frente */
 static char peek_next(Lexer *lexer)
 {
-    if (is_at_end(lexer))
+    if (lexer->current + 1 >= lexer->end && !ensure_available(lexer, 2))
         return '\0';
     return lexer->current[1];
 }
@@ -41,52 +104,58 @@ static int match(Lexer *lexer, char expected)
     return 1;
 }
 
-/* Cria token do tipo especificado */
+/* Cria token bruto do tipo especificado: o lexeme aponta para o fonte
+ * (sem cópia e sem '\0' final) e só é válido até o próximo refill */
 static Token make_token(Lexer *lexer, TokenType type)
 {
     Token token;
     token.type = type;
+    token.lexeme = (char *)lexer->start;
     token.length = (int)(lexer->current - lexer->start);
-    token.lexeme = malloc(token.length + 1);
-    if (token.lexeme == NULL)
-    {
-        // Erro de alocação de memória
-        token.type = TOKEN_ERROR;
-        token.lexeme = malloc(20);
-        strcpy(token.lexeme, "Erro de memória");
-        token.length = strlen(token.lexeme);
-    }
-    else
-    {
-        memcpy(token.lexeme, lexer->start, token.length);
-        token.lexeme[token.length] = '\0';
-    }
     token.line = lexer->line;
     token.column = lexer->column - token.length;
     return token;
 }
 
-/* Cria token de erro */
+/* Cria token de erro bruto: o lexeme aponta para a mensagem estática */
 static Token error_token(Lexer *lexer, const char *message)
 {
     Token token;
     token.type = TOKEN_ERROR;
-    token.length = strlen(message);
-    token.lexeme = malloc(token.length + 1);
-    if (token.lexeme != NULL)
-    {
-        strcpy(token.lexeme, message);
-    }
+    token.lexeme = (char *)message;
+    token.length = (int)strlen(message);
     token.line = lexer->line;
     token.column = lexer->column;
     return token;
 }
 
+/* Copia o lexeme de um token bruto para memória própria, terminada em '\0' */
+static Token own_token(Token token)
+{
+    char *lexeme = malloc(token.length + 1);
+    if (lexeme == NULL)
+    {
+        // Erro de alocação de memória
+        token.type = TOKEN_ERROR;
+        token.lexeme = malloc(20);
+        strcpy(token.lexeme, "Erro de memória");
+        token.length = strlen(token.lexeme);
+        return token;
+    }
+
+    memcpy(lexeme, token.lexeme, token.length);
+    lexeme[token.length] = '\0';
+    token.lexeme = lexeme;
+    return token;
+}
+
 /* Pula espaços em branco e comentários */
 static void skip_whitespace_and_comments(Lexer *lexer)
 {
     for (;;)
     {
+        // Nada antes daqui precisa ser preservado num refill do modo streaming
+        lexer->start = lexer->current;
         char c = peek(lexer);
         switch (c)
         {
@@ -113,74 +182,142 @@ static void skip_whitespace_and_comments(Lexer *lexer)
     }
 }
 
-/* Funções de checagem de caracteres */
+/* --- CLASSIFICAÇÃO DE CARACTERES --- */
+
+/* Classes de caractere (bits combináveis) */
+#define CHAR_ALPHA 0x01 /* a-z, A-Z, _ */
+#define CHAR_DIGIT 0x02 /* 0-9 */
+
+#define A CHAR_ALPHA
+#define D CHAR_DIGIT
+
+/* Tabela de 256 entradas indexada pelo byte: uma leitura por classificação */
+static const unsigned char char_class[256] = {
+    /* 0x00 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x10 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x20 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x30 */ D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, 0, 0,
+    /* 0x40 */ 0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,
+    /* 0x50 */ A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, A,
+    /* 0x60 */ 0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,
+    /* 0x70 */ A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, 0,
+    /* 0x80-0xFF: bytes não-ASCII não fazem parte de identificadores */
+};
+
+#undef A
+#undef D
+
 static int is_alpha(char c)
 {
-    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    return char_class[(unsigned char)c] & CHAR_ALPHA;
 }
 
 static int is_digit(char c)
 {
-    return c >= '0' && c <= '9';
+    return char_class[(unsigned char)c] & CHAR_DIGIT;
 }
 
 static int is_alphanumeric(char c)
 {
-    return is_alpha(c) || is_digit(c);
+    return char_class[(unsigned char)c] & (CHAR_ALPHA | CHAR_DIGIT);
 }
 
-/* Verificar se é palavra-chave */
+/* --- PALAVRAS-CHAVE (HASH PERFEITO) --- */
+
+/*
+ * Hash perfeito sobre as palavras-chave: combina primeiro caractere,
+ * último caractere e comprimento. As constantes foram escolhidas por busca
+ * exaustiva de modo que nenhuma palavra-chave colida; ao adicionar uma nova
+ * palavra-chave, refaça a busca e reposicione as entradas da tabela.
+ */
+#define KEYWORD_HASH_SIZE 64
+#define KEYWORD_HASH(first, last, length) \
+    ((2u * (unsigned)(first) + 25u * (unsigned)(last) + (unsigned)(length)) & (KEYWORD_HASH_SIZE - 1))
+
+typedef struct
+{
+    const char *text;
+    int length;
+    TokenType type;
+} KeywordEntry;
+
+/* Entradas vazias têm length == 0 e nunca casam */
+static const KeywordEntry keyword_table[KEYWORD_HASH_SIZE] = {
+    /*  0 */ {"struct", 6, TOKEN_STRUCT},
+    /*  1 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /*  2 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /*  3 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /*  4 */ {"bytes", 5, TOKEN_BYTES},
+    /*  5 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /*  6 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /*  7 */ {"match", 5, TOKEN_MATCH},
+    /*  8 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /*  9 */ {"true", 4, TOKEN_TRUE},
+    /* 10 */ {"if", 2, TOKEN_IF},
+    /* 11 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 12 */ {"fn", 2, TOKEN_FN},
+    /* 13 */ {"map", 3, TOKEN_MAP},
+    /* 14 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 15 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 16 */ {"while", 5, TOKEN_WHILE},
+    /* 17 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 18 */ {"in", 2, TOKEN_IN},
+    /* 19 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 20 */ {"bool", 4, TOKEN_BOOL},
+    /* 21 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 22 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 23 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 24 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 25 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 26 */ {"step", 4, TOKEN_STEP},
+    /* 27 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 28 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 29 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 30 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 31 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 32 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 33 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 34 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 35 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 36 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 37 */ {"float", 5, TOKEN_FLOAT},
+    /* 38 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 39 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 40 */ {"return", 6, TOKEN_RETURN},
+    /* 41 */ {"int", 3, TOKEN_INT},
+    /* 42 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 43 */ {"else", 4, TOKEN_ELSE},
+    /* 44 */ {"import", 6, TOKEN_IMPORT},
+    /* 45 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 46 */ {"false", 5, TOKEN_FALSE},
+    /* 47 */ {"let", 3, TOKEN_LET},
+    /* 48 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 49 */ {"for", 3, TOKEN_FOR},
+    /* 50 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 51 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 52 */ {"void", 4, TOKEN_VOID},
+    /* 53 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 54 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 55 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 56 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 57 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 58 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 59 */ {"string", 6, TOKEN_STRING},
+    /* 60 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 61 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 62 */ {NULL, 0, TOKEN_IDENTIFIER},
+    /* 63 */ {NULL, 0, TOKEN_IDENTIFIER},
+};
+
+/* Verificar se é palavra-chave: um hash e uma comparação */
 static TokenType check_keyword(const char *lexeme, int length)
 {
-    switch (lexeme[0])
-    {
-    case 'b':
-        if (length == 4 && memcmp(lexeme, "bool", 4) == 0)
-            return TOKEN_BOOL;
-        break;
-    case 'e':
-        if (length == 4 && memcmp(lexeme, "else", 4) == 0)
-            return TOKEN_ELSE;
-        break;
-    case 'f':
-        if (length == 2 && memcmp(lexeme, "fn", 2) == 0)
-            return TOKEN_FN;
-        if (length == 5 && memcmp(lexeme, "false", 5) == 0)
-            return TOKEN_FALSE;
-        if (length == 5 && memcmp(lexeme, "float", 5) == 0)
-            return TOKEN_FLOAT;
-        break;
-    case 'i':
-        if (length == 2 && memcmp(lexeme, "if", 2) == 0)
-            return TOKEN_IF;
-        if (length == 3 && memcmp(lexeme, "int", 3) == 0)
-            return TOKEN_INT;
-        break;
-    case 'l':
-        if (length == 3 && memcmp(lexeme, "let", 3) == 0)
-            return TOKEN_LET;
-        break;
-    case 'r':
-        if (length == 6 && memcmp(lexeme, "return", 6) == 0)
-            return TOKEN_RETURN;
-        break;
-    case 's':
-        if (length == 6 && memcmp(lexeme, "string", 6) == 0)
-            return TOKEN_STRING;
-        break;
-    case 't':
-        if (length == 4 && memcmp(lexeme, "true", 4) == 0)
-            return TOKEN_TRUE;
-        break;
-    case 'v':
-        if (length == 4 && memcmp(lexeme, "void", 4) == 0)
-            return TOKEN_VOID;
-        break;
-    case 'w':
-        if (length == 5 && memcmp(lexeme, "while", 5) == 0)
-            return TOKEN_WHILE;
-        break;
-    }
+    const KeywordEntry *entry =
+        &keyword_table[KEYWORD_HASH((unsigned char)lexeme[0], (unsigned char)lexeme[length - 1], length)];
+
+    if (entry->length == length && memcmp(lexeme, entry->text, length) == 0)
+        return entry->type;
+
     return TOKEN_IDENTIFIER;
 }
 
@@ -245,23 +382,48 @@ static Token string(Lexer *lexer)
 
 /* Inicializa o lexer com o código fonte */
 void lexer_init(Lexer *lexer, const char *source)
+{
+    lexer_init_span(lexer, source, strlen(source));
+}
+
+/* Inicializa o lexer sobre um trecho (ponteiro, tamanho) */
+void lexer_init_span(Lexer *lexer, const char *source, size_t length)
 {
     lexer->source = source;
     lexer->start = source;
     lexer->current = source;
+    lexer->end = source + length;
     lexer->line = 1;
     lexer->column = 1;
     lexer->error_msg[0] = '\0';
+
+    lexer->read_fn = NULL;
+    lexer->read_context = NULL;
+    lexer->stream_buffer = NULL;
+    lexer->stream_capacity = 0;
+    lexer->stream_eof = 1;
+}
+
+/* Inicializa o lexer em modo streaming */
+void lexer_init_stream(Lexer *lexer, LexerReadFn read_fn, void *context)
+{
+    lexer_init_span(lexer, "", 0);
+    lexer->read_fn = read_fn;
+    lexer->read_context = context;
+    lexer->stream_eof = 0;
 }
 
 /* Libera recursos do lexer */
 void lexer_cleanup(Lexer *lexer)
 {
-    // Não há recursos específicos do lexer para liberar
     // Os tokens individuais devem ser liberados pelo usuário
+    free(lexer->stream_buffer);
+    lexer->stream_buffer = NULL;
+    lexer->stream_capacity = 0;
     lexer->source = NULL;
     lexer->start = NULL;
     lexer->current = NULL;
+    lexer->end = NULL;
 }
 
 /* Libera recursos de um token */
@@ -274,8 +436,8 @@ void token_free(Token *token)
     }
 }
 
-/* Obtém próximo token - função principal */
-Token lexer_next_token(Lexer *lexer)
+/* Reconhece o próximo token sem copiar o lexeme */
+static Token scan_token(Lexer *lexer)
 {
     skip_whitespace_and_comments(lexer);
     lexer->start = lexer->current;
@@ -316,12 +478,22 @@ Token lexer_next_token(Lexer *lexer)
         return make_token(lexer, TOKEN_LEFT_BRACE);
     case '}':
         return make_token(lexer, TOKEN_RIGHT_BRACE);
+    case '[':
+        return make_token(lexer, TOKEN_LEFT_BRACKET);
+    case ']':
+        return make_token(lexer, TOKEN_RIGHT_BRACKET);
     case ':':
         return make_token(lexer, TOKEN_COLON);
     case ',':
         return make_token(lexer, TOKEN_COMMA);
     case ';':
         return make_token(lexer, TOKEN_SEMICOLON);
+    case '.':
+        if (match(lexer, '.'))
+        {
+            return make_token(lexer, TOKEN_DOT_DOT);
+        }
+        return make_token(lexer, TOKEN_DOT);
     case '+':
         return make_token(lexer, TOKEN_PLUS);
     case '-':
@@ -330,6 +502,8 @@ Token lexer_next_token(Lexer *lexer)
         return make_token(lexer, TOKEN_STAR);
     case '/':
         return make_token(lexer, TOKEN_SLASH);
+    case '%':
+        return make_token(lexer, TOKEN_PERCENT);
 
     // Operadores de 1-2 caracteres
     case '=':
@@ -337,13 +511,29 @@ Token lexer_next_token(Lexer *lexer)
         {
             return make_token(lexer, TOKEN_EQUAL_EQUAL);
         }
+        if (match(lexer, '>'))
+        {
+            return make_token(lexer, TOKEN_ARROW);
+        }
         return make_token(lexer, TOKEN_EQUAL);
     case '!':
         if (match(lexer, '='))
         {
             return make_token(lexer, TOKEN_BANG_EQUAL);
         }
-        return error_token(lexer, "Caractere '!' inesperado");
+        return make_token(lexer, TOKEN_BANG);
+    case '&':
+        if (match(lexer, '&'))
+        {
+            return make_token(lexer, TOKEN_AND_AND);
+        }
+        return error_token(lexer, "Caractere '&' inesperado (use '&&')");
+    case '|':
+        if (match(lexer, '|'))
+        {
+            return make_token(lexer, TOKEN_PIPE_PIPE);
+        }
+        return error_token(lexer, "Caractere '|' inesperado (use '||')");
     case '>':
         if (match(lexer, '='))
         {
@@ -361,6 +551,208 @@ Token lexer_next_token(Lexer *lexer)
     return error_token(lexer, "Caractere inesperado");
 }
 
+/* Obtém próximo token - função principal */
+Token lexer_next_token(Lexer *lexer)
+{
+    return own_token(scan_token(lexer));
+}
+
+/* --- BUFFER DE TOKENS (STRUCTURE-OF-ARRAYS) --- */
+
+/* Garante espaço para mais um token nos arrays paralelos */
+static int token_buffer_reserve(TokenBuffer *buffer)
+{
+    if (buffer->count < buffer->capacity)
+        return 1;
+
+    int capacity = buffer->capacity == 0 ? 1024 : buffer->capacity * 2;
+
+    unsigned char *types = realloc(buffer->types, sizeof(unsigned char) * capacity);
+    if (types)
+        buffer->types = types;
+    unsigned int *offsets = realloc(buffer->offsets, sizeof(unsigned int) * capacity);
+    if (offsets)
+        buffer->offsets = offsets;
+    int *lengths = realloc(buffer->lengths, sizeof(int) * capacity);
+    if (lengths)
+        buffer->lengths = lengths;
+    int *lines = realloc(buffer->lines, sizeof(int) * capacity);
+    if (lines)
+        buffer->lines = lines;
+    int *columns = realloc(buffer->columns, sizeof(int) * capacity);
+    if (columns)
+        buffer->columns = columns;
+
+    if (!types || !offsets || !lengths || !lines || !columns)
+        return 0;
+
+    buffer->capacity = capacity;
+    return 1;
+}
+
+/* Registra a mensagem de um token de erro e retorna seu índice */
+static unsigned int token_buffer_add_error(TokenBuffer *buffer, const char *message)
+{
+    if (buffer->error_count >= buffer->error_capacity)
+    {
+        int capacity = buffer->error_capacity == 0 ? 8 : buffer->error_capacity * 2;
+        const char **messages = realloc(buffer->error_messages, sizeof(const char *) * capacity);
+        if (messages == NULL)
+            return 0;
+        buffer->error_messages = messages;
+        buffer->error_capacity = capacity;
+    }
+
+    buffer->error_messages[buffer->error_count] = message;
+    return (unsigned int)buffer->error_count++;
+}
+
+/* Registra o início de uma declaração de nível superior */
+static int token_buffer_add_decl(TokenBuffer *buffer, int index)
+{
+    if (buffer->decl_count >= buffer->decl_capacity)
+    {
+        int capacity = buffer->decl_capacity == 0 ? 64 : buffer->decl_capacity * 2;
+        int *starts = realloc(buffer->decl_starts, sizeof(int) * capacity);
+        if (starts == NULL)
+            return 0;
+        buffer->decl_starts = starts;
+        buffer->decl_capacity = capacity;
+    }
+
+    buffer->decl_starts[buffer->decl_count++] = index;
+    return 1;
+}
+
+void token_buffer_init(TokenBuffer *buffer)
+{
+    buffer->source = NULL;
+    buffer->types = NULL;
+    buffer->offsets = NULL;
+    buffer->lengths = NULL;
+    buffer->lines = NULL;
+    buffer->columns = NULL;
+    buffer->count = 0;
+    buffer->capacity = 0;
+    buffer->error_messages = NULL;
+    buffer->error_count = 0;
+    buffer->error_capacity = 0;
+    buffer->decl_starts = NULL;
+    buffer->decl_count = 0;
+    buffer->decl_capacity = 0;
+}
+
+/* Tokeniza até o fim da entrada ou até o primeiro token que comece em
+ * 'limit' bytes ou além (substituído por TOKEN_EOF na mesma posição) */
+static int token_buffer_scan(TokenBuffer *buffer, Lexer *lexer, size_t limit)
+{
+    // Offsets são relativos ao fonte: exige o fonte inteiro em memória
+    if (lexer->read_fn != NULL)
+        return 0;
+
+    buffer->source = lexer->source;
+
+    // Pré-varredura de fronteiras: 'fn'/'let' fora de qualquer bloco e logo após
+    // o fim de uma instrução iniciam uma declaração independente
+    int depth = 0;
+    TokenType last = TOKEN_SEMICOLON;
+
+    for (;;)
+    {
+        Token token = scan_token(lexer);
+
+        if (token.type != TOKEN_EOF && (size_t)(lexer->start - lexer->source) >= limit)
+        {
+            token.type = TOKEN_EOF;
+            token.lexeme = (char *)lexer->start;
+            token.length = 0;
+        }
+
+        if (!token_buffer_reserve(buffer))
+            return 0;
+
+        int i = buffer->count++;
+
+        if (token.type == TOKEN_LEFT_BRACE)
+        {
+            depth++;
+        }
+        else if (token.type == TOKEN_RIGHT_BRACE)
+        {
+            if (depth > 0)
+                depth--;
+        }
+        else if ((token.type == TOKEN_FN || token.type == TOKEN_LET || token.type == TOKEN_STRUCT ||
+                  token.type == TOKEN_IMPORT) && depth == 0 &&
+                 (last == TOKEN_SEMICOLON || last == TOKEN_RIGHT_BRACE))
+        {
+            if (!token_buffer_add_decl(buffer, i))
+                return 0;
+        }
+        last = token.type;
+
+        buffer->types[i] = (unsigned char)token.type;
+        buffer->lengths[i] = token.length;
+        buffer->lines[i] = token.line;
+        buffer->columns[i] = token.column;
+
+        if (token.type == TOKEN_ERROR)
+        {
+            buffer->offsets[i] = token_buffer_add_error(buffer, token.lexeme);
+        }
+        else
+        {
+            buffer->offsets[i] = (unsigned int)(token.lexeme - buffer->source);
+        }
+
+        if (token.type == TOKEN_EOF)
+            return 1;
+    }
+}
+
+int token_buffer_fill(TokenBuffer *buffer, Lexer *lexer)
+{
+    return token_buffer_scan(buffer, lexer, (size_t)-1);
+}
+
+int token_buffer_fill_until(TokenBuffer *buffer, Lexer *lexer, size_t limit)
+{
+    return token_buffer_scan(buffer, lexer, limit);
+}
+
+Token token_buffer_get(const TokenBuffer *buffer, int index)
+{
+    Token token;
+
+    // Índices além do fim repetem o TOKEN_EOF final
+    if (index >= buffer->count)
+        index = buffer->count - 1;
+
+    token.type = (TokenType)buffer->types[index];
+    token.length = buffer->lengths[index];
+    token.line = buffer->lines[index];
+    token.column = buffer->columns[index];
+
+    if (token.type == TOKEN_ERROR)
+        token.lexeme = (char *)buffer->error_messages[buffer->offsets[index]];
+    else
+        token.lexeme = (char *)buffer->source + buffer->offsets[index];
+
+    return token;
+}
+
+void token_buffer_free(TokenBuffer *buffer)
+{
+    free(buffer->types);
+    free(buffer->offsets);
+    free(buffer->lengths);
+    free(buffer->lines);
+    free(buffer->columns);
+    free(buffer->error_messages);
+    free(buffer->decl_starts);
+    token_buffer_init(buffer);
+}
+
 /* Função utilitária para debug - converte tipo p/ string */
 const char *token_type_to_string(TokenType type)
 {
@@ -393,6 +785,22 @@ const char *token_type_to_string(TokenType type)
         return "TOKEN_STRING";
     case TOKEN_BOOL:
         return "TOKEN_BOOL";
+    case TOKEN_MAP:
+        return "TOKEN_MAP";
+    case TOKEN_BYTES:
+        return "TOKEN_BYTES";
+    case TOKEN_FOR:
+        return "TOKEN_FOR";
+    case TOKEN_IN:
+        return "TOKEN_IN";
+    case TOKEN_STEP:
+        return "TOKEN_STEP";
+    case TOKEN_STRUCT:
+        return "TOKEN_STRUCT";
+    case TOKEN_IMPORT:
+        return "TOKEN_IMPORT";
+    case TOKEN_MATCH:
+        return "TOKEN_MATCH";
 
     // Identificadores e literais
     case TOKEN_IDENTIFIER:
@@ -413,6 +821,8 @@ const char *token_type_to_string(TokenType type)
         return "TOKEN_STAR";
     case TOKEN_SLASH:
         return "TOKEN_SLASH";
+    case TOKEN_PERCENT:
+        return "TOKEN_PERCENT";
     case TOKEN_EQUAL:
         return "TOKEN_EQUAL";
     case TOKEN_EQUAL_EQUAL:
@@ -427,6 +837,14 @@ const char *token_type_to_string(TokenType type)
         return "TOKEN_GREATER_EQUAL";
     case TOKEN_LESS_EQUAL:
         return "TOKEN_LESS_EQUAL";
+    case TOKEN_BANG:
+        return "TOKEN_BANG";
+    case TOKEN_AND_AND:
+        return "TOKEN_AND_AND";
+    case TOKEN_PIPE_PIPE:
+        return "TOKEN_PIPE_PIPE";
+    case TOKEN_ARROW:
+        return "TOKEN_ARROW";
 
     // Delimitadores
     case TOKEN_LEFT_PAREN:
@@ -437,12 +855,20 @@ const char *token_type_to_string(TokenType type)
         return "TOKEN_LEFT_BRACE";
     case TOKEN_RIGHT_BRACE:
         return "TOKEN_RIGHT_BRACE";
+    case TOKEN_LEFT_BRACKET:
+        return "TOKEN_LEFT_BRACKET";
+    case TOKEN_RIGHT_BRACKET:
+        return "TOKEN_RIGHT_BRACKET";
     case TOKEN_COLON:
         return "TOKEN_COLON";
     case TOKEN_COMMA:
         return "TOKEN_COMMA";
     case TOKEN_SEMICOLON:
         return "TOKEN_SEMICOLON";
+    case TOKEN_DOT:
+        return "TOKEN_DOT";
+    case TOKEN_DOT_DOT:
+        return "TOKEN_DOT_DOT";
 
     // Controle
     case TOKEN_EOF:
@@ -1,40 +1,105 @@
 #include "../include/craze_interpreter.h"
+#include "../include/craze_cache.h"
+#include "../include/craze_module.h"
+#include "../include/craze_source.h"
 #include <stdio.h>
 #include <stdlib.h>
 
-// Função para ler arquivo completo
-char *read_file(const char *filename)
+// Executa um programa já validado
+static int run_program(ASTNode *program)
 {
-    FILE *file = fopen(filename, "rb"); // IMPORTANTE: Modo BINÁRIO para evitar conversão CRLF
-    if (!file)
+    Interpreter interpreter;
+    interpreter_init(&interpreter, program);
+    int result = interpreter_execute(&interpreter);
+    interpreter_cleanup(&interpreter);
+    return result ? 0 : 1;
+}
+
+// Pipeline completo: Parser → Semantic → Interpreter (parser já inicializado).
+// Com 'cache', o programa validado é gravado para as próximas execuções.
+// Com CRAZE_FUSED definido, cada declaração é verificada assim que o parser a
+// reduz, sem uma segunda passada sobre a árvore (partida mais rápida).
+// Imports relativos partem do diretório de 'path' (NULL = diretório atual).
+static int run_pipeline(Parser *parser, const CacheKey *cache, const char *path)
+{
+    SemanticAnalyzer analyzer;
+
+    // A AST inteira vive numa arena e é liberada de uma só vez
+    AstArena arena;
+    ast_arena_init(&arena);
+    parser->arena = &arena;
+
+    int fused = getenv("CRAZE_FUSED") != NULL;
+    if (fused)
     {
-        fprintf(stderr, "Erro: Não foi possível abrir o arquivo '%s'\n", filename);
-        return NULL;
+        semantic_init(&analyzer, NULL);
+        analyzer.source_path = path;
+        semantic_attach_parser(&analyzer, parser);
     }
 
-    // Descobrir tamanho do arquivo
-    fseek(file, 0, SEEK_END);
-    long length = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    ASTNode *program = parse_program(parser);
+    if (fused)
+        semantic_end_program(&analyzer, program);
 
-    // Alocar memória e ler conteúdo
-    char *content = malloc(length + 1);
-    if (!content)
+    if (program && !parser->had_error)
     {
-        fprintf(stderr, "Erro: Memória insuficiente\n");
-        fclose(file);
-        return NULL;
-    }
+        // Análise semântica (no modo fundido, já feita durante o parse)
+        int semantic_ok;
+        if (fused)
+        {
+            semantic_ok = analyzer.error_count == 0;
+        }
+        else
+        {
+            semantic_init(&analyzer, program);
+            analyzer.source_path = path;
+            analyzer.thread_count = parser->thread_count;
+            semantic_ok = semantic_analyze(&analyzer);
+        }
+
+        if (semantic_ok && analyzer.error_count == 0)
+        {
+            // Chamadas puras com argumentos constantes viram literais antes
+            // de o programa ir para o cache
+            semantic_fold_constants(&analyzer, &arena);
+
+            // Os avisos vão junto: uma execução a partir do cache os repete
+            CacheWarning *warnings;
+            int warning_count;
+            if (cache != NULL && cache_collect_warnings(&analyzer, &warnings, &warning_count))
+            {
+                cache_save(cache, program, warnings, warning_count);
+                free(warnings);
+            }
+
+            // Interpretação
+            int status = run_program(program);
 
-    size_t bytes_read = fread(content, 1, length, file);
-    if (bytes_read != (size_t)length)
+            // Limpeza
+            semantic_cleanup(&analyzer);
+            ast_arena_free(&arena);
+            parser_cleanup(parser);
+
+            return status;
+        }
+        else
+        {
+            printf("\n[ERRO] Análise semântica falhou:\n");
+            semantic_print_report(&analyzer);
+            semantic_cleanup(&analyzer);
+            ast_arena_free(&arena);
+        }
+    }
+    else
     {
-        fprintf(stderr, "Aviso: Esperava %ld bytes, leu %zu bytes\n", length, bytes_read);
+        printf("\n[ERRO] Erro na análise sintática\n");
+        if (fused)
+            semantic_cleanup(&analyzer);
+        ast_arena_free(&arena);
     }
-    content[length] = '\0';
-    fclose(file);
 
-    return content;
+    parser_cleanup(parser);
+    return 1;
 }
 
 // Executar arquivo .craze
@@ -46,82 +111,89 @@ int execute_craze_file(const char *filename)
     printf("Executando: %s\n", filename);
     printf("----------------------------------------\n\n");
 
-    // Ler código fonte
-    char *source = read_file(filename);
-    if (!source)
+    // Mapear código fonte em memória (sem cópias)
+    SourceFile source;
+    if (!source_open(&source, filename))
     {
         return 1;
     }
 
     printf("Código fonte:\n");
-    // Fazer cópia do source para impressão para evitar corrupção
-    size_t source_len = strlen(source);
-    char *source_display = malloc(source_len + 1);
-    if (source_display)
+    fwrite(source.data, 1, source.length, stdout);
+    printf("\n");
+    printf("----------------------------------------\n");
+    printf("Saída do programa:\n\n");
+
+    // Programa inalterado desde a última execução: carrega a AST validada do
+    // cache, desde que os módulos importados também não tenham mudado
+    CacheKey cache;
+    int use_cache = cache_key_init(&cache, filename, source.data, source.length);
+    if (use_cache)
     {
-        strcpy(source_display, source);
-        printf("%s\n", source_display);
-        free(source_display);
+        AstArena arena;
+        ast_arena_init(&arena);
+        CacheWarning *warnings;
+        int warning_count;
+        ASTNode *program = cache_load(&cache, &arena, &warnings, &warning_count);
+        if (program && module_resolve_imports(program, filename))
+        {
+            // Mesmos diagnósticos de uma execução sem cache
+            for (int i = 0; i < warning_count; i++)
+                semantic_print_diagnostic(0, warnings[i].line, warnings[i].column, warnings[i].message);
+
+            int status = run_program(program);
+            ast_arena_free(&arena);
+            cache_key_free(&cache);
+            source_close(&source);
+            return status;
+        }
+        ast_arena_free(&arena);
+    }
+
+    // Pré-tokenizar o arquivo inteiro e fazer o parser indexar o buffer
+    Lexer lexer;
+    TokenBuffer tokens;
+    Parser parser;
+    lexer_init_span(&lexer, source.data, source.length);
+    token_buffer_init(&tokens);
+
+    int status = 1;
+    if (token_buffer_fill(&tokens, &lexer))
+    {
+        parser_init_tokens(&parser, &tokens);
+        status = run_pipeline(&parser, use_cache ? &cache : NULL, filename);
     }
     else
     {
-        printf("%s\n", source);
+        fprintf(stderr, "Erro: Memória insuficiente\n");
     }
+
+    token_buffer_free(&tokens);
+    lexer_cleanup(&lexer);
+    cache_key_free(&cache);
+    source_close(&source);
+    return status;
+}
+
+// Executar programa lido da entrada padrão (pipes), em modo streaming
+int execute_craze_stdin(void)
+{
+    printf("========================================\n");
+    printf("       CRAZE v0.1 INTERPRETER\n");
+    printf("========================================\n");
+    printf("Executando: <stdin>\n");
     printf("----------------------------------------\n");
     printf("Saída do programa:\n\n");
 
     Lexer lexer;
     Parser parser;
-    SemanticAnalyzer analyzer;
-    Interpreter interpreter;
-
-    // Pipeline completo: Lexer → Parser → Semantic → Interpreter
-    lexer_init(&lexer, source);
+    lexer_init_stream(&lexer, source_stream_read, stdin);
     parser_init(&parser, &lexer);
 
-    ASTNode *program = parse_program(&parser);
-
-    if (program && !parser.had_error)
-    {
-        // Análise semântica
-        semantic_init(&analyzer, program);
-        int semantic_ok = semantic_analyze(&analyzer);
-
-        if (semantic_ok && analyzer.error_count == 0)
-        {
-            // Interpretação
-            interpreter_init(&interpreter, program);
-            int result = interpreter_execute(&interpreter);
-
-            // Limpeza
-            interpreter_cleanup(&interpreter);
-            semantic_cleanup(&analyzer);
-            ast_free(program);
-            parser_cleanup(&parser);
-            lexer_cleanup(&lexer);
-            free(source);
-
-            return result ? 0 : 1;
-        }
-        else
-        {
-            printf("\n[ERRO] Análise semântica falhou:\n");
-            semantic_print_report(&analyzer);
-            semantic_cleanup(&analyzer);
-            ast_free(program);
-        }
-    }
-    else
-    {
-        printf("\n[ERRO] Erro na análise sintática\n");
-        if (program)
-            ast_free(program);
-    }
+    int status = run_pipeline(&parser, NULL, NULL);
 
-    parser_cleanup(&parser);
     lexer_cleanup(&lexer);
-    free(source);
-    return 1;
+    return status;
 }
 
 int main(int argc, char *argv[])
@@ -131,7 +203,8 @@ int main(int argc, char *argv[])
         printf("========================================\n");
         printf("         CRAZE v0.1 INTERPRETER\n");
         printf("========================================\n\n");
-        printf("Uso: %s <arquivo.craze>\n\n", argv[0]);
+        printf("Uso: %s <arquivo.craze>\n", argv[0]);
+        printf("  ou: %s -   (lê o programa da entrada padrão)\n\n", argv[0]);
         printf("Exemplos:\n");
         printf("  %s examples/01_hello_world.craze\n", argv[0]);
         printf("  %s examples/02_calculadora.craze\n", argv[0]);
@@ -148,5 +221,9 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    return execute_craze_file(argv[1]);
+    int status = strcmp(argv[1], "-") == 0 ? execute_craze_stdin() : execute_craze_file(argv[1]);
+
+    // Módulos importados ficam compilados até o fim do processo
+    module_cache_clear();
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,404 @@
+// realpath() é XSI: não é declarada só com _POSIX_C_SOURCE
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "../include/craze_module.h"
+#include "../include/craze_cache.h"
+#include "../include/craze_semantic.h"
+#include "../include/craze_source.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* --- CACHE DE MÓDULOS --- */
+
+/* Todos os módulos compilados no processo; versões antigas de um arquivo
+ * (STALE) continuam na lista enquanto programas podem apontar para elas */
+static CrazeModule *modules;
+
+#ifdef _WIN32
+static CRITICAL_SECTION modules_lock; // Recursiva por natureza
+static INIT_ONCE modules_lock_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK modules_lock_init(PINIT_ONCE once, PVOID parameter, PVOID *context)
+{
+    (void)once;
+    (void)parameter;
+    (void)context;
+    InitializeCriticalSection(&modules_lock);
+    return TRUE;
+}
+#else
+static pthread_mutex_t modules_lock;
+static pthread_once_t modules_lock_once = PTHREAD_ONCE_INIT;
+
+// Recursiva: compilar um módulo analisa seus imports, que voltam a module_load
+static void modules_lock_init(void)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&modules_lock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+#endif
+
+/* --- FUNÇÕES INTERNAS/HELPERS --- */
+
+static int is_absolute_path(const char *path)
+{
+#ifdef _WIN32
+    return path[0] == '/' || path[0] == '\\' || (path[0] != '\0' && path[1] == ':');
+#else
+    return path[0] == '/';
+#endif
+}
+
+/* Caminho canônico de 'path', relativo ao diretório de 'importer';
+ * NULL se o arquivo não existir */
+static char *resolve_path(const char *path, const char *importer)
+{
+    size_t dir_length = 0;
+    if (importer != NULL && !is_absolute_path(path))
+    {
+        const char *slash = strrchr(importer, '/');
+#ifdef _WIN32
+        const char *backslash = strrchr(importer, '\\');
+        if (backslash != NULL && (slash == NULL || backslash > slash))
+            slash = backslash;
+#endif
+        if (slash != NULL)
+            dir_length = (size_t)(slash - importer) + 1;
+    }
+
+    size_t length = strlen(path);
+    char *joined = malloc(dir_length + length + 1);
+    if (!joined)
+        return NULL;
+    if (dir_length > 0)
+        memcpy(joined, importer, dir_length);
+    memcpy(joined + dir_length, path, length + 1);
+
+#ifdef _WIN32
+    char *canonical = _fullpath(NULL, joined, 0);
+#else
+    char *canonical = realpath(joined, NULL);
+#endif
+    free(joined);
+    return canonical;
+}
+
+/* FNV-1a sobre os 8 bytes de 'value' */
+static uint64_t hash_mix(uint64_t hash, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Conteúdo do módulo combinado com a árvore de cada import, na ordem */
+static uint64_t module_tree_hash(const CrazeModule *module)
+{
+    uint64_t hash = module->source_hash;
+    ASTNode *program = module->program;
+    for (int i = 0; i < program->data.block.stmt_count; i++)
+    {
+        ASTNode *stmt = program->data.block.statements[i];
+        if (stmt->node_type == NODE_IMPORT)
+            hash = hash_mix(hash, stmt->data.import_stmt.module_hash);
+    }
+    return hash;
+}
+
+static CrazeModule *module_find(const char *path, uint64_t source_hash, uint64_t source_length)
+{
+    for (CrazeModule *module = modules; module != NULL; module = module->next)
+    {
+        if (module->state != MODULE_STALE && module->source_hash == source_hash &&
+            module->source_length == source_length && strcmp(module->path, path) == 0)
+            return module;
+    }
+    return NULL;
+}
+
+static void module_free_instance(CrazeModule *module)
+{
+    if (module->instance != NULL && module->instance_free != NULL)
+        module->instance_free(module->instance);
+    module->instance = NULL;
+}
+
+static void module_free(CrazeModule *module)
+{
+    module_free_instance(module);
+    ast_arena_free(&module->arena);
+    free(module->path);
+    free(module);
+}
+
+static void module_unlink(CrazeModule *module)
+{
+    for (CrazeModule **link = &modules; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == module)
+        {
+            *link = module->next;
+            return;
+        }
+    }
+}
+
+/* Os imports de um módulo pronto ainda têm o conteúdo com que ele foi verificado? */
+static int imports_current(const CrazeModule *module)
+{
+    ASTNode *program = module->program;
+    for (int i = 0; i < program->data.block.stmt_count; i++)
+    {
+        ASTNode *stmt = program->data.block.statements[i];
+        if (stmt->node_type != NODE_IMPORT)
+            continue;
+
+        char error[256];
+        CrazeModule *imported = module_load(stmt->data.import_stmt.path, module->path, error, sizeof(error));
+        if (imported == NULL || imported->tree_hash != stmt->data.import_stmt.module_hash)
+            return 0;
+    }
+    return 1;
+}
+
+/* Parse para a arena do módulo e análise semântica; NULL com a causa em 'error'.
+ * Um programa aprovado é gravado em 'cache' (se ativo) com os seus avisos. */
+static ASTNode *module_analyze(CrazeModule *module, const SourceFile *source, const CacheKey *cache,
+                               char *error, size_t error_size)
+{
+    Lexer lexer;
+    TokenBuffer tokens;
+    lexer_init_span(&lexer, source->data, source->length);
+    token_buffer_init(&tokens);
+
+    ASTNode *program = NULL;
+    if (!token_buffer_fill(&tokens, &lexer))
+    {
+        snprintf(error, error_size, "memória insuficiente");
+    }
+    else
+    {
+        Parser parser;
+        parser_init_tokens(&parser, &tokens);
+        parser.arena = &module->arena;
+
+        program = parse_program(&parser);
+        if (program == NULL || parser.had_error)
+        {
+            snprintf(error, error_size, "%s", parser.error_msg);
+            program = NULL;
+        }
+        else
+        {
+            // Os diagnósticos do módulo não são ecoados: o primeiro erro vai
+            // para a mensagem do import
+            SemanticAnalyzer analyzer;
+            semantic_init(&analyzer, program);
+            analyzer.source_path = module->path;
+            analyzer.thread_count = parser.thread_count;
+            analyzer.print_diagnostics = 0;
+
+            if (!semantic_analyze(&analyzer) || analyzer.error_count > 0)
+            {
+                snprintf(error, error_size, "erro semântico");
+                for (int i = 0; i < analyzer.diagnostic_count; i++)
+                {
+                    if (analyzer.diagnostics[i].is_error)
+                    {
+                        snprintf(error, error_size, "Linha %d, Coluna %d: %s",
+                                 analyzer.diagnostics[i].line, analyzer.diagnostics[i].column,
+                                 semantic_diagnostic_message(&analyzer, i));
+                        break;
+                    }
+                }
+                program = NULL;
+            }
+            else
+            {
+                semantic_fold_constants(&analyzer, &module->arena);
+
+                // O mesmo .crzc serve ao arquivo executado como programa
+                CacheWarning *warnings;
+                int warning_count;
+                if (cache->path != NULL && cache_collect_warnings(&analyzer, &warnings, &warning_count))
+                {
+                    cache_save(cache, program, warnings, warning_count);
+                    free(warnings);
+                }
+            }
+            semantic_cleanup(&analyzer);
+        }
+        parser_cleanup(&parser);
+    }
+
+    token_buffer_free(&tokens);
+    lexer_cleanup(&lexer);
+    return program;
+}
+
+/* Compila o módulo (ou o carrega do .crzc) e o registra no cache */
+static CrazeModule *module_compile(const char *path, const SourceFile *source, const CacheKey *cache,
+                                   char *error, size_t error_size)
+{
+    CrazeModule *module = calloc(1, sizeof(CrazeModule));
+    char *owned_path = strdup(path);
+    if (!module || !owned_path)
+    {
+        free(module);
+        free(owned_path);
+        snprintf(error, error_size, "memória insuficiente");
+        return NULL;
+    }
+
+    module->path = owned_path;
+    module->source_hash = cache->source_hash;
+    module->source_length = source->length;
+    module->state = MODULE_LOADING;
+    ast_arena_init(&module->arena);
+
+    // Visível desde já, para que um import circular o encontre
+    module->next = modules;
+    modules = module;
+
+    // O .crzc não passou pela análise: vale só se os imports gravados nele
+    // ainda têm o mesmo conteúdo
+    ASTNode *program = NULL;
+    if (cache->path != NULL)
+    {
+        program = cache_load(cache, &module->arena, NULL, NULL);
+        if (program != NULL && !module_resolve_imports(program, module->path))
+        {
+            ast_arena_free(&module->arena);
+            ast_arena_init(&module->arena);
+            program = NULL;
+        }
+    }
+
+    if (program == NULL)
+    {
+        program = module_analyze(module, source, cache, error, error_size);
+    }
+
+    if (program == NULL)
+    {
+        module_unlink(module);
+        module_free(module);
+        return NULL;
+    }
+
+    module->program = program;
+    module->tree_hash = module_tree_hash(module);
+    module->state = MODULE_READY;
+    return module;
+}
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+CrazeModule *module_load(const char *path, const char *importer, char *error, size_t error_size)
+{
+    char *canonical = resolve_path(path, importer);
+    if (canonical == NULL)
+    {
+        snprintf(error, error_size, "arquivo não encontrado");
+        return NULL;
+    }
+
+    SourceFile source;
+    if (!source_open(&source, canonical))
+    {
+        snprintf(error, error_size, "não foi possível ler o arquivo");
+        free(canonical);
+        return NULL;
+    }
+
+    // A chave do .crzc traz o hash do conteúdo mesmo com o cache em disco desligado
+    CacheKey key;
+    cache_key_init(&key, canonical, source.data, source.length);
+
+    module_lock();
+    CrazeModule *module = module_find(canonical, key.source_hash, source.length);
+    if (module != NULL && module->state == MODULE_LOADING)
+    {
+        snprintf(error, error_size, "importação circular de '%s'", path);
+        module = NULL;
+    }
+    else if (module == NULL || !imports_current(module))
+    {
+        if (module != NULL)
+            module->state = MODULE_STALE;
+        module = module_compile(canonical, &source, &key, error, error_size);
+    }
+    module_unlock();
+
+    cache_key_free(&key);
+    source_close(&source);
+    free(canonical);
+    return module;
+}
+
+int module_resolve_imports(ASTNode *program, const char *importer)
+{
+    for (int i = 0; i < program->data.block.stmt_count; i++)
+    {
+        ASTNode *stmt = program->data.block.statements[i];
+        if (stmt->node_type != NODE_IMPORT)
+            continue;
+
+        char error[256];
+        CrazeModule *module = module_load(stmt->data.import_stmt.path, importer, error, sizeof(error));
+        if (module == NULL || module->tree_hash != stmt->data.import_stmt.module_hash)
+            return 0;
+        stmt->data.import_stmt.module = module;
+    }
+    return 1;
+}
+
+void module_lock(void)
+{
+#ifdef _WIN32
+    InitOnceExecuteOnce(&modules_lock_once, modules_lock_init, NULL, NULL);
+    EnterCriticalSection(&modules_lock);
+#else
+    pthread_once(&modules_lock_once, modules_lock_init);
+    pthread_mutex_lock(&modules_lock);
+#endif
+}
+
+void module_unlock(void)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&modules_lock);
+#else
+    pthread_mutex_unlock(&modules_lock);
+#endif
+}
+
+void module_cache_clear(void)
+{
+    module_lock();
+
+    // Instâncias primeiro: seus valores podem vir de outros módulos (structs
+    // apontam para a declaração na arena do módulo de origem)
+    for (CrazeModule *module = modules; module != NULL; module = module->next)
+        module_free_instance(module);
+
+    while (modules != NULL)
+    {
+        CrazeModule *next = modules->next;
+        module_free(modules);
+        modules = next;
+    }
+    module_unlock();
+}
@@ -1,19 +1,57 @@
 #include "../include/craze_parser.h"
+#include "../include/craze_compact.h"
 #include "../include/craze_semantic.h"
+#include <limits.h>
+#include <stdint.h>
 
 /* Para strdup no MinGW */
 #ifdef _WIN32
 #endif
 
+/* Threads para o parse paralelo */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Tamanho mínimo (em tokens) para dividir o parse entre threads; abaixo disso
+ * o custo de criar threads supera o ganho */
+#ifndef PARSER_PARALLEL_MIN_TOKENS
+#define PARSER_PARALLEL_MIN_TOKENS 65536
+#endif
+#define PARSER_MAX_THREADS 16
+
 /* --- DECLARAÇÕES ANTECIPADAS --- */
 static void parser_error(Parser *parser, const char *message);
 static void synchronize(Parser *parser);
+static void recover_declaration(Parser *parser, int line, int column);
 static ASTNode *parse_block(Parser *parser);
+static void ast_arena_merge(AstArena *dest, AstArena *source);
 
 /* --- FUNÇÕES UTILITÁRIAS DE TOKEN --- */
 
 static void advance(Parser *parser)
 {
+    if (parser->tokens != NULL)
+    {
+        // Modo pré-tokenizado: apenas avança o índice, sem alocações
+        parser->previous_token = parser->current_token;
+        if (parser->token_index < parser->token_end)
+        {
+            parser->current_token = token_buffer_get(parser->tokens, parser->token_index++);
+        }
+        else
+        {
+            // Fim do trecho: TOKEN_EOF sintético na posição do token seguinte
+            parser->current_token = token_buffer_get(parser->tokens, parser->token_end);
+            parser->current_token.type = TOKEN_EOF;
+            parser->current_token.length = 0;
+        }
+        return;
+    }
+
     // Liberar apenas o lexeme do previous_token antes de sobrescrevê-lo
     // Não chamamos token_free pois queremos manter o struct, só liberar o lexeme
     if (parser->previous_token.lexeme != NULL)
@@ -29,6 +67,60 @@ static void advance(Parser *parser)
     parser->current_token = lexer_next_token(parser->lexer);
 }
 
+/* --- ALOCAÇÃO DA AST --- */
+
+/* Aloca memória para a AST: na arena do parser, se houver, ou com malloc */
+static void *node_alloc(Parser *parser, size_t size)
+{
+    if (parser->arena != NULL)
+        return ast_arena_alloc(parser->arena, size);
+    return malloc(size);
+}
+
+/* Descarta um nó em caminho de erro (na arena ele some com ast_arena_free) */
+static void discard_node(Parser *parser, ASTNode *node)
+{
+    if (parser->arena == NULL)
+        ast_free(node);
+}
+
+/* Descarta memória obtida com node_alloc ou finish_list (nomes, listas) */
+static void discard_memory(Parser *parser, void *memory)
+{
+    if (parser->arena == NULL)
+        free(memory);
+}
+
+/* Copia o texto de um token (o lexeme não tem terminador) para memória da AST */
+static char *node_text(Parser *parser, const Token *token)
+{
+    char *text = node_alloc(parser, token->length + 1);
+    if (!text)
+        return NULL;
+
+    memcpy(text, token->lexeme, token->length);
+    text[token->length] = '\0';
+    return text;
+}
+
+/* Fixa uma lista de filhos montada com realloc: na arena, copia-a para junto
+ * dos nós e libera o array temporário */
+static ASTNode **finish_list(Parser *parser, ASTNode **items, int count)
+{
+    if (parser->arena == NULL || items == NULL)
+        return items;
+
+    ASTNode **list = NULL;
+    if (count > 0)
+    {
+        list = ast_arena_alloc(parser->arena, sizeof(ASTNode *) * count);
+        if (list)
+            memcpy(list, items, sizeof(ASTNode *) * count);
+    }
+    free(items);
+    return list;
+}
+
 static int check(Parser *parser, TokenType type)
 {
     return parser->current_token.type == type;
@@ -57,7 +149,8 @@ static void consume(Parser *parser, TokenType type, const char *error_msg)
     synchronize(parser);
 }
 
-static void parser_error(Parser *parser, const char *message)
+/* Reporta um erro na posição de 'token' */
+static void parser_error_at(Parser *parser, const Token *token, const char *message)
 {
     if (parser->panic_mode)
         return;
@@ -67,13 +160,18 @@ static void parser_error(Parser *parser, const char *message)
 
     snprintf(parser->error_msg, sizeof(parser->error_msg),
              "[Linha %d, Coluna %d] Erro: %s",
-             parser->current_token.line,
-             parser->current_token.column,
+             token->line,
+             token->column,
              message);
 
     fprintf(stderr, "%s\n", parser->error_msg);
 }
 
+static void parser_error(Parser *parser, const char *message)
+{
+    parser_error_at(parser, &parser->current_token, message);
+}
+
 static void synchronize(Parser *parser)
 {
     parser->panic_mode = 0;
@@ -89,6 +187,10 @@ static void synchronize(Parser *parser)
         case TOKEN_FN:
         case TOKEN_IF:
         case TOKEN_WHILE:
+        case TOKEN_FOR:
+        case TOKEN_MATCH:
+        case TOKEN_STRUCT:
+        case TOKEN_IMPORT:
         case TOKEN_RETURN:
             return;
         default:
@@ -99,11 +201,102 @@ static void synchronize(Parser *parser)
     }
 }
 
+/* Recupera de uma declaração inválida que começava em (line, column). Se nenhum
+ * token foi consumido (ex.: '}' solto logo após ';'), descarta o token atual,
+ * senão synchronize pararia de novo nele e o parse nunca terminaria. */
+static void recover_declaration(Parser *parser, int line, int column)
+{
+    if (parser->current_token.type != TOKEN_EOF &&
+        parser->current_token.line == line && parser->current_token.column == column)
+        advance(parser);
+
+    synchronize(parser);
+}
+
+/* --- CONVERSÃO DE LITERAIS NUMÉRICOS --- */
+/* Lêem os dígitos direto do lexeme (sem cópia nem atoi/atof). O lexer só
+ * produz literais no formato dígitos[.dígitos], sem sinal nem expoente. */
+
+/* Potências de 10 exatamente representáveis em double */
+static const double exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/* Converte um literal inteiro, negado se 'negative'; retorna 0 se não
+ * couber em int. O módulo é acumulado sem sinal porque o de INT_MIN não
+ * cabe em int. */
+static int parse_int_digits(const char *digits, int length, int negative, int *out)
+{
+    unsigned int limit = negative ? (unsigned int)INT_MAX + 1u : (unsigned int)INT_MAX;
+    unsigned int value = 0;
+    for (int i = 0; i < length; i++)
+    {
+        unsigned int digit = (unsigned int)(digits[i] - '0');
+        if (value > (limit - digit) / 10)
+            return 0;
+        value = value * 10 + digit;
+    }
+
+    if (!negative)
+        *out = (int)value;
+    else
+        *out = value > (unsigned int)INT_MAX ? INT_MIN : -(int)value;
+    return 1;
+}
+
+/* Converte um literal float com arredondamento correto */
+static double parse_float_digits(const char *digits, int length)
+{
+    // Caminho rápido (Clinger): mantissa inteira <= 2^53 e no máximo 22 casas
+    // decimais; mantissa e 10^k são exatas, então uma única divisão IEEE
+    // já produz o double mais próximo
+    uint64_t mantissa = 0;
+    int fraction_digits = -1; // -1 enquanto não passou pelo '.'
+    int exact = 1;
+
+    for (int i = 0; i < length; i++)
+    {
+        if (digits[i] == '.')
+        {
+            fraction_digits = 0;
+            continue;
+        }
+        if (mantissa > (UINT64_C(1) << 53) / 10)
+        {
+            exact = 0;
+            break;
+        }
+        mantissa = mantissa * 10 + (uint64_t)(digits[i] - '0');
+        if (fraction_digits >= 0)
+            fraction_digits++;
+    }
+
+    if (exact && mantissa <= (UINT64_C(1) << 53) && fraction_digits <= 22)
+    {
+        double value = (double)mantissa;
+        return fraction_digits > 0 ? value / exact_powers_of_ten[fraction_digits] : value;
+    }
+
+    // Casos raros (muitos dígitos significativos): strtod sobre cópia terminada
+    // em '\0'; o interpretador nunca troca o locale, então o '.' é sempre decimal
+    char buffer[64];
+    char *text = length < (int)sizeof(buffer) ? buffer : malloc(length + 1);
+    if (!text)
+        return 0.0;
+
+    memcpy(text, digits, length);
+    text[length] = '\0';
+    double value = strtod(text, NULL);
+    if (text != buffer)
+        free(text);
+    return value;
+}
+
 /* --- FUNÇÕES DE CONSTRUÇÃO DE NÓS --- */
 
-static ASTNode *make_node(NodeType type, int line, int col)
+static ASTNode *make_node(Parser *parser, NodeType type, int line, int col)
 {
-    ASTNode *node = malloc(sizeof(ASTNode));
+    ASTNode *node = node_alloc(parser, sizeof(ASTNode));
     if (!node)
         return NULL;
 
@@ -115,9 +308,9 @@ static ASTNode *make_node(NodeType type, int line, int col)
     return node;
 }
 
-static ASTNode *make_var_decl_node(char *name, ASTNode *type, ASTNode *initializer, int line, int col)
+static ASTNode *make_var_decl_node(Parser *parser, char *name, ASTNode *type, ASTNode *initializer, int line, int col)
 {
-    ASTNode *node = make_node(NODE_VAR_DECL, line, col);
+    ASTNode *node = make_node(parser, NODE_VAR_DECL, line, col);
     if (!node)
         return NULL;
 
@@ -128,10 +321,10 @@ static ASTNode *make_var_decl_node(char *name, ASTNode *type, ASTNode *initializ
     return node;
 }
 
-static ASTNode *make_func_decl_node(char *name, ASTNode **params, int param_count,
+static ASTNode *make_func_decl_node(Parser *parser, char *name, ASTNode **params, int param_count,
                                     ASTNode *return_type, ASTNode *body, int line, int col)
 {
-    ASTNode *node = make_node(NODE_FUNC_DECL, line, col);
+    ASTNode *node = make_node(parser, NODE_FUNC_DECL, line, col);
     if (!node)
         return NULL;
 
@@ -144,21 +337,51 @@ static ASTNode *make_func_decl_node(char *name, ASTNode **params, int param_coun
     return node;
 }
 
-static ASTNode *make_param_node(char *name, ASTNode *type, int line, int col)
+static ASTNode *make_param_node(Parser *parser, char *name, ASTNode *type, int line, int col)
 {
-    ASTNode *node = make_node(NODE_PARAM, line, col);
+    ASTNode *node = make_node(parser, NODE_PARAM, line, col);
     if (!node)
         return NULL;
 
     node->data.param.name = name;
     node->data.param.type_node = type;
+    node->data.param.offset = 0;
+    node->data.param.storage = FIELD_VALUE;
+
+    return node;
+}
+
+static ASTNode *make_struct_decl_node(Parser *parser, char *name, ASTNode **fields, int field_count,
+                                      int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_STRUCT_DECL, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.struct_decl.name = name;
+    node->data.struct_decl.fields = fields;
+    node->data.struct_decl.field_count = field_count;
+    node->data.struct_decl.size = 0;
+
+    return node;
+}
+
+static ASTNode *make_import_node(Parser *parser, char *path, int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_IMPORT, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.import_stmt.path = path;
+    node->data.import_stmt.module = NULL;
+    node->data.import_stmt.module_hash = 0;
 
     return node;
 }
 
-static ASTNode *make_if_node(ASTNode *condition, ASTNode *then_branch, ASTNode *else_branch, int line, int col)
+static ASTNode *make_if_node(Parser *parser, ASTNode *condition, ASTNode *then_branch, ASTNode *else_branch, int line, int col)
 {
-    ASTNode *node = make_node(NODE_IF_STMT, line, col);
+    ASTNode *node = make_node(parser, NODE_IF_STMT, line, col);
     if (!node)
         return NULL;
 
@@ -169,9 +392,9 @@ static ASTNode *make_if_node(ASTNode *condition, ASTNode *then_branch, ASTNode *
     return node;
 }
 
-static ASTNode *make_while_node(ASTNode *condition, ASTNode *body, int line, int col)
+static ASTNode *make_while_node(Parser *parser, ASTNode *condition, ASTNode *body, int line, int col)
 {
-    ASTNode *node = make_node(NODE_WHILE_STMT, line, col);
+    ASTNode *node = make_node(parser, NODE_WHILE_STMT, line, col);
     if (!node)
         return NULL;
 
@@ -181,9 +404,55 @@ static ASTNode *make_while_node(ASTNode *condition, ASTNode *body, int line, int
     return node;
 }
 
-static ASTNode *make_return_node(ASTNode *value, int line, int col)
+static ASTNode *make_for_node(Parser *parser, char *var_name, ASTNode *start, ASTNode *end,
+                              ASTNode *step, ASTNode *body, int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_FOR_STMT, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.for_stmt.var_name = var_name;
+    node->data.for_stmt.start = start;
+    node->data.for_stmt.end = end;
+    node->data.for_stmt.step = step;
+    node->data.for_stmt.body = body;
+
+    return node;
+}
+
+static ASTNode *make_match_node(Parser *parser, ASTNode *subject, ASTNode **arms, int arm_count,
+                                ASTNode *else_branch, int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_MATCH_STMT, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.match_stmt.subject = subject;
+    node->data.match_stmt.arms = arms;
+    node->data.match_stmt.arm_count = arm_count;
+    node->data.match_stmt.else_branch = else_branch;
+    node->data.match_stmt.table = NULL;
+
+    return node;
+}
+
+static ASTNode *make_match_arm_node(Parser *parser, ASTNode **labels, int label_count, ASTNode *body,
+                                    int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_MATCH_ARM, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.match_arm.labels = labels;
+    node->data.match_arm.label_count = label_count;
+    node->data.match_arm.body = body;
+
+    return node;
+}
+
+static ASTNode *make_return_node(Parser *parser, ASTNode *value, int line, int col)
 {
-    ASTNode *node = make_node(NODE_RETURN_STMT, line, col);
+    ASTNode *node = make_node(parser, NODE_RETURN_STMT, line, col);
     if (!node)
         return NULL;
 
@@ -192,9 +461,9 @@ static ASTNode *make_return_node(ASTNode *value, int line, int col)
     return node;
 }
 
-static ASTNode *make_block_node(ASTNode **statements, int count, int line, int col)
+static ASTNode *make_block_node(Parser *parser, ASTNode **statements, int count, int line, int col)
 {
-    ASTNode *node = make_node(NODE_BLOCK, line, col);
+    ASTNode *node = make_node(parser, NODE_BLOCK, line, col);
     if (!node)
         return NULL;
 
@@ -204,9 +473,9 @@ static ASTNode *make_block_node(ASTNode **statements, int count, int line, int c
     return node;
 }
 
-static ASTNode *make_binary_node(TokenType operator, ASTNode *left, ASTNode *right, int line, int col)
+static ASTNode *make_binary_node(Parser *parser, TokenType operator, ASTNode *left, ASTNode *right, int line, int col)
 {
-    ASTNode *node = make_node(NODE_BINARY_EXPR, line, col);
+    ASTNode *node = make_node(parser, NODE_BINARY_EXPR, line, col);
     if (!node)
         return NULL;
 
@@ -217,9 +486,9 @@ static ASTNode *make_binary_node(TokenType operator, ASTNode *left, ASTNode *rig
     return node;
 }
 
-static ASTNode *make_unary_node(TokenType operator, ASTNode *operand, int line, int col)
+static ASTNode *make_unary_node(Parser *parser, TokenType operator, ASTNode *operand, int line, int col)
 {
-    ASTNode *node = make_node(NODE_UNARY_EXPR, line, col);
+    ASTNode *node = make_node(parser, NODE_UNARY_EXPR, line, col);
     if (!node)
         return NULL;
 
@@ -229,9 +498,9 @@ static ASTNode *make_unary_node(TokenType operator, ASTNode *operand, int line,
     return node;
 }
 
-static ASTNode *make_assign_node(char *name, ASTNode *value, int line, int col)
+static ASTNode *make_assign_node(Parser *parser, char *name, ASTNode *value, int line, int col)
 {
-    ASTNode *node = make_node(NODE_ASSIGN_EXPR, line, col);
+    ASTNode *node = make_node(parser, NODE_ASSIGN_EXPR, line, col);
     if (!node)
         return NULL;
 
@@ -241,9 +510,9 @@ static ASTNode *make_assign_node(char *name, ASTNode *value, int line, int col)
     return node;
 }
 
-static ASTNode *make_call_node(char *name, ASTNode **args, int arg_count, int line, int col)
+static ASTNode *make_call_node(Parser *parser, char *name, ASTNode **args, int arg_count, int line, int col)
 {
-    ASTNode *node = make_node(NODE_CALL_EXPR, line, col);
+    ASTNode *node = make_node(parser, NODE_CALL_EXPR, line, col);
     if (!node)
         return NULL;
 
@@ -254,9 +523,78 @@ static ASTNode *make_call_node(char *name, ASTNode **args, int arg_count, int li
     return node;
 }
 
-static ASTNode *make_var_node(char *name, int line, int col)
+static ASTNode *make_index_node(Parser *parser, ASTNode *array, ASTNode *index, int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_INDEX_EXPR, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.index_expr.array = array;
+    node->data.index_expr.index = index;
+
+    return node;
+}
+
+static ASTNode *make_index_assign_node(Parser *parser, ASTNode *array, ASTNode *index, ASTNode *value,
+                                       int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_INDEX_ASSIGN, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.index_assign.array = array;
+    node->data.index_assign.index = index;
+    node->data.index_assign.value = value;
+
+    return node;
+}
+
+/* r.campo (value == NULL) ou r.campo = value */
+static ASTNode *make_field_node(Parser *parser, NodeType type, ASTNode *object, char *field_name,
+                                ASTNode *value, int line, int col)
+{
+    ASTNode *node = make_node(parser, type, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.field_expr.object = object;
+    node->data.field_expr.field_name = field_name;
+    node->data.field_expr.value = value;
+    node->data.field_expr.offset = 0;
+    node->data.field_expr.storage = FIELD_VALUE;
+
+    return node;
+}
+
+static ASTNode *make_array_literal_node(Parser *parser, ASTNode **elements, int count, int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_ARRAY_LITERAL, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.array_literal.elements = elements;
+    node->data.array_literal.element_count = count;
+
+    return node;
+}
+
+static ASTNode *make_map_literal_node(Parser *parser, ASTNode **items, int entry_count, int line, int col)
+{
+    ASTNode *node = make_node(parser, NODE_MAP_LITERAL, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.map_literal.items = items;
+    node->data.map_literal.entry_count = entry_count;
+    node->data.map_literal.key_type = TYPE_VOID;
+    node->data.map_literal.value_type = TYPE_VOID;
+
+    return node;
+}
+
+static ASTNode *make_var_node(Parser *parser, char *name, int line, int col)
 {
-    ASTNode *node = make_node(NODE_VAR_EXPR, line, col);
+    ASTNode *node = make_node(parser, NODE_VAR_EXPR, line, col);
     if (!node)
         return NULL;
 
@@ -265,28 +603,37 @@ static ASTNode *make_var_node(char *name, int line, int col)
     return node;
 }
 
-static ASTNode *make_literal_node(Token *token)
+static ASTNode *make_literal_node(Parser *parser, Token *token)
 {
-    ASTNode *node = make_node(NODE_LITERAL, token->line, token->column);
+    ASTNode *node = make_node(parser, NODE_LITERAL, token->line, token->column);
     if (!node)
         return NULL;
 
     node->data.literal.literal_type = token->type;
 
+    char *text = NULL;
+
     switch (token->type)
     {
     case TOKEN_INT_LITERAL:
-        node->data.literal.value.int_value = atoi(token->lexeme);
+        if (!parse_int_digits(token->lexeme, token->length, 0, &node->data.literal.value.int_value))
+        {
+            parser_error_at(parser, token, "Literal inteiro fora do intervalo de int");
+            discard_node(parser, node);
+            return NULL;
+        }
         node->data_type = TYPE_INT;
         break;
     case TOKEN_FLOAT_LITERAL:
-        node->data.literal.value.float_value = atof(token->lexeme);
+        node->data.literal.value.float_value = parse_float_digits(token->lexeme, token->length);
         node->data_type = TYPE_FLOAT;
         break;
     case TOKEN_STRING_LITERAL:
         // Remove aspas da string literal
-        node->data.literal.value.string_value = strdup(token->lexeme + 1);
-        node->data.literal.value.string_value[strlen(node->data.literal.value.string_value) - 1] = '\0';
+        text = node_alloc(parser, token->length - 1);
+        memcpy(text, token->lexeme + 1, token->length - 2);
+        text[token->length - 2] = '\0';
+        node->data.literal.value.string_value = text;
         node->data_type = TYPE_STRING;
         break;
     case TOKEN_TRUE:
@@ -298,20 +645,43 @@ static ASTNode *make_literal_node(Token *token)
         node->data_type = TYPE_BOOL;
         break;
     default:
-        free(node);
+        discard_node(parser, node);
         return NULL;
     }
 
     return node;
 }
 
-static ASTNode *make_type_node(DataType type, int line, int col)
+/* Literal int precedido de '-': a negação é aplicada já na conversão, o
+ * único jeito de escrever INT_MIN (2147483648 sozinho não cabe em int) */
+static ASTNode *make_negative_int_node(Parser *parser, Token *minus, Token *token)
+{
+    ASTNode *node = make_node(parser, NODE_LITERAL, minus->line, minus->column);
+    if (!node)
+        return NULL;
+
+    node->data.literal.literal_type = TOKEN_INT_LITERAL;
+    if (!parse_int_digits(token->lexeme, token->length, 1, &node->data.literal.value.int_value))
+    {
+        parser_error_at(parser, token, "Literal inteiro fora do intervalo de int");
+        discard_node(parser, node);
+        return NULL;
+    }
+    node->data_type = TYPE_INT;
+    return node;
+}
+
+static ASTNode *make_type_node(Parser *parser, DataType type, int is_array, int line, int col)
 {
-    ASTNode *node = make_node(NODE_TYPE, line, col);
+    ASTNode *node = make_node(parser, NODE_TYPE, line, col);
     if (!node)
         return NULL;
 
     node->data.type_node.type = type;
+    node->data.type_node.is_array = is_array;
+    node->data.type_node.is_map = 0;
+    node->data.type_node.key_type = TYPE_VOID;
+    node->data.type_node.struct_name = NULL;
     node->data_type = type;
 
     return node;
@@ -323,13 +693,51 @@ static ASTNode *make_type_node(DataType type, int line, int col)
 static ASTNode *parse_declaration(Parser *parser);
 static ASTNode *parse_statement(Parser *parser);
 static ASTNode *parse_expression(Parser *parser);
-static ASTNode *parse_assignment(Parser *parser);
-static ASTNode *parse_equality(Parser *parser);
-static ASTNode *parse_comparison(Parser *parser);
-static ASTNode *parse_term(Parser *parser);
-static ASTNode *parse_factor(Parser *parser);
-static ASTNode *parse_unary(Parser *parser);
-static ASTNode *parse_primary(Parser *parser);
+
+static ASTNode *parse_type(Parser *parser);
+
+/* map<K, V>: chave int, string ou bool; valor escalar */
+static ASTNode *parse_map_type(Parser *parser, int line, int col)
+{
+    advance(parser); // consome 'map'
+    consume(parser, TOKEN_LESS, "Esperado '<' após 'map'");
+
+    ASTNode *key = parse_type(parser);
+    if (!key)
+        return NULL;
+    consume(parser, TOKEN_COMMA, "Esperado ',' entre os tipos do map");
+
+    ASTNode *value = parse_type(parser);
+    if (!value)
+    {
+        discard_node(parser, key);
+        return NULL;
+    }
+    consume(parser, TOKEN_GREATER, "Esperado '>' após os tipos do map");
+
+    DataType key_type = key->data.type_node.type;
+    DataType value_type = value->data.type_node.type;
+    int nested = key->data.type_node.is_array || key->data.type_node.is_map ||
+                 value->data.type_node.is_array || value->data.type_node.is_map;
+    discard_node(parser, key);
+    discard_node(parser, value);
+
+    if (nested || key_type == TYPE_FLOAT || key_type == TYPE_VOID || key_type == TYPE_BYTES ||
+        key_type == TYPE_STRUCT || value_type == TYPE_VOID || value_type == TYPE_BYTES ||
+        value_type == TYPE_STRUCT)
+    {
+        parser_error(parser, "Map requer chave int, string ou bool e valor int, float, string ou bool");
+        return NULL;
+    }
+
+    ASTNode *node = make_type_node(parser, value_type, 0, line, col);
+    if (!node)
+        return NULL;
+
+    node->data.type_node.is_map = 1;
+    node->data.type_node.key_type = key_type;
+    return node;
+}
 
 static ASTNode *parse_type(Parser *parser)
 {
@@ -337,6 +745,9 @@ static ASTNode *parse_type(Parser *parser)
     int line = parser->current_token.line;
     int col = parser->current_token.column;
 
+    if (check(parser, TOKEN_MAP))
+        return parse_map_type(parser, line, col);
+
     switch (parser->current_token.type)
     {
     case TOKEN_INT:
@@ -351,22 +762,50 @@ static ASTNode *parse_type(Parser *parser)
     case TOKEN_BOOL:
         type = TYPE_BOOL;
         break;
+    case TOKEN_BYTES:
+        type = TYPE_BYTES;
+        break;
     case TOKEN_VOID:
         type = TYPE_VOID;
         break;
+    case TOKEN_IDENTIFIER:
+        type = TYPE_STRUCT; // Nome de struct, resolvido pela análise semântica
+        break;
     default:
         parser_error(parser, "Esperado tipo válido");
         return NULL;
     }
 
+    char *struct_name = type == TYPE_STRUCT ? node_text(parser, &parser->current_token) : NULL;
     advance(parser);
-    return make_type_node(type, line, col);
+
+    // Array tipado: T[]
+    int is_array = 0;
+    if (match(parser, TOKEN_LEFT_BRACKET))
+    {
+        consume(parser, TOKEN_RIGHT_BRACKET, "Esperado ']' no tipo array");
+        if (type == TYPE_VOID || type == TYPE_BYTES || type == TYPE_STRUCT)
+        {
+            parser_error(parser, type == TYPE_VOID    ? "Arrays de void não são permitidos"
+                                 : type == TYPE_BYTES ? "Arrays de bytes não são permitidos"
+                                                      : "Arrays de structs não são permitidos");
+            if (struct_name)
+                discard_memory(parser, struct_name);
+            return NULL;
+        }
+        is_array = 1;
+    }
+
+    ASTNode *node = make_type_node(parser, type, is_array, line, col);
+    if (node)
+        node->data.type_node.struct_name = struct_name;
+    return node;
 }
 
 static ASTNode *parse_variable_declaration(Parser *parser)
 {
     consume(parser, TOKEN_IDENTIFIER, "Esperado nome da variável");
-    char *name = strdup(parser->previous_token.lexeme);
+    char *name = node_text(parser, &parser->previous_token);
     int line = parser->previous_token.line;
     int col = parser->previous_token.column;
 
@@ -374,7 +813,7 @@ static ASTNode *parse_variable_declaration(Parser *parser)
     ASTNode *type_node = parse_type(parser);
     if (!type_node)
     {
-        free(name);
+        discard_memory(parser, name);
         return NULL;
     }
 
@@ -382,14 +821,14 @@ static ASTNode *parse_variable_declaration(Parser *parser)
     ASTNode *initializer = parse_expression(parser);
     if (!initializer)
     {
-        ast_free(type_node);
-        free(name);
+        discard_node(parser, type_node);
+        discard_memory(parser, name);
         return NULL;
     }
 
     consume(parser, TOKEN_SEMICOLON, "Esperado ';' após declaração de variável");
 
-    return make_var_decl_node(name, type_node, initializer, line, col);
+    return make_var_decl_node(parser, name, type_node, initializer, line, col);
 }
 
 static ASTNode **parse_parameters(Parser *parser, int *count)
@@ -406,7 +845,7 @@ static ASTNode **parse_parameters(Parser *parser, int *count)
         }
 
         consume(parser, TOKEN_IDENTIFIER, "Esperado nome do parâmetro");
-        char *param_name = strdup(parser->previous_token.lexeme);
+        char *param_name = node_text(parser, &parser->previous_token);
         int line = parser->previous_token.line;
         int col = parser->previous_token.column;
 
@@ -414,13 +853,14 @@ static ASTNode **parse_parameters(Parser *parser, int *count)
         ASTNode *param_type = parse_type(parser);
         if (!param_type)
         {
-            free(param_name);
+            discard_memory(parser, param_name);
             // Cleanup já alocados
             for (int i = 0; i < *count; i++)
             {
-                ast_free(params[i]);
+                discard_node(parser, params[i]);
             }
             free(params);
+            *count = 0;
             return NULL;
         }
 
@@ -431,16 +871,16 @@ static ASTNode **parse_parameters(Parser *parser, int *count)
             params = realloc(params, sizeof(ASTNode *) * capacity);
         }
 
-        params[(*count)++] = make_param_node(param_name, param_type, line, col);
+        params[(*count)++] = make_param_node(parser, param_name, param_type, line, col);
     }
 
-    return params;
+    return finish_list(parser, params, *count);
 }
 
 static ASTNode *parse_function_declaration(Parser *parser)
 {
     consume(parser, TOKEN_IDENTIFIER, "Esperado nome da função");
-    char *name = strdup(parser->previous_token.lexeme);
+    char *name = node_text(parser, &parser->previous_token);
     int line = parser->previous_token.line;
     int col = parser->previous_token.column;
 
@@ -455,29 +895,102 @@ static ASTNode *parse_function_declaration(Parser *parser)
     ASTNode *return_type = parse_type(parser);
     if (!return_type)
     {
-        free(name);
+        discard_memory(parser, name);
         for (int i = 0; i < param_count; i++)
         {
-            ast_free(params[i]);
+            discard_node(parser, params[i]);
         }
-        free(params);
+        discard_memory(parser, params);
         return NULL;
     }
 
     ASTNode *body = parse_block(parser);
     if (!body)
     {
-        free(name);
-        ast_free(return_type);
+        discard_memory(parser, name);
+        discard_node(parser, return_type);
         for (int i = 0; i < param_count; i++)
         {
-            ast_free(params[i]);
+            discard_node(parser, params[i]);
         }
-        free(params);
+        discard_memory(parser, params);
         return NULL;
     }
 
-    return make_func_decl_node(name, params, param_count, return_type, body, line, col);
+    return make_func_decl_node(parser, name, params, param_count, return_type, body, line, col);
+}
+
+/* struct Nome { campo: tipo, ... } (vírgula final opcional) */
+static ASTNode *parse_struct_declaration(Parser *parser)
+{
+    consume(parser, TOKEN_IDENTIFIER, "Esperado nome do struct");
+    char *name = node_text(parser, &parser->previous_token);
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    consume(parser, TOKEN_LEFT_BRACE, "Esperado '{' após nome do struct");
+
+    ASTNode **fields = NULL;
+    int count = 0;
+    int capacity = 0;
+
+    while (!check(parser, TOKEN_RIGHT_BRACE) && !check(parser, TOKEN_EOF))
+    {
+        consume(parser, TOKEN_IDENTIFIER, "Esperado nome do campo");
+        char *field_name = node_text(parser, &parser->previous_token);
+        int field_line = parser->previous_token.line;
+        int field_col = parser->previous_token.column;
+
+        consume(parser, TOKEN_COLON, "Esperado ':' após nome do campo");
+        ASTNode *field_type = parse_type(parser);
+        if (!field_type)
+        {
+            discard_memory(parser, field_name);
+            discard_memory(parser, name);
+            for (int i = 0; i < count; i++)
+            {
+                discard_node(parser, fields[i]);
+            }
+            free(fields);
+            return NULL;
+        }
+
+        if (count >= capacity)
+        {
+            capacity = capacity == 0 ? 4 : capacity * 2;
+            fields = realloc(fields, sizeof(ASTNode *) * capacity);
+        }
+
+        fields[count++] = make_param_node(parser, field_name, field_type, field_line, field_col);
+
+        if (!match(parser, TOKEN_COMMA))
+            break;
+    }
+
+    consume(parser, TOKEN_RIGHT_BRACE, "Esperado '}' após os campos do struct");
+
+    return make_struct_decl_node(parser, name, finish_list(parser, fields, count), count, line, col);
+}
+
+/* import "caminho"; */
+static ASTNode *parse_import(Parser *parser)
+{
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    consume(parser, TOKEN_STRING_LITERAL, "Esperado caminho entre aspas após 'import'");
+    if (parser->previous_token.type != TOKEN_STRING_LITERAL)
+        return NULL;
+
+    // Sem as aspas
+    const Token *token = &parser->previous_token;
+    char *path = node_alloc(parser, token->length - 1);
+    memcpy(path, token->lexeme + 1, token->length - 2);
+    path[token->length - 2] = '\0';
+
+    consume(parser, TOKEN_SEMICOLON, "Esperado ';' após import");
+
+    return make_import_node(parser, path, line, col);
 }
 
 static ASTNode *parse_block(Parser *parser)
@@ -492,6 +1005,8 @@ static ASTNode *parse_block(Parser *parser)
 
     while (!check(parser, TOKEN_RIGHT_BRACE) && !check(parser, TOKEN_EOF))
     {
+        int stmt_line = parser->current_token.line;
+        int stmt_col = parser->current_token.column;
         ASTNode *stmt = parse_declaration(parser);
         if (stmt)
         {
@@ -504,13 +1019,14 @@ static ASTNode *parse_block(Parser *parser)
         }
         else
         {
-            synchronize(parser);
+            recover_declaration(parser, stmt_line, stmt_col);
         }
     }
 
     consume(parser, TOKEN_RIGHT_BRACE, "Esperado '}'");
 
-    return make_block_node(statements, stmt_count, line, col);
+    statements = finish_list(parser, statements, stmt_count);
+    return make_block_node(parser, statements, stmt_count, line, col);
 }
 
 static ASTNode *parse_if_statement(Parser *parser)
@@ -528,7 +1044,7 @@ static ASTNode *parse_if_statement(Parser *parser)
     ASTNode *then_branch = parse_block(parser);
     if (!then_branch)
     {
-        ast_free(condition);
+        discard_node(parser, condition);
         return NULL;
     }
 
@@ -538,13 +1054,13 @@ static ASTNode *parse_if_statement(Parser *parser)
         else_branch = parse_block(parser);
         if (!else_branch)
         {
-            ast_free(condition);
-            ast_free(then_branch);
+            discard_node(parser, condition);
+            discard_node(parser, then_branch);
             return NULL;
         }
     }
 
-    return make_if_node(condition, then_branch, else_branch, line, col);
+    return make_if_node(parser, condition, then_branch, else_branch, line, col);
 }
 
 static ASTNode *parse_while_statement(Parser *parser)
@@ -562,47 +1078,253 @@ static ASTNode *parse_while_statement(Parser *parser)
     ASTNode *body = parse_block(parser);
     if (!body)
     {
-        ast_free(condition);
+        discard_node(parser, condition);
         return NULL;
     }
 
-    return make_while_node(condition, body, line, col);
+    return make_while_node(parser, condition, body, line, col);
 }
 
-static ASTNode *parse_return_statement(Parser *parser)
+/* for i in início..fim [step passo] { ... } -- intervalo semiaberto [início, fim) */
+static ASTNode *parse_for_statement(Parser *parser)
 {
     int line = parser->previous_token.line;
     int col = parser->previous_token.column;
 
-    ASTNode *value = NULL;
-    if (!check(parser, TOKEN_SEMICOLON))
+    consume(parser, TOKEN_IDENTIFIER, "Esperado nome da variável após 'for'");
+    char *name = node_text(parser, &parser->previous_token);
+
+    consume(parser, TOKEN_IN, "Esperado 'in' após variável do for");
+    ASTNode *start = parse_expression(parser);
+    if (!start)
     {
-        value = parse_expression(parser);
-        if (!value)
-            return NULL;
+        discard_memory(parser, name);
+        return NULL;
     }
 
-    consume(parser, TOKEN_SEMICOLON, "Esperado ';' após return");
-
-    return make_return_node(value, line, col);
-}
-
-static ASTNode *parse_expression_statement(Parser *parser)
-{
-    ASTNode *expr = parse_expression(parser);
-    if (!expr)
+    consume(parser, TOKEN_DOT_DOT, "Esperado '..' no intervalo do for");
+    ASTNode *end = parse_expression(parser);
+    if (!end)
+    {
+        discard_node(parser, start);
+        discard_memory(parser, name);
         return NULL;
+    }
 
-    consume(parser, TOKEN_SEMICOLON, "Esperado ';' após expressão");
+    ASTNode *step = NULL;
+    if (match(parser, TOKEN_STEP))
+    {
+        step = parse_expression(parser);
+        if (!step)
+        {
+            discard_node(parser, start);
+            discard_node(parser, end);
+            discard_memory(parser, name);
+            return NULL;
+        }
+    }
 
-    ASTNode *node = make_node(NODE_EXPR_STMT, expr->line, expr->column);
-    if (!node)
+    ASTNode *body = parse_block(parser);
+    if (!body)
     {
-        ast_free(expr);
+        discard_node(parser, start);
+        discard_node(parser, end);
+        if (step)
+            discard_node(parser, step);
+        discard_memory(parser, name);
         return NULL;
     }
 
-    // Armazenar a expressão diretamente
+    return make_for_node(parser, name, start, end, step, body, line, col);
+}
+
+/* Rótulo de um braço do match: literal int (com '-' opcional) ou string */
+static ASTNode *parse_match_label(Parser *parser)
+{
+    if (match(parser, TOKEN_STRING_LITERAL))
+        return make_literal_node(parser, &parser->previous_token);
+
+    Token minus = parser->current_token;
+    int negative = match(parser, TOKEN_MINUS);
+    if (!match(parser, TOKEN_INT_LITERAL))
+    {
+        parser_error(parser, "Rótulo do match deve ser um literal int ou string");
+        return NULL;
+    }
+
+    if (negative)
+        return make_negative_int_node(parser, &minus, &parser->previous_token);
+    return make_literal_node(parser, &parser->previous_token);
+}
+
+/* rótulo, rótulo, ... => { ... } */
+static ASTNode *parse_match_arm(Parser *parser)
+{
+    int line = parser->current_token.line;
+    int col = parser->current_token.column;
+
+    ASTNode **labels = NULL;
+    int count = 0;
+    int capacity = 0;
+
+    do
+    {
+        ASTNode *label = parse_match_label(parser);
+        if (!label)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                discard_node(parser, labels[i]);
+            }
+            free(labels);
+            return NULL;
+        }
+
+        if (count >= capacity)
+        {
+            capacity = capacity == 0 ? 4 : capacity * 2;
+            labels = realloc(labels, sizeof(ASTNode *) * capacity);
+        }
+        labels[count++] = label;
+    } while (match(parser, TOKEN_COMMA));
+
+    consume(parser, TOKEN_ARROW, "Esperado '=>' após os rótulos do braço");
+
+    labels = finish_list(parser, labels, count);
+    ASTNode *body = parse_block(parser);
+    if (!body)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            discard_node(parser, labels[i]);
+        }
+        discard_memory(parser, labels);
+        return NULL;
+    }
+
+    return make_match_arm_node(parser, labels, count, body, line, col);
+}
+
+/* match (valor) { 1, 2 => { ... } 3 => { ... } else => { ... } } */
+static ASTNode *parse_match_statement(Parser *parser)
+{
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    consume(parser, TOKEN_LEFT_PAREN, "Esperado '(' após 'match'");
+    ASTNode *subject = parse_expression(parser);
+    if (!subject)
+        return NULL;
+
+    consume(parser, TOKEN_RIGHT_PAREN, "Esperado ')' após valor do match");
+    consume(parser, TOKEN_LEFT_BRACE, "Esperado '{' antes dos braços do match");
+
+    ASTNode **arms = NULL;
+    int arm_count = 0;
+    int capacity = 0;
+    ASTNode *else_branch = NULL;
+    int failed = 0;
+
+    while (!failed && !check(parser, TOKEN_RIGHT_BRACE) && !check(parser, TOKEN_EOF))
+    {
+        if (else_branch)
+        {
+            parser_error(parser, "'else' deve ser o último braço do match");
+            failed = 1;
+        }
+        else if (match(parser, TOKEN_ELSE))
+        {
+            consume(parser, TOKEN_ARROW, "Esperado '=>' após 'else'");
+            else_branch = parse_block(parser);
+            failed = else_branch == NULL;
+        }
+        else
+        {
+            ASTNode *arm = parse_match_arm(parser);
+            if (!arm)
+            {
+                failed = 1;
+                break;
+            }
+
+            if (arm_count >= capacity)
+            {
+                capacity = capacity == 0 ? 8 : capacity * 2;
+                arms = realloc(arms, sizeof(ASTNode *) * capacity);
+            }
+            arms[arm_count++] = arm;
+        }
+    }
+
+    if (failed)
+    {
+        discard_node(parser, subject);
+        for (int i = 0; i < arm_count; i++)
+        {
+            discard_node(parser, arms[i]);
+        }
+        free(arms);
+        if (else_branch)
+            discard_node(parser, else_branch);
+        return NULL;
+    }
+
+    consume(parser, TOKEN_RIGHT_BRACE, "Esperado '}' após os braços do match");
+
+    arms = finish_list(parser, arms, arm_count);
+    ASTNode *node = make_match_node(parser, subject, arms, arm_count, else_branch, line, col);
+    if (!node)
+        return NULL;
+
+    // Rótulos de tipos diferentes deixam a tabela NULL: a análise semântica
+    // os rejeita ao comparar cada um com o tipo do valor
+    const ASTNode *duplicate = NULL;
+    node->data.match_stmt.table = match_table_build(node, parser->arena, &duplicate);
+    if (duplicate)
+    {
+        Token at = parser->previous_token;
+        at.line = duplicate->line;
+        at.column = duplicate->column;
+        parser_error_at(parser, &at, "Rótulo repetido no match");
+    }
+
+    return node;
+}
+
+static ASTNode *parse_return_statement(Parser *parser)
+{
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    ASTNode *value = NULL;
+    if (!check(parser, TOKEN_SEMICOLON))
+    {
+        value = parse_expression(parser);
+        if (!value)
+            return NULL;
+    }
+
+    consume(parser, TOKEN_SEMICOLON, "Esperado ';' após return");
+
+    return make_return_node(parser, value, line, col);
+}
+
+static ASTNode *parse_expression_statement(Parser *parser)
+{
+    ASTNode *expr = parse_expression(parser);
+    if (!expr)
+        return NULL;
+
+    consume(parser, TOKEN_SEMICOLON, "Esperado ';' após expressão");
+
+    ASTNode *node = make_node(parser, NODE_EXPR_STMT, expr->line, expr->column);
+    if (!node)
+    {
+        discard_node(parser, expr);
+        return NULL;
+    }
+
+    // Armazenar a expressão diretamente
     node->data.expr_stmt.expression = expr;
 
     return node;
@@ -618,6 +1340,14 @@ static ASTNode *parse_statement(Parser *parser)
     {
         return parse_while_statement(parser);
     }
+    else if (match(parser, TOKEN_FOR))
+    {
+        return parse_for_statement(parser);
+    }
+    else if (match(parser, TOKEN_MATCH))
+    {
+        return parse_match_statement(parser);
+    }
     else if (match(parser, TOKEN_RETURN))
     {
         return parse_return_statement(parser);
@@ -642,23 +1372,34 @@ static ASTNode *parse_declaration(Parser *parser)
     {
         return parse_function_declaration(parser);
     }
+    else if (match(parser, TOKEN_STRUCT))
+    {
+        return parse_struct_declaration(parser);
+    }
+    else if (match(parser, TOKEN_IMPORT))
+    {
+        // O nível superior trata o import em parse_declarations
+        parser_error_at(parser, &parser->previous_token, "'import' só é permitido no nível superior");
+        return NULL;
+    }
     else
     {
         return parse_statement(parser);
     }
 }
 
-static ASTNode **parse_argument_list(Parser *parser, int *count)
+/* Lista de expressões separadas por vírgula até 'closing' (não consumido) */
+static ASTNode **parse_expression_list(Parser *parser, TokenType closing, const char *comma_msg, int *count)
 {
     *count = 0;
     ASTNode **args = NULL;
     int capacity = 0;
 
-    while (!check(parser, TOKEN_RIGHT_PAREN) && !check(parser, TOKEN_EOF))
+    while (!check(parser, closing) && !check(parser, TOKEN_EOF))
     {
         if (*count > 0)
         {
-            consume(parser, TOKEN_COMMA, "Esperado ',' entre argumentos");
+            consume(parser, TOKEN_COMMA, comma_msg);
         }
 
         ASTNode *arg = parse_expression(parser);
@@ -667,9 +1408,10 @@ static ASTNode **parse_argument_list(Parser *parser, int *count)
             // Cleanup
             for (int i = 0; i < *count; i++)
             {
-                ast_free(args[i]);
+                discard_node(parser, args[i]);
             }
             free(args);
+            *count = 0;
             return NULL;
         }
 
@@ -682,246 +1424,966 @@ static ASTNode **parse_argument_list(Parser *parser, int *count)
         args[(*count)++] = arg;
     }
 
-    return args;
+    return finish_list(parser, args, *count);
+}
+
+static ASTNode **parse_argument_list(Parser *parser, int *count)
+{
+    return parse_expression_list(parser, TOKEN_RIGHT_PAREN, "Esperado ',' entre argumentos", count);
+}
+
+/* --- PARSER DE EXPRESSÕES (PRATT) --- */
+
+/* Precedências (binding powers), da menor para a maior */
+typedef enum
+{
+    PREC_NONE,
+    PREC_ASSIGNMENT, // =
+    PREC_OR,         // ||
+    PREC_AND,        // &&
+    PREC_EQUALITY,   // == !=
+    PREC_COMPARISON, // < > <= >=
+    PREC_TERM,       // + -
+    PREC_FACTOR,     // * / %
+    PREC_UNARY,      // - !
+    PREC_CALL,       // a[i]
+    PREC_PRIMARY
+} Precedence;
+
+/* Funções de parse chamadas com o token do operador/literal já consumido */
+typedef ASTNode *(*PrefixParseFn)(Parser *parser);
+typedef ASTNode *(*InfixParseFn)(Parser *parser, ASTNode *left);
+
+typedef struct
+{
+    PrefixParseFn prefix; // Token no início de uma expressão
+    InfixParseFn infix;   // Token entre dois operandos
+    Precedence precedence; // Precedência do uso infixo
+} ParseRule;
+
+static ASTNode *parse_precedence(Parser *parser, Precedence precedence);
+
+static ASTNode *parse_literal(Parser *parser)
+{
+    return make_literal_node(parser, &parser->previous_token);
+}
+
+static ASTNode *parse_identifier(Parser *parser)
+{
+    char *name = node_text(parser, &parser->previous_token);
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    // Verificar se é chamada de função
+    if (check(parser, TOKEN_LEFT_PAREN))
+    {
+        advance(parser); // consome '('
+
+        int arg_count = 0;
+        ASTNode **args = parse_argument_list(parser, &arg_count);
+
+        consume(parser, TOKEN_RIGHT_PAREN, "Esperado ')' após argumentos");
+
+        return make_call_node(parser, name, args, arg_count, line, col);
+    }
+
+    return make_var_node(parser, name, line, col);
+}
+
+static ASTNode *parse_grouping(Parser *parser)
+{
+    ASTNode *expr = parse_expression(parser);
+    consume(parser, TOKEN_RIGHT_PAREN, "Esperado ')' após expressão");
+    return expr;
+}
+
+static ASTNode *parse_unary(Parser *parser)
+{
+    TokenType operator = parser->previous_token.type;
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    // '-' seguido de literal int vira um literal negativo
+    if (operator == TOKEN_MINUS && check(parser, TOKEN_INT_LITERAL))
+    {
+        Token minus = parser->previous_token;
+        advance(parser);
+        return make_negative_int_node(parser, &minus, &parser->previous_token);
+    }
+
+    ASTNode *operand = parse_precedence(parser, PREC_UNARY);
+    if (!operand)
+        return NULL;
+
+    return make_unary_node(parser, operator, operand, line, col);
+}
+
+static ASTNode *parse_array_literal(Parser *parser)
+{
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    int count = 0;
+    ASTNode **elements = parse_expression_list(parser, TOKEN_RIGHT_BRACKET,
+                                               "Esperado ',' entre elementos do array", &count);
+    consume(parser, TOKEN_RIGHT_BRACKET, "Esperado ']' após elementos do array");
+
+    return make_array_literal_node(parser, elements, count, line, col);
+}
+
+/* {k: v, ...}; '{}' é o map vazio */
+static ASTNode *parse_map_literal(Parser *parser)
+{
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    ASTNode **items = NULL;
+    int count = 0; // Nós em 'items' (2 por par)
+    int capacity = 0;
+
+    while (!check(parser, TOKEN_RIGHT_BRACE) && !check(parser, TOKEN_EOF))
+    {
+        if (count > 0)
+        {
+            consume(parser, TOKEN_COMMA, "Esperado ',' entre os pares do map");
+        }
+
+        ASTNode *key = parse_expression(parser);
+        ASTNode *value = NULL;
+        if (key)
+        {
+            consume(parser, TOKEN_COLON, "Esperado ':' entre chave e valor do map");
+            value = parse_expression(parser);
+        }
+
+        if (!value)
+        {
+            if (key)
+                discard_node(parser, key);
+            for (int i = 0; i < count; i++)
+            {
+                discard_node(parser, items[i]);
+            }
+            free(items);
+            return NULL;
+        }
+
+        if (count + 2 > capacity)
+        {
+            capacity = capacity == 0 ? 8 : capacity * 2;
+            items = realloc(items, sizeof(ASTNode *) * capacity);
+        }
+
+        items[count++] = key;
+        items[count++] = value;
+    }
+
+    consume(parser, TOKEN_RIGHT_BRACE, "Esperado '}' após os pares do map");
+
+    return make_map_literal_node(parser, finish_list(parser, items, count), count / 2, line, col);
+}
+
+static ASTNode *parse_binary(Parser *parser, ASTNode *left);
+static ASTNode *parse_assignment(Parser *parser, ASTNode *left);
+static ASTNode *parse_index(Parser *parser, ASTNode *left);
+static ASTNode *parse_field(Parser *parser, ASTNode *left);
+
+/* Tabela de regras indexada por TokenType; novos operadores são uma entrada aqui */
+static const ParseRule parse_rules[TOKEN_ERROR + 1] = {
+    [TOKEN_TRUE] = {parse_literal, NULL, PREC_NONE},
+    [TOKEN_FALSE] = {parse_literal, NULL, PREC_NONE},
+    [TOKEN_INT_LITERAL] = {parse_literal, NULL, PREC_NONE},
+    [TOKEN_FLOAT_LITERAL] = {parse_literal, NULL, PREC_NONE},
+    [TOKEN_STRING_LITERAL] = {parse_literal, NULL, PREC_NONE},
+    [TOKEN_IDENTIFIER] = {parse_identifier, NULL, PREC_NONE},
+    [TOKEN_LEFT_PAREN] = {parse_grouping, NULL, PREC_NONE},
+    [TOKEN_LEFT_BRACKET] = {parse_array_literal, parse_index, PREC_CALL},
+    [TOKEN_LEFT_BRACE] = {parse_map_literal, NULL, PREC_NONE},
+    [TOKEN_DOT] = {NULL, parse_field, PREC_CALL},
+    [TOKEN_EQUAL] = {NULL, parse_assignment, PREC_ASSIGNMENT},
+    [TOKEN_PIPE_PIPE] = {NULL, parse_binary, PREC_OR},
+    [TOKEN_AND_AND] = {NULL, parse_binary, PREC_AND},
+    [TOKEN_BANG] = {parse_unary, NULL, PREC_NONE},
+    [TOKEN_EQUAL_EQUAL] = {NULL, parse_binary, PREC_EQUALITY},
+    [TOKEN_BANG_EQUAL] = {NULL, parse_binary, PREC_EQUALITY},
+    [TOKEN_GREATER] = {NULL, parse_binary, PREC_COMPARISON},
+    [TOKEN_GREATER_EQUAL] = {NULL, parse_binary, PREC_COMPARISON},
+    [TOKEN_LESS] = {NULL, parse_binary, PREC_COMPARISON},
+    [TOKEN_LESS_EQUAL] = {NULL, parse_binary, PREC_COMPARISON},
+    [TOKEN_PLUS] = {NULL, parse_binary, PREC_TERM},
+    [TOKEN_MINUS] = {parse_unary, parse_binary, PREC_TERM},
+    [TOKEN_STAR] = {NULL, parse_binary, PREC_FACTOR},
+    [TOKEN_SLASH] = {NULL, parse_binary, PREC_FACTOR},
+    [TOKEN_PERCENT] = {NULL, parse_binary, PREC_FACTOR},
+};
+
+static ASTNode *parse_binary(Parser *parser, ASTNode *left)
+{
+    TokenType operator = parser->previous_token.type;
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    // Associatividade à esquerda: o lado direito só aceita precedência maior
+    ASTNode *right = parse_precedence(parser, parse_rules[operator].precedence + 1);
+    if (!right)
+    {
+        discard_node(parser, left);
+        return NULL;
+    }
+
+    return make_binary_node(parser, operator, left, right, line, col);
+}
+
+static ASTNode *parse_index(Parser *parser, ASTNode *left)
+{
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    ASTNode *index = parse_expression(parser);
+    if (!index)
+    {
+        discard_node(parser, left);
+        return NULL;
+    }
+
+    consume(parser, TOKEN_RIGHT_BRACKET, "Esperado ']' após índice");
+
+    return make_index_node(parser, left, index, line, col);
+}
+
+static ASTNode *parse_field(Parser *parser, ASTNode *left)
+{
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+
+    if (!check(parser, TOKEN_IDENTIFIER))
+    {
+        parser_error(parser, "Esperado nome do campo após '.'");
+        discard_node(parser, left);
+        return NULL;
+    }
+    advance(parser);
+
+    char *field_name = node_text(parser, &parser->previous_token);
+    return make_field_node(parser, NODE_FIELD_EXPR, left, field_name, NULL, line, col);
+}
+
+/* r.campo = v: reaproveita objeto e nome do nó de acesso, que é descartado */
+static ASTNode *parse_field_assignment(Parser *parser, ASTNode *left)
+{
+    ASTNode *object = left->data.field_expr.object;
+    char *field_name = left->data.field_expr.field_name;
+    left->data.field_expr.object = NULL;
+    left->data.field_expr.field_name = NULL;
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+    discard_node(parser, left);
+
+    ASTNode *value = parse_precedence(parser, PREC_ASSIGNMENT);
+    if (!value)
+    {
+        discard_node(parser, object);
+        discard_memory(parser, field_name);
+        return NULL;
+    }
+
+    return make_field_node(parser, NODE_FIELD_ASSIGN, object, field_name, value, line, col);
+}
+
+/* a[i] = v: reaproveita array e índice do nó de indexação, que é descartado */
+static ASTNode *parse_index_assignment(Parser *parser, ASTNode *left)
+{
+    ASTNode *array = left->data.index_expr.array;
+    ASTNode *index = left->data.index_expr.index;
+    left->data.index_expr.array = NULL;
+    left->data.index_expr.index = NULL;
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+    discard_node(parser, left);
+
+    ASTNode *value = parse_precedence(parser, PREC_ASSIGNMENT);
+    if (!value)
+    {
+        discard_node(parser, array);
+        discard_node(parser, index);
+        return NULL;
+    }
+
+    return make_index_assign_node(parser, array, index, value, line, col);
+}
+
+static ASTNode *parse_assignment(Parser *parser, ASTNode *left)
+{
+    if (left->node_type == NODE_INDEX_EXPR)
+    {
+        return parse_index_assignment(parser, left);
+    }
+
+    if (left->node_type == NODE_FIELD_EXPR)
+    {
+        return parse_field_assignment(parser, left);
+    }
+
+    if (left->node_type != NODE_VAR_EXPR)
+    {
+        parser_error(parser, "Lado esquerdo da atribuição deve ser uma variável");
+        discard_node(parser, left);
+        return NULL;
+    }
+
+    // Reaproveita o nome do nó de variável, que é descartado
+    char *var_name = left->data.var_expr.name;
+    left->data.var_expr.name = NULL;
+    int line = parser->previous_token.line;
+    int col = parser->previous_token.column;
+    discard_node(parser, left);
+
+    // Associatividade à direita: a = b = c
+    ASTNode *value = parse_precedence(parser, PREC_ASSIGNMENT);
+    if (!value)
+    {
+        discard_memory(parser, var_name);
+        return NULL;
+    }
+
+    return make_assign_node(parser, var_name, value, line, col);
+}
+
+/* Analisa uma expressão cujos operadores tenham precedência >= 'precedence' */
+static ASTNode *parse_precedence(Parser *parser, Precedence precedence)
+{
+    PrefixParseFn prefix = parse_rules[parser->current_token.type].prefix;
+    if (prefix == NULL)
+    {
+        parser_error(parser, "Expressão esperada");
+        return NULL;
+    }
+
+    advance(parser);
+    ASTNode *expr = prefix(parser);
+
+    while (expr != NULL && precedence <= parse_rules[parser->current_token.type].precedence)
+    {
+        InfixParseFn infix = parse_rules[parser->current_token.type].infix;
+        advance(parser);
+        expr = infix(parser, expr);
+    }
+
+    return expr;
+}
+
+static ASTNode *parse_expression(Parser *parser)
+{
+    return parse_precedence(parser, PREC_ASSIGNMENT);
+}
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+void parser_init_range(Parser *parser, TokenBuffer *tokens, int begin, int end)
+{
+    parser->lexer = NULL;
+    parser->tokens = tokens;
+    parser->token_index = begin;
+    parser->token_end = end;
+    parser->thread_count = 1;
+    parser->arena = NULL;
+    parser->on_declaration = NULL;
+    parser->hook_context = NULL;
+    parser->had_error = 0;
+    parser->panic_mode = 0;
+    parser->error_msg[0] = '\0';
+
+    parser->current_token.lexeme = NULL;
+    parser->previous_token.lexeme = NULL;
+    parser->previous_token.type = TOKEN_EOF;
+
+    // Avançar para o primeiro token
+    advance(parser);
+}
+
+/* Número de processadores disponíveis (1 se não for possível detectar) */
+static int parser_default_thread_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    int count = 1;
+#endif
+    if (count < 1)
+        count = 1;
+    return count > PARSER_MAX_THREADS ? PARSER_MAX_THREADS : count;
+}
+
+void parser_init(Parser *parser, Lexer *lexer)
+{
+    parser->lexer = lexer;
+    parser->tokens = NULL;
+    parser->token_index = 0;
+    parser->token_end = 0;
+    parser->thread_count = 1;
+    parser->arena = NULL;
+    parser->on_declaration = NULL;
+    parser->hook_context = NULL;
+    parser->had_error = 0;
+    parser->panic_mode = 0;
+    parser->error_msg[0] = '\0';
+
+    // Inicializar tokens
+    parser->current_token.lexeme = NULL;
+    parser->previous_token.lexeme = NULL;
+
+    // Avançar para o primeiro token
+    advance(parser);
+}
+
+void parser_init_tokens(Parser *parser, TokenBuffer *tokens)
+{
+    parser_init_range(parser, tokens, 0, tokens->count);
+    parser->thread_count = parser_default_thread_count();
+}
+
+void parser_cleanup(Parser *parser)
+{
+    // No modo pré-tokenizado os lexemes pertencem ao fonte
+    if (parser->tokens != NULL)
+        return;
+
+    token_free(&parser->current_token);
+    token_free(&parser->previous_token);
+}
+
+TokenType parser_peek_type(Parser *parser, int distance)
+{
+    if (distance == 0)
+        return parser->current_token.type;
+
+    if (parser->tokens == NULL)
+        return TOKEN_ERROR; // Lookahead > 0 exige o modo pré-tokenizado
+
+    // token_index já aponta para o token seguinte ao atual
+    int index = parser->token_index + distance - 1;
+    if (index >= parser->token_end)
+        return TOKEN_EOF;
+    return (TokenType)parser->tokens->types[index];
+}
+
+ASTNode **parse_declarations(Parser *parser, int *count)
+{
+    ASTNode **declarations = NULL;
+    int decl_count = 0;
+    int capacity = 0;
+
+    while (!check(parser, TOKEN_EOF))
+    {
+        int decl_line = parser->current_token.line;
+        int decl_col = parser->current_token.column;
+        ASTNode *decl = match(parser, TOKEN_IMPORT) ? parse_import(parser) : parse_declaration(parser);
+        if (decl)
+        {
+            // Modo fundido: entregar enquanto a subárvore ainda está no cache
+            if (parser->on_declaration && !parser->had_error)
+                parser->on_declaration(parser->hook_context, decl);
+
+            if (decl_count >= capacity)
+            {
+                capacity = capacity == 0 ? 8 : capacity * 2;
+                declarations = realloc(declarations, sizeof(ASTNode *) * capacity);
+            }
+            declarations[decl_count++] = decl;
+        }
+        else
+        {
+            recover_declaration(parser, decl_line, decl_col);
+        }
+    }
+
+    *count = decl_count;
+    return declarations;
+}
+
+/* --- PARSE PARALELO --- */
+
+/* Trecho de declarações de nível superior analisado por uma thread */
+typedef struct
+{
+    TokenBuffer *tokens;
+    int begin;
+    int end;
+    ASTNode **declarations;
+    int decl_count;
+    int had_error;
+    int use_arena; // Cada trecho aloca em sua própria arena (sem disputa)
+    AstArena arena;
+} ParseChunk;
+
+static void parse_chunk(ParseChunk *chunk)
+{
+    Parser parser;
+    parser_init_range(&parser, chunk->tokens, chunk->begin, chunk->end);
+    if (chunk->use_arena)
+        parser.arena = &chunk->arena;
+    chunk->declarations = parse_declarations(&parser, &chunk->decl_count);
+    chunk->had_error = parser.had_error;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI parse_chunk_thread(LPVOID arg)
+{
+    parse_chunk((ParseChunk *)arg);
+    return 0;
+}
+#else
+static void *parse_chunk_thread(void *arg)
+{
+    parse_chunk((ParseChunk *)arg);
+    return NULL;
 }
+#endif
 
-static ASTNode *parse_primary(Parser *parser)
+/* Divide o buffer em trechos com número parecido de tokens, sempre em
+ * fronteiras de declaração; retorna o número de trechos */
+static int split_chunks(TokenBuffer *tokens, int wanted, int use_arena, ParseChunk *chunks)
 {
-    if (match(parser, TOKEN_TRUE) || match(parser, TOKEN_FALSE) ||
-        match(parser, TOKEN_INT_LITERAL) || match(parser, TOKEN_FLOAT_LITERAL) ||
-        match(parser, TOKEN_STRING_LITERAL))
+    int chunk_count = 0;
+    int begin = 0;
+    int next_decl = 0;
+
+    for (int k = 1; k < wanted; k++)
     {
-        return make_literal_node(&parser->previous_token);
+        int target = (int)((long long)tokens->count * k / wanted);
+        while (next_decl < tokens->decl_count &&
+               (tokens->decl_starts[next_decl] <= begin || tokens->decl_starts[next_decl] < target))
+            next_decl++;
+        if (next_decl >= tokens->decl_count)
+            break;
+
+        chunks[chunk_count].begin = begin;
+        chunks[chunk_count].end = tokens->decl_starts[next_decl];
+        chunk_count++;
+        begin = tokens->decl_starts[next_decl];
     }
 
-    if (match(parser, TOKEN_IDENTIFIER))
+    chunks[chunk_count].begin = begin;
+    chunks[chunk_count].end = tokens->count;
+    chunk_count++;
+
+    for (int i = 0; i < chunk_count; i++)
     {
-        char *name = strdup(parser->previous_token.lexeme);
-        int line = parser->previous_token.line;
-        int col = parser->previous_token.column;
+        chunks[i].tokens = tokens;
+        chunks[i].declarations = NULL;
+        chunks[i].decl_count = 0;
+        chunks[i].had_error = 0;
+        chunks[i].use_arena = use_arena;
+        ast_arena_init(&chunks[i].arena);
+    }
+    return chunk_count;
+}
 
-        // Verificar se é chamada de função
-        if (check(parser, TOKEN_LEFT_PAREN))
-        {
-            advance(parser); // consome '('
+static ASTNode *parse_program_parallel(Parser *parser)
+{
+    ParseChunk chunks[PARSER_MAX_THREADS];
+    int wanted = parser->thread_count > PARSER_MAX_THREADS ? PARSER_MAX_THREADS : parser->thread_count;
+    int chunk_count = split_chunks(parser->tokens, wanted, parser->arena != NULL, chunks);
 
-            int arg_count = 0;
-            ASTNode **args = parse_argument_list(parser, &arg_count);
+#ifdef _WIN32
+    HANDLE threads[PARSER_MAX_THREADS];
+#else
+    pthread_t threads[PARSER_MAX_THREADS];
+#endif
+    int started[PARSER_MAX_THREADS] = {0};
 
-            consume(parser, TOKEN_RIGHT_PAREN, "Esperado ')' após argumentos");
+    // O primeiro trecho é analisado na thread atual
+    for (int i = 1; i < chunk_count; i++)
+    {
+#ifdef _WIN32
+        threads[i] = CreateThread(NULL, 0, parse_chunk_thread, &chunks[i], 0, NULL);
+        started[i] = threads[i] != NULL;
+#else
+        started[i] = pthread_create(&threads[i], NULL, parse_chunk_thread, &chunks[i]) == 0;
+#endif
+        if (!started[i])
+            parse_chunk(&chunks[i]); // Sem thread disponível: analisa aqui mesmo
+    }
+    parse_chunk(&chunks[0]);
 
-            return make_call_node(name, args, arg_count, line, col);
+    int total = 0;
+    for (int i = 0; i < chunk_count; i++)
+    {
+        if (i > 0 && started[i])
+        {
+#ifdef _WIN32
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+#else
+            pthread_join(threads[i], NULL);
+#endif
         }
-
-        return make_var_node(name, line, col);
+        total += chunks[i].decl_count;
+        if (chunks[i].had_error)
+            parser->had_error = 1;
+        if (parser->arena != NULL)
+            ast_arena_merge(parser->arena, &chunks[i].arena);
     }
 
-    if (match(parser, TOKEN_LEFT_PAREN))
+    // Reúne os nós na ordem do fonte
+    ASTNode **declarations = total > 0 ? malloc(sizeof(ASTNode *) * total) : NULL;
+    int decl_count = 0;
+    for (int i = 0; i < chunk_count; i++)
     {
-        ASTNode *expr = parse_expression(parser);
-        consume(parser, TOKEN_RIGHT_PAREN, "Esperado ')' após expressão");
-        return expr;
+        if (declarations)
+        {
+            memcpy(declarations + decl_count, chunks[i].declarations,
+                   sizeof(ASTNode *) * chunks[i].decl_count);
+            decl_count += chunks[i].decl_count;
+        }
+        else
+        {
+            for (int j = 0; j < chunks[i].decl_count; j++)
+                discard_node(parser, chunks[i].declarations[j]);
+        }
+        free(chunks[i].declarations);
     }
 
-    parser_error(parser, "Expressão esperada");
-    return NULL;
+    if (total > 0 && !declarations)
+        parser->had_error = 1;
+
+    // O parser principal termina posicionado no fim da entrada
+    parser->token_index = parser->token_end;
+    parser->current_token = token_buffer_get(parser->tokens, parser->token_end);
+
+    declarations = finish_list(parser, declarations, decl_count);
+    return make_block_node(parser, declarations, decl_count, 1, 1);
 }
 
-static ASTNode *parse_unary(Parser *parser)
+ASTNode *parse_program(Parser *parser)
 {
-    if (match(parser, TOKEN_MINUS))
+    // Parse paralelo apenas para buffers grandes e analisados desde o início
+    // (no modo fundido as declarações precisam chegar ao gancho em ordem)
+    if (parser->tokens != NULL && parser->thread_count > 1 && parser->token_index == 1 &&
+        parser->on_declaration == NULL &&
+        parser->token_end == parser->tokens->count &&
+        parser->tokens->count >= PARSER_PARALLEL_MIN_TOKENS && parser->tokens->decl_count > 1)
     {
-        TokenType operator = parser->previous_token.type;
-        int line = parser->previous_token.line;
-        int col = parser->previous_token.column;
+        return parse_program_parallel(parser);
+    }
 
-        ASTNode *operand = parse_unary(parser);
-        if (!operand)
-            return NULL;
+    int decl_count = 0;
+    ASTNode **declarations = parse_declarations(parser, &decl_count);
+    declarations = finish_list(parser, declarations, decl_count);
+    return make_block_node(parser, declarations, decl_count, 1, 1);
+}
 
-        return make_unary_node(operator, operand, line, col);
-    }
+/* --- ARENA DA AST --- */
 
-    return parse_primary(parser);
+#define AST_ARENA_BLOCK_SIZE (64 * 1024)
+#define AST_ARENA_ALIGN 8
+
+void ast_arena_init(AstArena *arena)
+{
+    arena->head = NULL;
+    arena->bytes = 0;
 }
 
-static ASTNode *parse_factor(Parser *parser)
+void *ast_arena_alloc(AstArena *arena, size_t size)
 {
-    ASTNode *expr = parse_unary(parser);
+    size = (size + AST_ARENA_ALIGN - 1) & ~(size_t)(AST_ARENA_ALIGN - 1);
 
-    while (match(parser, TOKEN_STAR) || match(parser, TOKEN_SLASH))
+    AstArenaBlock *block = arena->head;
+    if (block == NULL || block->capacity - block->used < size)
     {
-        TokenType operator = parser->previous_token.type;
-        int line = parser->previous_token.line;
-        int col = parser->previous_token.column;
-
-        ASTNode *right = parse_unary(parser);
-        if (!right)
-        {
-            ast_free(expr);
+        // Pedidos maiores que um bloco recebem um bloco só para eles
+        size_t capacity = size > AST_ARENA_BLOCK_SIZE ? size : AST_ARENA_BLOCK_SIZE;
+        block = malloc(sizeof(AstArenaBlock) + capacity);
+        if (block == NULL)
             return NULL;
-        }
 
-        expr = make_binary_node(operator, expr, right, line, col);
+        block->used = 0;
+        block->capacity = capacity;
+        block->next = arena->head;
+        arena->head = block;
     }
 
-    return expr;
+    void *memory = block->data + block->used;
+    block->used += size;
+    arena->bytes += size;
+    return memory;
 }
 
-static ASTNode *parse_term(Parser *parser)
-{
-    ASTNode *expr = parse_factor(parser);
+/* --- TABELA DE DESPACHO DO MATCH --- */
 
-    while (match(parser, TOKEN_PLUS) || match(parser, TOKEN_MINUS))
-    {
-        TokenType operator = parser->previous_token.type;
-        int line = parser->previous_token.line;
-        int col = parser->previous_token.column;
+/* Rótulos int viram tabela de salto enquanto ao menos 1 a cada
+ * MATCH_JUMP_SPREAD slots estiver ocupado; acima disso, busca binária */
+#define MATCH_JUMP_SPREAD 3
 
-        ASTNode *right = parse_factor(parser);
-        if (!right)
-        {
-            ast_free(expr);
-            return NULL;
-        }
+typedef struct
+{
+    int value;
+    int order; // Posição no fonte: entre rótulos iguais, o repetido é o posterior
+    int arm;
+    const ASTNode *label;
+} MatchIntLabel;
 
-        expr = make_binary_node(operator, expr, right, line, col);
-    }
+static int compare_int_labels(const void *a, const void *b)
+{
+    const MatchIntLabel *x = a;
+    const MatchIntLabel *y = b;
+    if (x->value != y->value)
+        return x->value < y->value ? -1 : 1;
+    return x->order - y->order;
+}
 
-    return expr;
+/* FNV-1a de 32 bits */
+static uint32_t match_hash(const char *chars, int length)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)chars[i];
+        hash *= 16777619u;
+    }
+    return hash;
 }
 
-static ASTNode *parse_comparison(Parser *parser)
+static MatchTable *match_table_alloc(AstArena *arena, size_t size)
 {
-    ASTNode *expr = parse_term(parser);
+    MatchTable *table = arena != NULL ? ast_arena_alloc(arena, size) : malloc(size);
+    if (table)
+        memset(table, 0, sizeof(MatchTable));
+    return table;
+}
 
-    while (match(parser, TOKEN_GREATER) || match(parser, TOKEN_GREATER_EQUAL) ||
-           match(parser, TOKEN_LESS) || match(parser, TOKEN_LESS_EQUAL))
+static MatchTable *build_int_table(MatchIntLabel *labels, int count, AstArena *arena,
+                                   const ASTNode **duplicate)
+{
+    qsort(labels, count, sizeof(MatchIntLabel), compare_int_labels);
+    for (int i = 1; i < count; i++)
     {
-        TokenType operator = parser->previous_token.type;
-        int line = parser->previous_token.line;
-        int col = parser->previous_token.column;
-
-        ASTNode *right = parse_term(parser);
-        if (!right)
+        if (labels[i].value == labels[i - 1].value)
         {
-            ast_free(expr);
+            if (duplicate)
+                *duplicate = labels[i].label;
             return NULL;
         }
+    }
+
+    int64_t span = count > 0 ? (int64_t)labels[count - 1].value - labels[0].value + 1 : 0;
+    if (count > 0 && span <= (int64_t)count * MATCH_JUMP_SPREAD)
+    {
+        MatchTable *table = match_table_alloc(arena, sizeof(MatchTable) + sizeof(int) * (size_t)span);
+        if (!table)
+            return NULL;
 
-        expr = make_binary_node(operator, expr, right, line, col);
+        table->kind = MATCH_JUMP_TABLE;
+        table->base = labels[0].value;
+        table->size = (int)span;
+        table->arms = (int *)(table + 1);
+        for (int i = 0; i < table->size; i++)
+            table->arms[i] = -1;
+        for (int i = 0; i < count; i++)
+            table->arms[labels[i].value - table->base] = labels[i].arm;
+        return table;
     }
 
-    return expr;
+    MatchTable *table = match_table_alloc(arena, sizeof(MatchTable) + sizeof(int) * 2 * (size_t)count);
+    if (!table)
+        return NULL;
+
+    table->kind = MATCH_BINARY_SEARCH;
+    table->size = count;
+    table->keys = (int *)(table + 1);
+    table->arms = table->keys + count;
+    for (int i = 0; i < count; i++)
+    {
+        table->keys[i] = labels[i].value;
+        table->arms[i] = labels[i].arm;
+    }
+    return table;
 }
 
-static ASTNode *parse_equality(Parser *parser)
+static MatchTable *build_string_table(const ASTNode *node, int count, AstArena *arena,
+                                      const ASTNode **duplicate)
 {
-    ASTNode *expr = parse_comparison(parser);
+    int capacity = 8;
+    while (capacity < count * 2)
+        capacity *= 2;
+
+    size_t size = sizeof(MatchTable) +
+                  (size_t)capacity * (sizeof(char *) + sizeof(uint32_t) + 2 * sizeof(int));
+    MatchTable *table = match_table_alloc(arena, size);
+    if (!table)
+        return NULL;
 
-    while (match(parser, TOKEN_EQUAL_EQUAL) || match(parser, TOKEN_BANG_EQUAL))
+    table->kind = MATCH_STRING_HASH;
+    table->size = capacity;
+    table->strings = (const char **)(table + 1);
+    table->hashes = (uint32_t *)(table->strings + capacity);
+    table->lengths = (int *)(table->hashes + capacity);
+    table->arms = table->lengths + capacity;
+    for (int i = 0; i < capacity; i++)
     {
-        TokenType operator = parser->previous_token.type;
-        int line = parser->previous_token.line;
-        int col = parser->previous_token.column;
+        table->strings[i] = NULL;
+        table->arms[i] = -1;
+    }
 
-        ASTNode *right = parse_comparison(parser);
-        if (!right)
+    for (int a = 0; a < node->data.match_stmt.arm_count; a++)
+    {
+        const ASTNode *arm = node->data.match_stmt.arms[a];
+        for (int l = 0; l < arm->data.match_arm.label_count; l++)
         {
-            ast_free(expr);
-            return NULL;
-        }
+            const ASTNode *label = arm->data.match_arm.labels[l];
+            const char *text = label->data.literal.value.string_value;
+            int length = (int)strlen(text);
+            uint32_t hash = match_hash(text, length);
 
-        expr = make_binary_node(operator, expr, right, line, col);
-    }
+            int slot = (int)(hash & (uint32_t)(capacity - 1));
+            while (table->strings[slot] != NULL)
+            {
+                if (table->hashes[slot] == hash && table->lengths[slot] == length &&
+                    memcmp(table->strings[slot], text, length) == 0)
+                {
+                    if (duplicate)
+                        *duplicate = label;
+                    if (arena == NULL)
+                        free(table);
+                    return NULL;
+                }
+                slot = (slot + 1) & (capacity - 1);
+            }
 
-    return expr;
+            table->strings[slot] = text;
+            table->hashes[slot] = hash;
+            table->lengths[slot] = length;
+            table->arms[slot] = a;
+        }
+    }
+    return table;
 }
 
-static ASTNode *parse_assignment(Parser *parser)
+MatchTable *match_table_build(const ASTNode *node, AstArena *arena, const ASTNode **duplicate)
 {
-    ASTNode *expr = parse_equality(parser);
+    if (duplicate)
+        *duplicate = NULL;
 
-    if (match(parser, TOKEN_EQUAL))
+    // Todos os rótulos precisam ser do mesmo tipo
+    int count = 0;
+    int strings = 0;
+    for (int a = 0; a < node->data.match_stmt.arm_count; a++)
     {
-        if (expr->node_type != NODE_VAR_EXPR)
+        const ASTNode *arm = node->data.match_stmt.arms[a];
+        for (int l = 0; l < arm->data.match_arm.label_count; l++)
         {
-            parser_error(parser, "Lado esquerdo da atribuição deve ser uma variável");
-            ast_free(expr);
-            return NULL;
+            if (arm->data.match_arm.labels[l]->data.literal.literal_type == TOKEN_STRING_LITERAL)
+                strings++;
+            count++;
         }
+    }
 
-        char *var_name = strdup(expr->data.var_expr.name);
-        int line = parser->previous_token.line;
-        int col = parser->previous_token.column;
-        ast_free(expr);
+    if (strings > 0)
+        return strings == count ? build_string_table(node, count, arena, duplicate) : NULL;
 
-        ASTNode *value = parse_assignment(parser);
-        if (!value)
+    MatchIntLabel *labels = malloc(sizeof(MatchIntLabel) * (count > 0 ? count : 1));
+    if (!labels)
+        return NULL;
+
+    int index = 0;
+    for (int a = 0; a < node->data.match_stmt.arm_count; a++)
+    {
+        const ASTNode *arm = node->data.match_stmt.arms[a];
+        for (int l = 0; l < arm->data.match_arm.label_count; l++)
         {
-            free(var_name);
-            return NULL;
+            labels[index].value = arm->data.match_arm.labels[l]->data.literal.value.int_value;
+            labels[index].order = index;
+            labels[index].arm = a;
+            labels[index].label = arm->data.match_arm.labels[l];
+            index++;
         }
-
-        return make_assign_node(var_name, value, line, col);
     }
 
-    return expr;
+    MatchTable *table = build_int_table(labels, count, arena, duplicate);
+    free(labels);
+    return table;
 }
 
-static ASTNode *parse_expression(Parser *parser)
+int match_table_find_int(const MatchTable *table, int value)
 {
-    return parse_assignment(parser);
-}
+    if (table->kind == MATCH_JUMP_TABLE)
+    {
+        int64_t slot = (int64_t)value - table->base;
+        return slot >= 0 && slot < table->size ? table->arms[slot] : -1;
+    }
+    if (table->kind != MATCH_BINARY_SEARCH)
+        return -1;
 
-/* --- FUNÇÕES PÚBLICAS --- */
+    int low = 0;
+    int high = table->size - 1;
+    while (low <= high)
+    {
+        int mid = low + (high - low) / 2;
+        if (table->keys[mid] == value)
+            return table->arms[mid];
+        if (table->keys[mid] < value)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
 
-void parser_init(Parser *parser, Lexer *lexer)
+int match_table_find_string(const MatchTable *table, const char *chars, int length)
 {
-    parser->lexer = lexer;
-    parser->had_error = 0;
-    parser->panic_mode = 0;
-    parser->error_msg[0] = '\0';
-
-    // Inicializar tokens
-    parser->current_token.lexeme = NULL;
-    parser->previous_token.lexeme = NULL;
+    if (table->kind != MATCH_STRING_HASH)
+        return -1;
 
-    // Avançar para o primeiro token
-    advance(parser);
+    uint32_t hash = match_hash(chars, length);
+    int slot = (int)(hash & (uint32_t)(table->size - 1));
+    while (table->strings[slot] != NULL)
+    {
+        if (table->hashes[slot] == hash && table->lengths[slot] == length &&
+            memcmp(table->strings[slot], chars, length) == 0)
+            return table->arms[slot];
+        slot = (slot + 1) & (table->size - 1);
+    }
+    return -1;
 }
 
-void parser_cleanup(Parser *parser)
+/* Move os blocos de 'source' para 'dest' (usado ao reunir o parse paralelo) */
+static void ast_arena_merge(AstArena *dest, AstArena *source)
 {
-    token_free(&parser->current_token);
-    token_free(&parser->previous_token);
+    if (source->head == NULL)
+        return;
+
+    if (dest->head == NULL)
+    {
+        dest->head = source->head;
+    }
+    else
+    {
+        // Os blocos entram depois do bloco atual de 'dest', que segue recebendo alocações
+        AstArenaBlock *tail = source->head;
+        while (tail->next != NULL)
+            tail = tail->next;
+        tail->next = dest->head->next;
+        dest->head->next = source->head;
+    }
+
+    dest->bytes += source->bytes;
+    ast_arena_init(source);
 }
 
-ASTNode *parse_program(Parser *parser)
+void ast_arena_free(AstArena *arena)
 {
-    ASTNode **declarations = NULL;
-    int decl_count = 0;
-    int capacity = 0;
-
-    while (!check(parser, TOKEN_EOF))
+    AstArenaBlock *block = arena->head;
+    while (block != NULL)
     {
-        ASTNode *decl = parse_declaration(parser);
-        if (decl)
-        {
-            if (decl_count >= capacity)
-            {
-                capacity = capacity == 0 ? 8 : capacity * 2;
-                declarations = realloc(declarations, sizeof(ASTNode *) * capacity);
-            }
-            declarations[decl_count++] = decl;
-        }
-        else
-        {
-            synchronize(parser);
-        }
+        AstArenaBlock *next = block->next;
+        free(block);
+        block = next;
     }
-
-    return make_block_node(declarations, decl_count, 1, 1);
+    ast_arena_init(arena);
 }
 
 /* --- FUNÇÕES DE UTILIDADE --- */
@@ -955,6 +2417,19 @@ void ast_free(ASTNode *node)
         ast_free(node->data.param.type_node);
         break;
 
+    case NODE_STRUCT_DECL:
+        free(node->data.struct_decl.name);
+        for (int i = 0; i < node->data.struct_decl.field_count; i++)
+        {
+            ast_free(node->data.struct_decl.fields[i]);
+        }
+        free(node->data.struct_decl.fields);
+        break;
+
+    case NODE_IMPORT:
+        free(node->data.import_stmt.path);
+        break;
+
     case NODE_IF_STMT:
         ast_free(node->data.if_stmt.condition);
         ast_free(node->data.if_stmt.then_branch);
@@ -966,6 +2441,34 @@ void ast_free(ASTNode *node)
         ast_free(node->data.while_stmt.body);
         break;
 
+    case NODE_FOR_STMT:
+        free(node->data.for_stmt.var_name);
+        ast_free(node->data.for_stmt.start);
+        ast_free(node->data.for_stmt.end);
+        ast_free(node->data.for_stmt.step);
+        ast_free(node->data.for_stmt.body);
+        break;
+
+    case NODE_MATCH_STMT:
+        ast_free(node->data.match_stmt.subject);
+        for (int i = 0; i < node->data.match_stmt.arm_count; i++)
+        {
+            ast_free(node->data.match_stmt.arms[i]);
+        }
+        free(node->data.match_stmt.arms);
+        ast_free(node->data.match_stmt.else_branch);
+        free(node->data.match_stmt.table);
+        break;
+
+    case NODE_MATCH_ARM:
+        for (int i = 0; i < node->data.match_arm.label_count; i++)
+        {
+            ast_free(node->data.match_arm.labels[i]);
+        }
+        free(node->data.match_arm.labels);
+        ast_free(node->data.match_arm.body);
+        break;
+
     case NODE_RETURN_STMT:
         ast_free(node->data.return_stmt.value);
         break;
@@ -1009,167 +2512,73 @@ void ast_free(ASTNode *node)
         free(node->data.var_expr.name);
         break;
 
-    case NODE_LITERAL:
-        if (node->data.literal.literal_type == TOKEN_STRING_LITERAL)
-        {
-            free(node->data.literal.value.string_value);
-        }
-        break;
-
-    case NODE_TYPE:
-        // Sem cleanup necessário
-        break;
-
-    default:
+    case NODE_INDEX_EXPR:
+        ast_free(node->data.index_expr.array);
+        ast_free(node->data.index_expr.index);
         break;
-    }
-
-    free(node);
-}
 
-void ast_print(ASTNode *node, int indent)
-{
-    if (!node)
-        return;
-
-    for (int i = 0; i < indent; i++)
-    {
-        printf("  ");
-    }
-
-    switch (node->node_type)
-    {
-    case NODE_VAR_DECL:
-        printf("VAR_DECL: %s:%s = \n",
-               node->data.var_decl.name,
-               data_type_to_string(node->data.var_decl.type_node->data.type_node.type));
-        ast_print(node->data.var_decl.initializer, indent + 1);
+    case NODE_INDEX_ASSIGN:
+        ast_free(node->data.index_assign.array);
+        ast_free(node->data.index_assign.index);
+        ast_free(node->data.index_assign.value);
         break;
 
-    case NODE_FUNC_DECL:
-        printf("FUNC_DECL: %s(", node->data.func_decl.name);
-        for (int i = 0; i < node->data.func_decl.param_count; i++)
-        {
-            if (i > 0)
-                printf(", ");
-            printf("%s:%s",
-                   node->data.func_decl.params[i]->data.param.name,
-                   data_type_to_string(node->data.func_decl.params[i]->data.param.type_node->data.type_node.type));
-        }
-        printf(") -> %s\n", data_type_to_string(node->data.func_decl.return_type->data.type_node.type));
-        ast_print(node->data.func_decl.body, indent + 1);
+    case NODE_FIELD_EXPR:
+    case NODE_FIELD_ASSIGN:
+        ast_free(node->data.field_expr.object);
+        free(node->data.field_expr.field_name);
+        ast_free(node->data.field_expr.value);
         break;
 
-    case NODE_IF_STMT:
-        printf("IF\n");
-        for (int i = 0; i < indent + 1; i++)
-            printf("  ");
-        printf("CONDITION:\n");
-        ast_print(node->data.if_stmt.condition, indent + 2);
-        for (int i = 0; i < indent + 1; i++)
-            printf("  ");
-        printf("THEN:\n");
-        ast_print(node->data.if_stmt.then_branch, indent + 2);
-        if (node->data.if_stmt.else_branch)
+    case NODE_ARRAY_LITERAL:
+        for (int i = 0; i < node->data.array_literal.element_count; i++)
         {
-            for (int i = 0; i < indent + 1; i++)
-                printf("  ");
-            printf("ELSE:\n");
-            ast_print(node->data.if_stmt.else_branch, indent + 2);
+            ast_free(node->data.array_literal.elements[i]);
         }
+        free(node->data.array_literal.elements);
         break;
 
-    case NODE_WHILE_STMT:
-        printf("WHILE\n");
-        for (int i = 0; i < indent + 1; i++)
-            printf("  ");
-        printf("CONDITION:\n");
-        ast_print(node->data.while_stmt.condition, indent + 2);
-        for (int i = 0; i < indent + 1; i++)
-            printf("  ");
-        printf("BODY:\n");
-        ast_print(node->data.while_stmt.body, indent + 2);
-        break;
-
-    case NODE_RETURN_STMT:
-        printf("RETURN\n");
-        if (node->data.return_stmt.value)
+    case NODE_MAP_LITERAL:
+        for (int i = 0; i < 2 * node->data.map_literal.entry_count; i++)
         {
-            ast_print(node->data.return_stmt.value, indent + 1);
+            ast_free(node->data.map_literal.items[i]);
         }
+        free(node->data.map_literal.items);
         break;
 
-    case NODE_BLOCK:
-        printf("BLOCK\n");
-        for (int i = 0; i < node->data.block.stmt_count; i++)
+    case NODE_LITERAL:
+        if (node->data.literal.literal_type == TOKEN_STRING_LITERAL)
         {
-            ast_print(node->data.block.statements[i], indent + 1);
+            free(node->data.literal.value.string_value);
         }
         break;
 
-    case NODE_EXPR_STMT:
-        printf("EXPR_STMT\n");
-        ast_print(node->data.block.statements[0], indent + 1);
-        break;
-
-    case NODE_BINARY_EXPR:
-        printf("BINARY_OP(%s)\n", token_type_to_string(node->data.binary_expr.operator));
-        ast_print(node->data.binary_expr.left, indent + 1);
-        ast_print(node->data.binary_expr.right, indent + 1);
-        break;
-
-    case NODE_UNARY_EXPR:
-        printf("UNARY_OP(%s)\n", token_type_to_string(node->data.unary_expr.operator));
-        ast_print(node->data.unary_expr.operand, indent + 1);
-        break;
-
-    case NODE_ASSIGN_EXPR:
-        printf("ASSIGN: %s =\n", node->data.assign_expr.variable_name);
-        ast_print(node->data.assign_expr.value, indent + 1);
+    case NODE_TYPE:
+        free(node->data.type_node.struct_name);
         break;
 
-    case NODE_CALL_EXPR:
-        printf("CALL: %s\n", node->data.call_expr.function_name);
-        for (int i = 0; i < node->data.call_expr.arg_count; i++)
-        {
-            for (int j = 0; j < indent + 1; j++)
-                printf("  ");
-            printf("ARG %d:\n", i);
-            ast_print(node->data.call_expr.arguments[i], indent + 2);
-        }
+    default:
         break;
+    }
 
-    case NODE_VAR_EXPR:
-        printf("VAR: %s\n", node->data.var_expr.name);
-        break;
+    free(node);
+}
 
-    case NODE_LITERAL:
-        printf("LITERAL: ");
-        switch (node->data.literal.literal_type)
-        {
-        case TOKEN_INT_LITERAL:
-            printf("%d\n", node->data.literal.value.int_value);
-            break;
-        case TOKEN_FLOAT_LITERAL:
-            printf("%.6f\n", node->data.literal.value.float_value);
-            break;
-        case TOKEN_STRING_LITERAL:
-            printf("\"%s\"\n", node->data.literal.value.string_value);
-            break;
-        case TOKEN_TRUE:
-        case TOKEN_FALSE:
-            printf("%s\n", node->data.literal.value.bool_value ? "true" : "false");
-            break;
-        default:
-            printf("unknown\n");
-            break;
-        }
-        break;
+/* Imprime a árvore pela forma compacta (craze_compact.c), que guarda os nós
+ * em pré-ordem num único array */
+void ast_print(ASTNode *node, int indent)
+{
+    if (!node)
+        return;
 
-    default:
-        printf("UNKNOWN_NODE\n");
-        break;
-    }
+    CompactAst compact;
+    compact_ast_init(&compact);
+    AstHandle root = compact_ast_build(&compact, node);
+    if (root != AST_NONE)
+        compact_ast_print(&compact, root, indent);
+    else
+        printf("(AST sem representação compacta)\n");
+    compact_ast_free(&compact);
 }
 
 const char *node_type_to_string(NodeType type)
@@ -1182,12 +2591,22 @@ const char *node_type_to_string(NodeType type)
         return "FUNC_DECL";
     case NODE_PARAM:
         return "PARAM";
+    case NODE_STRUCT_DECL:
+        return "STRUCT_DECL";
+    case NODE_IMPORT:
+        return "IMPORT";
     case NODE_EXPR_STMT:
         return "EXPR_STMT";
     case NODE_IF_STMT:
         return "IF_STMT";
     case NODE_WHILE_STMT:
         return "WHILE_STMT";
+    case NODE_FOR_STMT:
+        return "FOR_STMT";
+    case NODE_MATCH_STMT:
+        return "MATCH_STMT";
+    case NODE_MATCH_ARM:
+        return "MATCH_ARM";
     case NODE_RETURN_STMT:
         return "RETURN_STMT";
     case NODE_BLOCK:
@@ -1204,6 +2623,18 @@ const char *node_type_to_string(NodeType type)
         return "VAR_EXPR";
     case NODE_LITERAL_EXPR:
         return "LITERAL_EXPR";
+    case NODE_INDEX_EXPR:
+        return "INDEX_EXPR";
+    case NODE_INDEX_ASSIGN:
+        return "INDEX_ASSIGN";
+    case NODE_ARRAY_LITERAL:
+        return "ARRAY_LITERAL";
+    case NODE_MAP_LITERAL:
+        return "MAP_LITERAL";
+    case NODE_FIELD_EXPR:
+        return "FIELD_EXPR";
+    case NODE_FIELD_ASSIGN:
+        return "FIELD_ASSIGN";
     case NODE_TYPE:
         return "TYPE";
     case NODE_LITERAL:
@@ -1227,6 +2658,10 @@ const char *data_type_to_string(DataType type)
         return "string";
     case TYPE_BOOL:
         return "bool";
+    case TYPE_BYTES:
+        return "bytes";
+    case TYPE_STRUCT:
+        return "struct";
     case TYPE_INVALID:
         return "invalid";
     default:
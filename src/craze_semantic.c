@@ -1,9 +1,25 @@
 #include "../include/craze_semantic.h"
+#include "../include/craze_module.h"
+#include <limits.h>
 
 /* Para strdup no MinGW */
 #ifdef _WIN32
 #endif
 
+/* Threads para a verificação paralela dos corpos de funções */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* Número mínimo de funções de nível superior para dividir a análise entre
+ * threads; abaixo disso o custo de criar threads supera o ganho */
+#ifndef SEMANTIC_PARALLEL_MIN_FUNCTIONS
+#define SEMANTIC_PARALLEL_MIN_FUNCTIONS 256
+#endif
+#define SEMANTIC_MAX_THREADS 16
+
 /* --- DECLARAÇÕES ANTECIPADAS --- */
 static void semantic_error(SemanticAnalyzer *analyzer, int line, int column, const char *format, ...);
 static void semantic_warning(SemanticAnalyzer *analyzer, int line, int column, const char *format, ...);
@@ -20,59 +36,262 @@ static int symbol_insert(SemanticAnalyzer *analyzer, SymbolEntry *entry);
 static void visit_node(SemanticAnalyzer *analyzer, ASTNode *node);
 static TypeCheckResult check_expression(SemanticAnalyzer *analyzer, ASTNode *node);
 
-/* --- FUNÇÕES DE UTILIDADE PARA TIPOS --- */
+/* --- TIPOS INTERNADOS --- */
+/* Cada tipo existe uma única vez: os primitivos são constantes estáticas e os
+ * compostos (arrays, tipos com 'inner') passam por hash-consing. Assim a
+ * verificação não aloca nada por expressão, tipos não têm dono nem precisam
+ * ser liberados, e dois tipos são iguais se e somente se os ponteiros são. */
+
+#define TYPE_INTERN_BUCKETS 256
+
+static const TypeInfo primitive_types[TYPE_INVALID + 1] = {
+    [TYPE_INT] = {TYPE_INT, 0, 0, NULL},
+    [TYPE_FLOAT] = {TYPE_FLOAT, 0, 0, NULL},
+    [TYPE_STRING] = {TYPE_STRING, 0, 0, NULL},
+    [TYPE_BOOL] = {TYPE_BOOL, 0, 0, NULL},
+    [TYPE_BYTES] = {TYPE_BYTES, 0, 0, NULL},
+    [TYPE_VOID] = {TYPE_VOID, 0, 0, NULL},
+    [TYPE_INVALID] = {TYPE_INVALID, 0, 0, NULL},
+};
+
+typedef struct InternedType
+{
+    TypeInfo type; // Primeiro membro: um TypeInfo de map é um InternedType
+    struct InternedType *next;
+    char name[40]; // "map<string, int>" (só maps; os demais nomes são constantes)
+} InternedType;
+
+static InternedType *interned_types[TYPE_INTERN_BUCKETS];
+
+/* A tabela de compostos é compartilhada pelas threads da análise paralela */
+#ifdef _WIN32
+static SRWLOCK interned_types_lock = SRWLOCK_INIT;
+#define INTERNED_TYPES_LOCK() AcquireSRWLockExclusive(&interned_types_lock)
+#define INTERNED_TYPES_UNLOCK() ReleaseSRWLockExclusive(&interned_types_lock)
+#else
+static pthread_mutex_t interned_types_lock = PTHREAD_MUTEX_INITIALIZER;
+#define INTERNED_TYPES_LOCK() pthread_mutex_lock(&interned_types_lock)
+#define INTERNED_TYPES_UNLOCK() pthread_mutex_unlock(&interned_types_lock)
+#endif
 
-TypeInfo *typeinfo_create(DataType base_type)
+static const TypeInfo *intern_type(DataType base_type, int is_array, int is_map, int is_const,
+                                   const TypeInfo *inner, const TypeInfo *key)
 {
-    TypeInfo *type_info = malloc(sizeof(TypeInfo));
-    if (!type_info)
-        return NULL;
+    if ((unsigned)base_type > TYPE_INVALID)
+        base_type = TYPE_INVALID;
+
+    if (!is_array && !is_map && !is_const && !inner)
+        return &primitive_types[base_type];
+
+    // 'inner' e 'key' já são canônicos: seus endereços identificam o tipo inteiro
+    uintptr_t hash = (uintptr_t)inner ^ ((uintptr_t)key >> 3);
+    hash ^= (uintptr_t)base_type * 31u + (uintptr_t)(is_map ? 4 : 0) +
+            (uintptr_t)(is_array ? 2 : 0) + (uintptr_t)(is_const ? 1 : 0);
+    hash ^= hash >> 7;
+    InternedType **bucket = &interned_types[hash & (TYPE_INTERN_BUCKETS - 1)];
+
+    INTERNED_TYPES_LOCK();
+    InternedType *entry;
+    for (entry = *bucket; entry; entry = entry->next)
+    {
+        if (entry->type.base_type == base_type && entry->type.is_array == !!is_array &&
+            entry->type.is_map == !!is_map && entry->type.is_const == !!is_const &&
+            entry->type.inner == inner && entry->type.key == key)
+            break;
+    }
+
+    if (!entry)
+    {
+        entry = malloc(sizeof(InternedType));
+        if (entry)
+        {
+            entry->type.base_type = base_type;
+            entry->type.is_array = !!is_array;
+            entry->type.is_const = !!is_const;
+            entry->type.inner = inner;
+            entry->type.is_map = !!is_map;
+            entry->type.key = key;
+            entry->type.layout = NULL;
+            entry->name[0] = '\0';
+            if (is_map)
+            {
+                snprintf(entry->name, sizeof(entry->name), "map<%s, %s>",
+                         typeinfo_to_string(key), typeinfo_to_string(inner));
+            }
+            entry->next = *bucket;
+            *bucket = entry;
+        }
+    }
+    INTERNED_TYPES_UNLOCK();
+
+    return entry ? &entry->type : &primitive_types[TYPE_INVALID];
+}
 
-    type_info->base_type = base_type;
-    type_info->is_array = 0;
-    type_info->is_const = 0;
-    type_info->inner = NULL;
+const TypeInfo *typeinfo_intern(DataType base_type, int is_array, int is_const, const TypeInfo *inner)
+{
+    return intern_type(base_type, is_array, 0, is_const, inner, NULL);
+}
 
-    return type_info;
+const TypeInfo *typeinfo_create(DataType base_type)
+{
+    return typeinfo_intern(base_type, 0, 0, NULL);
 }
 
-void typeinfo_free(TypeInfo *type_info)
+const TypeInfo *typeinfo_array(DataType element_type)
 {
-    if (!type_info)
-        return;
+    return typeinfo_intern(element_type, 1, 0, typeinfo_create(element_type));
+}
+
+const TypeInfo *typeinfo_map(DataType key_type, DataType value_type)
+{
+    return intern_type(value_type, 0, 1, 0, typeinfo_create(value_type), typeinfo_create(key_type));
+}
+
+/* --- STRUCTS INTERNADOS --- */
+/* Um struct é identificado pelo nome e pelos campos (nomes e tipos): duas
+ * declarações iguais dão o mesmo TypeInfo, uma alteração dá outro. São poucos,
+ * então a busca é linear. */
+
+typedef struct InternedStruct
+{
+    TypeInfo type; // type.layout aponta para o layout, alocado à parte
+    struct InternedStruct *next;
+} InternedStruct;
 
-    if (type_info->inner)
+static InternedStruct *interned_structs;
+
+/* Representação de um campo do tipo 'type' e seu tamanho (= alinhamento) */
+static FieldStorage field_storage(const TypeInfo *type, int *size)
+{
+    if (type == &primitive_types[TYPE_INT])
     {
-        typeinfo_free(type_info->inner);
+        *size = (int)sizeof(int32_t);
+        return FIELD_INT;
     }
-
-    free(type_info);
+    if (type == &primitive_types[TYPE_BOOL])
+    {
+        *size = 1;
+        return FIELD_BOOL;
+    }
+    if (type == &primitive_types[TYPE_FLOAT])
+    {
+        *size = (int)sizeof(double);
+        return FIELD_FLOAT;
+    }
+    *size = (int)sizeof(void *);
+    return FIELD_VALUE;
 }
 
-TypeInfo *typeinfo_copy(TypeInfo *type_info)
+static int struct_matches(const StructLayout *layout, const char *name, const char *const *field_names,
+                          const TypeInfo *const *field_types, int field_count)
 {
-    if (!type_info)
-        return NULL;
+    if (layout->field_count != field_count || strcmp(layout->name, name) != 0)
+        return 0;
+    for (int i = 0; i < field_count; i++)
+    {
+        if (layout->fields[i].type != field_types[i] || strcmp(layout->fields[i].name, field_names[i]) != 0)
+            return 0;
+    }
+    return 1;
+}
 
-    TypeInfo *copy = typeinfo_create(type_info->base_type);
-    if (!copy)
-        return NULL;
+const TypeInfo *typeinfo_struct(const char *name, const char *const *field_names,
+                                const TypeInfo *const *field_types, int field_count)
+{
+    INTERNED_TYPES_LOCK();
+    InternedStruct *entry;
+    for (entry = interned_structs; entry; entry = entry->next)
+    {
+        if (struct_matches(entry->type.layout, name, field_names, field_types, field_count))
+            break;
+    }
 
-    copy->is_array = type_info->is_array;
-    copy->is_const = type_info->is_const;
-    if (type_info->inner)
+    if (!entry)
     {
-        copy->inner = typeinfo_copy(type_info->inner);
+        // Nomes copiados logo após os campos: o layout é uma alocação só
+        size_t names_size = strlen(name) + 1;
+        for (int i = 0; i < field_count; i++)
+            names_size += strlen(field_names[i]) + 1;
+
+        entry = malloc(sizeof(InternedStruct));
+        StructLayout *layout = malloc(sizeof(StructLayout) + sizeof(StructField) * field_count + names_size);
+        if (entry && layout)
+        {
+            char *names = (char *)&layout->fields[field_count];
+            layout->name = strcpy(names, name);
+            names += strlen(name) + 1;
+
+            int offset = 0;
+            int max_align = 1;
+            for (int i = 0; i < field_count; i++)
+            {
+                int size;
+                StructField *field = &layout->fields[i];
+                field->name = strcpy(names, field_names[i]);
+                names += strlen(field_names[i]) + 1;
+                field->type = field_types[i];
+                field->storage = field_storage(field_types[i], &size);
+                offset = (offset + size - 1) / size * size;
+                field->offset = offset;
+                offset += size;
+                if (size > max_align)
+                    max_align = size;
+            }
+            layout->field_count = field_count;
+            layout->size = (offset + max_align - 1) / max_align * max_align;
+
+            memset(&entry->type, 0, sizeof(TypeInfo));
+            entry->type.base_type = TYPE_STRUCT;
+            entry->type.layout = layout;
+            entry->next = interned_structs;
+            interned_structs = entry;
+        }
+        else
+        {
+            free(entry);
+            free(layout);
+            entry = NULL;
+        }
     }
+    INTERNED_TYPES_UNLOCK();
 
-    return copy;
+    return entry ? &entry->type : &primitive_types[TYPE_INVALID];
 }
 
-const char *typeinfo_to_string(TypeInfo *type_info)
+const char *typeinfo_to_string(const TypeInfo *type_info)
 {
     if (!type_info)
         return "unknown";
 
+    if (type_info->layout)
+        return type_info->layout->name;
+
+    if (type_info->is_map)
+    {
+        if (type_info->base_type == TYPE_VOID)
+            return "{}"; // Literal vazio
+        return ((const InternedType *)type_info)->name;
+    }
+
+    if (type_info->is_array)
+    {
+        switch (type_info->base_type)
+        {
+        case TYPE_INT:
+            return "int[]";
+        case TYPE_FLOAT:
+            return "float[]";
+        case TYPE_STRING:
+            return "string[]";
+        case TYPE_BOOL:
+            return "bool[]";
+        case TYPE_VOID:
+            return "[]"; // Literal vazio
+        default:
+            return "invalid[]";
+        }
+    }
+
     switch (type_info->base_type)
     {
     case TYPE_VOID:
@@ -85,6 +304,8 @@ const char *typeinfo_to_string(TypeInfo *type_info)
         return "string";
     case TYPE_BOOL:
         return "bool";
+    case TYPE_BYTES:
+        return "bytes";
     case TYPE_INVALID:
         return "invalid";
     default:
@@ -108,6 +329,22 @@ static Scope *scope_create(ScopeType type, Scope *parent)
     return scope;
 }
 
+static void symbol_entry_free(SymbolEntry *entry)
+{
+    free(entry->name);
+
+    if (entry->category == SYMBOL_FUNCTION)
+    {
+        for (int i = 0; i < entry->details.func_info.param_count; i++)
+        {
+            // Os parâmetros serão liberados quando seus escopos forem destruídos
+        }
+        free(entry->details.func_info.parameters);
+    }
+
+    free(entry);
+}
+
 static void scope_destroy(Scope *scope)
 {
     if (!scope)
@@ -118,25 +355,86 @@ static void scope_destroy(Scope *scope)
     while (current)
     {
         SymbolEntry *next = current->next;
+        symbol_entry_free(current);
+        current = next;
+    }
+
+    free(scope);
+}
+
+/* --- ÍNDICE DE NOMES --- */
+
+#define NAME_INDEX_INITIAL_CAPACITY 64
+
+static uint64_t name_hash(const char *name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *name; name++)
+    {
+        hash ^= (unsigned char)*name;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Slot do nome, ou o slot vazio onde ele seria inserido */
+static NameSlot *index_slot(NameSlot *index, int capacity, const char *name)
+{
+    int mask = capacity - 1;
+    for (int i = (int)(name_hash(name) & (uint64_t)mask);; i = (i + 1) & mask)
+    {
+        if (!index[i].name || strcmp(index[i].name, name) == 0)
+            return &index[i];
+    }
+}
 
-        free(current->name);
-        typeinfo_free(current->type);
+/* Slot do nome, internando-o se ainda não existir (NULL se faltar memória) */
+static NameSlot *index_intern(SymbolTable *table, const char *name)
+{
+    if ((table->index_count + 1) * 2 > table->index_capacity)
+    {
+        int capacity = table->index_capacity * 2;
+        NameSlot *index = calloc(capacity, sizeof(NameSlot));
+        if (!index)
+            return NULL;
 
-        if (current->category == SYMBOL_FUNCTION)
+        for (int i = 0; i < table->index_capacity; i++)
         {
-            for (int i = 0; i < current->details.func_info.param_count; i++)
-            {
-                // Os parâmetros serão liberados quando seus escopos forem destruídos
-            }
-            free(current->details.func_info.parameters);
-            typeinfo_free(current->details.func_info.return_type);
+            if (table->index[i].name)
+                *index_slot(index, capacity, table->index[i].name) = table->index[i];
         }
+        free(table->index);
+        table->index = index;
+        table->index_capacity = capacity;
+    }
 
-        free(current);
-        current = next;
+    NameSlot *slot = index_slot(table->index, table->index_capacity, name);
+    if (!slot->name)
+    {
+        slot->name = strdup(name);
+        if (!slot->name)
+            return NULL;
+        slot->symbol = NULL;
+        table->index_count++;
     }
+    return slot;
+}
 
-    free(scope);
+/* Torna 'entry' o símbolo visível com seu nome */
+static void index_push(SymbolTable *table, SymbolEntry *entry)
+{
+    NameSlot *slot = index_intern(table, entry->name);
+    entry->shadowed = slot ? slot->symbol : NULL;
+    if (slot)
+        slot->symbol = entry;
+}
+
+/* Desfaz index_push: o nome volta a indicar o símbolo que 'entry' escondia */
+static void index_pop(SymbolTable *table, SymbolEntry *entry)
+{
+    NameSlot *slot = index_slot(table->index, table->index_capacity, entry->name);
+    if (slot->name && slot->symbol == entry)
+        slot->symbol = entry->shadowed;
 }
 
 static void enter_scope(SemanticAnalyzer *analyzer, ScopeType type)
@@ -157,31 +455,33 @@ static void exit_scope(SemanticAnalyzer *analyzer)
     Scope *old_scope = analyzer->symbol_table->current_scope;
     analyzer->symbol_table->current_scope = old_scope->parent;
 
+    // Do mais recente ao mais antigo, restaurando o que cada símbolo escondia
+    for (SymbolEntry *symbol = old_scope->symbols; symbol; symbol = symbol->next)
+        index_pop(analyzer->symbol_table, symbol);
+
     scope_destroy(old_scope);
     analyzer->symbol_table->scope_count--;
 }
 
 /* --- FUNÇÕES DE GESTÃO DE SÍMBOLOS --- */
 
-static SymbolEntry *symbol_lookup(SemanticAnalyzer *analyzer, const char *name)
+static SymbolEntry *index_lookup(const SymbolTable *table, const char *name)
 {
-    Scope *current = analyzer->symbol_table->current_scope;
-
-    while (current)
-    {
-        SymbolEntry *symbol = current->symbols;
-        while (symbol)
-        {
-            if (strcmp(symbol->name, name) == 0)
-            {
-                return symbol;
-            }
-            symbol = symbol->next;
-        }
-        current = current->parent;
-    }
+    NameSlot *slot = index_slot(table->index, table->index_capacity, name);
+    return slot->name ? slot->symbol : NULL;
+}
 
-    return NULL;
+static SymbolEntry *symbol_lookup(SemanticAnalyzer *analyzer, const char *name)
+{
+    SymbolEntry *symbol = index_lookup(analyzer->symbol_table, name);
+    if (symbol || !analyzer->shared_symbols)
+        return symbol;
+
+    // Análise paralela: símbolos do programa inseridos até a função em verificação
+    symbol = index_lookup(analyzer->shared_symbols, name);
+    while (symbol && symbol->declared_order > analyzer->visible_order)
+        symbol = symbol->shadowed;
+    return symbol;
 }
 
 static SymbolEntry *symbol_lookup_current(SemanticAnalyzer *analyzer, const char *name)
@@ -189,15 +489,11 @@ static SymbolEntry *symbol_lookup_current(SemanticAnalyzer *analyzer, const char
     if (!analyzer->symbol_table->current_scope)
         return NULL;
 
-    SymbolEntry *symbol = analyzer->symbol_table->current_scope->symbols;
-    while (symbol)
-    {
-        if (strcmp(symbol->name, name) == 0)
-        {
-            return symbol;
-        }
-        symbol = symbol->next;
-    }
+    // O símbolo visível mais interno só pertence ao escopo atual se tiver a
+    // mesma profundidade (a tabela compartilhada nunca é o escopo atual)
+    SymbolEntry *symbol = index_lookup(analyzer->symbol_table, name);
+    if (symbol && symbol->scope_depth == analyzer->symbol_table->current_scope->depth)
+        return symbol;
 
     return NULL;
 }
@@ -208,13 +504,15 @@ static int symbol_insert(SemanticAnalyzer *analyzer, SymbolEntry *entry)
         return 0;
 
     entry->scope_depth = analyzer->symbol_table->current_scope->depth;
+    entry->declared_order = analyzer->symbol_table->insert_count++;
     entry->next = analyzer->symbol_table->current_scope->symbols;
     analyzer->symbol_table->current_scope->symbols = entry;
+    index_push(analyzer->symbol_table, entry);
 
     return 1;
 }
 
-static SymbolEntry *symbol_create_variable(const char *name, TypeInfo *type, int line, int col)
+static SymbolEntry *symbol_create_variable(const char *name, const TypeInfo *type, int line, int col)
 {
     SymbolEntry *entry = malloc(sizeof(SymbolEntry));
     if (!entry)
@@ -226,12 +524,15 @@ static SymbolEntry *symbol_create_variable(const char *name, TypeInfo *type, int
     entry->declared_line = line;
     entry->declared_column = col;
     entry->next = NULL;
+    entry->shadowed = NULL;
+    entry->module = NULL;
     entry->details.var_info.initializer = NULL;
+    entry->details.var_info.is_loop_counter = 0;
 
     return entry;
 }
 
-static SymbolEntry *symbol_create_function(const char *name, TypeInfo *return_type,
+static SymbolEntry *symbol_create_function(const char *name, const TypeInfo *return_type,
                                            SymbolEntry **params, int param_count,
                                            int line, int col)
 {
@@ -245,42 +546,64 @@ static SymbolEntry *symbol_create_function(const char *name, TypeInfo *return_ty
     entry->declared_line = line;
     entry->declared_column = col;
     entry->next = NULL;
+    entry->shadowed = NULL;
+    entry->module = NULL;
     entry->details.func_info.parameters = params;
     entry->details.func_info.param_count = param_count;
-    entry->details.func_info.return_type = typeinfo_copy(return_type);
+    entry->details.func_info.return_type = return_type;
     entry->details.func_info.function_node = NULL;
+    entry->details.func_info.check_call = NULL;
 
     return entry;
 }
 
 /* --- FUNÇÕES DE VERIFICAÇÃO DE TIPOS --- */
 
-static int is_numeric_type(TypeInfo *type)
+/* Tipo escalar 'base_type' (não array); tipos internados comparam por ponteiro */
+static int is_primitive(const TypeInfo *type, DataType base_type)
+{
+    return type == &primitive_types[base_type];
+}
+
+static int is_numeric_type(const TypeInfo *type)
 {
-    return type && (type->base_type == TYPE_INT || type->base_type == TYPE_FLOAT);
+    return is_primitive(type, TYPE_INT) || is_primitive(type, TYPE_FLOAT);
 }
 
-static int are_types_compatible(TypeInfo *expected, TypeInfo *actual)
+static int are_types_compatible(const TypeInfo *expected, const TypeInfo *actual)
 {
     if (!expected || !actual)
         return 0;
 
-    // Mesmo tipo
-    if (expected->base_type == actual->base_type)
+    // Mesmo tipo (tipos são internados: mesmo tipo, mesmo ponteiro)
+    if (expected == actual)
+        return 1;
+
+    // Conversões numéricas permitidas: int -> float (só escalares: o
+    // armazenamento de int[] e float[] é diferente)
+    if (is_primitive(expected, TYPE_FLOAT) && is_primitive(actual, TYPE_INT))
+        return 1;
+
+    // Literal de array vazio serve para qualquer tipo de array
+    if (expected->is_array && actual == typeinfo_array(TYPE_VOID))
         return 1;
 
-    // Conversões numéricas permitidas: int -> float
-    if (expected->base_type == TYPE_FLOAT && actual->base_type == TYPE_INT)
+    // Idem para o literal de map vazio
+    if (expected->is_map && actual == typeinfo_map(TYPE_VOID, TYPE_VOID))
         return 1;
 
     return 0;
 }
 
-static int are_types_comparable(TypeInfo *left, TypeInfo *right)
+static int are_types_comparable(const TypeInfo *left, const TypeInfo *right)
 {
     if (!left || !right)
         return 0;
 
+    // Arrays, maps e structs são referências: não há comparação de conteúdo
+    if (left->is_array || right->is_array || left->is_map || right->is_map || left->layout || right->layout)
+        return 0;
+
     // Mesmo tipo (exceto void)
     if (left->base_type == right->base_type && left->base_type != TYPE_VOID)
         return 1;
@@ -299,13 +622,43 @@ static int is_comparison_operator(TokenType op)
             op == TOKEN_GREATER_EQUAL || op == TOKEN_LESS_EQUAL);
 }
 
-static TypeInfo *type_from_ast_node(ASTNode *type_node)
+/* '{}' assume os tipos do map esperado no contexto (declaração, atribuição,
+ * argumento, retorno): é com eles que o runtime cria o map */
+static void bind_empty_map_literal(ASTNode *node, const TypeInfo *expected)
+{
+    if (node && node->node_type == NODE_MAP_LITERAL && node->data.map_literal.entry_count == 0 &&
+        expected->is_map)
+    {
+        node->data.map_literal.key_type = expected->key->base_type;
+        node->data.map_literal.value_type = expected->base_type;
+    }
+}
+
+static const TypeInfo *type_from_ast_node(SemanticAnalyzer *analyzer, ASTNode *type_node)
 {
     if (!type_node || type_node->node_type != NODE_TYPE)
     {
         return typeinfo_create(TYPE_INVALID);
     }
 
+    if (type_node->data.type_node.struct_name)
+    {
+        SymbolEntry *symbol = symbol_lookup(analyzer, type_node->data.type_node.struct_name);
+        if (symbol == NULL || symbol->category != SYMBOL_TYPE)
+        {
+            semantic_error(analyzer, type_node->line, type_node->column,
+                           "Tipo '%s' não declarado", type_node->data.type_node.struct_name);
+            return typeinfo_create(TYPE_INVALID);
+        }
+        return symbol->type;
+    }
+
+    if (type_node->data.type_node.is_array)
+        return typeinfo_array(type_node->data.type_node.type);
+
+    if (type_node->data.type_node.is_map)
+        return typeinfo_map(type_node->data.type_node.key_type, type_node->data.type_node.type);
+
     return typeinfo_create(type_node->data.type_node.type);
 }
 
@@ -335,7 +688,6 @@ static TypeCheckResult check_literal_expression(SemanticAnalyzer *analyzer, ASTN
     default:
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
-        snprintf(result.error_msg, sizeof(result.error_msg), "Literal desconhecido");
         break;
     }
 
@@ -349,16 +701,24 @@ static TypeCheckResult check_variable_expression(SemanticAnalyzer *analyzer, AST
     SymbolEntry *symbol = symbol_lookup(analyzer, node->data.var_expr.name);
     if (symbol == NULL)
     {
-        snprintf(result.error_msg, sizeof(result.error_msg),
-                 "Variável '%s' não declarada", node->data.var_expr.name);
-        semantic_error(analyzer, node->line, node->column, result.error_msg);
+        semantic_error(analyzer, node->line, node->column,
+                       "Variável '%s' não declarada", node->data.var_expr.name);
+        result.is_valid = 0;
+        result.type = typeinfo_create(TYPE_INVALID);
+        return result;
+    }
+
+    if (symbol->category == SYMBOL_TYPE)
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "'%s' é um tipo, não uma variável", node->data.var_expr.name);
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
         return result;
     }
 
     result.is_valid = 1;
-    result.type = typeinfo_copy(symbol->type);
+    result.type = symbol->type;
     return result;
 }
 
@@ -372,8 +732,6 @@ static TypeCheckResult check_binary_expression(SemanticAnalyzer *analyzer, ASTNo
 
     if (!left.is_valid || !right.is_valid)
     {
-        typeinfo_free(left.type);
-        typeinfo_free(right.type);
         result.type = typeinfo_create(TYPE_INVALID);
         return result;
     }
@@ -410,20 +768,36 @@ static TypeCheckResult check_binary_expression(SemanticAnalyzer *analyzer, ASTNo
             }
         }
         // Operador + para strings (concatenação)
-        else if (op == TOKEN_PLUS && left.type->base_type == TYPE_STRING &&
-                 right.type->base_type == TYPE_STRING)
+        else if (op == TOKEN_PLUS && is_primitive(left.type, TYPE_STRING) &&
+                 is_primitive(right.type, TYPE_STRING))
         {
             result.is_valid = 1;
             result.type = typeinfo_create(TYPE_STRING);
         }
         else
         {
-            snprintf(result.error_msg, sizeof(result.error_msg),
-                     "Operador '%s' não suportado para tipos %s e %s",
-                     token_type_to_string(op),
-                     typeinfo_to_string(left.type),
-                     typeinfo_to_string(right.type));
-            semantic_error(analyzer, node->line, node->column, result.error_msg);
+            semantic_error(analyzer, node->line, node->column,
+                           "Operador '%s' não suportado para tipos %s e %s",
+                           token_type_to_string(op),
+                           typeinfo_to_string(left.type),
+                           typeinfo_to_string(right.type));
+            result.type = typeinfo_create(TYPE_INVALID);
+        }
+    }
+    // Módulo: apenas int % int
+    else if (op == TOKEN_PERCENT)
+    {
+        if (is_primitive(left.type, TYPE_INT) && is_primitive(right.type, TYPE_INT))
+        {
+            result.is_valid = 1;
+            result.type = typeinfo_create(TYPE_INT);
+        }
+        else
+        {
+            semantic_error(analyzer, node->line, node->column,
+                           "Operador '%%' requer operandos int, recebeu %s e %s",
+                           typeinfo_to_string(left.type),
+                           typeinfo_to_string(right.type));
             result.type = typeinfo_create(TYPE_INVALID);
         }
     }
@@ -445,18 +819,31 @@ static TypeCheckResult check_binary_expression(SemanticAnalyzer *analyzer, ASTNo
         }
         else
         {
-            snprintf(result.error_msg, sizeof(result.error_msg),
-                     "Tipos %s e %s não são comparáveis",
-                     typeinfo_to_string(left.type),
-                     typeinfo_to_string(right.type));
-            semantic_error(analyzer, node->line, node->column, result.error_msg);
+            semantic_error(analyzer, node->line, node->column,
+                           "Tipos %s e %s não são comparáveis",
+                           typeinfo_to_string(left.type),
+                           typeinfo_to_string(right.type));
+            result.type = typeinfo_create(TYPE_INVALID);
+        }
+    }
+    // Operadores lógicos: bool && bool, bool || bool (sem conversão implícita)
+    else if (op == TOKEN_AND_AND || op == TOKEN_PIPE_PIPE)
+    {
+        if (is_primitive(left.type, TYPE_BOOL) && is_primitive(right.type, TYPE_BOOL))
+        {
+            result.is_valid = 1;
+            result.type = typeinfo_create(TYPE_BOOL);
+        }
+        else
+        {
+            semantic_error(analyzer, node->line, node->column,
+                           "Operador '%s' requer operandos bool, recebeu %s e %s",
+                           op == TOKEN_AND_AND ? "&&" : "||",
+                           typeinfo_to_string(left.type),
+                           typeinfo_to_string(right.type));
             result.type = typeinfo_create(TYPE_INVALID);
         }
     }
-
-    typeinfo_free(left.type);
-    typeinfo_free(right.type);
-
     return result;
 }
 
@@ -469,7 +856,6 @@ static TypeCheckResult check_unary_expression(SemanticAnalyzer *analyzer, ASTNod
     {
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
-        typeinfo_free(operand.type);
         return result;
     }
 
@@ -480,20 +866,78 @@ static TypeCheckResult check_unary_expression(SemanticAnalyzer *analyzer, ASTNod
         if (is_numeric_type(operand.type))
         {
             result.is_valid = 1;
-            result.type = typeinfo_copy(operand.type);
+            result.type = operand.type;
+        }
+        else
+        {
+            semantic_error(analyzer, node->line, node->column,
+                           "Operador unário '-' não suportado para tipo %s",
+                           typeinfo_to_string(operand.type));
+            result.is_valid = 0;
+            result.type = typeinfo_create(TYPE_INVALID);
+        }
+    }
+    else if (op == TOKEN_BANG)
+    {
+        if (is_primitive(operand.type, TYPE_BOOL))
+        {
+            result.is_valid = 1;
+            result.type = operand.type;
         }
         else
         {
-            snprintf(result.error_msg, sizeof(result.error_msg),
-                     "Operador unário '-' não suportado para tipo %s",
-                     typeinfo_to_string(operand.type));
-            semantic_error(analyzer, node->line, node->column, result.error_msg);
+            semantic_error(analyzer, node->line, node->column,
+                           "Operador unário '!' requer bool, recebeu %s",
+                           typeinfo_to_string(operand.type));
             result.is_valid = 0;
             result.type = typeinfo_create(TYPE_INVALID);
         }
     }
 
-    typeinfo_free(operand.type);
+    return result;
+}
+
+/* Nome(a, b, ...): um argumento por campo, na ordem da declaração */
+static TypeCheckResult check_struct_constructor(SemanticAnalyzer *analyzer, ASTNode *node, const TypeInfo *type)
+{
+    TypeCheckResult result = {0};
+    const StructLayout *layout = type->layout;
+    result.type = typeinfo_create(TYPE_INVALID);
+
+    if (node->data.call_expr.arg_count != layout->field_count)
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Número incorreto de argumentos para '%s': esperado %d, encontrado %d",
+                       layout->name, layout->field_count, node->data.call_expr.arg_count);
+        return result;
+    }
+
+    result.is_valid = 1;
+    for (int i = 0; i < layout->field_count; i++)
+    {
+        ASTNode *argument = node->data.call_expr.arguments[i];
+        TypeCheckResult arg_result = check_expression(analyzer, argument);
+        if (!arg_result.is_valid)
+        {
+            result.is_valid = 0;
+        }
+        else if (!are_types_compatible(layout->fields[i].type, arg_result.type))
+        {
+            semantic_error(analyzer, argument->line, argument->column,
+                           "Tipo incompatível para o campo '%s' de '%s': esperado %s, encontrado %s",
+                           layout->fields[i].name, layout->name,
+                           typeinfo_to_string(layout->fields[i].type),
+                           typeinfo_to_string(arg_result.type));
+            result.is_valid = 0;
+        }
+        else
+        {
+            bind_empty_map_literal(argument, layout->fields[i].type);
+        }
+    }
+
+    if (result.is_valid)
+        result.type = type;
     return result;
 }
 
@@ -503,26 +947,34 @@ static TypeCheckResult check_call_expression(SemanticAnalyzer *analyzer, ASTNode
 
     // Verificar se função existe
     SymbolEntry *function = symbol_lookup(analyzer, node->data.call_expr.function_name);
+    if (function != NULL && function->category == SYMBOL_TYPE)
+    {
+        return check_struct_constructor(analyzer, node, function->type);
+    }
+
     if (function == NULL || function->category != SYMBOL_FUNCTION)
     {
-        snprintf(result.error_msg, sizeof(result.error_msg),
-                 "Função '%s' não declarada", node->data.call_expr.function_name);
-        semantic_error(analyzer, node->line, node->column, result.error_msg);
+        semantic_error(analyzer, node->line, node->column,
+                       "Função '%s' não declarada", node->data.call_expr.function_name);
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
         return result;
     }
 
-    // Verificar número de argumentos (exceção para print que aceita qualquer número)
-    if (strcmp(node->data.call_expr.function_name, "print") != 0 &&
-        node->data.call_expr.arg_count != function->details.func_info.param_count)
+    // Built-ins de assinatura flexível verificam a própria chamada
+    if (function->details.func_info.check_call)
     {
-        snprintf(result.error_msg, sizeof(result.error_msg),
-                 "Número incorreto de argumentos para '%s': esperado %d, encontrado %d",
-                 node->data.call_expr.function_name,
-                 function->details.func_info.param_count,
-                 node->data.call_expr.arg_count);
-        semantic_error(analyzer, node->line, node->column, result.error_msg);
+        return function->details.func_info.check_call(analyzer, node);
+    }
+
+    // Verificar número de argumentos
+    if (node->data.call_expr.arg_count != function->details.func_info.param_count)
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Número incorreto de argumentos para '%s': esperado %d, encontrado %d",
+                       node->data.call_expr.function_name,
+                       function->details.func_info.param_count,
+                       node->data.call_expr.arg_count);
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
         return result;
@@ -531,45 +983,29 @@ static TypeCheckResult check_call_expression(SemanticAnalyzer *analyzer, ASTNode
     // Verificar tipos dos argumentos
     result.is_valid = 1;
 
-    // Para print, apenas verificar se argumentos são válidos (aceita qualquer tipo)
-    if (strcmp(node->data.call_expr.function_name, "print") == 0)
+    for (int i = 0; i < node->data.call_expr.arg_count; i++)
     {
-        for (int i = 0; i < node->data.call_expr.arg_count; i++)
+        TypeCheckResult arg_result = check_expression(analyzer, node->data.call_expr.arguments[i]);
+        SymbolEntry *param = function->details.func_info.parameters[i];
+
+        if (!are_types_compatible(param->type, arg_result.type))
         {
-            TypeCheckResult arg_result = check_expression(analyzer, node->data.call_expr.arguments[i]);
-            if (!arg_result.is_valid)
-            {
-                result.is_valid = 0;
-                result.type = typeinfo_create(TYPE_INVALID);
-                return result;
-            }
+            semantic_error(analyzer, node->line, node->column,
+                           "Tipo incompatível para argumento %d de '%s': esperado %s, encontrado %s",
+                           i + 1, node->data.call_expr.function_name,
+                           typeinfo_to_string(param->type),
+                           typeinfo_to_string(arg_result.type));
+            result.is_valid = 0;
         }
-    }
-    else
-    {
-        // Para outras funções, verificar compatibilidade de tipos
-        for (int i = 0; i < node->data.call_expr.arg_count; i++)
+        else
         {
-            TypeCheckResult arg_result = check_expression(analyzer, node->data.call_expr.arguments[i]);
-            SymbolEntry *param = function->details.func_info.parameters[i];
-
-            if (!are_types_compatible(param->type, arg_result.type))
-            {
-                semantic_error(analyzer, node->line, node->column,
-                               "Tipo incompatível para argumento %d de '%s': esperado %s, encontrado %s",
-                               i + 1, node->data.call_expr.function_name,
-                               typeinfo_to_string(param->type),
-                               typeinfo_to_string(arg_result.type));
-                result.is_valid = 0;
-            }
-
-            typeinfo_free(arg_result.type);
+            bind_empty_map_literal(node->data.call_expr.arguments[i], param->type);
         }
     }
 
     if (result.is_valid)
     {
-        result.type = typeinfo_copy(function->details.func_info.return_type);
+        result.type = function->details.func_info.return_type;
     }
     else
     {
@@ -587,42 +1023,369 @@ static TypeCheckResult check_assignment(SemanticAnalyzer *analyzer, ASTNode *nod
     SymbolEntry *var = symbol_lookup(analyzer, node->data.assign_expr.variable_name);
     if (var == NULL || var->category != SYMBOL_VARIABLE)
     {
-        snprintf(result.error_msg, sizeof(result.error_msg),
-                 "Variável '%s' não declarada", node->data.assign_expr.variable_name);
-        semantic_error(analyzer, node->line, node->column, result.error_msg);
+        semantic_error(analyzer, node->line, node->column,
+                       "Variável '%s' não declarada", node->data.assign_expr.variable_name);
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
         return result;
     }
 
-    // Verificar valor de atribuição
-    TypeCheckResult value_result = check_expression(analyzer, node->data.assign_expr.value);
-
-    if (!value_result.is_valid)
+    if (var->details.var_info.is_loop_counter)
     {
+        semantic_error(analyzer, node->line, node->column,
+                       "Variável de controle do 'for' '%s' não pode ser atribuída",
+                       node->data.assign_expr.variable_name);
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
-        typeinfo_free(value_result.type);
         return result;
     }
 
-    // Verificar compatibilidade de tipos
-    if (!are_types_compatible(var->type, value_result.type))
+    if (var->module != NULL)
     {
         semantic_error(analyzer, node->line, node->column,
-                       "Tipo incompatível na atribuição: variável %s, valor %s",
-                       typeinfo_to_string(var->type),
+                       "Variável importada '%s' é somente leitura", node->data.assign_expr.variable_name);
+        result.is_valid = 0;
+        result.type = typeinfo_create(TYPE_INVALID);
+        return result;
+    }
+
+    // Verificar valor de atribuição
+    TypeCheckResult value_result = check_expression(analyzer, node->data.assign_expr.value);
+
+    if (!value_result.is_valid)
+    {
+        result.is_valid = 0;
+        result.type = typeinfo_create(TYPE_INVALID);
+        return result;
+    }
+
+    // Verificar compatibilidade de tipos
+    if (!are_types_compatible(var->type, value_result.type))
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Tipo incompatível na atribuição: variável %s, valor %s",
+                       typeinfo_to_string(var->type),
                        typeinfo_to_string(value_result.type));
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
     }
     else
     {
+        bind_empty_map_literal(node->data.assign_expr.value, var->type);
         result.is_valid = 1;
-        result.type = typeinfo_copy(var->type);
+        result.type = var->type;
+    }
+
+    return result;
+}
+
+static TypeCheckResult check_array_literal(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult result = {0};
+    result.is_valid = 1;
+
+    // '[]' não tem tipo de elemento: é compatível com qualquer array
+    const TypeInfo *element = typeinfo_create(TYPE_VOID);
+
+    for (int i = 0; i < node->data.array_literal.element_count; i++)
+    {
+        ASTNode *item = node->data.array_literal.elements[i];
+        TypeCheckResult item_result = check_expression(analyzer, item);
+        if (!item_result.is_valid)
+        {
+            result.is_valid = 0;
+            continue;
+        }
+
+        const TypeInfo *type = item_result.type;
+        if (type->is_array || type->is_map || type->layout || is_primitive(type, TYPE_VOID))
+        {
+            semantic_error(analyzer, item->line, item->column,
+                           "Elemento de array deve ser int, float, string ou bool, encontrado %s",
+                           typeinfo_to_string(type));
+            result.is_valid = 0;
+        }
+        else if (type == element || is_primitive(element, TYPE_VOID))
+        {
+            element = type;
+        }
+        else if (is_numeric_type(type) && is_numeric_type(element))
+        {
+            // Mistura de int e float: o array é float[]
+            element = typeinfo_create(TYPE_FLOAT);
+        }
+        else
+        {
+            semantic_error(analyzer, item->line, item->column,
+                           "Elementos do array com tipos incompatíveis: %s e %s",
+                           typeinfo_to_string(element), typeinfo_to_string(type));
+            result.is_valid = 0;
+        }
+    }
+
+    result.type = result.is_valid ? typeinfo_array(element->base_type) : typeinfo_create(TYPE_INVALID);
+    return result;
+}
+
+/* Chave de map: int, string ou bool (float não tem igualdade confiável) */
+static int is_map_key_type(const TypeInfo *type)
+{
+    return is_primitive(type, TYPE_INT) || is_primitive(type, TYPE_STRING) || is_primitive(type, TYPE_BOOL);
+}
+
+/* Funde o tipo de mais um valor no tipo comum dos valores de um literal
+ * (int e float viram float). Retorna NULL se forem incompatíveis. */
+static const TypeInfo *merge_literal_type(const TypeInfo *common, const TypeInfo *type)
+{
+    if (type == common || is_primitive(common, TYPE_VOID))
+        return type;
+    if (is_numeric_type(type) && is_numeric_type(common))
+        return typeinfo_create(TYPE_FLOAT);
+    return NULL;
+}
+
+static TypeCheckResult check_map_literal(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult result = {0};
+    result.is_valid = 1;
+
+    // '{}' não tem tipos próprios: é compatível com qualquer map
+    const TypeInfo *key = typeinfo_create(TYPE_VOID);
+    const TypeInfo *value = typeinfo_create(TYPE_VOID);
+
+    for (int i = 0; i < node->data.map_literal.entry_count; i++)
+    {
+        ASTNode *key_node = node->data.map_literal.items[2 * i];
+        ASTNode *value_node = node->data.map_literal.items[2 * i + 1];
+        TypeCheckResult key_result = check_expression(analyzer, key_node);
+        TypeCheckResult value_result = check_expression(analyzer, value_node);
+
+        if (key_result.is_valid)
+        {
+            if (!is_map_key_type(key_result.type))
+            {
+                semantic_error(analyzer, key_node->line, key_node->column,
+                               "Chave de map deve ser int, string ou bool, encontrado %s",
+                               typeinfo_to_string(key_result.type));
+                result.is_valid = 0;
+            }
+            else if (!is_primitive(key, TYPE_VOID) && key_result.type != key)
+            {
+                semantic_error(analyzer, key_node->line, key_node->column,
+                               "Chaves do map com tipos incompatíveis: %s e %s",
+                               typeinfo_to_string(key), typeinfo_to_string(key_result.type));
+                result.is_valid = 0;
+            }
+            else
+            {
+                key = key_result.type;
+            }
+        }
+        else
+        {
+            result.is_valid = 0;
+        }
+
+        if (!value_result.is_valid)
+        {
+            result.is_valid = 0;
+            continue;
+        }
+
+        const TypeInfo *merged = NULL;
+        if (!value_result.type->is_array && !value_result.type->is_map && !value_result.type->layout &&
+            !is_primitive(value_result.type, TYPE_VOID))
+            merged = merge_literal_type(value, value_result.type);
+
+        if (merged)
+        {
+            value = merged;
+        }
+        else
+        {
+            semantic_error(analyzer, value_node->line, value_node->column,
+                           "Valores do map com tipos incompatíveis: %s e %s",
+                           typeinfo_to_string(value), typeinfo_to_string(value_result.type));
+            result.is_valid = 0;
+        }
+    }
+
+    // O runtime cria o map com estes tipos, sem inspecionar os valores
+    node->data.map_literal.key_type = key->base_type;
+    node->data.map_literal.value_type = value->base_type;
+
+    result.type = result.is_valid ? typeinfo_map(key->base_type, value->base_type) : typeinfo_create(TYPE_INVALID);
+    return result;
+}
+
+/* Verifica 'array[index]' ou 'map[chave]' e retorna o tipo do elemento/valor
+ * (NULL em caso de erro) */
+static const TypeInfo *check_index_target(SemanticAnalyzer *analyzer, ASTNode *node,
+                                          ASTNode *array, ASTNode *index)
+{
+    TypeCheckResult array_result = check_expression(analyzer, array);
+    TypeCheckResult index_result = check_expression(analyzer, index);
+
+    if (!array_result.is_valid || !index_result.is_valid)
+        return NULL;
+
+    if (array_result.type->is_map)
+    {
+        if (index_result.type != array_result.type->key)
+        {
+            semantic_error(analyzer, node->line, node->column,
+                           "Chave de %s deve ser %s, encontrado %s",
+                           typeinfo_to_string(array_result.type),
+                           typeinfo_to_string(array_result.type->key),
+                           typeinfo_to_string(index_result.type));
+            return NULL;
+        }
+        return array_result.type->inner;
+    }
+
+    if (!array_result.type->is_array)
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Indexação requer um array ou map, encontrado %s",
+                       typeinfo_to_string(array_result.type));
+        return NULL;
+    }
+
+    if (!is_primitive(index_result.type, TYPE_INT))
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Índice de array deve ser int, encontrado %s",
+                       typeinfo_to_string(index_result.type));
+        return NULL;
+    }
+
+    return array_result.type->inner;
+}
+
+static TypeCheckResult check_index_expression(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult result = {0};
+
+    const TypeInfo *element = check_index_target(analyzer, node, node->data.index_expr.array,
+                                                 node->data.index_expr.index);
+
+    result.is_valid = element != NULL;
+    result.type = element ? element : typeinfo_create(TYPE_INVALID);
+    return result;
+}
+
+/* Globais importados são somente leitura para quem importa: 'alvo[i] = v' e
+ * 'alvo.campo = v' não podem alterá-los (o interpretador ainda dá a cada
+ * import uma cópia, que alterações por alias não passam adiante) */
+static int check_not_imported(SemanticAnalyzer *analyzer, ASTNode *node, ASTNode *target)
+{
+    if (target->node_type != NODE_VAR_EXPR)
+        return 1;
+
+    SymbolEntry *symbol = symbol_lookup(analyzer, target->data.var_expr.name);
+    if (symbol == NULL || symbol->module == NULL)
+        return 1;
+
+    semantic_error(analyzer, node->line, node->column,
+                   "Variável importada '%s' é somente leitura", target->data.var_expr.name);
+    return 0;
+}
+
+static TypeCheckResult check_index_assignment(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult result = {0};
+    result.type = typeinfo_create(TYPE_INVALID);
+
+    const TypeInfo *element = check_index_target(analyzer, node, node->data.index_assign.array,
+                                                 node->data.index_assign.index);
+    TypeCheckResult value_result = check_expression(analyzer, node->data.index_assign.value);
+
+    if (!element || !value_result.is_valid ||
+        !check_not_imported(analyzer, node, node->data.index_assign.array))
+        return result;
+
+    if (!are_types_compatible(element, value_result.type))
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Tipo incompatível na atribuição: elemento %s, valor %s",
+                       typeinfo_to_string(element),
+                       typeinfo_to_string(value_result.type));
+        return result;
+    }
+
+    result.is_valid = 1;
+    result.type = element;
+    return result;
+}
+
+/* Resolve 'objeto.campo', anota offset e representação no nó e retorna o
+ * campo (NULL em caso de erro) */
+static const StructField *check_field_target(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult object = check_expression(analyzer, node->data.field_expr.object);
+    if (!object.is_valid)
+        return NULL;
+
+    const StructLayout *layout = object.type->layout;
+    if (!layout)
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Acesso a campo requer um struct, encontrado %s",
+                       typeinfo_to_string(object.type));
+        return NULL;
+    }
+
+    for (int i = 0; i < layout->field_count; i++)
+    {
+        const StructField *field = &layout->fields[i];
+        if (strcmp(field->name, node->data.field_expr.field_name) == 0)
+        {
+            node->data.field_expr.offset = field->offset;
+            node->data.field_expr.storage = field->storage;
+            return field;
+        }
+    }
+
+    semantic_error(analyzer, node->line, node->column,
+                   "Struct '%s' não tem campo '%s'", layout->name, node->data.field_expr.field_name);
+    return NULL;
+}
+
+static TypeCheckResult check_field_expression(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult result = {0};
+
+    const StructField *field = check_field_target(analyzer, node);
+
+    result.is_valid = field != NULL;
+    result.type = field ? field->type : typeinfo_create(TYPE_INVALID);
+    return result;
+}
+
+static TypeCheckResult check_field_assignment(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult result = {0};
+    result.type = typeinfo_create(TYPE_INVALID);
+
+    const StructField *field = check_field_target(analyzer, node);
+    TypeCheckResult value_result = check_expression(analyzer, node->data.field_expr.value);
+
+    if (!field || !value_result.is_valid ||
+        !check_not_imported(analyzer, node, node->data.field_expr.object))
+        return result;
+
+    if (!are_types_compatible(field->type, value_result.type))
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Tipo incompatível na atribuição: campo %s, valor %s",
+                       typeinfo_to_string(field->type),
+                       typeinfo_to_string(value_result.type));
+        return result;
     }
 
-    typeinfo_free(value_result.type);
+    bind_empty_map_literal(node->data.field_expr.value, field->type);
+    result.is_valid = 1;
+    result.type = field->type;
     return result;
 }
 
@@ -640,24 +1403,49 @@ static TypeCheckResult check_expression(SemanticAnalyzer *analyzer, ASTNode *nod
     switch (node->node_type)
     {
     case NODE_LITERAL:
-        return check_literal_expression(analyzer, node);
+        result = check_literal_expression(analyzer, node);
+        break;
     case NODE_VAR_EXPR:
-        return check_variable_expression(analyzer, node);
+        result = check_variable_expression(analyzer, node);
+        break;
     case NODE_BINARY_EXPR:
-        return check_binary_expression(analyzer, node);
+        result = check_binary_expression(analyzer, node);
+        break;
     case NODE_UNARY_EXPR:
-        return check_unary_expression(analyzer, node);
+        result = check_unary_expression(analyzer, node);
+        break;
     case NODE_CALL_EXPR:
-        return check_call_expression(analyzer, node);
+        result = check_call_expression(analyzer, node);
+        break;
     case NODE_ASSIGN_EXPR:
-        return check_assignment(analyzer, node);
+        result = check_assignment(analyzer, node);
+        break;
+    case NODE_ARRAY_LITERAL:
+        result = check_array_literal(analyzer, node);
+        break;
+    case NODE_MAP_LITERAL:
+        result = check_map_literal(analyzer, node);
+        break;
+    case NODE_INDEX_EXPR:
+        result = check_index_expression(analyzer, node);
+        break;
+    case NODE_INDEX_ASSIGN:
+        result = check_index_assignment(analyzer, node);
+        break;
+    case NODE_FIELD_EXPR:
+        result = check_field_expression(analyzer, node);
+        break;
+    case NODE_FIELD_ASSIGN:
+        result = check_field_assignment(analyzer, node);
+        break;
     default:
         result.is_valid = 0;
         result.type = typeinfo_create(TYPE_INVALID);
-        snprintf(result.error_msg, sizeof(result.error_msg), "Tipo de expressão não suportado");
         break;
     }
 
+    // Anotar o tipo no nó (TYPE_INVALID se a expressão tem erro)
+    node->data_type = result.type ? result.type->base_type : TYPE_INVALID;
     return result;
 }
 
@@ -676,12 +1464,10 @@ static void visit_variable_decl(SemanticAnalyzer *analyzer, ASTNode *node)
 
     // Verificar inicializador
     TypeCheckResult init_result = check_expression(analyzer, node->data.var_decl.initializer);
-    TypeInfo *declared_type = type_from_ast_node(node->data.var_decl.type_node);
+    const TypeInfo *declared_type = type_from_ast_node(analyzer, node->data.var_decl.type_node);
 
-    if (!init_result.is_valid)
+    if (!init_result.is_valid || is_primitive(declared_type, TYPE_INVALID))
     {
-        typeinfo_free(declared_type);
-        typeinfo_free(init_result.type);
         return;
     }
 
@@ -695,17 +1481,17 @@ static void visit_variable_decl(SemanticAnalyzer *analyzer, ASTNode *node)
     }
     else
     {
+        bind_empty_map_literal(node->data.var_decl.initializer, declared_type);
+
         // Registrar variável na tabela de símbolos
         SymbolEntry *var_entry = symbol_create_variable(
-            node->data.var_decl.name, typeinfo_copy(declared_type), node->line, node->column);
+            node->data.var_decl.name, declared_type, node->line, node->column);
         symbol_insert(analyzer, var_entry);
     }
-
-    typeinfo_free(declared_type);
-    typeinfo_free(init_result.type);
 }
 
-static void visit_function_decl(SemanticAnalyzer *analyzer, ASTNode *node)
+/* Registra a assinatura da função no escopo atual; NULL se já declarada */
+static SymbolEntry *declare_function(SemanticAnalyzer *analyzer, ASTNode *node)
 {
     // Verificar se função já foi declarada
     if (symbol_lookup_current(analyzer, node->data.func_decl.name))
@@ -713,24 +1499,18 @@ static void visit_function_decl(SemanticAnalyzer *analyzer, ASTNode *node)
         semantic_error(analyzer, node->line, node->column,
                        "Função '%s' já declarada neste escopo",
                        node->data.func_decl.name);
-        return;
+        return NULL;
     }
 
-    // Configurar contexto da função
-    analyzer->in_function = 1;
-    analyzer->has_return_statement = 0;
-    strncpy(analyzer->current_function, node->data.func_decl.name, sizeof(analyzer->current_function) - 1);
-
     // Determinar tipo de retorno
-    TypeInfo *return_type = type_from_ast_node(node->data.func_decl.return_type);
-    analyzer->current_return_type = return_type;
+    const TypeInfo *return_type = type_from_ast_node(analyzer, node->data.func_decl.return_type);
 
     // Criar entrada da função na tabela de símbolos
     SymbolEntry **params = malloc(sizeof(SymbolEntry *) * node->data.func_decl.param_count);
     for (int i = 0; i < node->data.func_decl.param_count; i++)
     {
         ASTNode *param = node->data.func_decl.params[i];
-        TypeInfo *param_type = type_from_ast_node(param->data.param.type_node);
+        const TypeInfo *param_type = type_from_ast_node(analyzer, param->data.param.type_node);
         params[i] = symbol_create_variable(param->data.param.name, param_type, param->line, param->column);
         params[i]->category = SYMBOL_PARAMETER;
     }
@@ -741,6 +1521,21 @@ static void visit_function_decl(SemanticAnalyzer *analyzer, ASTNode *node)
     func_entry->details.func_info.function_node = node;
     symbol_insert(analyzer, func_entry);
 
+    return func_entry;
+}
+
+/* Verifica o corpo de uma função já declarada */
+static void check_function_body(SemanticAnalyzer *analyzer, ASTNode *node, SymbolEntry *func_entry)
+{
+    const TypeInfo *return_type = func_entry->details.func_info.return_type;
+    SymbolEntry **params = func_entry->details.func_info.parameters;
+
+    // Configurar contexto da função
+    analyzer->in_function = 1;
+    analyzer->has_return_statement = 0;
+    strncpy(analyzer->current_function, node->data.func_decl.name, sizeof(analyzer->current_function) - 1);
+    analyzer->current_return_type = return_type;
+
     // Entrar no escopo da função
     enter_scope(analyzer, SCOPE_FUNCTION);
 
@@ -748,7 +1543,7 @@ static void visit_function_decl(SemanticAnalyzer *analyzer, ASTNode *node)
     for (int i = 0; i < node->data.func_decl.param_count; i++)
     {
         SymbolEntry *param_copy = symbol_create_variable(
-            params[i]->name, typeinfo_copy(params[i]->type), params[i]->declared_line, params[i]->declared_column);
+            params[i]->name, params[i]->type, params[i]->declared_line, params[i]->declared_column);
         param_copy->category = SYMBOL_PARAMETER;
         symbol_insert(analyzer, param_copy);
     }
@@ -768,51 +1563,255 @@ static void visit_function_decl(SemanticAnalyzer *analyzer, ASTNode *node)
     exit_scope(analyzer);
     analyzer->in_function = 0;
     analyzer->current_return_type = NULL;
+}
 
-    typeinfo_free(return_type);
+static void visit_function_decl(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    SymbolEntry *func_entry = declare_function(analyzer, node);
+    if (func_entry)
+        check_function_body(analyzer, node, func_entry);
 }
 
-static void visit_return_statement(SemanticAnalyzer *analyzer, ASTNode *node)
+/* Fixa o layout do struct, anota-o na declaração e registra o tipo */
+static void visit_struct_decl(SemanticAnalyzer *analyzer, ASTNode *node)
 {
-    if (!analyzer->in_function)
+    const char *name = node->data.struct_decl.name;
+    int field_count = node->data.struct_decl.field_count;
+
+    if (symbol_lookup_current(analyzer, name))
     {
-        semantic_error(analyzer, node->line, node->column,
-                       "Instrução 'return' fora de função");
+        semantic_error(analyzer, node->line, node->column, "Struct '%s' já declarado neste escopo", name);
         return;
     }
 
-    analyzer->has_return_statement = 1;
+    if (field_count == 0)
+    {
+        semantic_error(analyzer, node->line, node->column, "Struct '%s' deve ter ao menos um campo", name);
+        return;
+    }
 
-    if (analyzer->current_return_type->base_type == TYPE_VOID)
+    const char **field_names = malloc(sizeof(char *) * field_count);
+    const TypeInfo **field_types = malloc(sizeof(TypeInfo *) * field_count);
+    if (!field_names || !field_types)
     {
-        // Verificar que return void não tem valor
-        if (node->data.return_stmt.value != NULL)
-        {
-            semantic_error(analyzer, node->line, node->column,
-                           "Função void não pode retornar um valor");
-        }
+        free(field_names);
+        free(field_types);
+        return;
     }
-    else
+
+    // Campos do próprio struct ainda não o enxergam: não há registros recursivos
+    int is_valid = 1;
+    for (int i = 0; i < field_count; i++)
     {
-        // Verificar que return não-void tem valor
-        if (node->data.return_stmt.value == NULL)
+        ASTNode *field = node->data.struct_decl.fields[i];
+        field_names[i] = field->data.param.name;
+        field_types[i] = type_from_ast_node(analyzer, field->data.param.type_node);
+
+        if (is_primitive(field_types[i], TYPE_INVALID))
         {
-            semantic_error(analyzer, node->line, node->column,
-                           "Esperado valor de retorno do tipo %s",
-                           typeinfo_to_string(analyzer->current_return_type));
+            is_valid = 0;
         }
-        else
+        else if (is_primitive(field_types[i], TYPE_VOID))
         {
-            // Verificar compatibilidade do tipo do valor de retorno
-            TypeCheckResult result = check_expression(analyzer, node->data.return_stmt.value);
-            if (result.is_valid && !are_types_compatible(analyzer->current_return_type, result.type))
+            semantic_error(analyzer, field->line, field->column,
+                           "Campo '%s' do struct '%s' não pode ser void", field_names[i], name);
+            is_valid = 0;
+        }
+
+        for (int j = 0; j < i; j++)
+        {
+            if (strcmp(field_names[j], field_names[i]) == 0)
             {
-                semantic_error(analyzer, node->line, node->column,
-                               "Tipo de retorno incompatível: esperado %s, encontrado %s",
+                semantic_error(analyzer, field->line, field->column,
+                               "Campo '%s' duplicado no struct '%s'", field_names[i], name);
+                is_valid = 0;
+                break;
+            }
+        }
+    }
+
+    if (is_valid)
+    {
+        const TypeInfo *type = typeinfo_struct(name, field_names, field_types, field_count);
+        const StructLayout *layout = type->layout;
+        if (layout)
+        {
+            // O runtime lê o layout da própria declaração
+            for (int i = 0; i < field_count; i++)
+            {
+                node->data.struct_decl.fields[i]->data.param.offset = layout->fields[i].offset;
+                node->data.struct_decl.fields[i]->data.param.storage = layout->fields[i].storage;
+            }
+            node->data.struct_decl.size = layout->size;
+
+            SymbolEntry *entry = symbol_create_variable(name, type, node->line, node->column);
+            entry->category = SYMBOL_TYPE;
+            symbol_insert(analyzer, entry);
+        }
+    }
+
+    free(field_names);
+    free(field_types);
+}
+
+/* --- IMPORTS --- */
+
+/* 0 se 'name' está livre no escopo do programa; 1 se já veio deste mesmo
+ * módulo (import repetido ou alcançado por outro módulo); -1 em conflito */
+static int import_name_status(SemanticAnalyzer *analyzer, ASTNode *import, const CrazeModule *module,
+                              const char *name)
+{
+    SymbolEntry *existing = symbol_lookup_current(analyzer, name);
+    if (existing == NULL)
+        return 0;
+    if (existing->module == module)
+        return 1;
+
+    semantic_error(analyzer, import->line, import->column,
+                   "'%s' importado de '%s' já declarado neste escopo", name, import->data.import_stmt.path);
+    return -1;
+}
+
+/* Tipo de um struct do módulo: o layout internado é o mesmo que o módulo obteve */
+static const TypeInfo *imported_struct_type(SemanticAnalyzer *analyzer, ASTNode *decl)
+{
+    int field_count = decl->data.struct_decl.field_count;
+    const char **field_names = malloc(sizeof(char *) * field_count);
+    const TypeInfo **field_types = malloc(sizeof(TypeInfo *) * field_count);
+    const TypeInfo *type = NULL;
+
+    if (field_names && field_types)
+    {
+        for (int i = 0; i < field_count; i++)
+        {
+            ASTNode *field = decl->data.struct_decl.fields[i];
+            field_names[i] = field->data.param.name;
+            field_types[i] = type_from_ast_node(analyzer, field->data.param.type_node);
+        }
+        type = typeinfo_struct(decl->data.struct_decl.name, field_names, field_types, field_count);
+    }
+
+    free(field_names);
+    free(field_types);
+    return type;
+}
+
+/* Declara as funções, structs e globais de nível superior do módulo (e dos
+ * que ele importa, que as funções dele chamam) no escopo atual */
+static void import_module_symbols(SemanticAnalyzer *analyzer, ASTNode *import, const CrazeModule *module)
+{
+    ASTNode *program = module->program;
+    for (int i = 0; i < program->data.block.stmt_count; i++)
+    {
+        ASTNode *stmt = program->data.block.statements[i];
+        const char *name;
+
+        switch (stmt->node_type)
+        {
+        case NODE_IMPORT:
+            import_module_symbols(analyzer, import, stmt->data.import_stmt.module);
+            continue;
+        case NODE_FUNC_DECL:
+            name = stmt->data.func_decl.name;
+            break;
+        case NODE_STRUCT_DECL:
+            name = stmt->data.struct_decl.name;
+            break;
+        case NODE_VAR_DECL:
+            name = stmt->data.var_decl.name;
+            break;
+        default:
+            continue;
+        }
+
+        if (import_name_status(analyzer, import, module, name) != 0)
+            continue;
+
+        SymbolEntry *entry = NULL;
+        if (stmt->node_type == NODE_FUNC_DECL)
+        {
+            entry = declare_function(analyzer, stmt);
+        }
+        else
+        {
+            const TypeInfo *type = stmt->node_type == NODE_STRUCT_DECL
+                                       ? imported_struct_type(analyzer, stmt)
+                                       : type_from_ast_node(analyzer, stmt->data.var_decl.type_node);
+            if (type != NULL)
+            {
+                entry = symbol_create_variable(name, type, stmt->line, stmt->column);
+                if (stmt->node_type == NODE_STRUCT_DECL)
+                    entry->category = SYMBOL_TYPE;
+                symbol_insert(analyzer, entry);
+            }
+        }
+
+        if (entry != NULL)
+            entry->module = module;
+    }
+}
+
+static void visit_import(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    char error[256];
+    CrazeModule *module = module_load(node->data.import_stmt.path, analyzer->source_path, error, sizeof(error));
+    if (module == NULL)
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Não foi possível importar '%s': %s", node->data.import_stmt.path, error);
+        return;
+    }
+
+    // O interpretador instancia o módulo a partir do nó; o .crzc guarda o hash
+    node->data.import_stmt.module = module;
+    node->data.import_stmt.module_hash = module->tree_hash;
+    import_module_symbols(analyzer, node, module);
+}
+
+static void visit_return_statement(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    if (!analyzer->in_function)
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "Instrução 'return' fora de função");
+        return;
+    }
+
+    analyzer->has_return_statement = 1;
+
+    if (analyzer->current_return_type->base_type == TYPE_VOID)
+    {
+        // Verificar que return void não tem valor
+        if (node->data.return_stmt.value != NULL)
+        {
+            semantic_error(analyzer, node->line, node->column,
+                           "Função void não pode retornar um valor");
+        }
+    }
+    else
+    {
+        // Verificar que return não-void tem valor
+        if (node->data.return_stmt.value == NULL)
+        {
+            semantic_error(analyzer, node->line, node->column,
+                           "Esperado valor de retorno do tipo %s",
+                           typeinfo_to_string(analyzer->current_return_type));
+        }
+        else
+        {
+            // Verificar compatibilidade do tipo do valor de retorno
+            TypeCheckResult result = check_expression(analyzer, node->data.return_stmt.value);
+            if (result.is_valid && !are_types_compatible(analyzer->current_return_type, result.type))
+            {
+                semantic_error(analyzer, node->line, node->column,
+                               "Tipo de retorno incompatível: esperado %s, encontrado %s",
                                typeinfo_to_string(analyzer->current_return_type),
                                typeinfo_to_string(result.type));
             }
-            typeinfo_free(result.type);
+            else if (result.is_valid)
+            {
+                bind_empty_map_literal(node->data.return_stmt.value, analyzer->current_return_type);
+            }
         }
     }
 }
@@ -822,15 +1821,12 @@ static void visit_if_statement(SemanticAnalyzer *analyzer, ASTNode *node)
     // Verificar condição
     TypeCheckResult condition_result = check_expression(analyzer, node->data.if_stmt.condition);
 
-    if (condition_result.is_valid && condition_result.type->base_type != TYPE_BOOL)
+    if (condition_result.is_valid && !is_primitive(condition_result.type, TYPE_BOOL))
     {
         semantic_error(analyzer, node->line, node->column,
                        "Condição do 'if' deve ser do tipo bool, encontrado %s",
                        typeinfo_to_string(condition_result.type));
     }
-
-    typeinfo_free(condition_result.type);
-
     // Visitar ramos
     visit_node(analyzer, node->data.if_stmt.then_branch);
     if (node->data.if_stmt.else_branch)
@@ -844,19 +1840,99 @@ static void visit_while_statement(SemanticAnalyzer *analyzer, ASTNode *node)
     // Verificar condição
     TypeCheckResult condition_result = check_expression(analyzer, node->data.while_stmt.condition);
 
-    if (condition_result.is_valid && condition_result.type->base_type != TYPE_BOOL)
+    if (condition_result.is_valid && !is_primitive(condition_result.type, TYPE_BOOL))
     {
         semantic_error(analyzer, node->line, node->column,
                        "Condição do 'while' deve ser do tipo bool, encontrado %s",
                        typeinfo_to_string(condition_result.type));
     }
-
-    typeinfo_free(condition_result.type);
-
     // Visitar corpo
     visit_node(analyzer, node->data.while_stmt.body);
 }
 
+/* O valor do match é int ou string e todo rótulo é literal do mesmo tipo
+ * (rótulos repetidos já foram rejeitados pelo parser ao montar a tabela) */
+static void visit_match_statement(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeCheckResult subject_result = check_expression(analyzer, node->data.match_stmt.subject);
+    int label_type = -1;
+
+    if (subject_result.is_valid)
+    {
+        if (is_primitive(subject_result.type, TYPE_INT))
+            label_type = TOKEN_INT_LITERAL;
+        else if (is_primitive(subject_result.type, TYPE_STRING))
+            label_type = TOKEN_STRING_LITERAL;
+        else
+            semantic_error(analyzer, node->line, node->column,
+                           "Valor do 'match' deve ser do tipo int ou string, encontrado %s",
+                           typeinfo_to_string(subject_result.type));
+    }
+
+    for (int i = 0; i < node->data.match_stmt.arm_count; i++)
+    {
+        ASTNode *arm = node->data.match_stmt.arms[i];
+
+        for (int j = 0; label_type != -1 && j < arm->data.match_arm.label_count; j++)
+        {
+            ASTNode *label = arm->data.match_arm.labels[j];
+            if ((int)label->data.literal.literal_type != label_type)
+            {
+                semantic_error(analyzer, label->line, label->column,
+                               "Rótulo do 'match' deve ser do tipo %s",
+                               typeinfo_to_string(subject_result.type));
+            }
+        }
+        visit_node(analyzer, arm->data.match_arm.body);
+    }
+
+    visit_node(analyzer, node->data.match_stmt.else_branch);
+}
+
+/* Limites e passo do 'for' devem ser int */
+static void check_for_bound(SemanticAnalyzer *analyzer, ASTNode *node, ASTNode *bound, const char *what)
+{
+    TypeCheckResult bound_result = check_expression(analyzer, bound);
+
+    if (bound_result.is_valid && !is_primitive(bound_result.type, TYPE_INT))
+    {
+        semantic_error(analyzer, node->line, node->column,
+                       "%s do 'for' deve ser do tipo int, encontrado %s",
+                       what, typeinfo_to_string(bound_result.type));
+    }
+}
+
+static void visit_for_statement(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    ASTNode *step = node->data.for_stmt.step;
+
+    check_for_bound(analyzer, node, node->data.for_stmt.start, "Início do intervalo");
+    check_for_bound(analyzer, node, node->data.for_stmt.end, "Fim do intervalo");
+    if (step)
+    {
+        check_for_bound(analyzer, node, step, "Passo");
+
+        if (step->node_type == NODE_LITERAL &&
+            step->data.literal.literal_type == TOKEN_INT_LITERAL &&
+            step->data.literal.value.int_value == 0)
+        {
+            semantic_error(analyzer, step->line, step->column, "Passo do 'for' não pode ser zero");
+        }
+    }
+
+    // A variável de controle vive num escopo próprio em volta do corpo
+    enter_scope(analyzer, SCOPE_BLOCK);
+
+    SymbolEntry *counter = symbol_create_variable(node->data.for_stmt.var_name, typeinfo_create(TYPE_INT),
+                                                  node->line, node->column);
+    counter->details.var_info.is_loop_counter = 1;
+    symbol_insert(analyzer, counter);
+
+    visit_node(analyzer, node->data.for_stmt.body);
+
+    exit_scope(analyzer);
+}
+
 static void visit_block(SemanticAnalyzer *analyzer, ASTNode *node)
 {
     enter_scope(analyzer, SCOPE_BLOCK);
@@ -871,11 +1947,9 @@ static void visit_block(SemanticAnalyzer *analyzer, ASTNode *node)
 
 static void visit_expression_statement(SemanticAnalyzer *analyzer, ASTNode *node)
 {
-    // Para NODE_EXPR_STMT, a expressão está no primeiro statement do bloco
-    if (node->data.block.stmt_count > 0)
+    if (node->data.expr_stmt.expression)
     {
-        TypeCheckResult result = check_expression(analyzer, node->data.block.statements[0]);
-        typeinfo_free(result.type);
+        check_expression(analyzer, node->data.expr_stmt.expression);
     }
 }
 
@@ -892,12 +1966,24 @@ static void visit_node(SemanticAnalyzer *analyzer, ASTNode *node)
     case NODE_FUNC_DECL:
         visit_function_decl(analyzer, node);
         break;
+    case NODE_STRUCT_DECL:
+        visit_struct_decl(analyzer, node);
+        break;
+    case NODE_IMPORT:
+        visit_import(analyzer, node);
+        break;
     case NODE_IF_STMT:
         visit_if_statement(analyzer, node);
         break;
     case NODE_WHILE_STMT:
         visit_while_statement(analyzer, node);
         break;
+    case NODE_FOR_STMT:
+        visit_for_statement(analyzer, node);
+        break;
+    case NODE_MATCH_STMT:
+        visit_match_statement(analyzer, node);
+        break;
     case NODE_RETURN_STMT:
         visit_return_statement(analyzer, node);
         break;
@@ -915,18 +2001,117 @@ static void visit_node(SemanticAnalyzer *analyzer, ASTNode *node)
 
 /* --- FUNÇÕES DE RELATÓRIO DE ERROS --- */
 
-static void semantic_error(SemanticAnalyzer *analyzer, int line, int column, const char *format, ...)
+#define DIAGNOSTIC_INITIAL_CAPACITY 16
+#define DIAGNOSTIC_TEXT_INITIAL_CAPACITY 1024
+
+/* Reserva uma entrada no buffer de diagnósticos; NULL se faltar memória */
+static SemanticDiagnostic *diagnostic_append(SemanticAnalyzer *analyzer, int is_error, int line, int column)
 {
-    analyzer->error_count++;
+    if (analyzer->diagnostic_count == analyzer->diagnostic_capacity)
+    {
+        int capacity = analyzer->diagnostic_capacity ? analyzer->diagnostic_capacity * 2
+                                                     : DIAGNOSTIC_INITIAL_CAPACITY;
+        SemanticDiagnostic *grown = realloc(analyzer->diagnostics, capacity * sizeof(SemanticDiagnostic));
+        if (!grown)
+            return NULL;
+        analyzer->diagnostics = grown;
+        analyzer->diagnostic_capacity = capacity;
+    }
+
+    SemanticDiagnostic *diagnostic = &analyzer->diagnostics[analyzer->diagnostic_count];
+    diagnostic->line = line;
+    diagnostic->column = column;
+    diagnostic->is_error = is_error;
+    diagnostic->message = analyzer->diagnostic_text_length;
+    return diagnostic;
+}
+
+/* Formata a mensagem direto no fim do texto de diagnósticos; 0 se faltar memória */
+static int diagnostic_format(SemanticAnalyzer *analyzer, const char *format, va_list args)
+{
+    size_t length = analyzer->diagnostic_text_length;
+    size_t available = analyzer->diagnostic_text_capacity - length;
+
+    va_list retry;
+    va_copy(retry, args);
+    int needed = available ? vsnprintf(analyzer->diagnostic_text + length, available, format, args)
+                           : vsnprintf(NULL, 0, format, args);
+    if (needed < 0)
+    {
+        va_end(retry);
+        return 0;
+    }
+
+    if ((size_t)needed >= available)
+    {
+        size_t capacity = analyzer->diagnostic_text_capacity ? analyzer->diagnostic_text_capacity
+                                                             : DIAGNOSTIC_TEXT_INITIAL_CAPACITY;
+        while (capacity - length <= (size_t)needed)
+            capacity *= 2;
+
+        char *grown = realloc(analyzer->diagnostic_text, capacity);
+        if (!grown)
+        {
+            va_end(retry);
+            return 0;
+        }
+        analyzer->diagnostic_text = grown;
+        analyzer->diagnostic_text_capacity = capacity;
+        vsnprintf(grown + length, capacity - length, format, retry);
+    }
 
+    va_end(retry);
+    analyzer->diagnostic_text_length = length + (size_t)needed + 1;
+    return 1;
+}
+
+static void diagnostic_print(const SemanticAnalyzer *analyzer, const SemanticDiagnostic *diagnostic)
+{
+    semantic_print_diagnostic(diagnostic->is_error, diagnostic->line, diagnostic->column,
+                              analyzer->diagnostic_text + diagnostic->message);
+}
+
+/* Formata com argumentos variáveis (usado para copiar diagnósticos entre buffers) */
+static int diagnostic_formatf(SemanticAnalyzer *analyzer, const char *format, ...)
+{
     va_list args;
     va_start(args, format);
+    int ok = diagnostic_format(analyzer, format, args);
+    va_end(args);
+    return ok;
+}
+
+static void semantic_report(SemanticAnalyzer *analyzer, int is_error, int line, int column,
+                            const char *format, va_list args)
+{
+    SemanticDiagnostic *diagnostic = diagnostic_append(analyzer, is_error, line, column);
+    va_list print_args;
+    va_copy(print_args, args);
+
+    if (diagnostic && diagnostic_format(analyzer, format, args))
+    {
+        analyzer->diagnostic_count++;
+        if (analyzer->print_diagnostics)
+            diagnostic_print(analyzer, diagnostic);
+    }
+    else if (analyzer->print_diagnostics)
+    {
+        // Sem memória para guardar: ao menos mostrar o diagnóstico
+        fprintf(stderr, "[%s Semântico] Linha %d, Coluna %d: ", is_error ? "ERRO" : "AVISO", line, column);
+        vfprintf(stderr, format, print_args);
+        fputc('\n', stderr);
+    }
 
-    char message[256];
-    vsnprintf(message, sizeof(message), format, args);
+    va_end(print_args);
+}
 
-    fprintf(stderr, "[ERRO Semântico] Linha %d, Coluna %d: %s\n", line, column, message);
+static void semantic_error(SemanticAnalyzer *analyzer, int line, int column, const char *format, ...)
+{
+    analyzer->error_count++;
 
+    va_list args;
+    va_start(args, format);
+    semantic_report(analyzer, 1, line, column, format, args);
     va_end(args);
 }
 
@@ -936,121 +2121,1969 @@ static void semantic_warning(SemanticAnalyzer *analyzer, int line, int column, c
 
     va_list args;
     va_start(args, format);
-
-    char message[256];
-    vsnprintf(message, sizeof(message), format, args);
-
-    fprintf(stderr, "[AVISO Semântico] Linha %d, Coluna %d: %s\n", line, column, message);
-
+    semantic_report(analyzer, 0, line, column, format, args);
     va_end(args);
 }
 
-/* --- FUNÇÕES PÚBLICAS --- */
+/* --- ANÁLISE PARALELA --- */
 
-void semantic_init(SemanticAnalyzer *analyzer, ASTNode *ast_root)
+/* Corpo de função de nível superior adiado para a fase 2 */
+typedef struct
+{
+    ASTNode *node;
+    SymbolEntry *function;
+    int chunk;      // Thread que verifica o corpo
+    int diag_begin; // Diagnósticos do corpo no buffer da thread
+    int diag_end;
+} FunctionBody;
+
+/* Faixa contígua de corpos verificada por uma thread, com contexto próprio */
+typedef struct
+{
+    FunctionBody *bodies;
+    int begin;
+    int end;
+    SemanticAnalyzer analyzer;
+} BodyChunk;
+
+/* Inicializa o analisador sem registrar os built-ins */
+static void semantic_init_context(SemanticAnalyzer *analyzer, ASTNode *ast_root)
 {
     analyzer->ast_root = ast_root;
     analyzer->error_count = 0;
     analyzer->warning_count = 0;
-    analyzer->error_msg[0] = '\0';
+    analyzer->diagnostics = NULL;
+    analyzer->diagnostic_count = 0;
+    analyzer->diagnostic_capacity = 0;
+    analyzer->diagnostic_text = NULL;
+    analyzer->diagnostic_text_length = 0;
+    analyzer->diagnostic_text_capacity = 0;
     analyzer->current_return_type = NULL;
     analyzer->in_function = 0;
     analyzer->current_function[0] = '\0';
     analyzer->has_return_statement = 0;
     analyzer->strict_mode = 0;
+    analyzer->thread_count = 1;
+    analyzer->print_diagnostics = 1;
+    analyzer->source_path = NULL;
+    analyzer->shared_symbols = NULL;
+    analyzer->visible_order = 0;
+    analyzer->builtin_symbols = NULL;
 
     // Inicializar tabela de símbolos
     analyzer->symbol_table = malloc(sizeof(SymbolTable));
     analyzer->symbol_table->global_scope = scope_create(SCOPE_GLOBAL, NULL);
     analyzer->symbol_table->current_scope = analyzer->symbol_table->global_scope;
     analyzer->symbol_table->scope_count = 1;
-
-    // Registrar built-ins
-    semantic_register_builtins(analyzer);
+    analyzer->symbol_table->index = calloc(NAME_INDEX_INITIAL_CAPACITY, sizeof(NameSlot));
+    analyzer->symbol_table->index_capacity = NAME_INDEX_INITIAL_CAPACITY;
+    analyzer->symbol_table->index_count = 0;
+    analyzer->symbol_table->insert_count = 0;
 }
 
-int semantic_analyze(SemanticAnalyzer *analyzer)
+static int count_function_decls(ASTNode *program)
 {
-    if (!analyzer || !analyzer->ast_root)
+    int count = 0;
+    for (int i = 0; i < program->data.block.stmt_count; i++)
     {
-        return 0;
+        ASTNode *stmt = program->data.block.statements[i];
+        if (stmt && stmt->node_type == NODE_FUNC_DECL)
+            count++;
     }
+    return count;
+}
 
-    visit_node(analyzer, analyzer->ast_root);
-
-    return analyzer->error_count == 0;
+static void check_body_chunk(BodyChunk *chunk)
+{
+    SemanticAnalyzer *analyzer = &chunk->analyzer;
+    for (int i = chunk->begin; i < chunk->end; i++)
+    {
+        FunctionBody *body = &chunk->bodies[i];
+
+        // O corpo enxerga o que a análise serial enxergaria: os símbolos do
+        // programa inseridos até a própria função (inclusive)
+        analyzer->visible_order = body->function->declared_order;
+        body->diag_begin = analyzer->diagnostic_count;
+        check_function_body(analyzer, body->node, body->function);
+        body->diag_end = analyzer->diagnostic_count;
+    }
 }
 
-void semantic_cleanup(SemanticAnalyzer *analyzer)
+#ifdef _WIN32
+static DWORD WINAPI check_body_chunk_thread(LPVOID arg)
 {
-    if (!analyzer || !analyzer->symbol_table)
-        return;
+    check_body_chunk((BodyChunk *)arg);
+    return 0;
+}
+#else
+static void *check_body_chunk_thread(void *arg)
+{
+    check_body_chunk((BodyChunk *)arg);
+    return NULL;
+}
+#endif
 
-    // Voltar ao escopo global e limpar tudo
-    while (analyzer->symbol_table->current_scope != analyzer->symbol_table->global_scope)
+/* Copia os diagnósticos [begin, end) de 'source' para o fim de 'dest' */
+static void diagnostics_append_range(SemanticAnalyzer *dest, const SemanticAnalyzer *source, int begin, int end)
+{
+    for (int i = begin; i < end; i++)
     {
-        exit_scope(analyzer);
+        const SemanticDiagnostic *diagnostic = &source->diagnostics[i];
+        if (diagnostic_append(dest, diagnostic->is_error, diagnostic->line, diagnostic->column) &&
+            diagnostic_formatf(dest, "%s", source->diagnostic_text + diagnostic->message))
+            dest->diagnostic_count++;
     }
-
-    scope_destroy(analyzer->symbol_table->global_scope);
-    free(analyzer->symbol_table);
-    analyzer->symbol_table = NULL;
 }
 
-void semantic_print_report(SemanticAnalyzer *analyzer)
+/* Análise em duas fases do programa (NODE_BLOCK): equivale a visit_block */
+static void analyze_program_parallel(SemanticAnalyzer *analyzer, ASTNode *program)
 {
-    if (!analyzer)
+    int stmt_count = program->data.block.stmt_count;
+    FunctionBody *bodies = malloc(sizeof(FunctionBody) * stmt_count);
+    int *stmt_diagnostics = malloc(sizeof(int) * (stmt_count + 1));
+    int *stmt_bodies = malloc(sizeof(int) * stmt_count);
+    if (!bodies || !stmt_diagnostics || !stmt_bodies)
+    {
+        free(bodies);
+        free(stmt_diagnostics);
+        free(stmt_bodies);
+        visit_node(analyzer, program);
         return;
+    }
 
-    printf("========================================\n");
-    printf("     RELATÓRIO DE ANÁLISE SEMÂNTICA    \n");
-    printf("========================================\n");
+    // Os diagnósticos só são mostrados depois de reunidos na ordem do fonte
+    int print_diagnostics = analyzer->print_diagnostics;
+    int first_diagnostic = analyzer->diagnostic_count;
+    analyzer->print_diagnostics = 0;
 
-    if (analyzer->error_count == 0 && analyzer->warning_count == 0)
-    {
-        printf("✅ Análise semântica concluída sem problemas!\n");
-    }
-    else
+    // Fase 1: instruções de nível superior e assinaturas das funções, em série.
+    // Os diagnósticos da instrução i ficam em [stmt_diagnostics[i], stmt_diagnostics[i + 1])
+    enter_scope(analyzer, SCOPE_BLOCK);
+    int body_count = 0;
+    stmt_diagnostics[0] = analyzer->diagnostic_count;
+    for (int i = 0; i < stmt_count; i++)
     {
-        if (analyzer->error_count > 0)
+        ASTNode *stmt = program->data.block.statements[i];
+        stmt_bodies[i] = -1;
+        if (stmt && stmt->node_type == NODE_FUNC_DECL)
         {
-            printf("❌ %d erro(s) semântico(s) encontrado(s)\n", analyzer->error_count);
+            SymbolEntry *function = declare_function(analyzer, stmt);
+            if (function)
+            {
+                bodies[body_count].node = stmt;
+                bodies[body_count].function = function;
+                stmt_bodies[i] = body_count++;
+            }
         }
-        if (analyzer->warning_count > 0)
+        else
         {
-            printf("⚠️  %d aviso(s) semântico(s) encontrado(s)\n", analyzer->warning_count);
+            visit_node(analyzer, stmt);
         }
+        stmt_diagnostics[i + 1] = analyzer->diagnostic_count;
     }
 
-    printf("========================================\n");
-}
+    // Fase 2: corpos das funções divididos em faixas contíguas, uma por thread.
+    // A tabela do programa não muda mais até o fim desta fase.
+    int chunk_count = analyzer->thread_count > SEMANTIC_MAX_THREADS ? SEMANTIC_MAX_THREADS : analyzer->thread_count;
+    if (chunk_count > body_count)
+        chunk_count = body_count > 0 ? body_count : 1;
 
-void semantic_register_builtins(SemanticAnalyzer *analyzer)
-{
-    // Registrar função print(any): void
-    SymbolEntry **print_params = malloc(sizeof(SymbolEntry *) * 1);
-    print_params[0] = symbol_create_variable("value", typeinfo_create(TYPE_STRING), 0, 0);
-    print_params[0]->category = SYMBOL_PARAMETER;
+    BodyChunk chunks[SEMANTIC_MAX_THREADS];
+    for (int c = 0; c < chunk_count; c++)
+    {
+        chunks[c].bodies = bodies;
+        chunks[c].begin = (int)((long long)body_count * c / chunk_count);
+        chunks[c].end = (int)((long long)body_count * (c + 1) / chunk_count);
+        for (int i = chunks[c].begin; i < chunks[c].end; i++)
+            bodies[i].chunk = c;
+
+        semantic_init_context(&chunks[c].analyzer, NULL);
+        chunks[c].analyzer.strict_mode = analyzer->strict_mode;
+        chunks[c].analyzer.print_diagnostics = 0;
+        chunks[c].analyzer.shared_symbols = analyzer->symbol_table;
+    }
 
-    SymbolEntry *print_func = symbol_create_function(
-        "print", typeinfo_create(TYPE_VOID), print_params, 1, 0, 0);
-    symbol_insert(analyzer, print_func);
+#ifdef _WIN32
+    HANDLE threads[SEMANTIC_MAX_THREADS];
+#else
+    pthread_t threads[SEMANTIC_MAX_THREADS];
+#endif
+    int started[SEMANTIC_MAX_THREADS] = {0};
 
-    // Registrar função type(any): string
-    SymbolEntry **type_params = malloc(sizeof(SymbolEntry *) * 1);
+    // A primeira faixa é verificada na thread atual
+    for (int c = 1; c < chunk_count; c++)
+    {
+#ifdef _WIN32
+        threads[c] = CreateThread(NULL, 0, check_body_chunk_thread, &chunks[c], 0, NULL);
+        started[c] = threads[c] != NULL;
+#else
+        started[c] = pthread_create(&threads[c], NULL, check_body_chunk_thread, &chunks[c]) == 0;
+#endif
+        if (!started[c])
+            check_body_chunk(&chunks[c]); // Sem thread disponível: verifica aqui mesmo
+    }
+    check_body_chunk(&chunks[0]);
+
+    for (int c = 1; c < chunk_count; c++)
+    {
+        if (started[c])
+        {
+#ifdef _WIN32
+            WaitForSingleObject(threads[c], INFINITE);
+            CloseHandle(threads[c]);
+#else
+            pthread_join(threads[c], NULL);
+#endif
+        }
+    }
+
+    // Junção: cada instrução seguida do corpo da sua função, como na análise serial
+    SemanticAnalyzer merged;
+    merged.diagnostics = NULL;
+    merged.diagnostic_count = 0;
+    merged.diagnostic_capacity = 0;
+    merged.diagnostic_text = NULL;
+    merged.diagnostic_text_length = 0;
+    merged.diagnostic_text_capacity = 0;
+
+    diagnostics_append_range(&merged, analyzer, 0, first_diagnostic);
+    for (int i = 0; i < stmt_count; i++)
+    {
+        diagnostics_append_range(&merged, analyzer, stmt_diagnostics[i], stmt_diagnostics[i + 1]);
+        if (stmt_bodies[i] >= 0)
+        {
+            FunctionBody *body = &bodies[stmt_bodies[i]];
+            diagnostics_append_range(&merged, &chunks[body->chunk].analyzer, body->diag_begin, body->diag_end);
+        }
+    }
+
+    for (int c = 0; c < chunk_count; c++)
+    {
+        analyzer->error_count += chunks[c].analyzer.error_count;
+        analyzer->warning_count += chunks[c].analyzer.warning_count;
+        semantic_cleanup(&chunks[c].analyzer);
+    }
+
+    free(analyzer->diagnostics);
+    free(analyzer->diagnostic_text);
+    analyzer->diagnostics = merged.diagnostics;
+    analyzer->diagnostic_count = merged.diagnostic_count;
+    analyzer->diagnostic_capacity = merged.diagnostic_capacity;
+    analyzer->diagnostic_text = merged.diagnostic_text;
+    analyzer->diagnostic_text_length = merged.diagnostic_text_length;
+    analyzer->diagnostic_text_capacity = merged.diagnostic_text_capacity;
+
+    exit_scope(analyzer);
+
+    analyzer->print_diagnostics = print_diagnostics;
+    if (print_diagnostics)
+    {
+        for (int i = first_diagnostic; i < analyzer->diagnostic_count; i++)
+            diagnostic_print(analyzer, &analyzer->diagnostics[i]);
+    }
+
+    free(bodies);
+    free(stmt_diagnostics);
+    free(stmt_bodies);
+}
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+void semantic_init(SemanticAnalyzer *analyzer, ASTNode *ast_root)
+{
+    semantic_init_context(analyzer, ast_root);
+
+    // Registrar built-ins
+    semantic_register_builtins(analyzer);
+    analyzer->builtin_symbols = analyzer->symbol_table->global_scope->symbols;
+}
+
+int semantic_analyze(SemanticAnalyzer *analyzer)
+{
+    if (!analyzer || !analyzer->ast_root)
+    {
+        return 0;
+    }
+
+    ASTNode *root = analyzer->ast_root;
+    if (analyzer->thread_count > 1 && root->node_type == NODE_BLOCK &&
+        count_function_decls(root) >= SEMANTIC_PARALLEL_MIN_FUNCTIONS)
+    {
+        analyze_program_parallel(analyzer, root);
+    }
+    else
+    {
+        visit_node(analyzer, root);
+    }
+
+    return analyzer->error_count == 0;
+}
+
+void semantic_cleanup(SemanticAnalyzer *analyzer)
+{
+    if (!analyzer || !analyzer->symbol_table)
+        return;
+
+    // Voltar ao escopo global e limpar tudo
+    while (analyzer->symbol_table->current_scope != analyzer->symbol_table->global_scope)
+    {
+        exit_scope(analyzer);
+    }
+
+    scope_destroy(analyzer->symbol_table->global_scope);
+
+    for (int i = 0; i < analyzer->symbol_table->index_capacity; i++)
+        free(analyzer->symbol_table->index[i].name);
+    free(analyzer->symbol_table->index);
+    free(analyzer->symbol_table);
+    analyzer->symbol_table = NULL;
+
+    free(analyzer->diagnostics);
+    free(analyzer->diagnostic_text);
+    analyzer->diagnostics = NULL;
+    analyzer->diagnostic_text = NULL;
+    analyzer->diagnostic_count = 0;
+}
+
+/* --- AVALIAÇÃO DE CHAMADAS PURAS EM TEMPO DE COMPILAÇÃO --- */
+
+/* Limites de uma avaliação: passos (nós visitados) por chamada dobrada, no
+ * total da compilação, profundidade de chamadas e tamanho de strings.
+ * Passar de qualquer um só deixa a chamada para o tempo de execução. */
+#ifndef CONST_EVAL_STEP_LIMIT
+#define CONST_EVAL_STEP_LIMIT 100000
+#endif
+#ifndef CONST_EVAL_TOTAL_STEPS
+#define CONST_EVAL_TOTAL_STEPS 2000000
+#endif
+#define CONST_EVAL_MAX_DEPTH 64
+#define CONST_EVAL_MAX_STRING 1024
+
+typedef struct
+{
+    DataType type; // TYPE_INT, TYPE_FLOAT, TYPE_BOOL ou TYPE_STRING
+    union
+    {
+        int int_value;
+        double float_value;
+        int bool_value;
+    } as;
+    char *chars; // TYPE_STRING: malloc, terminada em '\0'
+    int length;
+} ConstValue;
+
+typedef struct
+{
+    const char *name;
+    ConstValue value;
+} ConstSlot;
+
+typedef struct
+{
+    const char *name;
+    ASTNode *decl;
+    int pure; // Candidata: tipos primitivos, só nós e chamadas que a avaliação entende
+} ConstFunction;
+
+typedef enum
+{
+    CONST_NORMAL,
+    CONST_RETURN,
+    CONST_FAIL // Não avaliável aqui: erro, limite ou código impuro
+} ConstStatus;
+
+typedef struct
+{
+    ConstFunction *functions; // Funções de nível superior, ordenadas por nome
+    int function_count;
+    ConstSlot *slots;         // Variáveis vivas; a função em avaliação vê de 'frame' em diante
+    int slot_count;
+    int slot_capacity;
+    int frame;
+    int depth;
+    long steps;  // Restantes para a chamada em avaliação
+    long budget; // Restantes para toda a compilação
+} ConstEvaluator;
+
+static ConstStatus const_execute(ConstEvaluator *eval, ASTNode *node, ConstValue *result);
+static int const_evaluate(ConstEvaluator *eval, ASTNode *node, ConstValue *out);
+
+static void const_value_free(ConstValue *value)
+{
+    if (value->type == TYPE_STRING)
+        free(value->chars);
+    value->type = TYPE_VOID;
+}
+
+static int const_string(ConstValue *out, const char *left, int left_length, const char *right, int right_length)
+{
+    if (left_length + right_length > CONST_EVAL_MAX_STRING)
+        return 0;
+
+    char *chars = malloc((size_t)left_length + (size_t)right_length + 1);
+    if (!chars)
+        return 0;
+    memcpy(chars, left, (size_t)left_length);
+    memcpy(chars + left_length, right, (size_t)right_length);
+    chars[left_length + right_length] = '\0';
+
+    out->type = TYPE_STRING;
+    out->chars = chars;
+    out->length = left_length + right_length;
+    return 1;
+}
+
+static int const_value_copy(ConstValue *out, const ConstValue *value)
+{
+    if (value->type == TYPE_STRING)
+        return const_string(out, value->chars, value->length, "", 0);
+    *out = *value;
+    return 1;
+}
+
+static int const_is_number(const ConstValue *value)
+{
+    return value->type == TYPE_INT || value->type == TYPE_FLOAT;
+}
+
+static double const_as_double(const ConstValue *value)
+{
+    return value->type == TYPE_INT ? (double)value->as.int_value : value->as.float_value;
+}
+
+static void const_bool(ConstValue *out, int truth)
+{
+    out->type = TYPE_BOOL;
+    out->as.bool_value = truth ? 1 : 0;
+}
+
+/* Resultado int de 64 bits que ainda cabe num int (o interpretador não
+ * define o estouro: a chamada fica para ele) */
+static int const_int(ConstValue *out, long long value)
+{
+    if (value < INT_MIN || value > INT_MAX)
+        return 0;
+    out->type = TYPE_INT;
+    out->as.int_value = (int)value;
+    return 1;
+}
+
+/* --- Variáveis da avaliação --- */
+
+static ConstSlot *const_lookup(ConstEvaluator *eval, const char *name)
+{
+    for (int i = eval->slot_count - 1; i >= eval->frame; i--)
+    {
+        if (strcmp(eval->slots[i].name, name) == 0)
+            return &eval->slots[i];
+    }
+    return NULL;
+}
+
+/* Empilha a variável 'name', que assume 'value'; 0 sem memória */
+static int const_push(ConstEvaluator *eval, const char *name, ConstValue *value)
+{
+    if (eval->slot_count == eval->slot_capacity)
+    {
+        int capacity = eval->slot_capacity ? eval->slot_capacity * 2 : 16;
+        ConstSlot *slots = realloc(eval->slots, sizeof(ConstSlot) * capacity);
+        if (!slots)
+        {
+            const_value_free(value);
+            return 0;
+        }
+        eval->slots = slots;
+        eval->slot_capacity = capacity;
+    }
+
+    eval->slots[eval->slot_count].name = name;
+    eval->slots[eval->slot_count].value = *value;
+    eval->slot_count++;
+    return 1;
+}
+
+static void const_pop_to(ConstEvaluator *eval, int count)
+{
+    while (eval->slot_count > count)
+        const_value_free(&eval->slots[--eval->slot_count].value);
+}
+
+/* Resolve o nome como o interpretador: uma função do usuário esconde o
+ * built-in de mesmo nome, e um nome que não é função do usuário nunca é
+ * dobrado */
+static ConstFunction *const_find_function(ConstEvaluator *eval, const char *name)
+{
+    int low = 0;
+    int high = eval->function_count - 1;
+    while (low <= high)
+    {
+        int mid = low + (high - low) / 2;
+        int order = strcmp(name, eval->functions[mid].name);
+        if (order == 0)
+            return &eval->functions[mid];
+        if (order < 0)
+            high = mid - 1;
+        else
+            low = mid + 1;
+    }
+    return NULL;
+}
+
+/* --- Expressões --- */
+
+/* Mesma igualdade de op_compare_eq no interpretador (floats com tolerância) */
+static int const_equal(const ConstValue *left, const ConstValue *right)
+{
+    if (const_is_number(left) && const_is_number(right))
+    {
+        if (left->type == TYPE_INT && right->type == TYPE_INT)
+            return left->as.int_value == right->as.int_value;
+        double difference = const_as_double(left) - const_as_double(right);
+        return difference < 1e-10 && difference > -1e-10;
+    }
+    if (left->type != right->type)
+        return 0;
+    if (left->type == TYPE_STRING)
+        return left->length == right->length && memcmp(left->chars, right->chars, (size_t)left->length) == 0;
+    return left->as.bool_value == right->as.bool_value;
+}
+
+static int const_binary(TokenType op, const ConstValue *left, const ConstValue *right, ConstValue *out)
+{
+    int ints = left->type == TYPE_INT && right->type == TYPE_INT;
+    int numbers = const_is_number(left) && const_is_number(right);
+    long long l = ints ? left->as.int_value : 0;
+    long long r = ints ? right->as.int_value : 0;
+
+    if (op == TOKEN_PLUS && left->type == TYPE_STRING && right->type == TYPE_STRING)
+        return const_string(out, left->chars, left->length, right->chars, right->length);
+
+    switch (op)
+    {
+    case TOKEN_PLUS:
+    case TOKEN_MINUS:
+    case TOKEN_STAR:
+        if (ints)
+            return const_int(out, op == TOKEN_PLUS ? l + r : op == TOKEN_MINUS ? l - r : l * r);
+        if (!numbers)
+            return 0;
+        out->type = TYPE_FLOAT;
+        out->as.float_value = op == TOKEN_PLUS    ? const_as_double(left) + const_as_double(right)
+                              : op == TOKEN_MINUS ? const_as_double(left) - const_as_double(right)
+                                                  : const_as_double(left) * const_as_double(right);
+        return 1;
+    case TOKEN_SLASH:
+        // '/' sempre dá float
+        if (!numbers || const_as_double(right) == 0.0)
+            return 0;
+        out->type = TYPE_FLOAT;
+        out->as.float_value = const_as_double(left) / const_as_double(right);
+        return 1;
+    case TOKEN_PERCENT:
+        if (!ints || r == 0 || (l == INT_MIN && r == -1))
+            return 0;
+        return const_int(out, l % r);
+    case TOKEN_EQUAL_EQUAL:
+        const_bool(out, const_equal(left, right));
+        return 1;
+    case TOKEN_BANG_EQUAL:
+        const_bool(out, !const_equal(left, right));
+        return 1;
+    case TOKEN_GREATER:
+    case TOKEN_LESS:
+    case TOKEN_GREATER_EQUAL:
+    case TOKEN_LESS_EQUAL:
+    {
+        if (!numbers)
+            return 0;
+        double a = const_as_double(left);
+        double b = const_as_double(right);
+        int truth = op == TOKEN_GREATER ? a > b : op == TOKEN_LESS ? a < b : 0;
+        // '>=' e '<=' são '>'/'<' ou igual, como em op_compare_gte/lte
+        if (op == TOKEN_GREATER_EQUAL)
+            truth = a > b || const_equal(left, right);
+        else if (op == TOKEN_LESS_EQUAL)
+            truth = a < b || const_equal(left, right);
+        const_bool(out, truth);
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+/* Chama a função pura 'function' com 'args' (assumidos pela chamada) */
+static int const_call(ConstEvaluator *eval, ASTNode *function, ConstValue *args, ConstValue *out)
+{
+    int count = function->data.func_decl.param_count;
+    if (eval->depth >= CONST_EVAL_MAX_DEPTH)
+    {
+        for (int i = 0; i < count; i++)
+            const_value_free(&args[i]);
+        return 0;
+    }
+
+    // A função só enxerga seus parâmetros e locais
+    int saved_frame = eval->frame;
+    eval->frame = eval->slot_count;
+    eval->depth++;
+
+    int ok = 1;
+    for (int i = 0; i < count; i++)
+    {
+        if (ok)
+            ok = const_push(eval, function->data.func_decl.params[i]->data.param.name, &args[i]);
+        else
+            const_value_free(&args[i]);
+    }
+
+    // Sem 'return' o interpretador devolve o valor do último statement: não dobrar
+    if (ok)
+        ok = const_execute(eval, function->data.func_decl.body, out) == CONST_RETURN;
+
+    const_pop_to(eval, eval->frame);
+    eval->depth--;
+    eval->frame = saved_frame;
+    return ok;
+}
+
+static int const_evaluate_call(ConstEvaluator *eval, ASTNode *node, ConstValue *out)
+{
+    ConstFunction *function = const_find_function(eval, node->data.call_expr.function_name);
+    int count = node->data.call_expr.arg_count;
+    if (!function || !function->pure || count != function->decl->data.func_decl.param_count)
+        return 0;
+
+    ConstValue *args = malloc(sizeof(ConstValue) * (count > 0 ? count : 1));
+    if (!args)
+        return 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!const_evaluate(eval, node->data.call_expr.arguments[i], &args[i]))
+        {
+            for (int j = 0; j < i; j++)
+                const_value_free(&args[j]);
+            free(args);
+            return 0;
+        }
+    }
+
+    int ok = const_call(eval, function->decl, args, out);
+    free(args);
+    return ok;
+}
+
+static int const_evaluate(ConstEvaluator *eval, ASTNode *node, ConstValue *out)
+{
+    if (--eval->steps < 0)
+        return 0;
+
+    switch (node->node_type)
+    {
+    case NODE_LITERAL:
+        switch (node->data.literal.literal_type)
+        {
+        case TOKEN_INT_LITERAL:
+            out->type = TYPE_INT;
+            out->as.int_value = node->data.literal.value.int_value;
+            return 1;
+        case TOKEN_FLOAT_LITERAL:
+            out->type = TYPE_FLOAT;
+            out->as.float_value = node->data.literal.value.float_value;
+            return 1;
+        case TOKEN_STRING_LITERAL:
+        {
+            const char *text = node->data.literal.value.string_value;
+            return const_string(out, text, (int)strlen(text), "", 0);
+        }
+        case TOKEN_TRUE:
+        case TOKEN_FALSE:
+            const_bool(out, node->data.literal.literal_type == TOKEN_TRUE);
+            return 1;
+        default:
+            return 0;
+        }
+
+    case NODE_VAR_EXPR:
+    {
+        // Fora dos locais (global ou variável de quem chamou) não é constante
+        ConstSlot *slot = const_lookup(eval, node->data.var_expr.name);
+        return slot && const_value_copy(out, &slot->value);
+    }
+
+    case NODE_ASSIGN_EXPR:
+    {
+        ConstValue value;
+        if (!const_evaluate(eval, node->data.assign_expr.value, &value))
+            return 0;
+
+        ConstSlot *slot = const_lookup(eval, node->data.assign_expr.variable_name);
+        if (!slot || !const_value_copy(out, &value))
+        {
+            const_value_free(&value);
+            return 0;
+        }
+        const_value_free(&slot->value);
+        slot->value = value;
+        return 1;
+    }
+
+    case NODE_UNARY_EXPR:
+    {
+        ConstValue operand;
+        if (!const_evaluate(eval, node->data.unary_expr.operand, &operand))
+            return 0;
+
+        int ok = 1;
+        if (node->data.unary_expr.operator == TOKEN_BANG && operand.type == TYPE_BOOL)
+            const_bool(out, !operand.as.bool_value);
+        else if (node->data.unary_expr.operator == TOKEN_MINUS && operand.type == TYPE_INT)
+            ok = const_int(out, -(long long)operand.as.int_value);
+        else if (node->data.unary_expr.operator == TOKEN_MINUS && operand.type == TYPE_FLOAT)
+        {
+            out->type = TYPE_FLOAT;
+            out->as.float_value = -operand.as.float_value;
+        }
+        else
+            ok = 0;
+
+        const_value_free(&operand);
+        return ok;
+    }
+
+    case NODE_BINARY_EXPR:
+    {
+        TokenType op = node->data.binary_expr.operator;
+        ConstValue left, right;
+        if (!const_evaluate(eval, node->data.binary_expr.left, &left))
+            return 0;
+
+        // '&&' e '||' em curto-circuito
+        if (op == TOKEN_AND_AND || op == TOKEN_PIPE_PIPE)
+        {
+            if (left.type != TYPE_BOOL)
+            {
+                const_value_free(&left);
+                return 0;
+            }
+            if (left.as.bool_value == (op == TOKEN_PIPE_PIPE))
+            {
+                *out = left;
+                return 1;
+            }
+            if (!const_evaluate(eval, node->data.binary_expr.right, out))
+                return 0;
+            if (out->type != TYPE_BOOL)
+            {
+                const_value_free(out);
+                return 0;
+            }
+            return 1;
+        }
+
+        if (!const_evaluate(eval, node->data.binary_expr.right, &right))
+        {
+            const_value_free(&left);
+            return 0;
+        }
+
+        int ok = const_binary(op, &left, &right, out);
+        const_value_free(&left);
+        const_value_free(&right);
+        return ok;
+    }
+
+    case NODE_CALL_EXPR:
+        return const_evaluate_call(eval, node, out);
+
+    default:
+        return 0;
+    }
+}
+
+/* --- Statements --- */
+
+static ConstStatus const_execute_block(ConstEvaluator *eval, ASTNode *node, ConstValue *result)
+{
+    int mark = eval->slot_count;
+    ConstStatus status = CONST_NORMAL;
+
+    for (int i = 0; status == CONST_NORMAL && i < node->data.block.stmt_count; i++)
+        status = const_execute(eval, node->data.block.statements[i], result);
+
+    const_pop_to(eval, mark);
+    return status;
+}
+
+/* Condição bool de 'if'/'while': 1 ou 0 em 'truth'; CONST_FAIL se não avaliável */
+static ConstStatus const_condition(ConstEvaluator *eval, ASTNode *condition, int *truth)
+{
+    ConstValue value;
+    if (!const_evaluate(eval, condition, &value))
+        return CONST_FAIL;
+    if (value.type != TYPE_BOOL)
+    {
+        const_value_free(&value);
+        return CONST_FAIL;
+    }
+    *truth = value.as.bool_value;
+    return CONST_NORMAL;
+}
+
+static int const_int_bound(ConstEvaluator *eval, ASTNode *bound, int *out)
+{
+    ConstValue value;
+    if (!const_evaluate(eval, bound, &value))
+        return 0;
+    if (value.type != TYPE_INT)
+    {
+        const_value_free(&value);
+        return 0;
+    }
+    *out = value.as.int_value;
+    return 1;
+}
+
+static ConstStatus const_execute_for(ConstEvaluator *eval, ASTNode *node, ConstValue *result)
+{
+    int start, end, step = 1;
+    if (!const_int_bound(eval, node->data.for_stmt.start, &start) ||
+        !const_int_bound(eval, node->data.for_stmt.end, &end) ||
+        (node->data.for_stmt.step && !const_int_bound(eval, node->data.for_stmt.step, &step)) || step == 0)
+        return CONST_FAIL;
+
+    int mark = eval->slot_count;
+    ConstValue counter = {0};
+    counter.type = TYPE_INT;
+    if (!const_push(eval, node->data.for_stmt.var_name, &counter))
+        return CONST_FAIL;
+
+    ConstStatus status = CONST_NORMAL;
+    for (long long i = start; status == CONST_NORMAL && (step > 0 ? i < end : i > end); i += step)
+    {
+        // A análise não deixa o corpo atribuir à variável de controle
+        eval->slots[mark].value.as.int_value = (int)i;
+        status = const_execute(eval, node->data.for_stmt.body, result);
+    }
+
+    const_pop_to(eval, mark);
+    return status;
+}
+
+static ConstStatus const_execute_match(ConstEvaluator *eval, ASTNode *node, ConstValue *result)
+{
+    const MatchTable *table = node->data.match_stmt.table;
+    ConstValue subject;
+    if (!table || !const_evaluate(eval, node->data.match_stmt.subject, &subject))
+        return CONST_FAIL;
+
+    int arm;
+    if (subject.type == TYPE_INT)
+        arm = match_table_find_int(table, subject.as.int_value);
+    else if (subject.type == TYPE_STRING)
+        arm = match_table_find_string(table, subject.chars, subject.length);
+    else
+        arm = -2;
+    const_value_free(&subject);
+
+    if (arm == -2)
+        return CONST_FAIL;
+
+    ASTNode *branch = arm >= 0 ? node->data.match_stmt.arms[arm]->data.match_arm.body
+                               : node->data.match_stmt.else_branch;
+    return branch ? const_execute(eval, branch, result) : CONST_NORMAL;
+}
+
+static ConstStatus const_execute(ConstEvaluator *eval, ASTNode *node, ConstValue *result)
+{
+    if (--eval->steps < 0)
+        return CONST_FAIL;
+
+    switch (node->node_type)
+    {
+    case NODE_BLOCK:
+        return const_execute_block(eval, node, result);
+
+    case NODE_VAR_DECL:
+    {
+        // Sem inicializador o interpretador cria null, que não é constante aqui
+        ConstValue value;
+        if (!node->data.var_decl.initializer || !const_evaluate(eval, node->data.var_decl.initializer, &value))
+            return CONST_FAIL;
+        return const_push(eval, node->data.var_decl.name, &value) ? CONST_NORMAL : CONST_FAIL;
+    }
+
+    case NODE_EXPR_STMT:
+    {
+        ConstValue value;
+        if (!node->data.expr_stmt.expression || !const_evaluate(eval, node->data.expr_stmt.expression, &value))
+            return CONST_FAIL;
+        const_value_free(&value);
+        return CONST_NORMAL;
+    }
+
+    case NODE_IF_STMT:
+    {
+        int truth;
+        if (const_condition(eval, node->data.if_stmt.condition, &truth) == CONST_FAIL)
+            return CONST_FAIL;
+        if (truth)
+            return const_execute(eval, node->data.if_stmt.then_branch, result);
+        return node->data.if_stmt.else_branch ? const_execute(eval, node->data.if_stmt.else_branch, result)
+                                              : CONST_NORMAL;
+    }
+
+    case NODE_WHILE_STMT:
+        for (;;)
+        {
+            int truth;
+            if (const_condition(eval, node->data.while_stmt.condition, &truth) == CONST_FAIL)
+                return CONST_FAIL;
+            if (!truth)
+                return CONST_NORMAL;
+
+            ConstStatus status = const_execute(eval, node->data.while_stmt.body, result);
+            if (status != CONST_NORMAL)
+                return status;
+        }
+
+    case NODE_FOR_STMT:
+        return const_execute_for(eval, node, result);
+
+    case NODE_MATCH_STMT:
+        return const_execute_match(eval, node, result);
+
+    case NODE_RETURN_STMT:
+        if (!node->data.return_stmt.value || !const_evaluate(eval, node->data.return_stmt.value, result))
+            return CONST_FAIL;
+        return CONST_RETURN;
+
+    default:
+        return CONST_FAIL;
+    }
+}
+
+/* --- Análise de pureza --- */
+
+/* int, float, bool ou string: os únicos tipos que viram literal */
+static int const_type_node(const ASTNode *type_node)
+{
+    if (!type_node || type_node->data.type_node.is_array || type_node->data.type_node.is_map)
+        return 0;
+
+    DataType type = type_node->data.type_node.type;
+    return type == TYPE_INT || type == TYPE_FLOAT || type == TYPE_BOOL || type == TYPE_STRING;
+}
+
+static int const_signature(const ASTNode *function)
+{
+    if (!const_type_node(function->data.func_decl.return_type))
+        return 0;
+    for (int i = 0; i < function->data.func_decl.param_count; i++)
+    {
+        if (!const_type_node(function->data.func_decl.params[i]->data.param.type_node))
+            return 0;
+    }
+    return 1;
+}
+
+/* O corpo só usa nós que a avaliação entende e só chama funções ainda puras
+ * (sem built-ins: print e afins têm efeitos, os demais pedem arrays e maps) */
+static int const_pure_node(ConstEvaluator *eval, const ASTNode *node)
+{
+    if (!node)
+        return 1;
+
+    switch (node->node_type)
+    {
+    case NODE_LITERAL:
+    case NODE_VAR_EXPR:
+        return 1;
+    case NODE_VAR_DECL:
+        return (!node->data.var_decl.type_node || const_type_node(node->data.var_decl.type_node)) &&
+               const_pure_node(eval, node->data.var_decl.initializer);
+    case NODE_EXPR_STMT:
+        return const_pure_node(eval, node->data.expr_stmt.expression);
+    case NODE_IF_STMT:
+        return const_pure_node(eval, node->data.if_stmt.condition) &&
+               const_pure_node(eval, node->data.if_stmt.then_branch) &&
+               const_pure_node(eval, node->data.if_stmt.else_branch);
+    case NODE_WHILE_STMT:
+        return const_pure_node(eval, node->data.while_stmt.condition) &&
+               const_pure_node(eval, node->data.while_stmt.body);
+    case NODE_FOR_STMT:
+        return const_pure_node(eval, node->data.for_stmt.start) &&
+               const_pure_node(eval, node->data.for_stmt.end) &&
+               const_pure_node(eval, node->data.for_stmt.step) &&
+               const_pure_node(eval, node->data.for_stmt.body);
+    case NODE_MATCH_STMT:
+        if (!const_pure_node(eval, node->data.match_stmt.subject) ||
+            !const_pure_node(eval, node->data.match_stmt.else_branch))
+            return 0;
+        for (int i = 0; i < node->data.match_stmt.arm_count; i++)
+        {
+            if (!const_pure_node(eval, node->data.match_stmt.arms[i]->data.match_arm.body))
+                return 0;
+        }
+        return 1;
+    case NODE_RETURN_STMT:
+        return const_pure_node(eval, node->data.return_stmt.value);
+    case NODE_BLOCK:
+        for (int i = 0; i < node->data.block.stmt_count; i++)
+        {
+            if (!const_pure_node(eval, node->data.block.statements[i]))
+                return 0;
+        }
+        return 1;
+    case NODE_ASSIGN_EXPR:
+        return const_pure_node(eval, node->data.assign_expr.value);
+    case NODE_BINARY_EXPR:
+        return const_pure_node(eval, node->data.binary_expr.left) &&
+               const_pure_node(eval, node->data.binary_expr.right);
+    case NODE_UNARY_EXPR:
+        return const_pure_node(eval, node->data.unary_expr.operand);
+    case NODE_CALL_EXPR:
+    {
+        ConstFunction *function = const_find_function(eval, node->data.call_expr.function_name);
+        if (!function || !function->pure)
+            return 0;
+        for (int i = 0; i < node->data.call_expr.arg_count; i++)
+        {
+            if (!const_pure_node(eval, node->data.call_expr.arguments[i]))
+                return 0;
+        }
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+/* Uma função declarada fora do nível superior pode esconder a de mesmo nome:
+ * nenhuma das duas é dobrada */
+static void const_mark_nested(ConstEvaluator *eval, ASTNode *node, int top_level);
+
+static void const_mark_nested_list(ConstEvaluator *eval, ASTNode **nodes, int count)
+{
+    for (int i = 0; i < count; i++)
+        const_mark_nested(eval, nodes[i], 0);
+}
+
+static void const_mark_nested(ConstEvaluator *eval, ASTNode *node, int top_level)
+{
+    if (!node)
+        return;
+
+    switch (node->node_type)
+    {
+    case NODE_FUNC_DECL:
+        if (!top_level)
+        {
+            ConstFunction *function = const_find_function(eval, node->data.func_decl.name);
+            if (function)
+                function->pure = 0;
+        }
+        const_mark_nested(eval, node->data.func_decl.body, 0);
+        break;
+    case NODE_BLOCK:
+        for (int i = 0; i < node->data.block.stmt_count; i++)
+            const_mark_nested(eval, node->data.block.statements[i], top_level);
+        break;
+    case NODE_IF_STMT:
+        const_mark_nested(eval, node->data.if_stmt.then_branch, 0);
+        const_mark_nested(eval, node->data.if_stmt.else_branch, 0);
+        break;
+    case NODE_WHILE_STMT:
+        const_mark_nested(eval, node->data.while_stmt.body, 0);
+        break;
+    case NODE_FOR_STMT:
+        const_mark_nested(eval, node->data.for_stmt.body, 0);
+        break;
+    case NODE_MATCH_STMT:
+        const_mark_nested_list(eval, node->data.match_stmt.arms, node->data.match_stmt.arm_count);
+        const_mark_nested(eval, node->data.match_stmt.else_branch, 0);
+        break;
+    case NODE_MATCH_ARM:
+        const_mark_nested(eval, node->data.match_arm.body, 0);
+        break;
+    default:
+        break;
+    }
+}
+
+static int compare_const_functions(const void *a, const void *b)
+{
+    return strcmp(((const ConstFunction *)a)->name, ((const ConstFunction *)b)->name);
+}
+
+/* Lista as funções de nível superior e marca as puras: candidatas pela
+ * assinatura e pelo corpo, descartando até não sobrar nenhuma que chame
+ * uma função impura. Ler uma variável de fora da função (global ou de quem
+ * chamou) só é detectado ao avaliar, e a chamada então não é dobrada. */
+static int const_collect_functions(ConstEvaluator *eval, ASTNode *root)
+{
+    int count = 0;
+    for (int i = 0; i < root->data.block.stmt_count; i++)
+    {
+        if (root->data.block.statements[i]->node_type == NODE_FUNC_DECL)
+            count++;
+    }
+    if (count == 0)
+        return 1;
+
+    eval->functions = malloc(sizeof(ConstFunction) * count);
+    if (!eval->functions)
+        return 0;
+
+    for (int i = 0; i < root->data.block.stmt_count; i++)
+    {
+        ASTNode *stmt = root->data.block.statements[i];
+        if (stmt->node_type != NODE_FUNC_DECL)
+            continue;
+
+        ConstFunction *function = &eval->functions[eval->function_count++];
+        function->name = stmt->data.func_decl.name;
+        function->decl = stmt;
+        function->pure = const_signature(stmt);
+    }
+    qsort(eval->functions, count, sizeof(ConstFunction), compare_const_functions);
+
+    // Nomes repetidos já são erro semântico; por segurança nenhum é dobrado
+    for (int i = 1; i < count; i++)
+    {
+        if (strcmp(eval->functions[i - 1].name, eval->functions[i].name) == 0)
+            eval->functions[i - 1].pure = eval->functions[i].pure = 0;
+    }
+    const_mark_nested(eval, root, 1);
+
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int i = 0; i < count; i++)
+        {
+            ConstFunction *function = &eval->functions[i];
+            if (function->pure && !const_pure_node(eval, function->decl->data.func_decl.body))
+            {
+                function->pure = 0;
+                changed = 1;
+            }
+        }
+    }
+    return 1;
+}
+
+/* --- Substituição das chamadas --- */
+
+/* Troca a chamada pelo literal 'value'; os filhos e nomes da chamada são
+ * liberados quando a árvore não vive numa arena */
+static int const_replace(ASTNode *node, const ConstValue *value, AstArena *arena)
+{
+    char *text = NULL;
+    if (value->type == TYPE_STRING)
+    {
+        text = arena ? ast_arena_alloc(arena, (size_t)value->length + 1) : malloc((size_t)value->length + 1);
+        if (!text)
+            return 0;
+        memcpy(text, value->chars, (size_t)value->length + 1);
+    }
+
+    if (!arena)
+    {
+        for (int i = 0; i < node->data.call_expr.arg_count; i++)
+            ast_free(node->data.call_expr.arguments[i]);
+        free(node->data.call_expr.arguments);
+        free(node->data.call_expr.function_name);
+    }
+
+    node->node_type = NODE_LITERAL;
+    node->data_type = value->type;
+    switch (value->type)
+    {
+    case TYPE_INT:
+        node->data.literal.literal_type = TOKEN_INT_LITERAL;
+        node->data.literal.value.int_value = value->as.int_value;
+        break;
+    case TYPE_FLOAT:
+        node->data.literal.literal_type = TOKEN_FLOAT_LITERAL;
+        node->data.literal.value.float_value = value->as.float_value;
+        break;
+    case TYPE_STRING:
+        node->data.literal.literal_type = TOKEN_STRING_LITERAL;
+        node->data.literal.value.string_value = text;
+        break;
+    default:
+        node->data.literal.literal_type = value->as.bool_value ? TOKEN_TRUE : TOKEN_FALSE;
+        node->data.literal.value.bool_value = value->as.bool_value;
+        break;
+    }
+    return 1;
+}
+
+/* Avalia a chamada se a função é pura e os argumentos são constantes */
+static int const_fold_call(ConstEvaluator *eval, ASTNode *node, AstArena *arena)
+{
+    ConstFunction *function = const_find_function(eval, node->data.call_expr.function_name);
+    if (!function || !function->pure || eval->budget <= 0)
+        return 0;
+
+    // Argumentos avaliados sem variáveis visíveis: só literais e expressões deles
+    eval->frame = eval->slot_count;
+    eval->steps = eval->budget < CONST_EVAL_STEP_LIMIT ? eval->budget : CONST_EVAL_STEP_LIMIT;
+    long available = eval->steps;
+
+    ConstValue value;
+    int ok = const_evaluate_call(eval, node, &value);
+    eval->budget -= available - (eval->steps > 0 ? eval->steps : 0);
+
+    if (!ok)
+        return 0;
+    ok = const_replace(node, &value, arena);
+    const_value_free(&value);
+    return ok;
+}
+
+static int const_fold_node(ConstEvaluator *eval, ASTNode *node, AstArena *arena);
+
+static int const_fold_list(ConstEvaluator *eval, ASTNode **nodes, int count, AstArena *arena)
+{
+    int folded = 0;
+    for (int i = 0; i < count; i++)
+        folded += const_fold_node(eval, nodes[i], arena);
+    return folded;
+}
+
+/* Dobra as chamadas de baixo para cima: argumentos que eram chamadas puras já
+ * chegam como literais à chamada de fora */
+static int const_fold_node(ConstEvaluator *eval, ASTNode *node, AstArena *arena)
+{
+    if (!node)
+        return 0;
+
+    switch (node->node_type)
+    {
+    case NODE_VAR_DECL:
+        return const_fold_node(eval, node->data.var_decl.initializer, arena);
+    case NODE_FUNC_DECL:
+        return const_fold_node(eval, node->data.func_decl.body, arena);
+    case NODE_EXPR_STMT:
+        return const_fold_node(eval, node->data.expr_stmt.expression, arena);
+    case NODE_IF_STMT:
+        return const_fold_node(eval, node->data.if_stmt.condition, arena) +
+               const_fold_node(eval, node->data.if_stmt.then_branch, arena) +
+               const_fold_node(eval, node->data.if_stmt.else_branch, arena);
+    case NODE_WHILE_STMT:
+        return const_fold_node(eval, node->data.while_stmt.condition, arena) +
+               const_fold_node(eval, node->data.while_stmt.body, arena);
+    case NODE_FOR_STMT:
+        return const_fold_node(eval, node->data.for_stmt.start, arena) +
+               const_fold_node(eval, node->data.for_stmt.end, arena) +
+               const_fold_node(eval, node->data.for_stmt.step, arena) +
+               const_fold_node(eval, node->data.for_stmt.body, arena);
+    case NODE_MATCH_STMT:
+        return const_fold_node(eval, node->data.match_stmt.subject, arena) +
+               const_fold_list(eval, node->data.match_stmt.arms, node->data.match_stmt.arm_count, arena) +
+               const_fold_node(eval, node->data.match_stmt.else_branch, arena);
+    case NODE_MATCH_ARM:
+        return const_fold_node(eval, node->data.match_arm.body, arena);
+    case NODE_RETURN_STMT:
+        return const_fold_node(eval, node->data.return_stmt.value, arena);
+    case NODE_BLOCK:
+        return const_fold_list(eval, node->data.block.statements, node->data.block.stmt_count, arena);
+    case NODE_ASSIGN_EXPR:
+        return const_fold_node(eval, node->data.assign_expr.value, arena);
+    case NODE_BINARY_EXPR:
+        return const_fold_node(eval, node->data.binary_expr.left, arena) +
+               const_fold_node(eval, node->data.binary_expr.right, arena);
+    case NODE_UNARY_EXPR:
+        return const_fold_node(eval, node->data.unary_expr.operand, arena);
+    case NODE_CALL_EXPR:
+    {
+        int folded = const_fold_list(eval, node->data.call_expr.arguments, node->data.call_expr.arg_count, arena);
+        return folded + const_fold_call(eval, node, arena);
+    }
+    case NODE_INDEX_EXPR:
+        return const_fold_node(eval, node->data.index_expr.array, arena) +
+               const_fold_node(eval, node->data.index_expr.index, arena);
+    case NODE_INDEX_ASSIGN:
+        return const_fold_node(eval, node->data.index_assign.array, arena) +
+               const_fold_node(eval, node->data.index_assign.index, arena) +
+               const_fold_node(eval, node->data.index_assign.value, arena);
+    case NODE_FIELD_EXPR:
+    case NODE_FIELD_ASSIGN:
+        return const_fold_node(eval, node->data.field_expr.object, arena) +
+               const_fold_node(eval, node->data.field_expr.value, arena);
+    case NODE_ARRAY_LITERAL:
+        return const_fold_list(eval, node->data.array_literal.elements, node->data.array_literal.element_count,
+                               arena);
+    case NODE_MAP_LITERAL:
+        return const_fold_list(eval, node->data.map_literal.items, 2 * node->data.map_literal.entry_count, arena);
+    default:
+        return 0;
+    }
+}
+
+int semantic_fold_constants(SemanticAnalyzer *analyzer, AstArena *arena)
+{
+    ASTNode *root = analyzer ? analyzer->ast_root : NULL;
+    if (!root || root->node_type != NODE_BLOCK || analyzer->error_count > 0)
+        return 0;
+
+    ConstEvaluator eval;
+    memset(&eval, 0, sizeof(eval));
+    eval.budget = CONST_EVAL_TOTAL_STEPS;
+
+    int folded = 0;
+    if (const_collect_functions(&eval, root))
+        folded = const_fold_node(&eval, root, arena);
+
+    const_pop_to(&eval, 0);
+    free(eval.slots);
+    free(eval.functions);
+    return folded;
+}
+
+/* --- ANÁLISE FUNDIDA COM O PARSE --- */
+
+static void check_declaration_hook(void *analyzer, ASTNode *declaration)
+{
+    visit_node((SemanticAnalyzer *)analyzer, declaration);
+}
+
+void semantic_attach_parser(SemanticAnalyzer *analyzer, Parser *parser)
+{
+    // Mesmo escopo que visit_block abre para o NODE_BLOCK do programa
+    enter_scope(analyzer, SCOPE_BLOCK);
+    parser->on_declaration = check_declaration_hook;
+    parser->hook_context = analyzer;
+}
+
+int semantic_end_program(SemanticAnalyzer *analyzer, ASTNode *program)
+{
+    exit_scope(analyzer);
+    analyzer->ast_root = program;
+    return analyzer->error_count == 0;
+}
+
+/* --- ANÁLISE INCREMENTAL --- */
+
+void semantic_reset_globals(SemanticAnalyzer *analyzer)
+{
+    // Os símbolos do programa ficam acima dos built-ins na lista do escopo global
+    Scope *global = analyzer->symbol_table->global_scope;
+    for (SymbolEntry *symbol = global->symbols; symbol != analyzer->builtin_symbols; symbol = symbol->next)
+        index_pop(analyzer->symbol_table, symbol);
+    global->symbols = analyzer->builtin_symbols;
+    analyzer->error_count = 0;
+    analyzer->warning_count = 0;
+    analyzer->diagnostic_count = 0;
+    analyzer->diagnostic_text_length = 0;
+}
+
+SymbolSpan semantic_analyze_statement(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    Scope *global = analyzer->symbol_table->global_scope;
+    SymbolEntry *mark = global->symbols;
+
+    visit_node(analyzer, node);
+
+    // Tudo o que foi inserido acima de 'mark' pertence a esta instrução
+    SymbolSpan span = {NULL, NULL};
+    if (global->symbols != mark)
+    {
+        span.first = global->symbols;
+        span.last = span.first;
+        while (span.last->next != mark)
+            span.last = span.last->next;
+    }
+    return span;
+}
+
+void semantic_restore_symbols(SemanticAnalyzer *analyzer, SymbolSpan span)
+{
+    if (!span.first)
+        return;
+
+    Scope *global = analyzer->symbol_table->global_scope;
+    span.last->next = global->symbols;
+    global->symbols = span.first;
+
+    // Nomes globais são únicos (redeclarações são rejeitadas), então a ordem
+    // de reinserção no índice não importa
+    for (SymbolEntry *symbol = span.first;; symbol = symbol->next)
+    {
+        index_push(analyzer->symbol_table, symbol);
+        if (symbol == span.last)
+            break;
+    }
+}
+
+void semantic_free_symbols(SymbolSpan span)
+{
+    SymbolEntry *current = span.first;
+    while (current)
+    {
+        SymbolEntry *next = current == span.last ? NULL : current->next;
+        symbol_entry_free(current);
+        current = next;
+    }
+}
+
+/* FNV-1a incremental */
+static uint64_t signature_mix(uint64_t hash, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t typeinfo_signature(uint64_t hash, const TypeInfo *type)
+{
+    for (; type; type = type->inner)
+    {
+        hash = signature_mix(hash, (uint64_t)type->base_type);
+        hash = signature_mix(hash, (uint64_t)(type->is_array | (type->is_const << 1) | (type->is_map << 2)));
+        if (type->key)
+            hash = signature_mix(hash, (uint64_t)type->key->base_type);
+        // Structs são internados pelo nome e pelos campos: o endereço identifica o layout
+        if (type->layout)
+            hash = signature_mix(hash, (uint64_t)(uintptr_t)type->layout);
+    }
+    return signature_mix(hash, 0xff);
+}
+
+uint64_t semantic_symbol_signature(const SymbolEntry *symbol)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *c = symbol->name; *c; c++)
+        hash = signature_mix(hash, (unsigned char)*c);
+
+    hash = signature_mix(hash, (uint64_t)symbol->category);
+    hash = typeinfo_signature(hash, symbol->type);
+
+    if (symbol->category == SYMBOL_FUNCTION)
+    {
+        hash = signature_mix(hash, (uint64_t)symbol->details.func_info.param_count);
+        for (int i = 0; i < symbol->details.func_info.param_count; i++)
+            hash = typeinfo_signature(hash, symbol->details.func_info.parameters[i]->type);
+    }
+
+    // 0 é reservado para "nenhum símbolo"
+    return hash ? hash : 1;
+}
+
+void semantic_print_report(SemanticAnalyzer *analyzer)
+{
+    if (!analyzer)
+        return;
+
+    printf("========================================\n");
+    printf("     RELATÓRIO DE ANÁLISE SEMÂNTICA    \n");
+    printf("========================================\n");
+
+    if (analyzer->error_count == 0 && analyzer->warning_count == 0)
+    {
+        printf("✅ Análise semântica concluída sem problemas!\n");
+    }
+    else
+    {
+        if (analyzer->error_count > 0)
+        {
+            printf("❌ %d erro(s) semântico(s) encontrado(s)\n", analyzer->error_count);
+        }
+        if (analyzer->warning_count > 0)
+        {
+            printf("⚠️  %d aviso(s) semântico(s) encontrado(s)\n", analyzer->warning_count);
+        }
+    }
+
+    printf("========================================\n");
+}
+
+void semantic_print_diagnostic(int is_error, int line, int column, const char *message)
+{
+    fprintf(stderr, "[%s Semântico] Linha %d, Coluna %d: %s\n", is_error ? "ERRO" : "AVISO",
+            line, column, message);
+}
+
+const char *semantic_diagnostic_message(const SemanticAnalyzer *analyzer, int index)
+{
+    if (!analyzer || index < 0 || index >= analyzer->diagnostic_count)
+        return NULL;
+
+    return analyzer->diagnostic_text + analyzer->diagnostics[index].message;
+}
+
+/* --- VERIFICAÇÃO DOS BUILT-INS --- */
+
+static TypeCheckResult builtin_result(int is_valid, DataType type)
+{
+    TypeCheckResult result = {0};
+    result.is_valid = is_valid;
+    result.type = typeinfo_create(is_valid ? type : TYPE_INVALID);
+    return result;
+}
+
+/* Verifica a quantidade de argumentos de um built-in */
+static int check_builtin_arity(SemanticAnalyzer *analyzer, ASTNode *call, int expected)
+{
+    if (call->data.call_expr.arg_count == expected)
+        return 1;
+
+    semantic_error(analyzer, call->line, call->column,
+                   "Número incorreto de argumentos para '%s': esperado %d, encontrado %d",
+                   call->data.call_expr.function_name, expected, call->data.call_expr.arg_count);
+    return 0;
+}
+
+/* print(...): qualquer quantidade de argumentos de qualquer tipo */
+static TypeCheckResult check_print_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    int is_valid = 1;
+    for (int i = 0; i < call->data.call_expr.arg_count; i++)
+    {
+        if (!check_expression(analyzer, call->data.call_expr.arguments[i]).is_valid)
+            is_valid = 0;
+    }
+    return builtin_result(is_valid, TYPE_VOID);
+}
+
+/* type(any): string */
+static TypeCheckResult check_type_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    if (!check_builtin_arity(analyzer, call, 1))
+        return builtin_result(0, TYPE_INVALID);
+
+    return builtin_result(check_expression(analyzer, call->data.call_expr.arguments[0]).is_valid,
+                          TYPE_STRING);
+}
+
+/* len(string | T[] | map<K, V> | bytes): int */
+static TypeCheckResult check_len_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    if (!check_builtin_arity(analyzer, call, 1))
+        return builtin_result(0, TYPE_INVALID);
+
+    TypeCheckResult arg = check_expression(analyzer, call->data.call_expr.arguments[0]);
+    if (!arg.is_valid)
+        return builtin_result(0, TYPE_INVALID);
+
+    if (!arg.type->is_array && !arg.type->is_map && !is_primitive(arg.type, TYPE_STRING) &&
+        !is_primitive(arg.type, TYPE_BYTES))
+    {
+        semantic_error(analyzer, call->line, call->column,
+                       "Função 'len' espera string, array, map ou bytes, encontrado %s",
+                       typeinfo_to_string(arg.type));
+        return builtin_result(0, TYPE_INVALID);
+    }
+
+    return builtin_result(1, TYPE_INT);
+}
+
+/* Argumentos vetoriais de sum/dot/scale...: 'count' arrays a partir de
+ * arguments[first], todos int[] ou todos float[] ('[]' assume o tipo dos
+ * demais). Grava o tipo do elemento em 'element'. */
+static int check_vector_arguments(SemanticAnalyzer *analyzer, ASTNode *call, int first, int count,
+                                  DataType *element)
+{
+    int is_valid = 1;
+    *element = TYPE_VOID;
+
+    for (int i = first; i < first + count; i++)
+    {
+        TypeCheckResult arg = check_expression(analyzer, call->data.call_expr.arguments[i]);
+        if (!arg.is_valid)
+        {
+            is_valid = 0;
+            continue;
+        }
+
+        DataType type = arg.type->is_array ? arg.type->base_type : TYPE_INVALID;
+        if (type != TYPE_INT && type != TYPE_FLOAT && type != TYPE_VOID)
+        {
+            semantic_error(analyzer, call->line, call->column,
+                           "Função '%s' espera int[] ou float[] no argumento %d, encontrado %s",
+                           call->data.call_expr.function_name, i + 1, typeinfo_to_string(arg.type));
+            is_valid = 0;
+        }
+        else if (type != TYPE_VOID && *element != TYPE_VOID && type != *element)
+        {
+            semantic_error(analyzer, call->line, call->column,
+                           "Função '%s' espera arrays do mesmo tipo, encontrado %s[] e %s[]",
+                           call->data.call_expr.function_name,
+                           data_type_to_string(*element), data_type_to_string(type));
+            is_valid = 0;
+        }
+        else if (type != TYPE_VOID)
+        {
+            *element = type;
+        }
+    }
+
+    if (*element == TYPE_VOID)
+        *element = TYPE_INT;
+    return is_valid;
+}
+
+/* Escalar de scale/axpy: int serve para float[]; float[] não aceita em int[] */
+static int check_vector_scalar_argument(SemanticAnalyzer *analyzer, ASTNode *call, int index,
+                                        DataType element)
+{
+    TypeCheckResult arg = check_expression(analyzer, call->data.call_expr.arguments[index]);
+    if (!arg.is_valid)
+        return 0;
+
+    if (!are_types_compatible(typeinfo_create(element), arg.type))
+    {
+        semantic_error(analyzer, call->line, call->column,
+                       "Função '%s' espera escalar %s no argumento %d, encontrado %s",
+                       call->data.call_expr.function_name, data_type_to_string(element),
+                       index + 1, typeinfo_to_string(arg.type));
+        return 0;
+    }
+    return 1;
+}
+
+/* sum/min/max(T[]): T */
+static TypeCheckResult check_reduce_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    DataType element;
+    if (!check_builtin_arity(analyzer, call, 1))
+        return builtin_result(0, TYPE_INVALID);
+
+    int is_valid = check_vector_arguments(analyzer, call, 0, 1, &element);
+    return builtin_result(is_valid, element);
+}
+
+/* dot(T[], T[]): T */
+static TypeCheckResult check_dot_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    DataType element;
+    if (!check_builtin_arity(analyzer, call, 2))
+        return builtin_result(0, TYPE_INVALID);
+
+    int is_valid = check_vector_arguments(analyzer, call, 0, 2, &element);
+    return builtin_result(is_valid, element);
+}
+
+/* scale(T[], T): void */
+static TypeCheckResult check_scale_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    DataType element;
+    if (!check_builtin_arity(analyzer, call, 2))
+        return builtin_result(0, TYPE_INVALID);
+
+    int is_valid = check_vector_arguments(analyzer, call, 0, 1, &element);
+    is_valid &= check_vector_scalar_argument(analyzer, call, 1, element);
+    return builtin_result(is_valid, TYPE_VOID);
+}
+
+/* axpy(T, T[], T[]): void */
+static TypeCheckResult check_axpy_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    DataType element;
+    if (!check_builtin_arity(analyzer, call, 3))
+        return builtin_result(0, TYPE_INVALID);
+
+    int is_valid = check_vector_arguments(analyzer, call, 1, 2, &element);
+    is_valid &= check_vector_scalar_argument(analyzer, call, 0, element);
+    return builtin_result(is_valid, TYPE_VOID);
+}
+
+/* add/mul(T[], T[]): T[] */
+static TypeCheckResult check_elementwise_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    DataType element;
+    if (!check_builtin_arity(analyzer, call, 2))
+        return builtin_result(0, TYPE_INVALID);
+
+    TypeCheckResult result = builtin_result(check_vector_arguments(analyzer, call, 0, 2, &element),
+                                            TYPE_INVALID);
+    if (result.is_valid)
+        result.type = typeinfo_array(element);
+    return result;
+}
+
+/* Primeiro argumento de get/set/has/remove/keys/values: um map com tipos
+ * (não o literal '{}'). Com 'check_key', o segundo argumento é a chave. */
+static const TypeInfo *check_map_arguments(SemanticAnalyzer *analyzer, ASTNode *call, int check_key)
+{
+    TypeCheckResult map = check_expression(analyzer, call->data.call_expr.arguments[0]);
+    TypeCheckResult key = {0};
+    key.is_valid = 1;
+    if (check_key)
+        key = check_expression(analyzer, call->data.call_expr.arguments[1]);
+
+    if (!map.is_valid || !key.is_valid)
+        return NULL;
+
+    if (!map.type->is_map || is_primitive(map.type->key, TYPE_VOID))
+    {
+        semantic_error(analyzer, call->line, call->column,
+                       "Função '%s' espera um map no argumento 1, encontrado %s",
+                       call->data.call_expr.function_name, typeinfo_to_string(map.type));
+        return NULL;
+    }
+
+    if (check_key && key.type != map.type->key)
+    {
+        semantic_error(analyzer, call->line, call->column,
+                       "Função '%s' espera chave %s, encontrado %s",
+                       call->data.call_expr.function_name, typeinfo_to_string(map.type->key),
+                       typeinfo_to_string(key.type));
+        return NULL;
+    }
+
+    return map.type;
+}
+
+/* get(map<K, V>, K): V */
+static TypeCheckResult check_map_get_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    if (!check_builtin_arity(analyzer, call, 2))
+        return builtin_result(0, TYPE_INVALID);
+
+    const TypeInfo *map = check_map_arguments(analyzer, call, 1);
+    return builtin_result(map != NULL, map ? map->base_type : TYPE_INVALID);
+}
+
+/* has/remove(map<K, V>, K): bool */
+static TypeCheckResult check_map_lookup_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    if (!check_builtin_arity(analyzer, call, 2))
+        return builtin_result(0, TYPE_INVALID);
+
+    return builtin_result(check_map_arguments(analyzer, call, 1) != NULL, TYPE_BOOL);
+}
+
+/* set(map<K, V>, K, V): void */
+static TypeCheckResult check_map_set_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    if (!check_builtin_arity(analyzer, call, 3))
+        return builtin_result(0, TYPE_INVALID);
+
+    const TypeInfo *map = check_map_arguments(analyzer, call, 1);
+    TypeCheckResult value = check_expression(analyzer, call->data.call_expr.arguments[2]);
+    if (!map || !value.is_valid)
+        return builtin_result(0, TYPE_INVALID);
+
+    if (!are_types_compatible(map->inner, value.type))
+    {
+        semantic_error(analyzer, call->line, call->column,
+                       "Função 'set' espera valor %s, encontrado %s",
+                       typeinfo_to_string(map->inner), typeinfo_to_string(value.type));
+        return builtin_result(0, TYPE_INVALID);
+    }
+
+    return builtin_result(1, TYPE_VOID);
+}
+
+/* keys(map<K, V>): K[]; values(map<K, V>): V[] (ordem de inserção) */
+static TypeCheckResult check_map_keys_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    if (!check_builtin_arity(analyzer, call, 1))
+        return builtin_result(0, TYPE_INVALID);
+
+    const TypeInfo *map = check_map_arguments(analyzer, call, 0);
+    TypeCheckResult result = builtin_result(map != NULL, TYPE_INVALID);
+    if (map)
+        result.type = typeinfo_array(map->key->base_type);
+    return result;
+}
+
+static TypeCheckResult check_map_values_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    if (!check_builtin_arity(analyzer, call, 1))
+        return builtin_result(0, TYPE_INVALID);
+
+    const TypeInfo *map = check_map_arguments(analyzer, call, 0);
+    TypeCheckResult result = builtin_result(map != NULL, TYPE_INVALID);
+    if (map)
+        result.type = typeinfo_array(map->base_type);
+    return result;
+}
+
+/* Argumentos de assinatura fixa: cada um compatível com o tipo primitivo em
+ * 'params' (int vale onde se espera float) */
+static int check_typed_arguments(SemanticAnalyzer *analyzer, ASTNode *call, const DataType *params, int count)
+{
+    if (!check_builtin_arity(analyzer, call, count))
+        return 0;
+
+    int is_valid = 1;
+    for (int i = 0; i < count; i++)
+    {
+        TypeCheckResult arg = check_expression(analyzer, call->data.call_expr.arguments[i]);
+        if (!arg.is_valid)
+        {
+            is_valid = 0;
+        }
+        else if (!are_types_compatible(typeinfo_create(params[i]), arg.type))
+        {
+            semantic_error(analyzer, call->line, call->column,
+                           "Função '%s' espera %s no argumento %d, encontrado %s",
+                           call->data.call_expr.function_name, typeinfo_to_string(typeinfo_create(params[i])),
+                           i + 1, typeinfo_to_string(arg.type));
+            is_valid = 0;
+        }
+    }
+    return is_valid;
+}
+
+/* substr(string, int, int): string */
+static TypeCheckResult check_substr_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    static const DataType params[] = {TYPE_STRING, TYPE_INT, TYPE_INT};
+    return builtin_result(check_typed_arguments(analyzer, call, params, 3), TYPE_STRING);
+}
+
+static const DataType string_pair_params[] = {TYPE_STRING, TYPE_STRING};
+
+/* find(string, string): int */
+static TypeCheckResult check_find_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    return builtin_result(check_typed_arguments(analyzer, call, string_pair_params, 2), TYPE_INT);
+}
+
+/* starts_with(string, string): bool */
+static TypeCheckResult check_starts_with_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    return builtin_result(check_typed_arguments(analyzer, call, string_pair_params, 2), TYPE_BOOL);
+}
+
+/* split(string, string): string[] */
+static TypeCheckResult check_split_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    TypeCheckResult result = builtin_result(check_typed_arguments(analyzer, call, string_pair_params, 2),
+                                            TYPE_INVALID);
+    if (result.is_valid)
+        result.type = typeinfo_array(TYPE_STRING);
+    return result;
+}
+
+/* make_bytes(int): bytes */
+static TypeCheckResult check_make_bytes_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    static const DataType params[] = {TYPE_INT};
+    return builtin_result(check_typed_arguments(analyzer, call, params, 1), TYPE_BYTES);
+}
+
+/* to_bytes(string): bytes */
+static TypeCheckResult check_to_bytes_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    static const DataType params[] = {TYPE_STRING};
+    return builtin_result(check_typed_arguments(analyzer, call, params, 1), TYPE_BYTES);
+}
+
+static const DataType bytes_range_params[] = {TYPE_BYTES, TYPE_INT, TYPE_INT};
+
+/* slice(bytes, int, int): bytes */
+static TypeCheckResult check_slice_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    return builtin_result(check_typed_arguments(analyzer, call, bytes_range_params, 3), TYPE_BYTES);
+}
+
+/* read_string(bytes, int, int): string */
+static TypeCheckResult check_read_string_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    return builtin_result(check_typed_arguments(analyzer, call, bytes_range_params, 3), TYPE_STRING);
+}
+
+/* read_u8/u16/i16/u32/i32(bytes, int): int; read_f32/f64(bytes, int): float */
+static TypeCheckResult check_read_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    static const DataType params[] = {TYPE_BYTES, TYPE_INT};
+    DataType result = call->data.call_expr.function_name[5] == 'f' ? TYPE_FLOAT : TYPE_INT;
+    return builtin_result(check_typed_arguments(analyzer, call, params, 2), result);
+}
+
+/* write_u8/u16/u32(bytes, int, int); write_f32/f64(bytes, int, float): void */
+static TypeCheckResult check_write_call(SemanticAnalyzer *analyzer, ASTNode *call)
+{
+    DataType params[] = {TYPE_BYTES, TYPE_INT, TYPE_INT};
+    if (call->data.call_expr.function_name[6] == 'f')
+        params[2] = TYPE_FLOAT;
+    return builtin_result(check_typed_arguments(analyzer, call, params, 3), TYPE_VOID);
+}
+
+/* Built-in sem assinatura fixa: 'check' verifica argumentos e tipo de retorno */
+static void register_checked_builtin(SemanticAnalyzer *analyzer, const char *name, BuiltinCheckFn check)
+{
+    SymbolEntry *func = symbol_create_function(name, typeinfo_create(TYPE_VOID), NULL, 0, 0, 0);
+    func->details.func_info.check_call = check;
+    symbol_insert(analyzer, func);
+}
+
+void semantic_register_builtins(SemanticAnalyzer *analyzer)
+{
+    // Registrar função print(any): void
+    SymbolEntry **print_params = malloc(sizeof(SymbolEntry *) * 1);
+    print_params[0] = symbol_create_variable("value", typeinfo_create(TYPE_STRING), 0, 0);
+    print_params[0]->category = SYMBOL_PARAMETER;
+
+    SymbolEntry *print_func = symbol_create_function(
+        "print", typeinfo_create(TYPE_VOID), print_params, 1, 0, 0);
+    print_func->details.func_info.check_call = check_print_call;
+    symbol_insert(analyzer, print_func);
+
+    // Registrar função type(any): string
+    SymbolEntry **type_params = malloc(sizeof(SymbolEntry *) * 1);
     type_params[0] = symbol_create_variable("value", typeinfo_create(TYPE_STRING), 0, 0);
     type_params[0]->category = SYMBOL_PARAMETER;
 
     SymbolEntry *type_func = symbol_create_function(
         "type", typeinfo_create(TYPE_STRING), type_params, 1, 0, 0);
+    type_func->details.func_info.check_call = check_type_call;
     symbol_insert(analyzer, type_func);
 
-    // Registrar função len(string): int
+    // Registrar função len(string | array): int
     SymbolEntry **len_params = malloc(sizeof(SymbolEntry *) * 1);
     len_params[0] = symbol_create_variable("text", typeinfo_create(TYPE_STRING), 0, 0);
     len_params[0]->category = SYMBOL_PARAMETER;
 
     SymbolEntry *len_func = symbol_create_function(
         "len", typeinfo_create(TYPE_INT), len_params, 1, 0, 0);
+    len_func->details.func_info.check_call = check_len_call;
     symbol_insert(analyzer, len_func);
+
+    // Built-ins vetoriais sobre int[] e float[]
+    register_checked_builtin(analyzer, "sum", check_reduce_call);
+    register_checked_builtin(analyzer, "min", check_reduce_call);
+    register_checked_builtin(analyzer, "max", check_reduce_call);
+    register_checked_builtin(analyzer, "dot", check_dot_call);
+    register_checked_builtin(analyzer, "scale", check_scale_call);
+    register_checked_builtin(analyzer, "axpy", check_axpy_call);
+    register_checked_builtin(analyzer, "add", check_elementwise_call);
+    register_checked_builtin(analyzer, "mul", check_elementwise_call);
+
+    // Operações sobre map<K, V>
+    register_checked_builtin(analyzer, "get", check_map_get_call);
+    register_checked_builtin(analyzer, "set", check_map_set_call);
+    register_checked_builtin(analyzer, "has", check_map_lookup_call);
+    register_checked_builtin(analyzer, "remove", check_map_lookup_call);
+    register_checked_builtin(analyzer, "keys", check_map_keys_call);
+    register_checked_builtin(analyzer, "values", check_map_values_call);
+
+    // Operações sobre string (substr devolve fatia, sem cópia)
+    register_checked_builtin(analyzer, "substr", check_substr_call);
+    register_checked_builtin(analyzer, "find", check_find_call);
+    register_checked_builtin(analyzer, "starts_with", check_starts_with_call);
+    register_checked_builtin(analyzer, "split", check_split_call);
+
+    // Buffers binários (leituras/escritas little-endian com offset)
+    register_checked_builtin(analyzer, "make_bytes", check_make_bytes_call);
+    register_checked_builtin(analyzer, "to_bytes", check_to_bytes_call);
+    register_checked_builtin(analyzer, "slice", check_slice_call);
+    register_checked_builtin(analyzer, "read_string", check_read_string_call);
+    static const char *const reads[] = {"read_u8", "read_u16", "read_i16", "read_u32", "read_i32",
+                                        "read_f32", "read_f64"};
+    for (size_t i = 0; i < sizeof(reads) / sizeof(reads[0]); i++)
+        register_checked_builtin(analyzer, reads[i], check_read_call);
+    static const char *const writes[] = {"write_u8", "write_u16", "write_u32", "write_f32", "write_f64"};
+    for (size_t i = 0; i < sizeof(writes) / sizeof(writes[0]); i++)
+        register_checked_builtin(analyzer, writes[i], check_write_call);
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "../include/craze_source.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* --- FUNÇÕES INTERNAS/HELPERS --- */
+
+/* Primeiro bloco do fallback; dobra até caber o arquivo inteiro */
+#define SOURCE_READ_CHUNK 65536
+
+#ifdef _WIN32
+typedef HANDLE SourceHandle;
+
+/* Lê até 'capacity' bytes; 0 em erro, com *got == 0 no fim do arquivo */
+static int source_read_chunk(HANDLE fh, char *buffer, size_t capacity, size_t *got)
+{
+    DWORD request = capacity > 0x40000000 ? 0x40000000 : (DWORD)capacity;
+    DWORD count = 0;
+    *got = 0;
+    if (!ReadFile(fh, buffer, request, &count, NULL))
+        return GetLastError() == ERROR_BROKEN_PIPE; // Pipe fechado do outro lado = fim
+    *got = count;
+    return 1;
+}
+#else
+typedef int SourceHandle;
+
+static int source_read_chunk(int fd, char *buffer, size_t capacity, size_t *got)
+{
+    ssize_t count;
+    do
+    {
+        count = read(fd, buffer, capacity);
+    } while (count < 0 && errno == EINTR);
+
+    *got = count > 0 ? (size_t)count : 0;
+    return count >= 0;
+}
+#endif
+
+/* Fallback: lê do descritor já aberto até o fim, num buffer que cresce.
+ * Serve para o que não pode ser mapeado: arquivos vazios e entradas sem
+ * tamanho conhecido (FIFOs, substituição de processo, dispositivos). */
+static int source_read_fallback(SourceFile *file, SourceHandle fh, const char *filename)
+{
+    size_t capacity = SOURCE_READ_CHUNK;
+    size_t length = 0;
+    char *content = malloc(capacity);
+
+    while (content)
+    {
+        if (length == capacity)
+        {
+            char *grown = capacity <= (size_t)-1 / 2 ? realloc(content, capacity * 2) : NULL;
+            if (!grown)
+            {
+                free(content);
+                content = NULL;
+                break;
+            }
+            content = grown;
+            capacity *= 2;
+        }
+
+        size_t got;
+        if (!source_read_chunk(fh, content + length, capacity - length, &got))
+        {
+            fprintf(stderr, "Erro: Falha ao ler o arquivo '%s'\n", filename);
+            free(content);
+            return 0;
+        }
+        if (got == 0)
+            break;
+        length += got;
+    }
+
+    if (!content)
+    {
+        fprintf(stderr, "Erro: Memória insuficiente\n");
+        return 0;
+    }
+
+    file->data = content;
+    file->length = length;
+    file->is_mapped = 0;
+    return 1;
+}
+
+/* --- FUNÇÕES PÚBLICAS --- */
+
+int source_open(SourceFile *file, const char *filename)
+{
+    file->data = NULL;
+    file->length = 0;
+    file->is_mapped = 0;
+    file->handle = NULL;
+
+#ifdef _WIN32
+    HANDLE fh = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fh == INVALID_HANDLE_VALUE)
+    {
+        fprintf(stderr, "Erro: Não foi possível abrir o arquivo '%s'\n", filename);
+        return 0;
+    }
+
+    // Arquivos vazios e pipes não podem ser mapeados
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    const char *view = NULL;
+    if (GetFileType(fh) == FILE_TYPE_DISK && GetFileSizeEx(fh, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping != NULL)
+    {
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == NULL)
+            CloseHandle(mapping);
+    }
+
+    if (view == NULL)
+    {
+        int ok = source_read_fallback(file, fh, filename);
+        CloseHandle(fh);
+        return ok;
+    }
+    CloseHandle(fh); // O mapeamento continua válido após fechar o arquivo
+
+    file->data = view;
+    file->length = (size_t)size.QuadPart;
+    file->is_mapped = 1;
+    file->handle = mapping;
+    return 1;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Erro: Não foi possível abrir o arquivo '%s'\n", filename);
+        return 0;
+    }
+
+    // Arquivos vazios ou especiais (FIFOs, dispositivos) não podem ser
+    // mapeados: são lidos do mesmo descritor, sem abrir o caminho de novo
+    struct stat st;
+    void *view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (view == MAP_FAILED)
+    {
+        int ok = source_read_fallback(file, fd, filename);
+        close(fd);
+        return ok;
+    }
+    close(fd); // O mapeamento continua válido após fechar o descritor
+
+    file->data = view;
+    file->length = (size_t)st.st_size;
+    file->is_mapped = 1;
+    return 1;
+#endif
+}
+
+void source_close(SourceFile *file)
+{
+    if (file->data == NULL)
+        return;
+
+    if (file->is_mapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(file->data);
+        CloseHandle((HANDLE)file->handle);
+#else
+        munmap((void *)file->data, file->length);
+#endif
+    }
+    else
+    {
+        free((void *)file->data);
+    }
+
+    file->data = NULL;
+    file->length = 0;
+    file->handle = NULL;
+}
+
+size_t source_stream_read(void *context, char *buffer, size_t capacity)
+{
+    return fread(buffer, 1, capacity, (FILE *)context);
+}
@@ -0,0 +1,537 @@
+#include "../include/craze_vector.h"
+
+/* --- SELEÇÃO DE ARQUITETURA --- */
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define VECTOR_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX __attribute__((target("avx")))
+#endif
+#else
+#define VECTOR_X86 0
+#endif
+
+typedef struct
+{
+    double (*sum)(const double *x, int n);
+    double (*dot)(const double *x, const double *y, int n);
+    double (*min)(const double *x, int n);
+    double (*max)(const double *x, int n);
+    void (*scale)(double *x, double alpha, int n);
+    void (*axpy)(double alpha, const double *x, double *y, int n);
+    void (*add)(const double *x, const double *y, double *out, int n);
+    void (*mul)(const double *x, const double *y, double *out, int n);
+} VectorKernels;
+
+/* --- KERNELS ESCALARES --- */
+
+static double sum_scalar(const double *x, int n)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; i++)
+        total += x[i];
+    return total;
+}
+
+static double dot_scalar(const double *x, const double *y, int n)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; i++)
+        total += x[i] * y[i];
+    return total;
+}
+
+static double min_scalar(const double *x, int n)
+{
+    double result = x[0];
+    for (int i = 1; i < n; i++)
+    {
+        if (x[i] < result)
+            result = x[i];
+    }
+    return result;
+}
+
+static double max_scalar(const double *x, int n)
+{
+    double result = x[0];
+    for (int i = 1; i < n; i++)
+    {
+        if (x[i] > result)
+            result = x[i];
+    }
+    return result;
+}
+
+static void scale_scalar(double *x, double alpha, int n)
+{
+    for (int i = 0; i < n; i++)
+        x[i] *= alpha;
+}
+
+static void axpy_scalar(double alpha, const double *x, double *y, int n)
+{
+    for (int i = 0; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+static void add_scalar(const double *x, const double *y, double *out, int n)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = x[i] + y[i];
+}
+
+static void mul_scalar(const double *x, const double *y, double *out, int n)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = x[i] * y[i];
+}
+
+static const VectorKernels scalar_kernels = {
+    sum_scalar, dot_scalar, min_scalar, max_scalar,
+    scale_scalar, axpy_scalar, add_scalar, mul_scalar,
+};
+
+#if VECTOR_X86
+
+/* --- KERNELS SSE2 (2 doubles por registrador) --- */
+/* Reduções usam dois acumuladores para esconder a latência da soma */
+
+TARGET_SSE2 static double horizontal_sum_sse2(__m128d v)
+{
+    double lanes[2];
+    _mm_storeu_pd(lanes, v);
+    return lanes[0] + lanes[1];
+}
+
+TARGET_SSE2 static double sum_sse2(const double *x, int n)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(x + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(x + i + 2));
+    }
+    double total = horizontal_sum_sse2(_mm_add_pd(acc0, acc1));
+    for (; i < n; i++)
+        total += x[i];
+    return total;
+}
+
+TARGET_SSE2 static double dot_sse2(const double *x, const double *y, int n)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+    double total = horizontal_sum_sse2(_mm_add_pd(acc0, acc1));
+    for (; i < n; i++)
+        total += x[i] * y[i];
+    return total;
+}
+
+TARGET_SSE2 static double min_sse2(const double *x, int n)
+{
+    if (n < 2)
+        return x[0];
+
+    __m128d best = _mm_loadu_pd(x);
+    int i = 2;
+    for (; i + 2 <= n; i += 2)
+        best = _mm_min_pd(best, _mm_loadu_pd(x + i));
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, best);
+    double result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    for (; i < n; i++)
+    {
+        if (x[i] < result)
+            result = x[i];
+    }
+    return result;
+}
+
+TARGET_SSE2 static double max_sse2(const double *x, int n)
+{
+    if (n < 2)
+        return x[0];
+
+    __m128d best = _mm_loadu_pd(x);
+    int i = 2;
+    for (; i + 2 <= n; i += 2)
+        best = _mm_max_pd(best, _mm_loadu_pd(x + i));
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, best);
+    double result = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    for (; i < n; i++)
+    {
+        if (x[i] > result)
+            result = x[i];
+    }
+    return result;
+}
+
+TARGET_SSE2 static void scale_sse2(double *x, double alpha, int n)
+{
+    __m128d a = _mm_set1_pd(alpha);
+    int i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(x + i, _mm_mul_pd(a, _mm_loadu_pd(x + i)));
+    for (; i < n; i++)
+        x[i] *= alpha;
+}
+
+TARGET_SSE2 static void axpy_sse2(double alpha, const double *x, double *y, int n)
+{
+    __m128d a = _mm_set1_pd(alpha);
+    int i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+    for (; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+TARGET_SSE2 static void add_sse2(const double *x, const double *y, double *out, int n)
+{
+    int i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; i++)
+        out[i] = x[i] + y[i];
+}
+
+TARGET_SSE2 static void mul_sse2(const double *x, const double *y, double *out, int n)
+{
+    int i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; i++)
+        out[i] = x[i] * y[i];
+}
+
+static const VectorKernels sse2_kernels = {
+    sum_sse2, dot_sse2, min_sse2, max_sse2,
+    scale_sse2, axpy_sse2, add_sse2, mul_sse2,
+};
+
+/* --- KERNELS AVX (4 doubles por registrador) --- */
+
+TARGET_AVX static double horizontal_sum_avx(__m256d v)
+{
+    double lanes[4];
+    _mm256_storeu_pd(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+TARGET_AVX static double sum_avx(const double *x, int n)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(x + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(x + i + 4));
+    }
+    double total = horizontal_sum_avx(_mm256_add_pd(acc0, acc1));
+    for (; i < n; i++)
+        total += x[i];
+    return total;
+}
+
+TARGET_AVX static double dot_avx(const double *x, const double *y, int n)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    double total = horizontal_sum_avx(_mm256_add_pd(acc0, acc1));
+    for (; i < n; i++)
+        total += x[i] * y[i];
+    return total;
+}
+
+TARGET_AVX static double min_avx(const double *x, int n)
+{
+    if (n < 4)
+        return min_scalar(x, n);
+
+    __m256d best = _mm256_loadu_pd(x);
+    int i = 4;
+    for (; i + 4 <= n; i += 4)
+        best = _mm256_min_pd(best, _mm256_loadu_pd(x + i));
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, best);
+    double result = min_scalar(lanes, 4);
+    for (; i < n; i++)
+    {
+        if (x[i] < result)
+            result = x[i];
+    }
+    return result;
+}
+
+TARGET_AVX static double max_avx(const double *x, int n)
+{
+    if (n < 4)
+        return max_scalar(x, n);
+
+    __m256d best = _mm256_loadu_pd(x);
+    int i = 4;
+    for (; i + 4 <= n; i += 4)
+        best = _mm256_max_pd(best, _mm256_loadu_pd(x + i));
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, best);
+    double result = max_scalar(lanes, 4);
+    for (; i < n; i++)
+    {
+        if (x[i] > result)
+            result = x[i];
+    }
+    return result;
+}
+
+TARGET_AVX static void scale_avx(double *x, double alpha, int n)
+{
+    __m256d a = _mm256_set1_pd(alpha);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(x + i, _mm256_mul_pd(a, _mm256_loadu_pd(x + i)));
+    for (; i < n; i++)
+        x[i] *= alpha;
+}
+
+TARGET_AVX static void axpy_avx(double alpha, const double *x, double *y, int n)
+{
+    __m256d a = _mm256_set1_pd(alpha);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i),
+                                              _mm256_mul_pd(a, _mm256_loadu_pd(x + i))));
+    for (; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+TARGET_AVX static void add_avx(const double *x, const double *y, double *out, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < n; i++)
+        out[i] = x[i] + y[i];
+}
+
+TARGET_AVX static void mul_avx(const double *x, const double *y, double *out, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < n; i++)
+        out[i] = x[i] * y[i];
+}
+
+static const VectorKernels avx_kernels = {
+    sum_avx, dot_avx, min_avx, max_avx,
+    scale_avx, axpy_avx, add_avx, mul_avx,
+};
+
+#endif /* VECTOR_X86 */
+
+/* --- DETECÇÃO E DESPACHO --- */
+
+VectorIsa vector_detect_isa(void)
+{
+#if VECTOR_X86 && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    // AVX exige suporte da CPU e que o sistema salve os registradores YMM (OSXSAVE + XCR0)
+    if ((info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6)
+        return VECTOR_ISA_AVX;
+    if (info[3] & (1 << 26))
+        return VECTOR_ISA_SSE2;
+    return VECTOR_ISA_SCALAR;
+#elif VECTOR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx"))
+        return VECTOR_ISA_AVX;
+    if (__builtin_cpu_supports("sse2"))
+        return VECTOR_ISA_SSE2;
+    return VECTOR_ISA_SCALAR;
+#else
+    return VECTOR_ISA_SCALAR;
+#endif
+}
+
+/* Kernels ativos; escolhidos na primeira chamada (a escrita é idempotente) */
+static const VectorKernels *active_kernels = NULL;
+static VectorIsa active_isa = VECTOR_ISA_SCALAR;
+
+static const VectorKernels *kernels_for(VectorIsa isa)
+{
+#if VECTOR_X86
+    if (isa == VECTOR_ISA_AVX)
+        return &avx_kernels;
+    if (isa == VECTOR_ISA_SSE2)
+        return &sse2_kernels;
+#endif
+    (void)isa;
+    return &scalar_kernels;
+}
+
+VectorIsa vector_force_isa(VectorIsa isa)
+{
+    VectorIsa supported = vector_detect_isa();
+    if (isa > supported)
+        isa = supported;
+
+    active_isa = isa;
+    active_kernels = kernels_for(isa);
+    return isa;
+}
+
+static const VectorKernels *kernels(void)
+{
+    if (active_kernels == NULL)
+        vector_force_isa(vector_detect_isa());
+    return active_kernels;
+}
+
+VectorIsa vector_active_isa(void)
+{
+    kernels();
+    return active_isa;
+}
+
+const char *vector_isa_name(VectorIsa isa)
+{
+    switch (isa)
+    {
+    case VECTOR_ISA_AVX:
+        return "avx";
+    case VECTOR_ISA_SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+/* --- KERNELS DE DOUBLE (PÚBLICOS) --- */
+
+double vector_sum(const double *x, int n)
+{
+    return kernels()->sum(x, n);
+}
+
+double vector_dot(const double *x, const double *y, int n)
+{
+    return kernels()->dot(x, y, n);
+}
+
+double vector_min(const double *x, int n)
+{
+    return kernels()->min(x, n);
+}
+
+double vector_max(const double *x, int n)
+{
+    return kernels()->max(x, n);
+}
+
+void vector_scale(double *x, double alpha, int n)
+{
+    kernels()->scale(x, alpha, n);
+}
+
+void vector_axpy(double alpha, const double *x, double *y, int n)
+{
+    kernels()->axpy(alpha, x, y, n);
+}
+
+void vector_add(const double *x, const double *y, double *out, int n)
+{
+    kernels()->add(x, y, out, n);
+}
+
+void vector_mul(const double *x, const double *y, double *out, int n)
+{
+    kernels()->mul(x, y, out, n);
+}
+
+/* --- KERNELS DE INT --- */
+/* Aritmética em unsigned: o wrap-around é definido e o laço continua
+ * vetorizável pelo compilador */
+
+int vector_sum_int(const int *x, int n)
+{
+    unsigned total = 0;
+    for (int i = 0; i < n; i++)
+        total += (unsigned)x[i];
+    return (int)total;
+}
+
+int vector_dot_int(const int *x, const int *y, int n)
+{
+    unsigned total = 0;
+    for (int i = 0; i < n; i++)
+        total += (unsigned)x[i] * (unsigned)y[i];
+    return (int)total;
+}
+
+int vector_min_int(const int *x, int n)
+{
+    int result = x[0];
+    for (int i = 1; i < n; i++)
+        result = x[i] < result ? x[i] : result;
+    return result;
+}
+
+int vector_max_int(const int *x, int n)
+{
+    int result = x[0];
+    for (int i = 1; i < n; i++)
+        result = x[i] > result ? x[i] : result;
+    return result;
+}
+
+void vector_scale_int(int *x, int alpha, int n)
+{
+    for (int i = 0; i < n; i++)
+        x[i] = (int)((unsigned)x[i] * (unsigned)alpha);
+}
+
+void vector_axpy_int(int alpha, const int *x, int *y, int n)
+{
+    for (int i = 0; i < n; i++)
+        y[i] = (int)((unsigned)y[i] + (unsigned)alpha * (unsigned)x[i]);
+}
+
+void vector_add_int(const int *x, const int *y, int *out, int n)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = (int)((unsigned)x[i] + (unsigned)y[i]);
+}
+
+void vector_mul_int(const int *x, const int *y, int *out, int n)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = (int)((unsigned)x[i] * (unsigned)y[i]);
+}
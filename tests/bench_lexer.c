@@ -0,0 +1,124 @@
+#include "../include/craze_lexer.h"
+#include <time.h>
+
+/* Trecho representativo de código Craze, repetido para gerar uma entrada grande */
+static const char *bench_snippet =
+    "# Função de pontuação gerada\n"
+    "fn calcular_pontuacao(valor: int, peso: float, ativo: bool): float {\n"
+    "    let resultado: float = 0.0;\n"
+    "    if (ativo == true) {\n"
+    "        resultado = valor * peso + 12.5;\n"
+    "    } else {\n"
+    "        resultado = valor - 3;\n"
+    "    }\n"
+    "    while (resultado > 1000) {\n"
+    "        resultado = resultado / 2;\n"
+    "    }\n"
+    "    return resultado;\n"
+    "}\n"
+    "let nome_regra: string = \"regra_de_exemplo\";\n"
+    "let limite_maximo: int = 4096;\n";
+
+static char *build_source(int repetitions)
+{
+    size_t snippet_len = strlen(bench_snippet);
+    char *source = malloc(snippet_len * repetitions + 1);
+    if (source == NULL)
+        return NULL;
+
+    for (int i = 0; i < repetitions; i++)
+    {
+        memcpy(source + snippet_len * i, bench_snippet, snippet_len);
+    }
+    source[snippet_len * repetitions] = '\0';
+    return source;
+}
+
+/* Tokeniza a entrada inteira e retorna o número de tokens produzidos */
+static long tokenize_all(const char *source)
+{
+    Lexer lexer;
+    lexer_init(&lexer, source);
+
+    long count = 0;
+    Token token;
+    do
+    {
+        token = lexer_next_token(&lexer);
+        count++;
+        token_free(&token);
+    } while (token.type != TOKEN_EOF && token.type != TOKEN_ERROR);
+
+    lexer_cleanup(&lexer);
+    return count;
+}
+
+/* Pré-tokeniza a entrada inteira no buffer SoA e retorna o número de tokens */
+static long prelex_all(const char *source)
+{
+    Lexer lexer;
+    TokenBuffer tokens;
+    lexer_init(&lexer, source);
+    token_buffer_init(&tokens);
+
+    long count = token_buffer_fill(&tokens, &lexer) ? tokens.count : 0;
+
+    token_buffer_free(&tokens);
+    lexer_cleanup(&lexer);
+    return count;
+}
+
+typedef long (*BenchFn)(const char *source);
+
+/* Executa 'rounds' rodadas e imprime a melhor vazão */
+static void run_bench(const char *name, BenchFn fn, const char *source, int rounds)
+{
+    double best = -1.0;
+    long tokens = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        clock_t start = clock();
+        tokens = fn(source);
+        double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        if (best < 0.0 || elapsed < best)
+            best = elapsed;
+    }
+
+    printf("--- %s ---\n", name);
+    printf("Tokens por rodada: %ld\n", tokens);
+    printf("Melhor tempo: %.4f s\n", best);
+    if (best > 0.0)
+    {
+        printf("Vazão: %.2f milhões de tokens/s\n", tokens / best / 1e6);
+        printf("Vazão: %.2f MB/s\n", strlen(source) / best / 1e6);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int repetitions = argc > 1 ? atoi(argv[1]) : 20000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+    if (repetitions <= 0)
+        repetitions = 20000;
+    if (rounds <= 0)
+        rounds = 5;
+
+    char *source = build_source(repetitions);
+    if (source == NULL)
+    {
+        fprintf(stderr, "Erro: Memória insuficiente\n");
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("     BENCHMARK DO LEXER CRAZE v0.1     \n");
+    printf("========================================\n");
+    printf("Entrada: %zu bytes, %d rodadas\n", strlen(source), rounds);
+
+    run_bench("lexer_next_token (lexeme alocado por token)", tokenize_all, source, rounds);
+    run_bench("token_buffer_fill (arrays paralelos, sem cópias)", prelex_all, source, rounds);
+    printf("========================================\n");
+
+    free(source);
+    return 0;
+}
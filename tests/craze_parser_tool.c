@@ -1,52 +1,21 @@
 #include "../include/craze_parser.h"
+#include "../include/craze_source.h"
 
 void print_usage(const char *program_name)
 {
     printf("Uso: %s <arquivo.craze>\n", program_name);
     printf("   ou: %s -c \"codigo craze\"\n", program_name);
+    printf("   ou: %s -   (lê da entrada padrão)\n", program_name);
     printf("\nExemplos:\n");
     printf("  %s exemplo.craze\n", program_name);
     printf("  %s -c \"let x: int = 42;\"\n", program_name);
 }
 
-char *read_file(const char *filename)
+void parse_and_print(Lexer *lexer)
 {
-    FILE *file = fopen(filename, "rb");
-    if (file == NULL)
-    {
-        printf("Erro: Não foi possível abrir o arquivo '%s'\n", filename);
-        return NULL;
-    }
-
-    // Determinar tamanho do arquivo
-    fseek(file, 0, SEEK_END);
-    long length = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    // Alocar buffer
-    char *buffer = malloc(length + 1);
-    if (buffer == NULL)
-    {
-        printf("Erro: Não foi possível alocar memória\n");
-        fclose(file);
-        return NULL;
-    }
-
-    // Ler arquivo
-    fread(buffer, 1, length, file);
-    buffer[length] = '\0';
-
-    fclose(file);
-    return buffer;
-}
-
-void parse_and_print(const char *source)
-{
-    Lexer lexer;
     Parser parser;
 
-    lexer_init(&lexer, source);
-    parser_init(&parser, &lexer);
+    parser_init(&parser, lexer);
 
     printf("========================================\n");
     printf("       PARSING DO CÓDIGO CRAZE         \n");
@@ -71,7 +40,6 @@ void parse_and_print(const char *source)
     }
 
     parser_cleanup(&parser);
-    lexer_cleanup(&lexer);
 }
 
 int main(int argc, char *argv[])
@@ -84,29 +52,36 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    char *source = NULL;
+    Lexer lexer;
+    SourceFile source = {NULL, 0, 0, NULL};
 
     // Verificar se é código inline (-c flag)
     if (argc == 3 && strcmp(argv[1], "-c") == 0)
     {
-        source = malloc(strlen(argv[2]) + 1);
-        strcpy(source, argv[2]);
+        lexer_init(&lexer, argv[2]);
         printf("Analisando código inline...\n\n");
     }
-    // Caso contrário, ler arquivo
+    // Entrada padrão em modo streaming
+    else if (strcmp(argv[1], "-") == 0)
+    {
+        lexer_init_stream(&lexer, source_stream_read, stdin);
+        printf("Analisando entrada padrão...\n\n");
+    }
+    // Caso contrário, mapear arquivo
     else
     {
         const char *filename = argv[1];
         printf("Analisando arquivo: %s\n\n", filename);
-        source = read_file(filename);
-        if (source == NULL)
+        if (!source_open(&source, filename))
         {
             return 1;
         }
+        lexer_init_span(&lexer, source.data, source.length);
     }
 
-    parse_and_print(source);
+    parse_and_print(&lexer);
 
-    free(source);
+    lexer_cleanup(&lexer);
+    source_close(&source);
     return 0;
-}
\ No newline at end of file
+}
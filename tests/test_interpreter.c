@@ -1,4 +1,14 @@
 #include "../include/craze_interpreter.h"
+#include "../include/craze_cache.h"
+#include "../include/craze_module.h"
+#include "../include/craze_source.h"
+#include "../include/craze_vector.h"
+#include <math.h>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 /* --- Programas de Teste --- */
 
@@ -72,7 +82,13 @@ const char *test_program_expressions =
     "print(\"Menor ou igual:\", x <= y);\n"
     "\n"
     "let verdadeiro: bool = true;\n"
-    "print(\"Negação:\", !verdadeiro);";
+    "print(\"Negação:\", !verdadeiro);\n"
+    "print(\"E:\", x > y && verdadeiro, \"Ou:\", x < y || !verdadeiro);\n"
+    "print(\"Precedência:\", !verdadeiro || x > y && y > 0);\n"
+    "\n"
+    "# Curto-circuito: itens[5] estaria fora dos limites\n"
+    "let itens: int[] = [1, 2];\n"
+    "print(\"Guardas:\", len(itens) > 5 && itens[5] == 1, len(itens) < 5 || itens[5] == 1);";
 
 const char *test_program_scopes =
     "let global_var: int = 100;\n"
@@ -91,6 +107,218 @@ const char *test_program_scopes =
     "print(\"Global no main:\", global_var);\n"
     "teste_escopo();";
 
+const char *test_program_arrays =
+    "fn soma(valores: float[]): float {\n"
+    "    let total: float = 0.0;\n"
+    "    let i: int = 0;\n"
+    "    while (i < len(valores)) {\n"
+    "        total = total + valores[i];\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    return total;\n"
+    "}\n"
+    "\n"
+    "let notas: float[] = [7.5, 8, 9.25];\n"
+    "let nomes: string[] = [\"Ana\", \"Bia\"];\n"
+    "let flags: bool[] = [true, false];\n"
+    "notas[1] = notas[0] + 1;\n"
+    "nomes[1] = nomes[0] + \"!\";\n"
+    "print(notas, nomes, flags, type(notas));\n"
+    "print(\"Soma:\", soma(notas), \"Tamanho:\", len(nomes));";
+
+const char *test_program_maps =
+    "fn contar(palavras: string[]): map<string, int> {\n"
+    "    let freq: map<string, int> = {};\n"
+    "    let i: int = 0;\n"
+    "    while (i < len(palavras)) {\n"
+    "        if (has(freq, palavras[i])) {\n"
+    "            freq[palavras[i]] = freq[palavras[i]] + 1;\n"
+    "        } else {\n"
+    "            set(freq, palavras[i], 1);\n"
+    "        }\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    return freq;\n"
+    "}\n"
+    "\n"
+    "let freq: map<string, int> = contar([\"a\", \"b\", \"a\", \"c\", \"a\"]);\n"
+    "print(freq, len(freq), type(freq));\n"
+    "print(remove(freq, \"b\"), keys(freq), values(freq));\n"
+    "let quadrados: map<int, int> = {};\n"
+    "let k: int = 0;\n"
+    "while (k < 100) {\n"
+    "    quadrados[k] = k * k;\n"
+    "    if (k % 2 == 1) {\n"
+    "        remove(quadrados, k - 1);\n"
+    "    }\n"
+    "    k = k + 1;\n"
+    "}\n"
+    "print(\"Ímpares:\", len(quadrados), get(quadrados, 99), has(quadrados, 98));";
+
+const char *test_program_ranges =
+    "fn primos(n: int): int[] {\n"
+    "    let composto: map<int, bool> = {};\n"
+    "    let lista: map<int, int> = {};\n"
+    "    for p in 2..n {\n"
+    "        if (has(composto, p) == false) {\n"
+    "            lista[len(lista)] = p;\n"
+    "            for m in p * p..n step p { composto[m] = true; }\n"
+    "        }\n"
+    "    }\n"
+    "    return values(lista);\n"
+    "}\n"
+    "\n"
+    "print(primos(30));\n"
+    "let fim: int = 3;\n"
+    "let voltas: int = 0;\n"
+    "let ultimo: int = -1;\n"
+    "for i in 0..fim {\n"
+    "    fim = 100;\n"
+    "    voltas = voltas + 1;\n"
+    "    ultimo = i;\n"
+    "}\n"
+    "let soma: int = 0;\n"
+    "for i in 10..0 step -4 {\n"
+    "    let copia: int = i;\n"
+    "    soma = soma * 100 + copia;\n"
+    "}\n"
+    "for i in 5..5 { print(\"nunca\"); }\n"
+    "print(voltas, ultimo, soma);";
+
+const char *test_program_strings =
+    "fn campos(linha: string): map<string, string> {\n"
+    "    let m: map<string, string> = {};\n"
+    "    let resto: string = linha;\n"
+    "    while (len(resto) > 0) {\n"
+    "        let fim: int = find(resto, \";\");\n"
+    "        if (fim < 0) { fim = len(resto); }\n"
+    "        let campo: string = substr(resto, 0, fim);\n"
+    "        let igual: int = find(campo, \"=\");\n"
+    "        m[substr(campo, 0, igual)] = substr(campo, igual + 1, len(campo) - igual - 1);\n"
+    "        if (fim == len(resto)) { resto = \"\"; } else { resto = substr(resto, fim + 1, len(resto) - fim - 1); }\n"
+    "    }\n"
+    "    return m;\n"
+    "}\n"
+    "\n"
+    "let linha: string = \"nome=ana;idade=30;cidade=rio\";\n"
+    "print(campos(linha), has(campos(linha), substr(\"xcidadex\", 1, 6)));\n"
+    "print(split(linha, \";\"), split(\"a,,b,\", \",\"));\n"
+    "print(starts_with(linha, \"nome\"), starts_with(\"ab\", \"abc\"), find(\"aaab\", \"ab\"), find(\"ab\", \"abc\"));\n"
+    "print(substr(linha, 5, 3) == \"ana\", substr(linha, 5, 3) + \"!\", len(substr(linha, 9, 0)));";
+
+const char *test_program_bytes =
+    "fn cabecalho(versao: int, escala: float, nome: string): bytes {\n"
+    "    let b: bytes = make_bytes(14 + len(nome));\n"
+    "    write_u16(b, 0, versao);\n"
+    "    write_u32(b, 2, len(nome));\n"
+    "    write_f64(b, 6, escala);\n"
+    "    let corpo: bytes = slice(b, 14, len(nome));\n"
+    "    let origem: bytes = to_bytes(nome);\n"
+    "    for i in 0..len(nome) { write_u8(corpo, i, read_u8(origem, i)); }\n"
+    "    return b;\n"
+    "}\n"
+    "\n"
+    "let b: bytes = cabecalho(513, 0.5, \"ab\");\n"
+    "print(b, len(b), type(b));\n"
+    "print(read_u16(b, 0), read_u32(b, 2), read_f64(b, 6), read_string(b, 14, read_u32(b, 2)));\n"
+    "write_u32(b, 2, -2);\n"
+    "write_f32(slice(b, 6, 8), 4, 1);\n"
+    "print(read_i16(b, 2), read_u32(b, 2), read_f32(b, 10), slice(b, 14, 2) == to_bytes(\"ab\"));";
+
+const char *test_program_structs =
+    "struct Ponto { x: int, y: float }\n"
+    "struct Corpo { nome: string, pos: Ponto, vivo: bool, marcas: int[] }\n"
+    "\n"
+    "fn mover(p: Ponto, dx: int): void {\n"
+    "    p.x = p.x + dx;\n"
+    "    p.y = p.y * 2;\n"
+    "}\n"
+    "\n"
+    "let c: Corpo = Corpo(\"nave\", Ponto(1, 1.5), true, [7]);\n"
+    "mover(c.pos, 4);\n"
+    "c.marcas[0] = c.pos.x;\n"
+    "c.vivo = false;\n"
+    "print(c);\n"
+    "print(c.pos.x + c.pos.y, type(c.pos), len(c.marcas));";
+
+const char *test_program_vectors =
+    "let a: float[] = [1.5, -2, 3, 4, 5.5, 6, 7, 8, 9.5];\n"
+    "let b: float[] = [2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0];\n"
+    "let c: int[] = [3, -1, 4, 1, -5, 9];\n"
+    "print(\"sum:\", sum(a), sum(c), \"min:\", min(a), min(c), \"max:\", max(a), max(c));\n"
+    "print(\"dot:\", dot(a, b), dot(c, c));\n"
+    "scale(b, 0.5);\n"
+    "axpy(2, a, b);\n"
+    "scale(c, 2);\n"
+    "print(b, c);\n"
+    "print(add(a, b), mul(c, c), type(add(c, c)));";
+
+const char *test_program_match =
+    "fn dia(n: int): string {\n"
+    "    match (n) {\n"
+    "        0, 6 => { return \"fim de semana\"; }\n"
+    "        1, 2, 3, 4, 5 => { return \"útil\"; }\n"
+    "        -1 => { return \"ontem\"; }\n"
+    "        else => { return \"?\"; }\n"
+    "    }\n"
+    "    return \"inalcançável\";\n"
+    "}\n"
+    "\n"
+    "fn porta(p: int): string {\n"
+    "    let nome: string = \"desconhecida\";\n"
+    "    match (p) {\n"
+    "        22 => { nome = \"ssh\"; }\n"
+    "        443 => { nome = \"https\"; }\n"
+    "        8080 => { nome = \"proxy\"; }\n"
+    "    }\n"
+    "    return nome;\n"
+    "}\n"
+    "\n"
+    "let cores: int = 0;\n"
+    "for i in 0..6 {\n"
+    "    let texto: string = \"verd azul rosa\";\n"
+    "    match (substr(texto, (i % 3) * 5, 4)) {\n"
+    "        \"verd\" => { cores = cores + 1; }\n"
+    "        \"azul\", \"rosa\" => { cores = cores + 10; }\n"
+    "    }\n"
+    "}\n"
+    "print(dia(0), dia(3), dia(-1), dia(7));\n"
+    "print(porta(443), porta(22), porta(80));\n"
+    "print(\"cores:\", cores);";
+
+const char *test_program_folding =
+    "fn area(l: float, a: float): float { return l * a; }\n"
+    "fn fib(n: int): int {\n"
+    "    if (n < 2) { return n; }\n"
+    "    return fib(n - 1) + fib(n - 2);\n"
+    "}\n"
+    "fn rotulo(n: int): string {\n"
+    "    let s: string = \"\";\n"
+    "    for i in 0..n { s = s + \"ab\"; }\n"
+    "    match (n) {\n"
+    "        0 => { return \"vazio\"; }\n"
+    "        else => { return s + \"!\"; }\n"
+    "    }\n"
+    "}\n"
+    "fn dobro(n: int): int { return n * 2; }\n"
+    "\n"
+    "let total: int = 0;\n"
+    "for i in 0..3 { total = total + fib(10); }\n"
+    "print(area(10.0, 5.5), area(2, 3), fib(fib(5) + 10), rotulo(3), rotulo(0));\n"
+    "print(total, dobro(-21), dobro(total), 7 / fib(3));";
+
+const char *test_program_shadowing =
+    "fn max(a: int, b: int): int {\n"
+    "    if (a > b) { return a; }\n"
+    "    return b;\n"
+    "}\n"
+    "fn add(v: int[], n: int): int { return sum(v) + n; }\n"
+    "\n"
+    "let x: int = 3;\n"
+    "let v: int[] = [1, 2, 3];\n"
+    "print(max(x, 4), max(x, 1), add(v, x), min(v));\n"
+    "print(max(3, 4), max(3, 1), add([1, 2, 3], 3));";
+
 /* --- Funções de Teste --- */
 
 int execute_test_program(const char *name, const char *source)
@@ -258,6 +486,294 @@ void test_hashtable_system()
     printf("✅ Sistema de hash table OK\n\n");
 }
 
+/* Compila um programa, grava-o no cache .crzc e o executa a partir do cache */
+int test_program_cache(const char *source)
+{
+    printf("========================================\n");
+    printf("TESTE: Cache de Programa (.crzc)\n");
+    printf("========================================\n");
+
+    const char *filename = "test_cache_tmp.craze";
+    size_t length = strlen(source);
+
+    CacheKey key;
+    if (!cache_key_init(&key, filename, source, length))
+    {
+        printf("[AVISO] Cache desativado (CRAZE_NO_CACHE)\n\n");
+        return 1;
+    }
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+    AstArena arena;
+    ast_arena_init(&arena);
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+    parser.arena = &arena;
+
+    int saved = 0;
+    int warning_total = 0;
+    char warning_text[512] = "";
+    ASTNode *program = parse_program(&parser);
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        if (semantic_analyze(&analyzer) && analyzer.error_count == 0)
+        {
+            // Como no CLI: o cache guarda as chamadas puras já avaliadas e os avisos
+            printf("Chamadas avaliadas na compilação: %d\n", semantic_fold_constants(&analyzer, &arena));
+            CacheWarning *warnings;
+            if (cache_collect_warnings(&analyzer, &warnings, &warning_total))
+            {
+                saved = cache_save(&key, program, warnings, warning_total);
+                if (warning_total > 0)
+                    snprintf(warning_text, sizeof(warning_text), "%d:%d %s", warnings[0].line,
+                             warnings[0].column, warnings[0].message);
+                free(warnings);
+            }
+        }
+        semantic_cleanup(&analyzer);
+    }
+    ast_arena_free(&arena);
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("Gravado em %s: %s\n", key.path, saved ? "sim" : "não");
+
+    // Carregar sem passar por lexer, parser ou análise semântica
+    int result = 0;
+    CacheWarning *cached_warnings;
+    int cached_warning_count;
+    ASTNode *cached = cache_load(&key, &arena, &cached_warnings, &cached_warning_count);
+    printf("Carregado do cache: %s\n", cached ? "sim" : "não");
+
+    // Os avisos da análise voltam com o programa, sem reanalisar
+    char cached_text[512] = "";
+    if (cached && cached_warning_count > 0)
+        snprintf(cached_text, sizeof(cached_text), "%d:%d %s", cached_warnings[0].line,
+                 cached_warnings[0].column, cached_warnings[0].message);
+    int same_warnings = cached_warning_count == warning_total && strcmp(cached_text, warning_text) == 0;
+    printf("Avisos preservados: %d de %d\n", cached_warning_count, warning_total);
+    if (cached)
+    {
+        printf("Saída:\n");
+        Interpreter interpreter;
+        interpreter_init(&interpreter, cached);
+        result = interpreter_execute(&interpreter);
+        interpreter_cleanup(&interpreter);
+    }
+    ast_arena_free(&arena);
+
+    // Fonte alterado: o cache antigo não pode ser usado
+    CacheKey changed;
+    cache_key_init(&changed, filename, "let x: int = 1;", 15);
+    ASTNode *stale = cache_load(&changed, &arena, NULL, NULL);
+    printf("Cache rejeitado para fonte alterado: %s\n", stale ? "não" : "sim");
+    ast_arena_free(&arena);
+    cache_key_free(&changed);
+
+    remove(key.path);
+    cache_key_free(&key);
+    printf("\n");
+    return saved && result && same_warnings && stale == NULL;
+}
+
+/* Dois programas importam o mesmo módulo: ele é compilado e inicializado uma
+ * única vez e os dois usam as funções, structs e globais dele */
+int test_program_modules(void)
+{
+    printf("========================================\n");
+    printf("TESTE: Módulos Importados\n");
+    printf("========================================\n");
+
+    const char *filename = "test_module_tmp.craze";
+    const char *module_source =
+        "struct Par { a: int, b: int }\n"
+        "let base: int = 40;\n"
+        "let nomes: string[] = [\"um\", \"dois\"];\n"
+        "fn somar(p: Par): int {\n"
+        "    return p.a + p.b + base;\n"
+        "}\n"
+        "fn get(p: Par): int { return p.b; }\n"
+        "let tabela: int[] = [10, 20, 30];\n"
+        "let contador: int = 0;\n"
+        "fn incrementa(): int {\n"
+        "    contador = contador + 1;\n"
+        "    return contador;\n"
+        "}\n";
+
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("❌ Não foi possível criar %s\n\n", filename);
+        return 0;
+    }
+    fputs(module_source, file);
+    fclose(file);
+
+    // O primeiro altera os globais importados por alias, por built-in e pela
+    // função do módulo; o segundo ainda deve ver os valores originais
+    int result = execute_test_program("Módulos (primeiro programa)",
+                                      "import \"test_module_tmp.craze\";\n"
+                                      "fn zera(v: int[]): void { v[0] = 0; }\n"
+                                      "zera(tabela);\n"
+                                      "scale(tabela, 3);\n"
+                                      "print(somar(Par(1, 1)), nomes[1], tabela, incrementa(), incrementa());");
+    result = execute_test_program("Módulos (segundo programa)",
+                                  "import \"test_module_tmp.craze\";\n"
+                                  "import \"test_module_tmp.craze\";\n"
+                                  "let p: Par = Par(base, 2);\n"
+                                  "print(somar(p), len(nomes), get(p), tabela, contador);\n"
+                                  "if (tabela[0] != 10 || tabela[2] != 30 || contador != 0) {\n"
+                                  "    let vazio: int[] = [];\n"
+                                  "    print(vazio[0]); # Globais alterados: falha o teste\n"
+                                  "}") &&
+             result;
+
+    // Os dois imports resolveram para o mesmo módulo, já instanciado
+    char error[256];
+    CrazeModule *first = module_load(filename, NULL, error, sizeof(error));
+    CrazeModule *second = module_load(filename, NULL, error, sizeof(error));
+    int shared = first != NULL && first == second && first->instance != NULL;
+    printf("Módulo compartilhado: %s\n", shared ? "sim" : "não");
+
+    module_cache_clear();
+    CacheKey key;
+    if (cache_key_init(&key, filename, module_source, strlen(module_source)))
+        remove(key.path);
+    cache_key_free(&key);
+    remove(filename);
+    printf("\n");
+    return result && shared;
+}
+
+/* Compara os kernels SSE2/AVX com os escalares em tamanhos que exercitam
+ * o laço vetorial e o resto */
+int test_vector_kernels(void)
+{
+    printf("========================================\n");
+    printf("TESTE: Kernels Vetoriais\n");
+    printf("========================================\n");
+
+    VectorIsa detected = vector_detect_isa();
+    printf("ISA detectada: %s\n", vector_isa_name(detected));
+
+    enum { MAX_N = 37 };
+    double x[MAX_N], y[MAX_N];
+    for (int i = 0; i < MAX_N; i++)
+    {
+        x[i] = (double)((i * 7) % 11) - 5.25;
+        y[i] = (double)((i * 3) % 5) + 0.5;
+    }
+
+    int failures = 0;
+    for (int isa = VECTOR_ISA_SSE2; isa <= (int)detected; isa++)
+    {
+        for (int n = 1; n <= MAX_N; n++)
+        {
+            double expected[5], actual[5];
+            double out_scalar[MAX_N], out_simd[MAX_N], axpy_scalar[MAX_N], axpy_simd[MAX_N];
+
+            vector_force_isa(VECTOR_ISA_SCALAR);
+            expected[0] = vector_sum(x, n);
+            expected[1] = vector_dot(x, y, n);
+            expected[2] = vector_min(x, n);
+            expected[3] = vector_max(x, n);
+            vector_mul(x, y, out_scalar, n);
+            memcpy(axpy_scalar, y, sizeof(double) * n);
+            vector_axpy(1.5, x, axpy_scalar, n);
+
+            vector_force_isa((VectorIsa)isa);
+            actual[0] = vector_sum(x, n);
+            actual[1] = vector_dot(x, y, n);
+            actual[2] = vector_min(x, n);
+            actual[3] = vector_max(x, n);
+            vector_mul(x, y, out_simd, n);
+            memcpy(axpy_simd, y, sizeof(double) * n);
+            vector_axpy(1.5, x, axpy_simd, n);
+
+            // Dados com poucas casas: a ordem das somas não altera o resultado
+            expected[4] = actual[4] = 0.0;
+            if (memcmp(expected, actual, sizeof(expected)) != 0 ||
+                memcmp(out_scalar, out_simd, sizeof(double) * n) != 0 ||
+                memcmp(axpy_scalar, axpy_simd, sizeof(double) * n) != 0)
+            {
+                printf("❌ %s difere do escalar com n=%d\n", vector_isa_name((VectorIsa)isa), n);
+                failures++;
+            }
+        }
+        printf("%s comparado com escalar\n", vector_isa_name((VectorIsa)isa));
+    }
+    vector_force_isa(detected);
+
+    int ints[] = {3, -1, 4, 1, -5, 9, 2};
+    if (vector_sum_int(ints, 7) != 13 || vector_min_int(ints, 7) != -5 ||
+        vector_max_int(ints, 7) != 9 || vector_dot_int(ints, ints, 7) != 137)
+    {
+        printf("❌ Kernels de int incorretos\n");
+        failures++;
+    }
+
+    if (failures == 0)
+        printf("✅ Kernels vetoriais OK\n");
+    printf("\n");
+    return failures == 0;
+}
+
+/* Fontes sem tamanho conhecido (pipes, <(...)) não podem ser mapeadas:
+ * source_open deve lê-las até o fim, maiores que o bloco inicial */
+int test_source_pipe(void)
+{
+    printf("========================================\n");
+    printf("TESTE: Fonte Lida de Pipe\n");
+    printf("========================================\n");
+
+#ifdef _WIN32
+    printf("Ignorado no Windows\n\n");
+    return 1;
+#else
+    const char *line = "print(\"linha\");\n";
+    size_t line_length = strlen(line);
+    int repeats = 20000; // ~300 KiB: maior que o buffer de um pipe
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        printf("❌ Não foi possível criar o pipe\n\n");
+        return 0;
+    }
+
+    pid_t writer = fork();
+    if (writer == 0)
+    {
+        close(fds[0]);
+        for (int i = 0; i < repeats; i++)
+            if (write(fds[1], line, line_length) != (ssize_t)line_length)
+                _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/dev/fd/%d", fds[0]);
+    SourceFile file;
+    int opened = source_open(&file, path);
+    close(fds[0]);
+    waitpid(writer, NULL, 0);
+
+    int ok = opened && !file.is_mapped && file.length == line_length * (size_t)repeats;
+    for (int i = 0; ok && i < repeats; i++)
+        ok = memcmp(file.data + (size_t)i * line_length, line, line_length) == 0;
+    if (opened)
+    {
+        printf("Bytes lidos: %zu\n", file.length);
+        source_close(&file);
+    }
+
+    printf(ok ? "✅ Conteúdo do pipe lido por completo\n\n" : "❌ Conteúdo do pipe incorreto\n\n");
+    return ok;
+#endif
+}
+
 int main()
 {
     printf("========================================\n");
@@ -293,6 +809,60 @@ int main()
     total_tests++;
     if (execute_test_program("Escopos de Variáveis", test_program_scopes))
         passed_tests++;
+    total_tests++;
+    if (execute_test_program("Arrays Tipados", test_program_arrays))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Built-ins Vetoriais", test_program_vectors))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Maps", test_program_maps))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("For com Intervalo", test_program_ranges))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Strings e Fatias", test_program_strings))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Bytes", test_program_bytes))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Structs", test_program_structs))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Match", test_program_match))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Funções com Nome de Built-in", test_program_shadowing))
+        passed_tests++;
+    total_tests++;
+    if (test_program_modules())
+        passed_tests++;
+    total_tests++;
+    if (test_vector_kernels())
+        passed_tests++;
+    total_tests++;
+    if (test_source_pipe())
+        passed_tests++;
+    total_tests++;
+    if (test_program_cache(test_program_1))
+        passed_tests++;
+    total_tests++;
+    if (test_program_cache(test_program_2))
+        passed_tests++;
+    total_tests++;
+    if (test_program_cache(test_program_match))
+        passed_tests++;
+    total_tests++;
+    if (execute_test_program("Chamadas Puras", test_program_folding))
+        passed_tests++;
+    total_tests++;
+    if (test_program_cache(test_program_folding))
+        passed_tests++;
+    total_tests++;
+    if (test_program_cache(test_program_shadowing))
+        passed_tests++;
 
     printf("========================================\n");
     printf("       RESUMO DOS TESTES\n");
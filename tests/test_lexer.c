@@ -71,7 +71,7 @@ void test_operators()
 {
     printf("=== TESTE: Operadores ===\n");
 
-    const char *source = "+ - * / = == != > < >= <=";
+    const char *source = "+ - * / = == != > < >= <= ! && || =>";
     Lexer lexer;
     lexer_init(&lexer, source);
 
@@ -91,7 +91,7 @@ void test_keywords()
 {
     printf("=== TESTE: Palavras-chave ===\n");
 
-    const char *source = "let fn return if else while true false void int float string bool";
+    const char *source = "let fn return if else while true false void int float string bool map bytes for in step struct import match";
     Lexer lexer;
     lexer_init(&lexer, source);
 
@@ -131,7 +131,7 @@ void test_delimiters()
 {
     printf("=== TESTE: Delimitadores ===\n");
 
-    const char *source = "( ) { } : , ;";
+    const char *source = "( ) { } : , ; . ..";
     Lexer lexer;
     lexer_init(&lexer, source);
 
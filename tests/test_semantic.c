@@ -1,4 +1,9 @@
 #include "../include/craze_semantic.h"
+#include "../include/craze_compact.h"
+#include "../include/craze_incremental.h"
+#include "../include/craze_module.h"
+#include <limits.h>
+#include <time.h>
 
 void test_basic_variable_declaration()
 {
@@ -183,6 +188,485 @@ void test_scope_resolution()
     printf("\n");
 }
 
+void test_shadowing()
+{
+    printf("=== TESTE: Sombreamento entre Escopos ===\n");
+
+    // Cada 'x' interno esconde o externo só até o fim do seu bloco
+    const char *source =
+        "let x: int = 10;\n"
+        "fn teste(x: string): void {\n"
+        "    if (true) {\n"
+        "        let x: bool = true;\n"
+        "        let a: bool = x;\n"   // OK: x é bool aqui
+        "    }\n"
+        "    let b: string = x;\n"     // OK: volta a ser o parâmetro string
+        "    let b: string = x;\n"     // ERRO: b já declarada neste escopo
+        "}\n"
+        "let c: int = x;";             // OK: x global é int
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        printf("%s Erros: %d (esperado 1)\n", analyzer.error_count == 1 ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_interned_types()
+{
+    printf("=== TESTE: Tipos Internados ===\n");
+
+    // Primitivos são singletons; compostos iguais compartilham o mesmo ponteiro
+    const TypeInfo *int_type = typeinfo_create(TYPE_INT);
+    const TypeInfo *int_array = typeinfo_intern(TYPE_INT, 1, 0, NULL);
+    const TypeInfo *nested = typeinfo_intern(TYPE_INT, 1, 0, int_array);
+
+    int ok = int_type == typeinfo_create(TYPE_INT) &&
+             int_type == typeinfo_intern(TYPE_INT, 0, 0, NULL) &&
+             int_type != typeinfo_create(TYPE_FLOAT) &&
+             int_array != int_type && int_array->is_array &&
+             int_array == typeinfo_intern(TYPE_INT, 1, 0, NULL) &&
+             nested == typeinfo_intern(TYPE_INT, 1, 0, int_array) &&
+             nested != int_array && nested->inner == int_array;
+
+    printf("%s Tipos iguais têm o mesmo ponteiro\n", ok ? "✅" : "❌");
+    printf("\n");
+}
+
+void test_array_types()
+{
+    printf("=== TESTE: Arrays Tipados ===\n");
+
+    const char *source =
+        "let a: int[] = [1, 2, 3];\n"
+        "let f: float[] = [1, 2.5];\n"
+        "let e: string[] = [];\n"
+        "a[0] = a[1] + len(a);\n"
+        "f[1] = a[2];\n"
+        "let x: int[] = [1, \"dois\"];\n" // ERRO: elementos incompatíveis
+        "let y: int[] = f;\n"               // ERRO: float[] não é int[]
+        "let z: int = a[true];\n"           // ERRO: índice não int
+        "a[1] = 2.5;";                       // ERRO: float em int[]
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        int ok = analyzer.error_count == 4 &&
+                 analyzer.diagnostics[0].line == 6 && analyzer.diagnostics[3].line == 9 &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 1),
+                        "Tipo incompatível na inicialização: declarado int[], inicializador float[]") == 0 &&
+                 typeinfo_array(TYPE_INT) == typeinfo_array(TYPE_INT) &&
+                 typeinfo_array(TYPE_INT)->inner == typeinfo_create(TYPE_INT);
+
+        printf("%s Erros de tipo em arrays: %d (esperado 4)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_vector_builtins()
+{
+    printf("=== TESTE: Built-ins Vetoriais ===\n");
+
+    const char *source =
+        "let v: float[] = [1.5, 2.0];\n"
+        "let n: int[] = [1, 2];\n"
+        "let s: float = sum(v) + dot(v, v) + max(v);\n"
+        "let t: int = min(n) + sum([]);\n"
+        "let w: float[] = add(v, mul(v, v));\n"
+        "scale(v, 2);\n"
+        "axpy(3, n, n);\n"
+        "let u: int = sum(v);\n"   // ERRO: sum(float[]) é float
+        "dot(v, n);\n"             // ERRO: float[] e int[]
+        "scale(n, 0.5);\n"         // ERRO: escalar float em int[]
+        "sum(\"abc\");";           // ERRO: não é array numérico
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        int ok = analyzer.error_count == 4 &&
+                 analyzer.diagnostics[0].line == 8 && analyzer.diagnostics[3].line == 11 &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 1),
+                        "Função 'dot' espera arrays do mesmo tipo, encontrado float[] e int[]") == 0;
+
+        printf("%s Erros em built-ins vetoriais: %d (esperado 4)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_map_types()
+{
+    printf("=== TESTE: Maps ===\n");
+
+    const char *source =
+        "let idades: map<string, int> = {\"ana\": 30, \"bia\": 25};\n"
+        "let notas: map<int, float> = {1: 7.5, 2: 8};\n"
+        "let vazio: map<bool, string> = {};\n"
+        "idades[\"caio\"] = get(idades, \"ana\") + len(idades);\n"
+        "set(notas, 3, 10);\n"
+        "let nomes: string[] = keys(idades);\n"
+        "let existe: bool = has(vazio, true) == remove(notas, 1);\n"
+        "let x: map<string, int> = {\"a\": 1, 2: 3};\n" // ERRO: chaves incompatíveis
+        "let y: int = idades[1];\n"                      // ERRO: chave int em map<string, int>
+        "set(idades, \"d\", 1.5);\n"                     // ERRO: float em map<string, int>
+        "let z: map<string, float> = idades;";          // ERRO: valores int não são float
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        int ok = analyzer.error_count == 4 &&
+                 analyzer.diagnostics[0].line == 8 && analyzer.diagnostics[3].line == 11 &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 3),
+                        "Tipo incompatível na inicialização: declarado map<string, float>, "
+                        "inicializador map<string, int>") == 0 &&
+                 typeinfo_map(TYPE_STRING, TYPE_INT) == typeinfo_map(TYPE_STRING, TYPE_INT) &&
+                 typeinfo_map(TYPE_STRING, TYPE_INT) != typeinfo_map(TYPE_INT, TYPE_INT);
+
+        printf("%s Erros de tipo em maps: %d (esperado 4)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_for_loops()
+{
+    printf("=== TESTE: For com Intervalo ===\n");
+
+    const char *source =
+        "let total: int = 0;\n"
+        "for i in 0..10 step 2 { total = total + i; }\n"
+        "for i in 0..len(\"abc\") { for j in i..3 { total = total + j; } }\n"
+        "for i in 0..2.5 { }\n"          // ERRO: fim float
+        "for i in 0..10 step 0 { }\n"    // ERRO: passo zero
+        "for i in 0..3 { i = 1; }\n"     // ERRO: contador somente leitura
+        "let fora: int = i;";             // ERRO: i só existe dentro do for
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        int ok = analyzer.error_count == 4 &&
+                 analyzer.diagnostics[0].line == 4 && analyzer.diagnostics[3].line == 7 &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 2),
+                        "Variável de controle do 'for' 'i' não pode ser atribuída") == 0;
+
+        printf("%s Erros em for: %d (esperado 4)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_string_builtins()
+{
+    printf("=== TESTE: Built-ins de String ===\n");
+
+    const char *source =
+        "let texto: string = \"a=1;b=2\";\n"
+        "let parte: string = substr(texto, 0, find(texto, \";\"));\n"
+        "let campos: string[] = split(texto, \";\");\n"
+        "let comeca: bool = starts_with(parte, \"a=\");\n"
+        "let x: string = substr(texto, 1.5, 2);\n" // ERRO: início float
+        "let y: int = find(texto, 1);\n"           // ERRO: agulha int
+        "let z: string[] = split(texto);\n"        // ERRO: aridade
+        "let w: string = find(texto, \"a\");";    // ERRO: find retorna int
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        int ok = analyzer.error_count == 4 &&
+                 analyzer.diagnostics[0].line == 5 && analyzer.diagnostics[3].line == 8 &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 1),
+                        "Função 'find' espera string no argumento 2, encontrado int") == 0;
+
+        printf("%s Erros em built-ins de string: %d (esperado 4)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_bytes_type()
+{
+    printf("=== TESTE: Tipo bytes ===\n");
+
+    const char *source =
+        "let b: bytes = make_bytes(8);\n"
+        "write_u32(b, 0, len(b));\n"
+        "write_f64(slice(b, 0, 8), 0, 1);\n"
+        "let x: float = read_f32(b, 4) + read_u16(b, 0);\n"
+        "let y: int = read_f64(b, 0);\n"         // ERRO: read_f64 retorna float
+        "write_u8(b, 0, 1.5);\n"                 // ERRO: valor float em write_u8
+        "let s: string = to_bytes(\"abc\");\n" // ERRO: bytes não é string
+        "let z: bytes = read_string(b, 0, 2);";  // ERRO: read_string retorna string
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        int ok = analyzer.error_count == 4 &&
+                 analyzer.diagnostics[0].line == 5 && analyzer.diagnostics[3].line == 8 &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 1),
+                        "Função 'write_u8' espera int no argumento 3, encontrado float") == 0;
+
+        printf("%s Erros com bytes: %d (esperado 4)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_struct_types()
+{
+    printf("=== TESTE: Structs ===\n");
+
+    const char *source =
+        "struct Ponto { x: int, y: float }\n"
+        "let p: Ponto = Ponto(1, 2);\n"
+        "p.y = p.x + p.y;\n"
+        "let a: int = p.y;\n"             // ERRO: campo float em int
+        "let q: Ponto = Ponto(1);\n"      // ERRO: aridade do construtor
+        "let z: int = p.z;\n"             // ERRO: campo inexistente
+        "let w: Linha = p;\n"             // ERRO: tipo não declarado
+        "p.x = \"a\";";                   // ERRO: string em campo int
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        ASTNode *decl = program->data.block.statements[0];
+        int ok = analyzer.error_count == 5 &&
+                 analyzer.diagnostics[1].line == 4 &&
+                 decl->data.struct_decl.size == 16 &&
+                 decl->data.struct_decl.fields[1]->data.param.offset == 8 &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 3),
+                        "Struct 'Ponto' não tem campo 'z'") == 0;
+
+        printf("%s Erros com structs: %d (esperado 5)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_imports()
+{
+    printf("=== TESTE: Imports ===\n");
+
+    const char *filename = "test_import_tmp.craze";
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("❌ Não foi possível criar %s\n\n", filename);
+        return;
+    }
+    fputs("let limite: int = 3;\n"
+          "let itens: int[] = [1, 2];\n"
+          "fn dobro(x: int): int { return x * 2; }\n",
+          file);
+    fclose(file);
+
+    const char *source =
+        "import \"test_import_tmp.craze\";\n"
+        "import \"nao_existe_tmp.craze\";\n"  // ERRO: arquivo não encontrado
+        "limite = 4;\n"                        // ERRO: global importado
+        "itens[0] = 5;\n"                      // ERRO: global importado
+        "let dobro: int = 1;\n"                // ERRO: conflita com a função importada
+        "let x: int = dobro(limite) + itens[1];";
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        ASTNode *import = program->data.block.statements[0];
+        int ok = analyzer.error_count == 4 &&
+                 import->data.import_stmt.module != NULL &&
+                 import->data.import_stmt.module_hash == import->data.import_stmt.module->tree_hash &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 1),
+                        "Variável importada 'limite' é somente leitura") == 0;
+
+        printf("%s Erros com imports: %d (esperado 4)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    module_cache_clear();
+    remove("test_import_tmp.craze.crzc");
+    remove(filename);
+    printf("\n");
+}
+
+void test_diagnostics()
+{
+    printf("=== TESTE: Buffer de Diagnósticos ===\n");
+
+    const char *source =
+        "let a: int = z;\n"           // ERRO: z não declarada
+        "let f: float = 1 + 2.5;\n"   // AVISO: conversão implícita
+        "let s: string = 1 % 2.0;";   // ERRO: '%' com float
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        const char *first = semantic_diagnostic_message(&analyzer, 0);
+        const char *last = semantic_diagnostic_message(&analyzer, 2);
+        int ok = analyzer.diagnostic_count == 3 &&
+                 analyzer.diagnostics[0].is_error && analyzer.diagnostics[0].line == 1 &&
+                 !analyzer.diagnostics[1].is_error && analyzer.diagnostics[1].line == 2 &&
+                 strcmp(first, "Variável 'z' não declarada") == 0 &&
+                 strcmp(last, "Operador '%' requer operandos int, recebeu int e float") == 0 &&
+                 semantic_diagnostic_message(&analyzer, 3) == NULL;
+
+        printf("%s Diagnósticos guardados em ordem: %d (esperado 3)\n", ok ? "✅" : "❌",
+               analyzer.diagnostic_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
 void test_error_cases()
 {
     printf("=== TESTE: Casos de Erro ===\n");
@@ -334,6 +818,176 @@ void test_expression_types()
     printf("\n");
 }
 
+void test_logical_operators()
+{
+    printf("=== TESTE: Operadores Lógicos ===\n");
+
+    const char *source =
+        "let a: int = 1;\n"
+        "let ok: bool = a > 0 && !(a == 2) || false;\n"
+        "let x: bool = a && true;\n"    // ERRO: int em '&&'
+        "let y: bool = !a;\n"           // ERRO: '!' em int
+        "let z: int = true || false;";  // ERRO: bool em int
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        // '&&' liga mais forte que '||'
+        ASTNode *condition = program->data.block.statements[1]->data.var_decl.initializer;
+        int ok = analyzer.error_count == 3 &&
+                 condition->data.binary_expr.operator == TOKEN_PIPE_PIPE &&
+                 condition->data.binary_expr.left->data.binary_expr.operator == TOKEN_AND_AND &&
+                 strcmp(semantic_diagnostic_message(&analyzer, 0),
+                        "Operador '&&' requer operandos bool, recebeu int e bool") == 0;
+
+        printf("%s Erros com operadores lógicos: %d (esperado 3)\n", ok ? "✅" : "❌", analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_match_statement()
+{
+    printf("=== TESTE: Match ===\n");
+
+    const char *source =
+        "let n: int = 3;\n"
+        "let s: string = \"b\";\n"
+        "match (n) { 1, 2 => { n = 0; } 3 => { n = 1; } -1 => { n = 2; } else => { n = 3; } }\n"
+        "match (n) { 1 => { n = 0; } 1000 => { n = 1; } 50000 => { n = 2; } }\n"
+        "match (s) { \"a\" => { n = 0; } \"b\", \"c\" => { n = 1; } }\n"
+        "match (1.5) { 1 => { n = 0; } }\n"         // ERRO: float no match
+        "match (n) { 1 => { n = 0; } \"x\" => { n = 1; } }"; // ERRO: rótulo string em int
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+
+        // Rótulos densos viram tabela de saltos; esparsos, busca binária
+        const MatchTable *dense = program->data.block.statements[2]->data.match_stmt.table;
+        const MatchTable *sparse = program->data.block.statements[3]->data.match_stmt.table;
+        const MatchTable *strings = program->data.block.statements[4]->data.match_stmt.table;
+        int tables = dense->kind == MATCH_JUMP_TABLE && sparse->kind == MATCH_BINARY_SEARCH &&
+                     strings->kind == MATCH_STRING_HASH &&
+                     match_table_find_int(dense, 2) == 0 && match_table_find_int(dense, -1) == 2 &&
+                     match_table_find_int(dense, 0) == -1 && match_table_find_int(sparse, 50000) == 2 &&
+                     match_table_find_int(sparse, 999) == -1 &&
+                     match_table_find_string(strings, "c", 1) == 1 &&
+                     match_table_find_string(strings, "cc", 2) == -1;
+
+        printf("%s Tabelas de despacho do match\n", tables ? "✅" : "❌");
+        printf("%s Erros no match: %d (esperado 2)\n", analyzer.error_count == 2 ? "✅" : "❌",
+               analyzer.error_count);
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+
+    // Rótulo repetido é erro de parsing (a tabela não pode ser montada)
+    lexer_init(&lexer, "let n: int = 1;\nmatch (n) { 1 => { n = 2; } 2, 1 => { n = 3; } }");
+    parser_init(&parser, &lexer);
+    program = parse_program(&parser);
+    printf("%s Rótulo repetido no match rejeitado\n", parser.had_error ? "✅" : "❌");
+    if (program)
+        ast_free(program);
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
+void test_constant_folding()
+{
+    printf("=== TESTE: Avaliação de Chamadas Puras ===\n");
+
+    const char *source =
+        "fn area(l: float, a: float): float { return l * a; }\n"
+        "fn fib(n: int): int { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }\n"
+        "fn nome(n: int): string { match (n) { 1 => { return \"um\"; } else => { return \"outro\"; } } }\n"
+        "fn dobro(n: int): int { return n * 2; }\n"
+        "fn conta(n: int): int { print(n); return n; }\n"     // Impura: print
+        "let base: int = 3;\n"
+        "fn usa_global(): int { return base; }\n"              // Lê um global
+        "fn laco(): int { while (true) { base = 1; } return 0; }\n"
+        "let a: float = area(10.0, 5.5);\n"
+        "let f: int = fib(fib(5) + 5);\n"
+        "let s: string = nome(1) + nome(-2);\n"
+        "let c: int = conta(2);\n"
+        "let g: int = usa_global();\n"
+        "let d: int = fib(base);\n"                            // Argumento não constante
+        "let e: int = laco();\n"
+        "let o: int = dobro(2000000000);\n"                  // Estouraria int
+        "fn max(a: int, b: int): int { if (a > b) { return a; } return b; }\n"
+        "let m: int = max(3, 4);";                            // Esconde o built-in max
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+        int folded = semantic_fold_constants(&analyzer, NULL);
+
+        ASTNode **stmts = program->data.block.statements;
+        ASTNode *a = stmts[8]->data.var_decl.initializer;
+        ASTNode *f = stmts[9]->data.var_decl.initializer;
+        ASTNode *s = stmts[10]->data.var_decl.initializer;
+        int literals = a->node_type == NODE_LITERAL && a->data.literal.value.float_value == 55.0 &&
+                       f->node_type == NODE_LITERAL && f->data.literal.value.int_value == 55 &&
+                       s->data.binary_expr.left->node_type == NODE_LITERAL &&
+                       strcmp(s->data.binary_expr.right->data.literal.value.string_value, "outro") == 0;
+        ASTNode *m = stmts[17]->data.var_decl.initializer;
+        literals = literals && m->node_type == NODE_LITERAL && m->data.literal.value.int_value == 4;
+
+        int kept = 1;
+        for (int i = 11; i < 16; i++)
+            kept = kept && stmts[i]->data.var_decl.initializer->node_type == NODE_CALL_EXPR;
+
+        printf("%s Chamadas puras com argumentos constantes: %d (esperado 6)\n",
+               folded == 6 && literals ? "✅" : "❌", folded);
+        printf("%s Chamadas impuras, não constantes ou sem resultado mantidas\n", kept ? "✅" : "❌");
+        semantic_cleanup(&analyzer);
+        ast_free(program);
+    }
+
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    printf("\n");
+}
+
 void test_complex_program()
 {
     printf("=== TESTE: Programa Complexo ===\n");
@@ -382,6 +1036,557 @@ void test_complex_program()
     printf("\n");
 }
 
+/* Gera um programa com muitas funções, grande o bastante para o parse paralelo */
+static char *build_large_program(int functions)
+{
+    size_t capacity = (size_t)functions * 96 + 64;
+    char *source = malloc(capacity);
+    if (!source)
+        return NULL;
+
+    size_t length = 0;
+    for (int i = 0; i < functions; i++)
+    {
+        length += snprintf(source + length, capacity - length,
+                           "let v%d: int = %d;\n"
+                           "fn f%d(a: int): int { let b: int = a + v%d; return b * 2; }\n",
+                           i, i, i, i);
+    }
+    return source;
+}
+
+/* Faz o parse pré-tokenizado com o número de threads dado (arena opcional) */
+static ASTNode *parse_with_threads(TokenBuffer *tokens, int thread_count, AstArena *arena,
+                                   int *had_error)
+{
+    Parser parser;
+    parser_init_tokens(&parser, tokens);
+    parser.thread_count = thread_count;
+    parser.arena = arena;
+
+    ASTNode *program = parse_program(&parser);
+    *had_error = parser.had_error;
+    parser_cleanup(&parser);
+    return program;
+}
+
+void test_parallel_parse()
+{
+    printf("=== TESTE: Parse Paralelo de Declarações ===\n");
+
+    char *source = build_large_program(4000);
+    if (!source)
+    {
+        printf("❌ Memória insuficiente\n\n");
+        return;
+    }
+
+    Lexer lexer;
+    TokenBuffer tokens;
+    lexer_init(&lexer, source);
+    token_buffer_init(&tokens);
+
+    if (!token_buffer_fill(&tokens, &lexer))
+    {
+        printf("❌ Falha ao tokenizar\n\n");
+        free(source);
+        return;
+    }
+    printf("Tokens: %d, declarações de nível superior: %d\n", tokens.count, tokens.decl_count);
+
+    int serial_error = 0;
+    int parallel_error = 0;
+    AstArena arena;
+    ast_arena_init(&arena);
+    ASTNode *serial = parse_with_threads(&tokens, 1, NULL, &serial_error);
+    ASTNode *parallel = parse_with_threads(&tokens, 4, &arena, &parallel_error);
+
+    // Mesmo número de nós, na mesma ordem do fonte
+    int same = !serial_error && !parallel_error &&
+               serial->data.block.stmt_count == parallel->data.block.stmt_count;
+    for (int i = 0; same && i < serial->data.block.stmt_count; i++)
+    {
+        ASTNode *a = serial->data.block.statements[i];
+        ASTNode *b = parallel->data.block.statements[i];
+        same = a->node_type == b->node_type && a->line == b->line && a->column == b->column;
+    }
+    printf("%s Serial: %d nós, paralelo: %d nós (arena: %zu bytes)\n", same ? "✅" : "❌",
+           serial->data.block.stmt_count, parallel->data.block.stmt_count, arena.bytes);
+
+    SemanticAnalyzer analyzer;
+    semantic_init(&analyzer, parallel);
+    int success = semantic_analyze(&analyzer);
+    printf("Resultado semântico: %s\n", success ? "Sucesso" : "Erro");
+    semantic_cleanup(&analyzer);
+
+    ast_free(serial);
+    ast_arena_free(&arena);
+    token_buffer_free(&tokens);
+    lexer_cleanup(&lexer);
+    free(source);
+    printf("\n");
+}
+
+/* Programa com erros e avisos espalhados pelos corpos e pelo nível superior:
+ * uso de global declarada depois da função, chamada à função seguinte,
+ * conversão implícita e redeclaração */
+static char *build_program_with_errors(int functions)
+{
+    size_t capacity = (size_t)functions * 256 + 64;
+    char *source = malloc(capacity);
+    if (!source)
+        return NULL;
+
+    size_t length = 0;
+    for (int i = 0; i < functions; i++)
+    {
+        char value[32];
+        if (i % 5 == 0)
+            snprintf(value, sizeof(value), "w%d", i);
+        else if (i % 7 == 0)
+            snprintf(value, sizeof(value), "f%d(a)", i + 1);
+        else
+            snprintf(value, sizeof(value), "b");
+
+        length += snprintf(source + length, capacity - length,
+                           "let v%d: int = %d;\n"
+                           "fn f%d(a: int): int {\n"
+                           "    let b: int = a + v%d;\n"
+                           "    let c: int = %s;\n"
+                           "    let d: float = b * %s;\n"
+                           "    return c;\n"
+                           "}\n",
+                           i, i, i, i, value, i % 3 == 0 ? "1.5" : "2");
+        if (i % 5 == 0)
+            length += snprintf(source + length, capacity - length, "let w%d: int = f%d(1);\n", i, i);
+        if (i % 11 == 0)
+            length += snprintf(source + length, capacity - length, "fn f%d(a: int): int { return a; }\n", i);
+    }
+    return source;
+}
+
+/* Mesmas contagens e mesmos diagnósticos, na mesma ordem */
+static int same_diagnostics(SemanticAnalyzer *a, SemanticAnalyzer *b)
+{
+    if (a->error_count != b->error_count || a->warning_count != b->warning_count ||
+        a->diagnostic_count != b->diagnostic_count)
+        return 0;
+
+    for (int i = 0; i < a->diagnostic_count; i++)
+    {
+        SemanticDiagnostic *x = &a->diagnostics[i];
+        SemanticDiagnostic *y = &b->diagnostics[i];
+        if (x->line != y->line || x->column != y->column || x->is_error != y->is_error ||
+            strcmp(semantic_diagnostic_message(a, i), semantic_diagnostic_message(b, i)) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+static void analyze_with_threads(SemanticAnalyzer *analyzer, ASTNode *program, int thread_count)
+{
+    semantic_init(analyzer, program);
+    analyzer->thread_count = thread_count;
+    analyzer->print_diagnostics = 0;
+    semantic_analyze(analyzer);
+}
+
+void test_parallel_semantic()
+{
+    printf("=== TESTE: Análise Semântica Paralela ===\n");
+
+    char *source = build_program_with_errors(2000);
+    if (!source)
+    {
+        printf("❌ Memória insuficiente\n\n");
+        return;
+    }
+
+    Lexer lexer;
+    Parser parser;
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+    ASTNode *program = parse_program(&parser);
+
+    if (program && !parser.had_error)
+    {
+        SemanticAnalyzer serial;
+        SemanticAnalyzer parallel;
+        analyze_with_threads(&serial, program, 1);
+        analyze_with_threads(&parallel, program, 4);
+
+        int same = same_diagnostics(&serial, &parallel);
+        printf("%s Serial: %d erros/%d avisos, paralelo: %d erros/%d avisos\n", same ? "✅" : "❌",
+               serial.error_count, serial.warning_count, parallel.error_count, parallel.warning_count);
+
+        semantic_cleanup(&serial);
+        semantic_cleanup(&parallel);
+    }
+    else
+    {
+        printf("❌ Erro no parsing\n");
+    }
+
+    ast_free(program);
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+    free(source);
+    printf("\n");
+}
+
+void test_fused_analysis()
+{
+    printf("=== TESTE: Parse e Análise Fundidos ===\n");
+
+    char *source = build_program_with_errors(300);
+    if (!source)
+    {
+        printf("❌ Memória insuficiente\n\n");
+        return;
+    }
+
+    // Duas passadas: parse completo e depois semantic_analyze
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer two_pass;
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+    ASTNode *program = parse_program(&parser);
+    analyze_with_threads(&two_pass, program, 1);
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+
+    // Uma passada: cada declaração verificada assim que é reduzida
+    Lexer fused_lexer;
+    Parser fused_parser;
+    SemanticAnalyzer fused;
+    lexer_init(&fused_lexer, source);
+    parser_init(&fused_parser, &fused_lexer);
+    semantic_init(&fused, NULL);
+    fused.print_diagnostics = 0;
+    semantic_attach_parser(&fused, &fused_parser);
+    ASTNode *fused_program = parse_program(&fused_parser);
+    semantic_end_program(&fused, fused_program);
+
+    int same = !parser.had_error && !fused_parser.had_error && fused.ast_root == fused_program &&
+               same_diagnostics(&two_pass, &fused);
+    printf("%s Duas passadas: %d erros/%d avisos, fundido: %d erros/%d avisos\n", same ? "✅" : "❌",
+           two_pass.error_count, two_pass.warning_count, fused.error_count, fused.warning_count);
+
+    // As expressões ficam anotadas com o tipo calculado: 'let d: float = b * 1.5;' em f0
+    ASTNode *body = fused_program->data.block.statements[1]->data.func_decl.body;
+    ASTNode *product = body->data.block.statements[2]->data.var_decl.initializer;
+    ASTNode *sum = body->data.block.statements[0]->data.var_decl.initializer;
+    int annotated = product->data_type == TYPE_FLOAT && sum->data_type == TYPE_INT;
+    printf("%s Tipos anotados na AST: b * 1.5 -> %s, a + v0 -> %s\n", annotated ? "✅" : "❌",
+           data_type_to_string(product->data_type), data_type_to_string(sum->data_type));
+
+    semantic_cleanup(&two_pass);
+    semantic_cleanup(&fused);
+    ast_free(program);
+    ast_free(fused_program);
+    parser_cleanup(&fused_parser);
+    lexer_cleanup(&fused_lexer);
+    free(source);
+    printf("\n");
+}
+
+/* Faz o parse de 'let x: <tipo> = <literal>;' e retorna o nó do literal */
+static ASTNode *parse_single_literal(const char *source, ASTNode **program, Parser *parser, Lexer *lexer)
+{
+    lexer_init(lexer, source);
+    parser_init(parser, lexer);
+    *program = parse_program(parser);
+    if (!*program || parser->had_error || (*program)->data.block.stmt_count != 1)
+        return NULL;
+    return (*program)->data.block.statements[0]->data.var_decl.initializer;
+}
+
+void test_numeric_literals()
+{
+    printf("=== TESTE: Literais Numéricos ===\n");
+
+    const char *floats[] = {"0.1", "3.14159", "12.5", "0.30000000000000004",
+                            "9007199254740993.0", "123456789012345678901234567890.5",
+                            "0.000000000000000000000000001"};
+    int exact = 1;
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++)
+    {
+        char source[128];
+        snprintf(source, sizeof(source), "let x: float = %s;", floats[i]);
+
+        Lexer lexer;
+        Parser parser;
+        ASTNode *program = NULL;
+        ASTNode *literal = parse_single_literal(source, &program, &parser, &lexer);
+        if (!literal || literal->data.literal.value.float_value != strtod(floats[i], NULL))
+        {
+            printf("❌ %s convertido incorretamente\n", floats[i]);
+            exact = 0;
+        }
+        ast_free(program);
+        parser_cleanup(&parser);
+        lexer_cleanup(&lexer);
+    }
+    if (exact)
+        printf("✅ Floats idênticos a strtod\n");
+
+    // INT_MIN só é representável com o '-' aplicado ao literal
+    const char *ints[] = {"let x: int = 2147483647;", "let x: int = 2147483648;",
+                          "let x: int = -2147483648;", "let x: int = -2147483649;"};
+    const int accepted[] = {1, 0, 1, 0};
+    const int values[] = {INT_MAX, 0, INT_MIN, 0};
+    int bounds = 1;
+    for (int i = 0; i < 4; i++)
+    {
+        Lexer lexer;
+        Parser parser;
+        ASTNode *program = NULL;
+        ASTNode *literal = parse_single_literal(ints[i], &program, &parser, &lexer);
+        if (literal)
+            printf("%s: %d\n", ints[i], literal->data.literal.value.int_value);
+        else
+            printf("%s: erro de parsing (overflow detectado)\n", ints[i]);
+        if ((literal != NULL) != accepted[i] ||
+            (literal && (literal->node_type != NODE_LITERAL || literal->data.literal.value.int_value != values[i])))
+            bounds = 0;
+        ast_free(program);
+        parser_cleanup(&parser);
+        lexer_cleanup(&lexer);
+    }
+
+    // O mesmo vale para rótulos negativos do match
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+    lexer_init(&lexer, "let n: int = 0;\nmatch (n) { -2147483648 => { n = 1; } 2147483647 => { n = 2; } }");
+    parser_init(&parser, &lexer);
+    ASTNode *program = parse_program(&parser);
+    if (program && !parser.had_error)
+    {
+        semantic_init(&analyzer, program);
+        semantic_analyze(&analyzer);
+        const MatchTable *table = program->data.block.statements[1]->data.match_stmt.table;
+        bounds = bounds && analyzer.error_count == 0 && match_table_find_int(table, INT_MIN) == 0 &&
+                 match_table_find_int(table, INT_MAX) == 1;
+        semantic_cleanup(&analyzer);
+    }
+    else
+        bounds = 0;
+    ast_free(program);
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+
+    printf("%s Limites de int em literais e rótulos do match\n\n", bounds ? "✅" : "❌");
+}
+
+void test_compact_ast()
+{
+    printf("=== TESTE: AST Compacta ===\n");
+
+    // Um programa com todos os tipos de nó (menos import, que precisa de arquivo)
+    const char *source =
+        "struct Par { a: int, b: float, nome: string, v: int[] }\n"
+        "let g: map<string, int> = {\"x\": 1, \"y\": 2};\n"
+        "let arr: float[] = [1.5, 2.25];\n"
+        "fn f(p: Par, n: int): int {\n"
+        "    let t: bool = !true && false || n >= -2147483648;\n"
+        "    p.a = n % 3;\n"
+        "    arr[0] = p.b;\n"
+        "    let k: int = n;\n"
+        "    while (k > 0) { k = k - 1; }\n"
+        "    for i in 0..10 step 2 { print(i); }\n"
+        "    if (t) { return p.a; } else { print(\"s\", p.nome); }\n"
+        "    match (n) { 1, 2 => { print(1); } -5 => { print(2); } else => { print(3); } }\n"
+        "    return -n;\n"
+        "}\n"
+        "print(f(Par(1, 2.5, \"n\", [1]), 2), g[\"x\"]);";
+
+    Lexer lexer;
+    Parser parser;
+    SemanticAnalyzer analyzer;
+
+    lexer_init(&lexer, source);
+    parser_init(&parser, &lexer);
+    ASTNode *program = parse_program(&parser);
+    if (!program || parser.had_error)
+    {
+        printf("❌ Erro de parsing: %s\n\n", parser.error_msg);
+        parser_cleanup(&parser);
+        lexer_cleanup(&lexer);
+        return;
+    }
+    semantic_init(&analyzer, program);
+    semantic_analyze(&analyzer);
+
+    // Árvore -> compacta -> árvore -> compacta: as duas formas compactas são idênticas
+    CompactAst first;
+    CompactAst second;
+    AstArena arena;
+    compact_ast_init(&first);
+    compact_ast_init(&second);
+    ast_arena_init(&arena);
+
+    AstHandle root = compact_ast_build(&first, program);
+    ASTNode *expanded = compact_ast_expand(&first, &arena);
+    int same = root == 0 && first.nodes[0].kind == NODE_BLOCK && expanded != NULL &&
+               compact_ast_build(&second, expanded) == 0 && analyzer.error_count == 0 &&
+               first.node_count == second.node_count && first.list_count == second.list_count &&
+               first.string_size == second.string_size &&
+               memcmp(first.nodes, second.nodes, sizeof(CompactNode) * first.node_count) == 0 &&
+               memcmp(first.lists, second.lists, sizeof(AstHandle) * first.list_count) == 0 &&
+               memcmp(first.strings, second.strings, first.string_size) == 0;
+    printf("%s Ida e volta: %u nós, %u handles em listas, %u bytes de strings\n", same ? "✅" : "❌",
+           first.node_count, first.list_count, first.string_size);
+    printf("%s Nó compacto com %d bytes (ASTNode: %d)\n", sizeof(CompactNode) == 32 ? "✅" : "❌",
+           (int)sizeof(CompactNode), (int)sizeof(ASTNode));
+
+    // A expansão remonta a tabela de despacho do match
+    if (expanded)
+    {
+        const ASTNode *body = expanded->data.block.statements[3]->data.func_decl.body;
+        const MatchTable *table = body->data.block.statements[7]->data.match_stmt.table;
+        printf("%s Tabela do match remontada\n",
+               table && match_table_find_int(table, -5) == 1 && match_table_find_int(table, 3) == -1 ? "✅" : "❌");
+    }
+
+    // Um filho que aponta para trás (ciclo) é rejeitado sem tocar na arena
+    CompactNode *copy = malloc(sizeof(CompactNode) * first.node_count);
+    size_t bytes = arena.bytes;
+    int rejected = 0;
+    if (copy)
+    {
+        memcpy(copy, first.nodes, sizeof(CompactNode) * first.node_count);
+        CompactAst corrupt;
+        compact_ast_view(&corrupt, copy, first.node_count, first.lists, first.list_count, first.strings,
+                         first.string_size);
+        copy[first.lists[1]].slot[2] = 0; // Inicializador de 'g' aponta para a raiz
+        rejected = compact_ast_expand(&corrupt, &arena) == NULL && arena.bytes == bytes;
+        free(copy);
+    }
+    printf("%s Handle inválido rejeitado\n\n", rejected ? "✅" : "❌");
+
+    compact_ast_free(&first);
+    compact_ast_free(&second);
+    ast_arena_free(&arena);
+    semantic_cleanup(&analyzer);
+    ast_free(program);
+    parser_cleanup(&parser);
+    lexer_cleanup(&lexer);
+}
+
+/* Refaz parse + análise do fonte do documento do zero e compara com o estado
+ * incremental: mesmas instruções nas mesmas posições e mesmo número de erros */
+static int matches_full_analysis(Document *doc)
+{
+    Lexer lexer;
+    TokenBuffer tokens;
+    lexer_init_span(&lexer, doc->source, doc->length);
+    token_buffer_init(&tokens);
+    token_buffer_fill(&tokens, &lexer);
+
+    int had_error = 0;
+    ASTNode *full = parse_with_threads(&tokens, 1, NULL, &had_error);
+    ASTNode *program = document_program(doc);
+
+    int same = full->data.block.stmt_count == program->data.block.stmt_count;
+    for (int i = 0; same && i < full->data.block.stmt_count; i++)
+    {
+        ASTNode *a = full->data.block.statements[i];
+        ASTNode *b = program->data.block.statements[i];
+        same = a->node_type == b->node_type && a->line == b->line && a->column == b->column;
+        if (same && a->node_type == NODE_FUNC_DECL)
+            same = a->data.func_decl.body->line == b->data.func_decl.body->line;
+    }
+
+    if (same && !had_error)
+    {
+        SemanticAnalyzer analyzer;
+        semantic_init(&analyzer, full);
+        semantic_analyze(&analyzer);
+        same = analyzer.error_count == doc->error_count;
+        semantic_cleanup(&analyzer);
+    }
+
+    ast_free(full);
+    token_buffer_free(&tokens);
+    lexer_cleanup(&lexer);
+    return same;
+}
+
+/* Substitui a primeira ocorrência de 'old_text' no documento por 'new_text' */
+static void edit_document(Document *doc, const char *old_text, const char *new_text)
+{
+    const char *at = strstr(doc->source, old_text);
+    if (at)
+        document_edit(doc, at - doc->source, strlen(old_text), new_text, strlen(new_text));
+}
+
+static void report_edit(Document *doc, const char *description, double elapsed)
+{
+    int ok = document_analyze(doc);
+    printf("%s %s: %d trecho(s) refeito(s) (%zu bytes), %d re-verificado(s), %d erro(s), %.3f ms\n",
+           matches_full_analysis(doc) ? "✅" : "❌", description, doc->reparsed_units,
+           doc->relexed_bytes, doc->rechecked_units, ok ? 0 : doc->error_count, elapsed * 1000.0);
+}
+
+void test_incremental_analysis()
+{
+    printf("=== TESTE: Análise Incremental ===\n");
+
+    char *source = build_large_program(2000);
+    if (!source)
+    {
+        printf("❌ Memória insuficiente\n\n");
+        return;
+    }
+
+    clock_t start = clock();
+    Document doc;
+    if (!document_open(&doc, source, strlen(source)))
+    {
+        printf("❌ Falha ao abrir o documento\n\n");
+        free(source);
+        return;
+    }
+    document_analyze(&doc);
+    double full = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%s Análise completa: %d trechos, %d verificados, %.3f ms\n",
+           doc.error_count == 0 ? "✅" : "❌", doc.unit_count, doc.rechecked_units, full * 1000.0);
+
+    // Corpo de função: só o próprio trecho muda
+    start = clock();
+    edit_document(&doc, "a + v1000; return b * 2", "a + v1000; return b * 3");
+    report_edit(&doc, "Corpo de f1000", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    // Tipo de uma global: re-verifica também quem a usa (f1500 passa a ter erro)
+    start = clock();
+    edit_document(&doc, "let v1500: int", "let v1500: float");
+    report_edit(&doc, "Tipo de v1500", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    start = clock();
+    edit_document(&doc, "let v1500: float", "let v1500: int");
+    report_edit(&doc, "Tipo de v1500 restaurado", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    // Linhas novas no início: as demais ASTs só têm as linhas deslocadas
+    start = clock();
+    document_edit(&doc, 0, 0, "# cabeçalho\n\n", 13);
+    report_edit(&doc, "Comentário no início", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    // Chave sem par: o resto do arquivo vira um único trecho até ser corrigido
+    start = clock();
+    edit_document(&doc, "fn f10(a: int): int {", "fn f10(a: int): int { {");
+    report_edit(&doc, "Chave aberta em f10", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    start = clock();
+    edit_document(&doc, "fn f10(a: int): int { {", "fn f10(a: int): int {");
+    report_edit(&doc, "Chave removida", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    document_free(&doc);
+    free(source);
+    printf("\n");
+}
+
 int main()
 {
     printf("========================================\n");
@@ -393,10 +1598,30 @@ int main()
     test_function_declaration();
     test_function_call();
     test_scope_resolution();
+    test_shadowing();
+    test_interned_types();
+    test_array_types();
+    test_vector_builtins();
+    test_map_types();
+    test_for_loops();
+    test_string_builtins();
+    test_bytes_type();
+    test_struct_types();
+    test_imports();
+    test_diagnostics();
     test_builtin_functions();
     test_expression_types();
+    test_logical_operators();
+    test_match_statement();
+    test_constant_folding();
     test_error_cases();
     test_complex_program();
+    test_parallel_parse();
+    test_parallel_semantic();
+    test_fused_analysis();
+    test_numeric_literals();
+    test_compact_ast();
+    test_incremental_analysis();
 
     printf("========================================\n");
     printf("       TESTES CONCLUÍDOS               \n");